@@ -0,0 +1,91 @@
+project "VulkanBench"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++20"
+	staticruntime "off"
+	
+	architecture "x86_64"
+	
+	-- Note: Runs from the sandbox, so it shares the shaders and models.
+	debugdir ("%{wks.location}/VulkanSandbox")
+	
+	targetdir ("%{wks.location}/bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("%{wks.location}/bin-int/" .. outputdir .. "/%{prj.name}")
+
+	files
+	{
+		"src/**.h",
+		"src/**.hpp",
+		"src/**.cpp"
+	}
+
+	includedirs
+	{
+		"src",
+
+		"%{wks.location}/VulkanCore/src",
+		"%{wks.location}vendor",
+
+		"%{IncludeDir.GLFW}",
+		"%{IncludeDir.ImGui}",
+		"%{IncludeDir.spdlog}",
+		"%{IncludeDir.glm}",
+		"%{IncludeDir.stb_image}",
+		"%{IncludeDir.assimp}",
+		"%{IncludeDir.VulkanSDK}",
+		"%{IncludeDir.VMA}"
+	}
+
+	links
+	{
+		"VulkanCore"
+	}
+
+	disablewarnings
+	{
+		"4005",
+		"4996"
+	}
+
+	-- The results are logged as info, which Release and Dist strip by default (VKAPP_LOG_LEVEL_INFO)
+	defines
+	{
+		"VKAPP_LOG_LEVEL=1"
+	}
+
+	filter "system:windows"
+		systemversion "latest"
+		staticruntime "on"
+
+		defines
+		{
+			"VKAPP_PLATFORM_WINDOWS",
+			"GLFW_INCLUDE_NONE"
+		}
+
+	filter "configurations:Debug"
+		defines "VKAPP_DEBUG"
+		runtime "Debug"
+		symbols "on"
+
+	filter "configurations:Release"
+		defines "VKAPP_RELEASE"
+		runtime "Release"
+		optimize "on"
+
+	filter "configurations:Dist"
+		defines "VKAPP_DIST"
+		runtime "Release"
+		optimize "on"
+
+	filter { "system:windows", "configurations:Debug" }
+		postbuildcommands
+		{
+			'{COPYFILE} "%{wks.location}/vendor/assimp/bin/windows/Debug/assimp-vc143-mtd.dll" "%{cfg.targetdir}"',
+		}
+
+	filter { "system:windows", "configurations:Release or Dist" }
+		postbuildcommands
+		{
+			'{COPYFILE} "%{wks.location}/vendor/assimp/bin/windows/Release/assimp-vc143-mt.dll" "%{cfg.targetdir}"',
+		}
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include "BenchConfig.hpp"
+
+#include <fstream>
+#include <algorithm>
+
+#include <VulkanCore/Core/Logging.hpp>
+
+static std::string Trim(const std::string& str)
+{
+	size_t begin = str.find_first_not_of(" \t\r\n");
+	if (begin == std::string::npos)
+		return {};
+
+	size_t end = str.find_last_not_of(" \t\r\n");
+	return str.substr(begin, end - begin + 1);
+}
+
+template<typename T>
+static bool ParseNumber(const std::string& value, T& result)
+{
+	try
+	{
+		if constexpr (std::is_floating_point_v<T>)
+			result = static_cast<T>(std::stod(value));
+		else
+		{
+			long long number = std::stoll(value);
+			if (number < 0)
+				return false;
+
+			result = static_cast<T>(number);
+		}
+	}
+	catch (...)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+static bool ParseBool(const std::string& value, bool& result)
+{
+	if (value == "true" || value == "1" || value == "yes")
+		result = true;
+	else if (value == "false" || value == "0" || value == "no")
+		result = false;
+	else
+		return false;
+
+	return true;
+}
+
+bool BenchConfig::Parse(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg.rfind("--", 0) != 0)
+		{
+			VKAPP_LOG_ERROR("Unexpected argument '{0}'.", arg);
+			return false;
+		}
+
+		std::string key = arg.substr(2);
+		std::string value = { };
+
+		size_t equals = key.find('=');
+		if (equals != std::string::npos)
+		{
+			value = key.substr(equals + 1);
+			key = key.substr(0, equals);
+		}
+		else if (i + 1 < argc)
+			value = argv[++i];
+
+		if (key == "config")
+		{
+			if (!LoadFile(value))
+				return false;
+
+			continue;
+		}
+
+		if (!Set(key, value))
+			return false;
+	}
+
+	return true;
+}
+
+bool BenchConfig::LoadFile(const std::filesystem::path& path)
+{
+	std::ifstream file(path);
+	if (!file.is_open())
+	{
+		VKAPP_LOG_ERROR("Failed to open bench config '{0}'.", path.string());
+		return false;
+	}
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		line = Trim(line.substr(0, line.find('#')));
+		if (line.empty())
+			continue;
+
+		size_t equals = line.find('=');
+		if (equals == std::string::npos)
+		{
+			VKAPP_LOG_ERROR("Expected 'key = value' in '{0}', got '{1}'.", path.string(), line);
+			return false;
+		}
+
+		if (!Set(Trim(line.substr(0, equals)), Trim(line.substr(equals + 1))))
+			return false;
+	}
+
+	return true;
+}
+
+bool BenchConfig::Set(const std::string& key, const std::string& value)
+{
+	bool valid = false;
+
+	if (key == "instances")				valid = ParseNumber(value, Instances);
+	else if (key == "textures")			valid = ParseNumber(value, Textures);
+	else if (key == "pipelines")		valid = ParseNumber(value, Pipelines);
+	else if (key == "texture-size")		valid = ParseNumber(value, TextureSize) && TextureSize > 0;
+	else if (key == "mesh")				{ Mesh = value; valid = !value.empty(); }
+	else if (key == "warmup")			valid = ParseNumber(value, WarmupFrames);
+	else if (key == "frames")			valid = ParseNumber(value, Frames) && Frames > 0;
+	else if (key == "timestep")			valid = ParseNumber(value, Timestep) && Timestep > 0.0f;
+	else if (key == "width")			valid = ParseNumber(value, Width) && Width > 0;
+	else if (key == "height")			valid = ParseNumber(value, Height) && Height > 0;
+	else if (key == "frames-in-flight")	valid = ParseNumber(value, FramesInFlight);
+	else if (key == "headless")			valid = ParseBool(value, Headless);
+	else if (key == "output")			{ Output = value; valid = !value.empty(); }
+	else if (key == "baseline")			{ Baseline = value; valid = true; }
+	else if (key == "threshold")		valid = ParseNumber(value, Threshold) && Threshold >= 0.0f;
+	else
+	{
+		VKAPP_LOG_ERROR("Unknown bench setting '{0}'.", key);
+		return false;
+	}
+
+	if (!valid)
+		VKAPP_LOG_ERROR("Invalid value '{0}' for bench setting '{1}'.", value, key);
+
+	// Note: Zero textures or pipelines would leave instances without one.
+	Textures = std::max(Textures, 1u);
+	Pipelines = std::max(Pipelines, 1u);
+
+	return valid;
+}
\ No newline at end of file
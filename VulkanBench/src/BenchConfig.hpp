@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <filesystem>
+
+// Everything that defines a run. Two runs with the same config render the exact same frames.
+struct BenchConfig
+{
+public:
+	// Scene
+	uint32_t Instances = 256;		// Copies of the mesh, laid out on a grid
+	uint32_t Textures = 8;			// Generated textures, instance i uses texture i % Textures
+	uint32_t Pipelines = 4;			// Pipelines, instance i uses pipeline i % Pipelines
+	uint32_t TextureSize = 512;
+	std::filesystem::path Mesh = "assets/objects/Cat.obj";
+
+	// Run
+	uint32_t WarmupFrames = 60;		// Not measured
+	uint32_t Frames = 600;
+	float Timestep = 1.0f / 60.0f;	// Animation time per frame, independent of how long the frame took
+	uint32_t Width = 1280;
+	uint32_t Height = 720;
+	uint32_t FramesInFlight = 2;
+	bool Headless = true;
+
+	// Output
+	std::filesystem::path Output = "BenchResult.json";
+	std::filesystem::path Baseline = { };	// Compared against when set
+	float Threshold = 0.10f;				// Allowed relative slowdown before it counts as a regression
+
+public:
+	// Reads "--key value" / "--key=value" arguments, "--config file" loads a file of "key = value" lines first.
+	// Returns false on unknown keys or bad values.
+	bool Parse(int argc, char* argv[]);
+	bool LoadFile(const std::filesystem::path& path);
+
+	bool Set(const std::string& key, const std::string& value);
+};
\ No newline at end of file
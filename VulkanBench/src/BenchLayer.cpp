@@ -0,0 +1,329 @@
+#include "BenchLayer.hpp"
+
+#include <cmath>
+#include <array>
+#include <algorithm>
+
+#include <VulkanCore/Core/Application.hpp>
+#include <VulkanCore/Core/Logging.hpp>
+#include <VulkanCore/Core/Profiler.hpp>
+#include <VulkanCore/Renderer/Renderer.hpp>
+#include <VulkanCore/Renderer/GpuProfiler.hpp>
+#include <VulkanCore/Renderer/InstanceManager.hpp>
+#include <VulkanCore/Renderer/DeviceObjectCache.hpp>
+#include <VulkanCore/Renderer/ResidencyManager.hpp>
+#include <VulkanCore/Utils/BufferManager.hpp>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE 
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+struct UniformBufferObject
+{
+	glm::mat4 Model;
+	glm::mat4 View;
+	glm::mat4 Proj;
+};
+
+static const float s_InstanceSpacing = 40.0f;
+
+static std::vector<DescriptorInfo> GetDescriptors()
+{
+	DescriptorInfo uniformDescriptor = {};
+	uniformDescriptor.Binding = 0;
+	uniformDescriptor.DescriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC; // Offset per instance
+
+	DescriptorInfo imageDescriptor = {};
+	imageDescriptor.Binding = 1;
+	imageDescriptor.DescriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	imageDescriptor.StageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+	return { uniformDescriptor, imageDescriptor };
+}
+
+BenchLayer::BenchLayer(const BenchConfig& config)
+	: Layer("Bench"), m_Config(config)
+{
+}
+
+void BenchLayer::OnAttach()
+{
+	m_Mesh = Mesh(m_Config.Mesh);
+	if (m_Mesh.GetAmountOfIndices() == 0)
+	{
+		VKAPP_LOG_ERROR("Failed to load the bench mesh '{0}'.", m_Config.Mesh.string());
+		Application::Get().Close();
+		return;
+	}
+
+	CreateTextures();
+	CreatePipelines();
+	CreateDescriptors();
+
+	// The draw stats don't change from frame to frame
+	m_Result.DrawsPerFrame = m_Config.Instances;
+	m_Result.DescriptorBindsPerFrame = m_Config.Instances; // Every draw has its own dynamic offset
+	m_Result.PipelineBindsPerFrame = std::min(m_Config.Pipelines, m_Config.Instances);
+	m_Result.TrianglesPerFrame = (uint64_t)m_Config.Instances * (m_Mesh.GetAmountOfIndices() / 3);
+
+	m_CPUFrameMs.reserve(m_Config.Frames);
+	m_GPUFrameMs.reserve(m_Config.Frames);
+
+	VKAPP_LOG_INFO("Bench: {0} instances, {1} textures, {2} pipelines, {3} + {4} frames", m_Config.Instances, m_Config.Textures, m_Config.Pipelines, m_Config.WarmupFrames, m_Config.Frames);
+}
+
+void BenchLayer::OnDetach()
+{
+	vkDeviceWaitIdle(InstanceManager::Get()->GetLogicalDevice());
+
+	for (auto& pool : m_DescriptorPools)
+		vkDestroyDescriptorPool(InstanceManager::Get()->GetLogicalDevice(), pool, nullptr);
+
+	if (m_DescriptorLayout != VK_NULL_HANDLE)
+		DeviceObjectCache::Get()->Release(m_DescriptorLayout);
+
+	for (size_t i = 0; i < m_UniformBuffers.size(); i++)
+		BufferManager::DestroyBuffer(m_UniformBuffers[i], m_UniformBuffersMemory[i]);
+
+	for (uint32_t i = 0; i < m_Pipelines.size(); i++)
+		GraphicsPipelineManager::Get()->DestroyPipeline("Bench Pipeline " + std::to_string(i));
+
+	for (auto& texture : m_Textures)
+		texture.Destroy();
+
+	m_Mesh.Destroy();
+}
+
+void BenchLayer::OnUpdate(float deltaTime)
+{
+	if (m_Pipelines.empty() || m_Finished)
+		return;
+
+	auto now = std::chrono::steady_clock::now();
+
+	// Note: Frame times are measured from update to update, so they cover the whole loop including the GPU wait.
+	if (m_Frame > m_Config.WarmupFrames)
+	{
+		m_CPUFrameMs.push_back(std::chrono::duration<float, std::milli>(now - m_LastFrame).count());
+
+		if (GpuProfiler::Get() && GpuProfiler::Get()->IsSupported())
+			m_GPUFrameMs.push_back(GpuProfiler::Get()->GetFrameMs());
+	}
+
+	m_LastFrame = now;
+
+	for (auto& heap : ResidencyManager::Get()->GetHeapStats())
+		m_Result.PeakUsageBytes = std::max<uint64_t>(m_Result.PeakUsageBytes, heap.Usage);
+
+	if (m_CPUFrameMs.size() == m_Config.Frames)
+	{
+		Finish();
+		return;
+	}
+
+	// Note: Animation time only depends on the frame number, never on the measured time.
+	UpdateUniforms(Renderer::Get()->GetCurrentImage(), (float)m_Frame * m_Config.Timestep);
+	m_Frame++;
+}
+
+void BenchLayer::OnRender()
+{
+	if (m_Pipelines.empty() || m_Finished)
+		return;
+
+	Renderer::AddToQueue([this](VkCommandBuffer& buffer, uint32_t imageIndex)
+	{
+		VKAPP_PROFILE_SCOPE("Bench::Record");
+
+		uint32_t currentFrame = Renderer::Get()->GetCurrentImage();
+		VkDeviceSize offset = 0;
+
+		vkCmdBindVertexBuffers(buffer, 0, 1, &m_Mesh.GetVertexBuffer(), &offset);
+		vkCmdBindIndexBuffer(buffer, m_Mesh.GetIndexBuffer(), 0, VK_INDEX_TYPE_UINT32);
+
+		// Sorted by pipeline, then texture, like a real renderer would
+		for (uint32_t pipeline = 0; pipeline < m_Pipelines.size(); pipeline++)
+		{
+			if (pipeline >= m_Config.Instances)
+				break;
+
+			m_Pipelines[pipeline]->Bind(buffer, VK_PIPELINE_BIND_POINT_GRAPHICS);
+
+			for (uint32_t instance = pipeline; instance < m_Config.Instances; instance += (uint32_t)m_Pipelines.size())
+			{
+				uint32_t texture = instance % (uint32_t)m_Textures.size();
+				uint32_t dynamicOffset = static_cast<uint32_t>(instance * m_UniformStride);
+
+				vkCmdBindDescriptorSets(buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipelines[pipeline]->GetPipelineLayout(), 0, 1, &m_DescriptorSets[texture][currentFrame], 1, &dynamicOffset);
+				vkCmdDrawIndexed(buffer, m_Mesh.GetAmountOfIndices(), 1, 0, 0, 0);
+			}
+		}
+	});
+}
+
+void BenchLayer::CreateTextures()
+{
+	uint32_t size = m_Config.TextureSize;
+
+	for (uint32_t i = 0; i < m_Config.Textures; i++)
+	{
+		TextureData data = {};
+		data.Width = size;
+		data.Height = size;
+		data.Pixels.resize((size_t)size * size * 4);
+
+		// Checkerboard in a colour that's different for every texture
+		uint8_t r = (uint8_t)(64 + (i * 97) % 192), g = (uint8_t)(64 + (i * 57) % 192), b = (uint8_t)(64 + (i * 31) % 192);
+		for (uint32_t y = 0; y < size; y++)
+		{
+			for (uint32_t x = 0; x < size; x++)
+			{
+				bool dark = ((x / 32) + (y / 32)) % 2;
+				uint8_t* pixel = &data.Pixels[((size_t)y * size + x) * 4];
+
+				pixel[0] = dark ? r / 2 : r;
+				pixel[1] = dark ? g / 2 : g;
+				pixel[2] = dark ? b / 2 : b;
+				pixel[3] = 255;
+			}
+		}
+
+		m_Textures.emplace_back(data);
+	}
+}
+
+void BenchLayer::CreatePipelines()
+{
+	PipelineInfo info = {};
+	info.VertexShader = GraphicsPipelineManager::ReadFile("assets/shaders/vert.spv");
+	info.FragmentShader = GraphicsPipelineManager::ReadFile("assets/shaders/frag.spv");
+	info.VertexBindingDescription = MeshVertex::GetBindingDescription();
+	info.VertexAttributeDescriptions = MeshVertex::GetAttributeDescriptions();
+	info.DescriptorSets.Set0 = GetDescriptors();
+
+	// Note: Identical state, but every one is its own VkPipeline so binds aren't free.
+	for (uint32_t i = 0; i < m_Config.Pipelines; i++)
+		m_Pipelines.push_back(&GraphicsPipelineManager::Get()->CreatePipeline("Bench Pipeline " + std::to_string(i), info));
+}
+
+void BenchLayer::CreateDescriptors()
+{
+	VkPhysicalDeviceProperties properties = {};
+	vkGetPhysicalDeviceProperties(InstanceManager::Get()->GetPhysicalDevice(), &properties);
+
+	VkDeviceSize alignment = std::max<VkDeviceSize>(properties.limits.minUniformBufferOffsetAlignment, 1);
+	m_UniformStride = (sizeof(UniformBufferObject) + alignment - 1) / alignment * alignment;
+
+	BufferManager::CreateUniformBuffer(m_UniformBuffers, m_UniformStride * std::max(m_Config.Instances, 1u), m_UniformBuffersMemory, m_UniformBuffersMapped);
+
+	std::vector<DescriptorInfo> descriptors = GetDescriptors();
+	m_DescriptorLayout = DescriptorSets::GetDescriptorSetLayout(descriptors);
+
+	uint32_t framesInFlight = Renderer::Get()->GetFramesInFlight();
+
+	for (auto& texture : m_Textures)
+	{
+		VkDescriptorPool pool = DescriptorSets::CreatePool(descriptors);
+		std::vector<VkDescriptorSet> sets = DescriptorSets::CreateDescriptorSets(m_DescriptorLayout, pool, descriptors);
+
+		for (uint32_t frame = 0; frame < framesInFlight; frame++)
+		{
+			VkDescriptorBufferInfo bufferInfo = {};
+			bufferInfo.buffer = m_UniformBuffers[frame];
+			bufferInfo.offset = 0;
+			bufferInfo.range = sizeof(UniformBufferObject);
+
+			VkDescriptorImageInfo imageInfo = {};
+			imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			imageInfo.imageView = texture.GetImageView();
+			imageInfo.sampler = texture.GetSampler();
+
+			std::array<VkWriteDescriptorSet, 2> writes = {};
+			writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[0].dstSet = sets[frame];
+			writes[0].dstBinding = 0;
+			writes[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+			writes[0].descriptorCount = 1;
+			writes[0].pBufferInfo = &bufferInfo;
+
+			writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[1].dstSet = sets[frame];
+			writes[1].dstBinding = 1;
+			writes[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			writes[1].descriptorCount = 1;
+			writes[1].pImageInfo = &imageInfo;
+
+			vkUpdateDescriptorSets(InstanceManager::Get()->GetLogicalDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+		}
+
+		m_DescriptorPools.push_back(pool);
+		m_DescriptorSets.push_back(sets);
+	}
+}
+
+void BenchLayer::UpdateUniforms(uint32_t frame, float time)
+{
+	uint32_t side = std::max((uint32_t)std::ceil(std::sqrt((float)m_Config.Instances)), 1u);
+	float extent = (float)side * s_InstanceSpacing;
+
+	// Scripted camera, a slow orbit around the grid
+	float angle = time * 0.25f;
+	float radius = extent * 0.75f + 60.0f;
+	glm::vec3 position = { std::cos(angle) * radius, extent * 0.35f + 30.0f, std::sin(angle) * radius };
+
+	glm::mat4 view = glm::lookAt(position, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	glm::mat4 proj = glm::perspective(glm::radians(45.0f), (float)m_Config.Width / (float)m_Config.Height, 0.1f, radius * 4.0f);
+	proj[1][1] *= -1;
+
+	uint8_t* mapped = static_cast<uint8_t*>(m_UniformBuffersMapped[frame]);
+
+	for (uint32_t i = 0; i < m_Config.Instances; i++)
+	{
+		glm::vec3 offset = { ((float)(i % side) - (float)side / 2.0f) * s_InstanceSpacing, 0.0f, ((float)(i / side) - (float)side / 2.0f) * s_InstanceSpacing };
+
+		UniformBufferObject ubo = {};
+		ubo.Model = glm::translate(glm::mat4(1.0f), offset);
+		ubo.Model = glm::rotate(ubo.Model, time * 0.5f + (float)i, glm::vec3(0.0f, 1.0f, 0.0f));
+		ubo.Model = glm::rotate(ubo.Model, glm::radians(270.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+		ubo.View = view;
+		ubo.Proj = proj;
+
+		BufferManager::SetUniformData(mapped + i * m_UniformStride, (void*)&ubo, sizeof(ubo));
+	}
+}
+
+void BenchLayer::Finish()
+{
+	m_Result.CPUFrameMs = FrameTimeStats::Calculate(m_CPUFrameMs);
+	m_Result.GPUFrameMs = FrameTimeStats::Calculate(m_GPUFrameMs);
+	m_Result.GPUTimingSupported = !m_GPUFrameMs.empty();
+
+	for (auto& heap : ResidencyManager::Get()->GetHeapStats())
+		m_Result.TrackedBytes += heap.Tracked;
+
+	VKAPP_LOG_INFO("CPU frame: p50 {0:.3f} ms, p95 {1:.3f} ms, p99 {2:.3f} ms", m_Result.CPUFrameMs.P50, m_Result.CPUFrameMs.P95, m_Result.CPUFrameMs.P99);
+	if (m_Result.GPUTimingSupported)
+		VKAPP_LOG_INFO("GPU frame: p50 {0:.3f} ms, p95 {1:.3f} ms, p99 {2:.3f} ms", m_Result.GPUFrameMs.P50, m_Result.GPUFrameMs.P95, m_Result.GPUFrameMs.P99);
+
+	m_Finished = true;
+	m_ExitCode = 0;
+
+	if (!WriteReport(m_Config.Output, m_Config, m_Result))
+		m_ExitCode = 2;
+	else
+		VKAPP_LOG_INFO("Wrote the bench results to '{0}'.", m_Config.Output.string());
+
+	if (m_ExitCode == 0 && !m_Config.Baseline.empty())
+	{
+		if (!std::filesystem::exists(m_Config.Baseline))
+		{
+			VKAPP_LOG_ERROR("Baseline '{0}' doesn't exist.", m_Config.Baseline.string());
+			m_ExitCode = 2;
+		}
+		else if (!CompareToBaseline(m_Config.Baseline, m_Result, m_Config.Threshold))
+			m_ExitCode = 1;
+	}
+
+	Application::Get().Close();
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+#include <chrono>
+
+#include <VulkanCore/Core/Layer.hpp>
+#include <VulkanCore/Renderer/Mesh.hpp>
+#include <VulkanCore/Renderer/Texture.hpp>
+#include <VulkanCore/Renderer/GraphicsPipelineManager.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include "BenchConfig.hpp"
+#include "BenchReport.hpp"
+
+using namespace VkApp;
+
+// Draws the configured scene along a fixed camera path and measures every frame after the warmup.
+// Closes the application once the run is done and the report is written.
+class BenchLayer : public Layer
+{
+public:
+	BenchLayer(const BenchConfig& config);
+
+	void OnAttach() override;
+	void OnDetach() override;
+
+	void OnUpdate(float deltaTime) override;
+	void OnRender() override;
+
+	inline int GetExitCode() const { return m_ExitCode; } // 0 passed, 1 regressed, 2 failed to run
+
+private:
+	void CreateTextures();
+	void CreatePipelines();
+	void CreateDescriptors();
+
+	void UpdateUniforms(uint32_t frame, float time);
+	void Finish();
+
+private:
+	BenchConfig m_Config;
+
+	Mesh m_Mesh;
+	std::vector<Texture> m_Textures = { };
+	std::vector<GraphicsPipeline*> m_Pipelines = { };
+
+	// One dynamic uniform buffer per frame in flight, holding every instance
+	std::vector<VkBuffer> m_UniformBuffers = { };
+	std::vector<VkDeviceMemory> m_UniformBuffersMemory = { };
+	std::vector<void*> m_UniformBuffersMapped = { };
+	VkDeviceSize m_UniformStride = 0;
+
+	// Per texture, a set per frame in flight
+	VkDescriptorSetLayout m_DescriptorLayout = VK_NULL_HANDLE;
+	std::vector<VkDescriptorPool> m_DescriptorPools = { };
+	std::vector<std::vector<VkDescriptorSet>> m_DescriptorSets = { };
+
+	// Run state
+	uint32_t m_Frame = 0; // Frames rendered so far, the first WarmupFrames aren't measured
+	std::chrono::steady_clock::time_point m_LastFrame = { };
+
+	std::vector<float> m_CPUFrameMs = { };
+	std::vector<float> m_GPUFrameMs = { };
+	BenchResult m_Result = {};
+	bool m_Finished = false;
+
+	int m_ExitCode = 2;
+};
\ No newline at end of file
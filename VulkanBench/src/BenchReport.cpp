@@ -0,0 +1,180 @@
+#include "BenchReport.hpp"
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <numeric>
+
+#include <VulkanCore/Core/Logging.hpp>
+
+FrameTimeStats FrameTimeStats::Calculate(std::vector<float> samples)
+{
+	FrameTimeStats stats = {};
+	if (samples.empty())
+		return stats;
+
+	std::sort(samples.begin(), samples.end());
+
+	auto percentile = [&samples](float p) -> float
+	{
+		size_t rank = static_cast<size_t>(std::ceil(p / 100.0f * (float)samples.size()));
+		return samples[std::clamp(rank, (size_t)1, samples.size()) - 1];
+	};
+
+	stats.Mean = std::accumulate(samples.begin(), samples.end(), 0.0f) / (float)samples.size();
+	stats.Min = samples.front();
+	stats.Max = samples.back();
+	stats.P50 = percentile(50.0f);
+	stats.P95 = percentile(95.0f);
+	stats.P99 = percentile(99.0f);
+
+	return stats;
+}
+
+static void WriteStats(std::ofstream& file, const char* name, const FrameTimeStats& stats)
+{
+	file << "\t\"" << name << "\": { \"mean\": " << stats.Mean << ", \"min\": " << stats.Min << ", \"max\": " << stats.Max
+		<< ", \"p50\": " << stats.P50 << ", \"p95\": " << stats.P95 << ", \"p99\": " << stats.P99 << " },\n";
+}
+
+bool WriteReport(const std::filesystem::path& path, const BenchConfig& config, const BenchResult& result)
+{
+	std::ofstream file(path);
+	if (!file.is_open())
+	{
+		VKAPP_LOG_ERROR("Failed to open '{0}' to write the bench results.", path.string());
+		return false;
+	}
+
+	file << std::fixed << std::setprecision(4);
+	file << "{\n";
+
+	file << "\t\"config\": { \"instances\": " << config.Instances << ", \"textures\": " << config.Textures << ", \"pipelines\": " << config.Pipelines
+		<< ", \"texture_size\": " << config.TextureSize << ", \"mesh\": \"" << config.Mesh.generic_string() << "\", \"warmup\": " << config.WarmupFrames
+		<< ", \"frames\": " << config.Frames << ", \"timestep\": " << config.Timestep << ", \"width\": " << config.Width << ", \"height\": " << config.Height
+		<< ", \"frames_in_flight\": " << config.FramesInFlight << ", \"headless\": " << (config.Headless ? "true" : "false") << " },\n";
+
+	WriteStats(file, "cpu_frame_ms", result.CPUFrameMs);
+	if (result.GPUTimingSupported)
+		WriteStats(file, "gpu_frame_ms", result.GPUFrameMs);
+
+	file << "\t\"per_frame\": { \"draws\": " << result.DrawsPerFrame << ", \"pipeline_binds\": " << result.PipelineBindsPerFrame
+		<< ", \"descriptor_binds\": " << result.DescriptorBindsPerFrame << ", \"triangles\": " << result.TrianglesPerFrame << " },\n";
+
+	file << "\t\"memory\": { \"tracked_bytes\": " << result.TrackedBytes << ", \"peak_usage_bytes\": " << result.PeakUsageBytes << " }\n";
+	file << "}\n";
+
+	return true;
+}
+
+bool ReadReport(const std::filesystem::path& path, std::unordered_map<std::string, double>& values)
+{
+	std::ifstream file(path);
+	if (!file.is_open())
+	{
+		VKAPP_LOG_ERROR("Failed to open baseline '{0}'.", path.string());
+		return false;
+	}
+
+	std::stringstream stream;
+	stream << file.rdbuf();
+	std::string json = stream.str();
+
+	// Note: Only understands what WriteReport() writes, objects of numbers, strings and booleans.
+	std::vector<std::string> objects = { };
+	std::string key = { };
+
+	for (size_t i = 0; i < json.size(); i++)
+	{
+		char c = json[i];
+
+		if (c == '"')
+		{
+			size_t end = json.find('"', i + 1);
+			if (end == std::string::npos)
+				return false;
+
+			std::string str = json.substr(i + 1, end - i - 1);
+			i = end;
+
+			// A string followed by a colon is a key, otherwise it's a value we don't need
+			size_t next = json.find_first_not_of(" \t\r\n", end + 1);
+			if (next != std::string::npos && json[next] == ':')
+				key = str;
+		}
+		else if (c == '{')
+		{
+			if (!key.empty())
+				objects.push_back(key);
+			key.clear();
+		}
+		else if (c == '}')
+		{
+			if (!objects.empty())
+				objects.pop_back();
+		}
+		else if (c == '-' || std::isdigit((unsigned char)c))
+		{
+			char* end = nullptr;
+			double value = std::strtod(json.c_str() + i, &end);
+			i = (size_t)(end - json.c_str()) - 1;
+
+			std::string name = key;
+			for (auto it = objects.rbegin(); it != objects.rend(); ++it)
+				name = *it + "." + name;
+
+			values[name] = value;
+			key.clear();
+		}
+	}
+
+	return true;
+}
+
+bool CompareToBaseline(const std::filesystem::path& baseline, const BenchResult& result, float threshold)
+{
+	std::unordered_map<std::string, double> values = { };
+	if (!ReadReport(baseline, values))
+		return false;
+
+	std::vector<std::pair<std::string, double>> current =
+	{
+		{ "cpu_frame_ms.p50", result.CPUFrameMs.P50 },
+		{ "cpu_frame_ms.p95", result.CPUFrameMs.P95 },
+		{ "cpu_frame_ms.p99", result.CPUFrameMs.P99 },
+		{ "memory.tracked_bytes", (double)result.TrackedBytes },
+	};
+
+	if (result.GPUTimingSupported)
+	{
+		current.push_back({ "gpu_frame_ms.p50", result.GPUFrameMs.P50 });
+		current.push_back({ "gpu_frame_ms.p95", result.GPUFrameMs.P95 });
+		current.push_back({ "gpu_frame_ms.p99", result.GPUFrameMs.P99 });
+	}
+
+	bool passed = true;
+	for (auto& [name, value] : current)
+	{
+		auto it = values.find(name);
+		if (it == values.end())
+		{
+			VKAPP_LOG_WARN("{0}: not in the baseline", name);
+			continue;
+		}
+
+		double base = it->second;
+		double change = base > 0.0 ? (value - base) / base : 0.0;
+
+		if (change > threshold)
+		{
+			VKAPP_LOG_ERROR("{0}: {1:.4f} vs {2:.4f} baseline ({3:+.1f}%), REGRESSION", name, value, base, change * 100.0);
+			passed = false;
+		}
+		else
+			VKAPP_LOG_INFO("{0}: {1:.4f} vs {2:.4f} baseline ({3:+.1f}%)", name, value, base, change * 100.0);
+	}
+
+	return passed;
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <filesystem>
+
+#include "BenchConfig.hpp"
+
+struct FrameTimeStats
+{
+public:
+	float Mean = 0.0f;
+	float Min = 0.0f;
+	float Max = 0.0f;
+	float P50 = 0.0f;
+	float P95 = 0.0f;
+	float P99 = 0.0f;
+
+	static FrameTimeStats Calculate(std::vector<float> samples); // Nearest rank percentiles
+};
+
+struct BenchResult
+{
+public:
+	FrameTimeStats CPUFrameMs = {};
+	FrameTimeStats GPUFrameMs = {};
+	bool GPUTimingSupported = false;
+
+	uint32_t DrawsPerFrame = 0;
+	uint32_t PipelineBindsPerFrame = 0;
+	uint32_t DescriptorBindsPerFrame = 0;
+	uint64_t TrianglesPerFrame = 0;
+
+	uint64_t TrackedBytes = 0;	// Allocated through the BufferManager, at the end of the run
+	uint64_t PeakUsageBytes = 0;	// Highest driver reported usage during the run
+};
+
+// Writes the result (and the config it ran with) as JSON.
+bool WriteReport(const std::filesystem::path& path, const BenchConfig& config, const BenchResult& result);
+
+// Flattens a report written by WriteReport() into "object.key" -> value, e.g. "cpu_frame_ms.p95".
+bool ReadReport(const std::filesystem::path& path, std::unordered_map<std::string, double>& values);
+
+// Logs every compared metric, returns false when one of them got slower (or bigger) by more than the threshold.
+bool CompareToBaseline(const std::filesystem::path& baseline, const BenchResult& result, float threshold);
\ No newline at end of file
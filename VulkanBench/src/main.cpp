@@ -0,0 +1,54 @@
+#include <VulkanCore/Core/Application.hpp>
+#include <VulkanCore/Core/Logging.hpp>
+
+#include "BenchConfig.hpp"
+#include "BenchLayer.hpp"
+
+// Note: No Entrypoint.hpp, the bench has its own main to return the result as exit code.
+class BenchApplication : public VkApp::Application
+{
+public:
+	BenchApplication(const VkApp::AppInfo& appInfo, const BenchConfig& config)
+		: VkApp::Application(appInfo)
+	{
+		m_Layer = new BenchLayer(config);
+		AddLayer(m_Layer);
+	}
+
+	inline int GetExitCode() const { return m_Layer->GetExitCode(); }
+
+private:
+	BenchLayer* m_Layer = nullptr;
+};
+
+// ----------------------------------------------------------------
+// Usage: VulkanBench [--config scene.cfg] [--key value]...
+// See BenchConfig for the keys. Exits with 0 when passed, 1 on a
+// regression against --baseline and 2 when the run failed.
+// ----------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+	BenchConfig config = {};
+	if (!config.Parse(argc, argv))
+		return 2;
+
+	VkApp::AppInfo appInfo;
+	appInfo.ArgCount = argc;
+	appInfo.Args = argv;
+
+	appInfo.WindowProperties.Name = "VulkanBench";
+	appInfo.WindowProperties.Width = config.Width;
+	appInfo.WindowProperties.Height = config.Height;
+	appInfo.WindowProperties.VSync = false;
+	appInfo.WindowProperties.Headless = config.Headless;
+
+	appInfo.RendererSettings.FramesInFlight = config.FramesInFlight;
+
+	BenchApplication* app = new BenchApplication(appInfo, config);
+	app->Run();
+
+	int exitCode = app->GetExitCode();
+	delete app;
+
+	return exitCode;
+}
\ No newline at end of file
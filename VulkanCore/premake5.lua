@@ -69,6 +69,12 @@ project "VulkanCore"
 			"VKAPP_PLATFORM_WINDOWS"
 		}
 
+		-- Core compute shaders, loaded from the shared assets directory every app runs in
+		prebuildcommands
+		{
+			"\"%{VULKAN_SDK}/Bin/glslc.exe\" \"%{wks.location}/VulkanSandbox/assets/shaders/mipgen.comp\" -o \"%{wks.location}/VulkanSandbox/assets/shaders/mipgen.spv\""
+		}
+
 	filter "configurations:Debug"
 		defines "VKAPP_DEBUG"
 		runtime "Debug"
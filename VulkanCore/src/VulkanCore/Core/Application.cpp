@@ -4,8 +4,11 @@
 #include <GLFW/glfw3.h>
 
 #include "VulkanCore/Core/Logging.hpp"
+#include "VulkanCore/Core/Profiler.hpp"
+#include "VulkanCore/Core/JobSystem.hpp"
 
 #include "VulkanCore/Renderer/Renderer.hpp"
+#include "VulkanCore/Renderer/AssetManager.hpp"
 
 namespace VkApp
 {
@@ -26,7 +29,11 @@ namespace VkApp
 			delete layer;
 		}
 
+		AssetManager::Destroy();
 		Renderer::Destroy();
+		JobSystem::Destroy();
+
+		Log::Shutdown();
 	}
 
 	void Application::OnEvent(Event& e)
@@ -46,36 +53,68 @@ namespace VkApp
 
 	void Application::Run()
 	{
+		m_LastFrameTime = std::chrono::steady_clock::now();
+
 		while (m_Running)
 		{
-			//Delta Time
-			float currentTime = (float)glfwGetTime();
-			static float lastTime = 0.0f;
+			VKAPP_PROFILE_SCOPE("Frame");
 
-			float deltaTime = currentTime - lastTime;
-			lastTime = currentTime;
+			//Delta Time
+			// Note: Not glfwGetTime(), GLFW isn't initialized when headless. Time points instead of
+			// seconds since the start, so the delta doesn't lose precision as the session goes on.
+			auto currentTime = std::chrono::steady_clock::now();
+			double deltaTime = std::chrono::duration<double>(currentTime - m_LastFrameTime).count();
+			m_LastFrameTime = currentTime;
 
 			//Update & Render
-			m_Window->OnUpdate();
-			//ProcessEvents();
+			{
+				VKAPP_PROFILE_SCOPE("Window::OnUpdate");
+				m_Window->OnUpdate();
+			}
+			ProcessEvents();
+
+			// Note: Waits for the GPU to finish with this frame slot, so the layers can safely write per frame buffers.
+			bool frameBegun = Renderer::BeginFrame();
 
+			AssetManager::Update();
+
+			FixedUpdate(deltaTime);
+			UpdateLayers((float)deltaTime);
+
+			// Note: No image was acquired (out of date swapchain or an error), so there's nothing to render into this frame.
+			if (!frameBegun)
+				continue;
+
+			// Note: Always on the main thread and in stack order, so the order of the render queue doesn't depend on the scheduling above.
 			for (Layer* layer : m_LayerStack)
 			{
-				layer->OnUpdate(deltaTime);
-				layer->OnRender();
+				VKAPP_PROFILE_SCOPE(layer->GetName());
+
+				// Note: Everything the layer queues is timed on the GPU under its name.
+				Renderer::SetQueueZone(layer->GetName());
+				{
+					VKAPP_PROFILE_SCOPE("Layer::OnRender");
+					layer->OnRender();
+				}
 			}
+			Renderer::SetQueueZone({});
 
 			if (m_ImGuiLayer)
 			{
+				VKAPP_PROFILE_SCOPE("ImGui");
+
 				m_ImGuiLayer->Begin();
 				for (Layer* layer : m_LayerStack)
 					layer->OnImGuiRender();
 				m_ImGuiLayer->End();
 			}
 
-			Renderer::Display();
+			Renderer::EndFrame();
 
-			m_Window->OnRender();
+			{
+				VKAPP_PROFILE_SCOPE("Window::OnRender");
+				m_Window->OnRender();
+			}
 		}
 	}
 
@@ -92,17 +131,216 @@ namespace VkApp
 	void Application::Init(const AppInfo& appInfo)
 	{
 		s_Instance = this;
+		m_StartTime = std::chrono::steady_clock::now();
 
 		Log::Init();
+		VKAPP_PROFILE_THREAD("Main");
+
+		JobSystem::Init();
 
 		m_Window = Window::Create(appInfo.WindowProperties);
-		m_Window->SetEventCallBack(VKAPP_BIND_EVENT_FN(Application::OnEvent));
+		m_Window->SetEventQueue(&m_EventQueue);
 
-		Renderer::Init();
+		Renderer::Init(appInfo.RendererSettings);
+		AssetManager::Init();
 
 		//Add ImGui
-		m_ImGuiLayer = new BaseImGuiLayer();
-		AddOverlay(m_ImGuiLayer);
+		// Note: ImGui needs a real window for its input and platform backend.
+		if (!m_Window->IsHeadless())
+		{
+			m_ImGuiLayer = new BaseImGuiLayer();
+			AddOverlay(m_ImGuiLayer);
+		}
+	}
+
+	template<typename TEvent>
+	void Application::HandleEvent(TEvent& e)
+	{
+		// Note: The type is known at compile time here, so the application's own handlers are picked
+		// without EventHandler's runtime type checks. Layers are virtual and still get the base Event.
+		if constexpr (std::is_same<TEvent, WindowCloseEvent>::value)
+			e.Handled = OnWindowClose(e);
+		else if constexpr (std::is_same<TEvent, WindowResizeEvent>::value)
+			e.Handled = OnWindowResize(e);
+
+		for (auto it = m_LayerStack.rbegin(); it != m_LayerStack.rend(); ++it)
+		{
+			if (e.Handled)
+				break;
+			(*it)->OnEvent(e);
+		}
+	}
+
+	void Application::ProcessEvents()
+	{
+		VKAPP_PROFILE_SCOPE("Application::ProcessEvents");
+
+		// Note: std::visit instantiates the visitor per event type, so every queued event reaches HandleEvent() as its own type.
+		m_EventQueue.Dispatch([this](auto& e) { HandleEvent(e); });
+
+		if (m_EventQueue.GetDroppedCount() != m_DroppedEvents)
+		{
+			VKAPP_LOG_WARN("The event queue was full, {0} event(s) were dropped.", m_EventQueue.GetDroppedCount() - m_DroppedEvents);
+			m_DroppedEvents = m_EventQueue.GetDroppedCount();
+		}
+	}
+
+	void Application::FixedUpdate(double deltaTime)
+	{
+		double step = m_AppInfo.FixedTimeStep;
+		if (step <= 0.0)
+			return;
+
+		VKAPP_PROFILE_SCOPE("Application::FixedUpdate");
+
+		// Note: Clamped so a long frame (a breakpoint, a window drag) can't snowball into ever more steps.
+		m_FixedAccumulator += std::min(deltaTime, step * m_AppInfo.MaxFixedSteps);
+
+		while (m_FixedAccumulator >= step)
+		{
+			for (Layer* layer : m_LayerStack)
+			{
+				VKAPP_PROFILE_SCOPE("Layer::OnFixedUpdate");
+				layer->OnFixedUpdate((float)step);
+			}
+
+			m_FixedAccumulator -= step;
+			m_FixedStepCount++;
+		}
+
+		m_InterpolationAlpha = m_FixedAccumulator / step;
+	}
+
+	static void UpdateLayer(Layer* layer, float deltaTime)
+	{
+		VKAPP_PROFILE_SCOPE(layer->GetName());
+		VKAPP_PROFILE_SCOPE("Layer::OnUpdate");
+
+		layer->OnUpdate(deltaTime);
+	}
+
+	void Application::UpdateLayers(float deltaTime)
+	{
+		VKAPP_PROFILE_SCOPE("Application::UpdateLayers");
+
+		// Note: Layer generations only go up, so their sum changes whenever the dependencies of the same stack do.
+		uint64_t dependencyGeneration = 0;
+		for (Layer* layer : m_LayerStack)
+			dependencyGeneration += layer->GetGeneration();
+
+		if (m_LayerStackGeneration != m_LayerStack.GetGeneration() || m_LayerDependencyGeneration != dependencyGeneration || m_LayerTasks.size() != m_LayerStack.GetSize())
+		{
+			BuildLayerGraph();
+
+			m_LayerStackGeneration = m_LayerStack.GetGeneration();
+			m_LayerDependencyGeneration = dependencyGeneration;
+		}
+
+		uint32_t count = (uint32_t)m_LayerTasks.size();
+		if (m_LayerOrder.size() < count)
+		{
+			for (Layer* layer : m_LayerStack)
+				UpdateLayer(layer, deltaTime);
+
+			return;
+		}
+
+		for (uint32_t i = 0; i < count; i++)
+			m_LayerTasks[i].Remaining.Increment(m_LayerTasks[i].DependencyCount);
+
+		// Note: Parallel layers are started by whoever finishes their last dependency, so no job ever waits on another.
+		JobCounter frame = {};
+		for (uint32_t i : m_LayerOrder)
+		{
+			if (m_LayerTasks[i].Instance->IsParallel() && m_LayerTasks[i].DependencyCount == 0)
+				LaunchLayer(i, deltaTime, frame);
+		}
+
+		// Note: Waiting runs other jobs, the parallel layers included.
+		for (uint32_t i : m_LayerOrder)
+		{
+			if (m_LayerTasks[i].Instance->IsParallel())
+				continue;
+
+			JobSystem::Wait(m_LayerTasks[i].Remaining);
+			UpdateLayer(m_LayerTasks[i].Instance, deltaTime);
+			FinishLayer(i, deltaTime, frame);
+		}
+
+		JobSystem::Wait(frame);
+	}
+
+	void Application::BuildLayerGraph()
+	{
+		VKAPP_PROFILE_SCOPE("Application::BuildLayerGraph");
+
+		std::vector<Layer*> layers(m_LayerStack.begin(), m_LayerStack.end());
+		uint32_t count = (uint32_t)layers.size();
+
+		m_LayerTasks = std::vector<LayerTask>(count);
+		for (uint32_t i = 0; i < count; i++)
+			m_LayerTasks[i].Instance = layers[i];
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			for (Layer* dependency : layers[i]->GetDependencies())
+			{
+				auto it = std::find(layers.begin(), layers.end(), dependency);
+				if (it == layers.end() || *it == layers[i])
+					continue;
+
+				m_LayerTasks[it - layers.begin()].Dependents.push_back(i);
+				m_LayerTasks[i].DependencyCount++;
+			}
+		}
+
+		// Topological order, always taking the lowest ready index so serial layers keep the stack order wherever the dependencies allow it.
+		m_LayerOrder.clear();
+
+		std::vector<uint32_t> remaining(count, 0);
+		std::vector<bool> ordered(count, false);
+		for (uint32_t i = 0; i < count; i++)
+			remaining[i] = m_LayerTasks[i].DependencyCount;
+
+		while (m_LayerOrder.size() < count)
+		{
+			uint32_t next = UINT32_MAX;
+			for (uint32_t i = 0; i < count && next == UINT32_MAX; i++)
+			{
+				if (!ordered[i] && remaining[i] == 0)
+					next = i;
+			}
+
+			if (next == UINT32_MAX)
+				break;
+
+			ordered[next] = true;
+			m_LayerOrder.push_back(next);
+
+			for (uint32_t dependent : m_LayerTasks[next].Dependents)
+				remaining[dependent]--;
+		}
+
+		if (m_LayerOrder.size() < count)
+			VKAPP_LOG_WARN("The layer dependencies contain a cycle, the layers are updated one after another in stack order.");
+	}
+
+	void Application::LaunchLayer(uint32_t index, float deltaTime, JobCounter& frame)
+	{
+		JobSystem::Run([this, index, deltaTime, &frame]()
+		{
+			UpdateLayer(m_LayerTasks[index].Instance, deltaTime);
+			FinishLayer(index, deltaTime, frame);
+		}, &frame);
+	}
+
+	void Application::FinishLayer(uint32_t index, float deltaTime, JobCounter& frame)
+	{
+		for (uint32_t dependent : m_LayerTasks[index].Dependents)
+		{
+			if (m_LayerTasks[dependent].Remaining.Decrement() && m_LayerTasks[dependent].Instance->IsParallel())
+				LaunchLayer(dependent, deltaTime, frame);
+		}
 	}
 
 	bool Application::OnWindowClose(WindowCloseEvent& e)
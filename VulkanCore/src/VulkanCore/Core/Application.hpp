@@ -1,14 +1,19 @@
 #pragma once
 
 #include "VulkanCore/Core/Events.hpp"
+#include "VulkanCore/Core/EventQueue.hpp"
 #include "VulkanCore/Core/Layer.hpp"
+#include "VulkanCore/Core/JobSystem.hpp"
 
 #include "VulkanCore/Core/Window.hpp"
 
+#include "VulkanCore/Renderer/RendererSettings.hpp"
+
 #include "VulkanCore/ImGui/BaseImGuiLayer.hpp"
 
 #include <vector>
 #include <memory>
+#include <chrono>
 #include <filesystem>
 
 namespace VkApp
@@ -18,6 +23,13 @@ namespace VkApp
 	{
 	public:
 		WindowProperties WindowProperties;
+		RendererSettings RendererSettings;
+
+		// Seconds between Layer::OnFixedUpdate() calls, 0 disables them.
+		double FixedTimeStep = 0.0;
+		// At most this many fixed steps per frame, a frame that took longer than that drops the rest.
+		uint32_t MaxFixedSteps = 5;
+
 		int ArgCount = 0;
 		char** Args = nullptr;
 
@@ -43,13 +55,37 @@ namespace VkApp
 		template<typename TEvent>
 		inline void DispatchEvent(TEvent e = TEvent()) { static_assert(std::is_base_of<Event, TEvent>::value); OnEvent(e); }
 
+		// Dispatched at the start of the next frame, together with the window's events.
+		template<typename TEvent>
+		inline void QueueEvent(const TEvent& e) { m_EventQueue.Push(e); }
+
 		inline static Application& Get() { return *s_Instance; }
 		inline static std::filesystem::path GetWorkingDirectory() { return std::filesystem::path(s_Instance->m_AppInfo.Args[0]).parent_path(); }
 
 		inline bool IsMinimized() const { return m_Minimized; }
 
+		// Seconds since the application started, double so it keeps its precision over long sessions.
+		inline double GetTime() const { return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_StartTime).count(); }
+
+		inline double GetFixedTimeStep() const { return m_AppInfo.FixedTimeStep; }
+		inline void SetFixedTimeStep(double step) { m_AppInfo.FixedTimeStep = step; m_FixedAccumulator = 0.0; }
+		inline uint64_t GetFixedStepCount() const { return m_FixedStepCount; }
+
+		// How far the current frame is between the last fixed step and the next one (0 to 1),
+		// for rendering interpolated between the previous and the current simulation state.
+		inline double GetInterpolationAlpha() const { return m_InterpolationAlpha; }
+
 	private:
 		void Init(const AppInfo& appInfo);
+		void ProcessEvents();
+		template<typename TEvent>
+		void HandleEvent(TEvent& e); // OnEvent() for a known event type
+		void FixedUpdate(double deltaTime);
+
+		void UpdateLayers(float deltaTime);
+		void BuildLayerGraph();
+		void LaunchLayer(uint32_t index, float deltaTime, JobCounter& frame);
+		void FinishLayer(uint32_t index, float deltaTime, JobCounter& frame);
 
 		bool OnWindowClose(WindowCloseEvent& e);
 		bool OnWindowResize(WindowResizeEvent& e);
@@ -58,11 +94,34 @@ namespace VkApp
 		AppInfo m_AppInfo;
 
 		std::unique_ptr<Window> m_Window = nullptr;
+		EventQueue m_EventQueue = {};
+		uint64_t m_DroppedEvents = 0; // Already warned about
 		bool m_Running = true;
 		bool m_Minimized = false;
 
+		std::chrono::steady_clock::time_point m_StartTime = { };
+		std::chrono::steady_clock::time_point m_LastFrameTime = { };
+
+		double m_FixedAccumulator = 0.0;
+		double m_InterpolationAlpha = 0.0;
+		uint64_t m_FixedStepCount = 0;
+
 		LayerStack m_LayerStack;
 
+		// The layer update graph, only rebuilt when the LayerStack or the dependencies change
+		struct LayerTask
+		{
+		public:
+			Layer* Instance = nullptr;
+			uint32_t DependencyCount = 0;
+			JobCounter Remaining = {}; // Dependencies that didn't finish their OnUpdate() yet this frame
+			std::vector<uint32_t> Dependents = { };
+		};
+		std::vector<LayerTask> m_LayerTasks = { };
+		std::vector<uint32_t> m_LayerOrder = { };	// Shorter than m_LayerTasks when there's a cycle
+		uint32_t m_LayerStackGeneration = 0;
+		uint64_t m_LayerDependencyGeneration = 0;
+
 	private:
 		static Application* s_Instance;
 
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <variant>
+#include <cstdint>
+#include <type_traits>
+
+#include "VulkanCore/Core/Events.hpp"
+
+namespace VkApp
+{
+
+	#define VKAPP_EVENT_QUEUE_CAPACITY 256u // Events per frame, after coalescing
+
+	// Every event the window can send, stored by value so queueing never allocates.
+	// Note: WindowCloseEvent goes first, it's the only one that can be default constructed.
+	using EventVariant = std::variant<
+		WindowCloseEvent, WindowResizeEvent,
+		KeyPressedEvent, KeyReleasedEvent, KeyTypedEvent,
+		MouseMovedEvent, MouseScrolledEvent, MouseButtonPressedEvent, MouseButtonReleasedEvent
+	>;
+
+	// Collects the window's events during Window::OnUpdate(), the application dispatches them once per frame.
+	// Runs of mouse moves and resizes are coalesced into the latest one, anything in between (a click, a key)
+	// ends the run so the order of events is kept.
+	class EventQueue
+	{
+	public:
+		template<typename TEvent>
+		void Push(const TEvent& e)
+		{
+			static_assert(std::is_constructible<EventVariant, TEvent>::value, "Not a queueable event type.");
+
+			if constexpr (std::is_same<TEvent, MouseMovedEvent>::value || std::is_same<TEvent, WindowResizeEvent>::value)
+			{
+				if (m_Count > 0 && std::holds_alternative<TEvent>(m_Events[Index(m_Count - 1)]))
+				{
+					m_Events[Index(m_Count - 1)] = e;
+					m_Coalesced++;
+					return;
+				}
+			}
+
+			if (m_Count == VKAPP_EVENT_QUEUE_CAPACITY)
+			{
+				m_Dropped++;
+				return;
+			}
+
+			m_Events[Index(m_Count)] = e;
+			m_Count++;
+		}
+
+		// Calls func with every queued event as its own type, oldest first, and empties the queue.
+		// Events pushed by func are dispatched in the same call.
+		template<typename F>
+		void Dispatch(F&& func)
+		{
+			while (m_Count > 0)
+			{
+				EventVariant e = std::move(m_Events[m_Head]);
+				m_Head = Index(1);
+				m_Count--;
+
+				std::visit(func, e);
+			}
+		}
+
+		inline uint32_t GetCount() const { return m_Count; }
+		inline bool IsEmpty() const { return m_Count == 0; }
+
+		// Totals since the queue was created.
+		inline uint64_t GetCoalescedCount() const { return m_Coalesced; }
+		inline uint64_t GetDroppedCount() const { return m_Dropped; }
+
+	private:
+		inline uint32_t Index(uint32_t offset) const { return (m_Head + offset) % VKAPP_EVENT_QUEUE_CAPACITY; }
+
+	private:
+		std::array<EventVariant, VKAPP_EVENT_QUEUE_CAPACITY> m_Events = { };
+		uint32_t m_Head = 0;
+		uint32_t m_Count = 0;
+
+		uint64_t m_Coalesced = 0;
+		uint64_t m_Dropped = 0;
+	};
+
+}
\ No newline at end of file
@@ -2,10 +2,12 @@
 
 #include <string>
 #include <sstream>
+#include <utility>
 #include <functional>
 
 #define BIT(x) (1 << x)
-#define VKAPP_BIND_EVENT_FN(fn) std::bind(&fn, this, std::placeholders::_1)
+// Note: A lambda instead of std::bind, so handlers can be inlined into the EventHandler.
+#define VKAPP_BIND_EVENT_FN(fn) [this](auto&&... args) -> decltype(auto) { return this->fn(std::forward<decltype(args)>(args)...); }
 
 namespace VkApp
 {
@@ -30,7 +32,6 @@ namespace VkApp
 
 	#define EVENT_CLASS_TYPE(type)\
 		static EventType GetStaticType() { return EventType::type; }\
-		virtual EventType GetEventType() const override { return GetStaticType(); }\
 		virtual const char* GetName() const override { return #type; }
 
 	#define EVENT_CLASS_CATEGORY(category)\
@@ -39,10 +40,12 @@ namespace VkApp
 	class Event
 	{
 	public:
-		Event() = default;
+		Event(EventType type)
+			: m_Type(type) {}
 		virtual ~Event() = default;
 
-		virtual EventType GetEventType() const = 0;
+		// Note: Not virtual, every handler checks it for every event.
+		inline EventType GetEventType() const { return m_Type; }
 		virtual const char* GetName() const = 0;
 		virtual int GetCategoryFlags() const = 0;
 		virtual std::string ToString() const { return GetName(); }
@@ -53,6 +56,9 @@ namespace VkApp
 		}
 	public:
 		bool Handled = false;
+
+	private:
+		EventType m_Type = EventType::None;
 	};
 
 
@@ -95,7 +101,7 @@ namespace VkApp
 	{
 	public:
 		WindowResizeEvent(unsigned int width, unsigned int height)
-			: m_Width(width), m_Height(height) {}
+			: Event(GetStaticType()), m_Width(width), m_Height(height) {}
 
 		inline unsigned int GetWidth() const { return m_Width; }
 		inline unsigned int GetHeight() const { return m_Height; }
@@ -116,7 +122,8 @@ namespace VkApp
 	class WindowCloseEvent : public Event
 	{
 	public:
-		WindowCloseEvent() = default;
+		WindowCloseEvent()
+			: Event(GetStaticType()) {}
 
 		EVENT_CLASS_TYPE(WindowClose)
 			EVENT_CLASS_CATEGORY(EventCategoryApplication)
@@ -134,8 +141,8 @@ namespace VkApp
 
 		EVENT_CLASS_CATEGORY(EventCategoryKeyboard | EventCategoryInput)
 	protected:
-		KeyEvent(int keycode)
-			: m_KeyCode(keycode) {}
+		KeyEvent(int keycode, EventType type)
+			: Event(type), m_KeyCode(keycode) {}
 
 		int m_KeyCode;
 	};
@@ -144,7 +151,7 @@ namespace VkApp
 	{
 	public:
 		KeyPressedEvent(int keycode, int repeatCount)
-			: KeyEvent(keycode), m_RepeatCount(repeatCount) {}
+			: KeyEvent(keycode, GetStaticType()), m_RepeatCount(repeatCount) {}
 
 		inline int GetRepeatCount() const { return m_RepeatCount; }
 
@@ -164,7 +171,7 @@ namespace VkApp
 	{
 	public:
 		KeyReleasedEvent(int keycode)
-			: KeyEvent(keycode) {}
+			: KeyEvent(keycode, GetStaticType()) {}
 
 		std::string ToString() const override
 		{
@@ -180,7 +187,7 @@ namespace VkApp
 	{
 	public:
 		KeyTypedEvent(int keycode)
-			: KeyEvent(keycode) {}
+			: KeyEvent(keycode, GetStaticType()) {}
 
 		std::string ToString() const override
 		{
@@ -201,7 +208,7 @@ namespace VkApp
 	{
 	public:
 		MouseMovedEvent(float x, float y)
-			: m_MouseX(x), m_MouseY(y) {}
+			: Event(GetStaticType()), m_MouseX(x), m_MouseY(y) {}
 
 		inline float GetX() const { return m_MouseX; }
 		inline float GetY() const { return m_MouseY; }
@@ -223,7 +230,7 @@ namespace VkApp
 	{
 	public:
 		MouseScrolledEvent(float xOffset, float yOffset)
-			: m_XOffset(xOffset), m_YOffset(yOffset) {}
+			: Event(GetStaticType()), m_XOffset(xOffset), m_YOffset(yOffset) {}
 
 		inline float GetXOffset() const { return m_XOffset; }
 		inline float GetYOffset() const { return m_YOffset; }
@@ -248,8 +255,8 @@ namespace VkApp
 
 		EVENT_CLASS_CATEGORY(EventCategoryMouse | EventCategoryInput)
 	protected:
-		MouseButtonEvent(int button)
-			: m_Button(button) {}
+		MouseButtonEvent(int button, EventType type)
+			: Event(type), m_Button(button) {}
 
 		int m_Button;
 	};
@@ -258,7 +265,7 @@ namespace VkApp
 	{
 	public:
 		MouseButtonPressedEvent(int button)
-			: MouseButtonEvent(button) {}
+			: MouseButtonEvent(button, GetStaticType()) {}
 
 		std::string ToString() const override
 		{
@@ -274,7 +281,7 @@ namespace VkApp
 	{
 	public:
 		MouseButtonReleasedEvent(int button)
-			: MouseButtonEvent(button) {}
+			: MouseButtonEvent(button, GetStaticType()) {}
 
 		std::string ToString() const override
 		{
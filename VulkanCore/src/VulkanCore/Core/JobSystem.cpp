@@ -0,0 +1,482 @@
+#include "vcpch.h"
+#include "JobSystem.hpp"
+
+#include "VulkanCore/Core/Profiler.hpp"
+
+namespace VkApp
+{
+
+	#define VKAPP_JOB_QUEUE_CAPACITY 4096	// Per worker, has to be a power of two. When it's full new jobs run right away.
+	#define VKAPP_JOB_SPIN_COUNT 64			// Rounds an idle worker keeps looking for jobs before going to sleep
+
+	struct Job
+	{
+	public:
+		JobFunction Function = nullptr;
+		JobCounter* Counter = nullptr;
+	};
+
+	// Chase-Lev deque of a fixed size, see "Correct and Efficient Work-Stealing for Weak Memory Models".
+	// Only the owner pushes and pops (at the bottom), any thread can steal (from the top).
+	class WorkStealingDeque
+	{
+	public:
+		bool Push(Job* job)
+		{
+			int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+			int64_t top = m_Top.load(std::memory_order_acquire);
+			if (bottom - top >= VKAPP_JOB_QUEUE_CAPACITY)
+				return false;
+
+			m_Jobs[bottom & (VKAPP_JOB_QUEUE_CAPACITY - 1)].store(job, std::memory_order_relaxed);
+			m_Bottom.store(bottom + 1, std::memory_order_release);
+			return true;
+		}
+
+		Job* Pop()
+		{
+			int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+			m_Bottom.store(bottom, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64_t top = m_Top.load(std::memory_order_relaxed);
+
+			if (top > bottom)
+			{
+				m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			Job* job = m_Jobs[bottom & (VKAPP_JOB_QUEUE_CAPACITY - 1)].load(std::memory_order_relaxed);
+
+			// Note: The last job, a thief might be taking it at the same time.
+			if (top == bottom)
+			{
+				if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+					job = nullptr;
+
+				m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+			}
+
+			return job;
+		}
+
+		Job* Steal()
+		{
+			int64_t top = m_Top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+
+			if (top >= bottom)
+				return nullptr;
+
+			Job* job = m_Jobs[top & (VKAPP_JOB_QUEUE_CAPACITY - 1)].load(std::memory_order_relaxed);
+			if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				return nullptr;
+
+			return job;
+		}
+
+	private:
+		// Note: Own cache lines, thieves hammer the top while the owner works at the bottom.
+		alignas(64) std::atomic<int64_t> m_Top = 0;
+		alignas(64) std::atomic<int64_t> m_Bottom = 0;
+		alignas(64) std::atomic<Job*> m_Jobs[VKAPP_JOB_QUEUE_CAPACITY];
+	};
+
+	struct JobWorker
+	{
+	public:
+		WorkStealingDeque Jobs = {};
+
+		// Only written by the worker itself
+		alignas(64) std::atomic<uint64_t> JobsExecuted = 0;
+		std::atomic<uint64_t> JobsStolen = 0;
+		std::atomic<int64_t> BusyTime = 0; // Nanoseconds
+	};
+
+	// ===================================
+	// ------------- Helper --------------
+	// ===================================
+	JobSystem* JobSystem::s_Instance = nullptr;
+
+	static thread_local uint32_t t_WorkerIndex = UINT32_MAX;
+	static thread_local uint32_t t_JobDepth = 0; // Jobs run from Wait() inside a job are nested
+	static thread_local uint32_t t_Random = 0;
+
+	static int64_t GetTime()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// Xorshift, only used to spread out which worker gets stolen from.
+	static uint32_t NextRandom()
+	{
+		if (t_Random == 0)
+			t_Random = (uint32_t)std::hash<std::thread::id>()(std::this_thread::get_id()) | 1u;
+
+		t_Random ^= t_Random << 13;
+		t_Random ^= t_Random >> 17;
+		t_Random ^= t_Random << 5;
+		return t_Random;
+	}
+
+	// ===================================
+	// ------------- Counter -------------
+	// ===================================
+	void JobCounter::Increment(uint32_t count)
+	{
+		if (count > 0 && m_Count.fetch_add(count, std::memory_order_relaxed) == 0 && m_Parent)
+			m_Parent->Increment();
+	}
+
+	bool JobCounter::Decrement()
+	{
+		// Note: Once the count hits zero a waiter can destroy the counter, so the parent is read before.
+		JobCounter* parent = m_Parent;
+		if (m_Count.fetch_sub(1, std::memory_order_acq_rel) != 1)
+			return false;
+
+		JobSystem::NotifyWaiters();
+
+		if (parent)
+			parent->Decrement();
+
+		return true;
+	}
+
+	// ===================================
+	// ------------ Public ---------------
+	// ===================================
+	void JobSystem::Init(uint32_t workerCount)
+	{
+		s_Instance = new JobSystem();
+
+		if (workerCount == 0)
+			workerCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+		s_Instance->StartWorkers(workerCount);
+	}
+
+	void JobSystem::Destroy()
+	{
+		s_Instance->StopWorkers();
+
+		delete s_Instance;
+		s_Instance = nullptr;
+	}
+
+	void JobSystem::Run(JobFunction job, JobCounter* counter)
+	{
+		if (counter)
+			counter->Increment();
+
+		// Note: Without a job system everything runs right away, on the calling thread.
+		if (!s_Instance)
+		{
+			job();
+
+			if (counter)
+				counter->Decrement();
+			return;
+		}
+
+		s_Instance->Push(new Job({ std::move(job), counter }));
+	}
+
+	void JobSystem::Wait(JobCounter& counter)
+	{
+		if (!s_Instance)
+			return;
+
+		uint32_t index = t_WorkerIndex;
+		uint32_t idleRounds = 0;
+		while (!counter.IsDone())
+		{
+			bool stolen = false;
+			if (Job* job = s_Instance->FindJob(index, stolen))
+			{
+				s_Instance->Execute(job, index, stolen);
+				idleRounds = 0;
+				continue;
+			}
+
+			if (++idleRounds < VKAPP_JOB_SPIN_COUNT)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			s_Instance->Sleep(&counter);
+			idleRounds = 0;
+		}
+	}
+
+	void JobSystem::ParallelFor(uint32_t count, uint32_t batchSize, ParallelForFunction func)
+	{
+		if (count == 0)
+			return;
+
+		batchSize = std::max(batchSize, 1u);
+		if (count <= batchSize || GetWorkerCount() <= 1)
+		{
+			func(0, count);
+			return;
+		}
+
+		JobCounter counter = {};
+		SplitRange(0, count, batchSize, func, counter);
+		Wait(counter);
+	}
+
+	uint32_t JobSystem::GetCurrentWorker()
+	{
+		return t_WorkerIndex;
+	}
+
+	std::vector<JobWorkerStats> JobSystem::GetStats()
+	{
+		std::vector<JobWorkerStats> stats = { };
+		if (!s_Instance)
+			return stats;
+
+		double elapsed = (double)(GetTime() - s_Instance->m_StatsStart.load(std::memory_order_relaxed));
+
+		for (JobWorker* worker : s_Instance->m_Workers)
+		{
+			double busy = (double)worker->BusyTime.load(std::memory_order_relaxed);
+
+			JobWorkerStats& workerStats = stats.emplace_back();
+			workerStats.JobsExecuted = worker->JobsExecuted.load(std::memory_order_relaxed);
+			workerStats.JobsStolen = worker->JobsStolen.load(std::memory_order_relaxed);
+			workerStats.BusyMs = busy / 1000000.0;
+			workerStats.Utilization = elapsed > 0.0 ? std::min(busy / elapsed, 1.0) : 0.0;
+		}
+
+		return stats;
+	}
+
+	void JobSystem::ResetStats()
+	{
+		if (!s_Instance)
+			return;
+
+		for (JobWorker* worker : s_Instance->m_Workers)
+		{
+			worker->JobsExecuted.store(0, std::memory_order_relaxed);
+			worker->JobsStolen.store(0, std::memory_order_relaxed);
+			worker->BusyTime.store(0, std::memory_order_relaxed);
+		}
+
+		s_Instance->m_StatsStart.store(GetTime(), std::memory_order_relaxed);
+	}
+
+	// ===================================
+	// ------------ Private --------------
+	// ===================================
+	void JobSystem::StartWorkers(uint32_t workerCount)
+	{
+		for (uint32_t i = 0; i < workerCount; i++)
+			m_Workers.push_back(new JobWorker());
+
+		m_Running = true;
+		m_StatsStart = GetTime();
+
+		t_WorkerIndex = 0;
+
+		for (uint32_t i = 1; i < workerCount; i++)
+			m_Threads.emplace_back([this, i]() { WorkerLoop(i); });
+	}
+
+	void JobSystem::StopWorkers()
+	{
+		{
+			std::scoped_lock<std::mutex> lock(m_SleepMutex);
+			m_Running = false;
+		}
+		m_SleepCondition.notify_all();
+
+		for (auto& thread : m_Threads)
+			thread.join();
+
+		m_Threads.clear();
+		t_WorkerIndex = UINT32_MAX;
+
+		// Note: Every worker is gone now, so popping from their deques here is fine.
+		for (JobWorker* worker : m_Workers)
+		{
+			while (Job* job = worker->Jobs.Pop())
+				delete job;
+
+			delete worker;
+		}
+
+		for (Job* job : m_SharedJobs)
+			delete job;
+
+		m_SharedJobs.clear();
+		m_Workers.clear();
+	}
+
+	void JobSystem::WorkerLoop(uint32_t index)
+	{
+		t_WorkerIndex = index;
+		VKAPP_PROFILE_THREAD("Job Worker " + std::to_string(index));
+
+		uint32_t idleRounds = 0;
+		while (m_Running.load(std::memory_order_acquire))
+		{
+			bool stolen = false;
+			if (Job* job = FindJob(index, stolen))
+			{
+				Execute(job, index, stolen);
+				idleRounds = 0;
+				continue;
+			}
+
+			if (++idleRounds < VKAPP_JOB_SPIN_COUNT)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			Sleep(nullptr);
+			idleRounds = 0;
+		}
+	}
+
+	void JobSystem::Push(Job* job)
+	{
+		uint32_t index = t_WorkerIndex;
+		if (index < m_Workers.size())
+		{
+			if (!m_Workers[index]->Jobs.Push(job))
+			{
+				Execute(job, index, false);
+				return;
+			}
+		}
+		else
+		{
+			std::scoped_lock<std::mutex> lock(m_SharedMutex);
+			m_SharedJobs.push_back(job);
+			m_SharedCount.fetch_add(1, std::memory_order_release);
+		}
+
+		m_Queued.fetch_add(1);
+		if (m_Sleeping.load() > 0)
+		{
+			std::scoped_lock<std::mutex> lock(m_SleepMutex);
+			m_SleepCondition.notify_one();
+		}
+	}
+
+	Job* JobSystem::FindJob(uint32_t index, bool& stolen)
+	{
+		Job* job = nullptr;
+		stolen = false;
+
+		// Own jobs first, newest first, they're the most likely to still be in cache
+		if (index < m_Workers.size())
+			job = m_Workers[index]->Jobs.Pop();
+
+		if (!job && m_SharedCount.load(std::memory_order_acquire) > 0)
+		{
+			std::scoped_lock<std::mutex> lock(m_SharedMutex);
+			if (!m_SharedJobs.empty())
+			{
+				job = m_SharedJobs.front();
+				m_SharedJobs.pop_front();
+				m_SharedCount.fetch_sub(1, std::memory_order_relaxed);
+			}
+		}
+
+		// Steal, starting from a random worker so thieves don't all line up behind the same one
+		if (!job)
+		{
+			uint32_t count = (uint32_t)m_Workers.size();
+			uint32_t start = NextRandom() % count;
+
+			for (uint32_t i = 0; i < count && !job; i++)
+			{
+				uint32_t victim = (start + i) % count;
+				if (victim != index)
+					job = m_Workers[victim]->Jobs.Steal();
+			}
+
+			stolen = (job != nullptr);
+		}
+
+		if (job)
+			m_Queued.fetch_sub(1);
+
+		return job;
+	}
+
+	void JobSystem::Sleep(const JobCounter* counter)
+	{
+		// Note: Push() bumps m_Queued before it checks m_Sleeping, we do the opposite, so one of us always sees the other.
+		// The same goes for m_Waiting and counters reaching zero.
+		std::unique_lock<std::mutex> lock(m_SleepMutex);
+		m_Sleeping.fetch_add(1);
+		if (counter)
+			m_Waiting.fetch_add(1);
+
+		m_SleepCondition.wait(lock, [this, counter]() { return m_Queued.load() > 0 || !m_Running.load() || (counter && counter->m_Count.load() == 0); });
+
+		if (counter)
+			m_Waiting.fetch_sub(1);
+		m_Sleeping.fetch_sub(1);
+	}
+
+	void JobSystem::NotifyWaiters()
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (!s_Instance || s_Instance->m_Waiting.load() == 0)
+			return;
+
+		std::scoped_lock<std::mutex> lock(s_Instance->m_SleepMutex);
+		s_Instance->m_SleepCondition.notify_all();
+	}
+
+	void JobSystem::Execute(Job* job, uint32_t index, bool stolen)
+	{
+		// Note: Only the outermost job counts as busy time, a nested one runs inside its time already.
+		bool outermost = (t_JobDepth++ == 0);
+		int64_t start = GetTime();
+
+		job->Function();
+		t_JobDepth--;
+
+		// Note: The job (and whatever its function captured) goes before the counter does, a waiter might free what it points to.
+		JobCounter* counter = job->Counter;
+		delete job;
+
+		if (counter)
+			counter->Decrement();
+
+		if (index < m_Workers.size())
+		{
+			JobWorker& worker = *m_Workers[index];
+			worker.JobsExecuted.fetch_add(1, std::memory_order_relaxed);
+			if (outermost)
+				worker.BusyTime.fetch_add(GetTime() - start, std::memory_order_relaxed);
+
+			if (stolen)
+				worker.JobsStolen.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	void JobSystem::SplitRange(uint32_t begin, uint32_t end, uint32_t batchSize, const ParallelForFunction& func, JobCounter& counter)
+	{
+		// Note: The second half goes to the deque, the top of it (where thieves take from) ends up holding the largest ranges.
+		while (end - begin > batchSize)
+		{
+			uint32_t middle = begin + (end - begin) / 2;
+			Run([middle, end, batchSize, &func, &counter]() { SplitRange(middle, end, batchSize, func, counter); }, &counter);
+			end = middle;
+		}
+
+		func(begin, end);
+	}
+
+}
\ No newline at end of file
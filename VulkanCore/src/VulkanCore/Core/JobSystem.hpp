@@ -0,0 +1,118 @@
+#pragma once
+
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+namespace VkApp
+{
+
+	typedef std::function<void()> JobFunction;
+	typedef std::function<void(uint32_t, uint32_t)> ParallelForFunction; // Gets a [begin, end) range
+
+	// Counts the unfinished jobs that were started with it. A counter with a parent counts as one
+	// unfinished job of the parent while it's above zero, so waiting on the parent waits for the whole tree.
+	// Jobs can also start children on their own counter, the counter only reaches zero once those are done too.
+	class JobCounter
+	{
+	public:
+		JobCounter(JobCounter* parent = nullptr)
+			: m_Parent(parent) {}
+
+		inline bool IsDone() const { return m_Count.load(std::memory_order_acquire) == 0; }
+		inline uint32_t GetCount() const { return m_Count.load(std::memory_order_relaxed); }
+
+		// Run() does these, calling them directly lets Wait() wait on work that isn't a job.
+		void Increment(uint32_t count = 1);
+		bool Decrement(); // Returns true when this reached zero
+
+	private:
+		std::atomic<uint32_t> m_Count = 0;
+		JobCounter* m_Parent = nullptr;
+
+		friend class JobSystem;
+	};
+
+	struct JobWorkerStats
+	{
+	public:
+		uint64_t JobsExecuted = 0;
+		uint64_t JobsStolen = 0;	// Of the executed jobs, how many were taken from another worker
+		double BusyMs = 0.0;
+		double Utilization = 0.0;	// Busy time over the time since the stats were reset, 0 to 1
+	};
+
+	struct Job;
+	struct JobWorker;
+
+	// Work stealing scheduler. Every worker owns a deque, it pushes and pops its own jobs at the bottom
+	// while idle workers steal from the top of the others. The thread calling Init() is worker 0, it only
+	// runs jobs while it waits. Other threads (like the asset loaders) submit into a shared queue.
+	class JobSystem
+	{
+	public:
+		static JobSystem* Get() { return s_Instance; }
+
+		// workerCount includes the calling thread, 0 picks the hardware concurrency.
+		static void Init(uint32_t workerCount = 0);
+		// Jobs that didn't start yet are dropped.
+		static void Destroy();
+
+		static void Run(JobFunction job, JobCounter* counter = nullptr);
+		// Runs other jobs until the counter reaches zero, sleeps when there are none.
+		static void Wait(JobCounter& counter);
+
+		// Splits [0, count) into ranges of at most batchSize and runs them on every worker, returns once all are done.
+		// Note: Ranges are split in halves, so a stealing worker takes a large part of what's left instead of a single batch.
+		static void ParallelFor(uint32_t count, uint32_t batchSize, ParallelForFunction func);
+
+		inline static uint32_t GetWorkerCount() { return s_Instance ? (uint32_t)s_Instance->m_Workers.size() : 1u; }
+		static uint32_t GetCurrentWorker(); // UINT32_MAX on threads that aren't workers
+
+		static std::vector<JobWorkerStats> GetStats();
+		static void ResetStats();
+
+	private:
+		static JobSystem* s_Instance;
+
+	private:
+		void StartWorkers(uint32_t workerCount);
+		void StopWorkers();
+		void WorkerLoop(uint32_t index);
+
+		void Push(Job* job);
+		Job* FindJob(uint32_t index, bool& stolen);
+		void Execute(Job* job, uint32_t index, bool stolen);
+
+		void Sleep(const JobCounter* counter); // Until there are jobs, or until the counter is done
+		static void NotifyWaiters();
+
+		static void SplitRange(uint32_t begin, uint32_t end, uint32_t batchSize, const ParallelForFunction& func, JobCounter& counter);
+
+	private:
+		std::vector<JobWorker*> m_Workers = { };
+		std::vector<std::thread> m_Threads = { };
+		std::atomic<bool> m_Running = false;
+
+		// Submissions from threads that aren't workers
+		std::mutex m_SharedMutex;
+		std::deque<Job*> m_SharedJobs = { };
+		std::atomic<uint32_t> m_SharedCount = 0;
+
+		// Idle workers and waiters sleep here, Push() and JobCounter::Decrement() only take the mutex when someone is sleeping.
+		std::mutex m_SleepMutex;
+		std::condition_variable m_SleepCondition;
+		std::atomic<int32_t> m_Queued = 0;
+		std::atomic<uint32_t> m_Sleeping = 0;
+		std::atomic<uint32_t> m_Waiting = 0; // Of the sleeping, how many wait on a counter
+
+		std::atomic<int64_t> m_StatsStart = 0; // Steady clock nanoseconds
+
+		friend class JobCounter;
+	};
+
+}
\ No newline at end of file
@@ -26,6 +26,7 @@ namespace VkApp
 	void LayerStack::AddLayer(Layer* layer)
 	{
 		m_Layers.emplace(m_Layers.begin() + m_InsertIndex++, layer);
+		m_Generation++;
 
 		layer->OnAttach();
 	}
@@ -38,12 +39,14 @@ namespace VkApp
 			layer->OnDetach();
 			m_Layers.erase(layerIndex);
 			m_InsertIndex--;
+			m_Generation++;
 		}
 	}
 
 	void LayerStack::AddOverlay(Layer* overlay)
 	{
 		m_Layers.emplace_back(overlay);
+		m_Generation++;
 
 		overlay->OnAttach();
 	}
@@ -55,6 +58,7 @@ namespace VkApp
 		{
 			overlay->OnDetach();
 			m_Layers.erase(layerIndex);
+			m_Generation++;
 		}
 	}
 
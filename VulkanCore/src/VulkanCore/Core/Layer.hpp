@@ -18,14 +18,32 @@ namespace VkApp
 		virtual void OnDetach() {}
 
 		virtual void OnUpdate(float deltaTime) {}
+		virtual void OnFixedUpdate(float fixedTimeStep) {} // Only called when AppInfo::FixedTimeStep is set, before OnUpdate()
 		virtual void OnRender() {}
 		virtual void OnImGuiRender() {}
 		virtual void OnEvent(Event& e) {}
 
 		inline const std::string& GetName() { return m_DebugName; }
 
+		// A parallel layer's OnUpdate() runs on the JobSystem, at the same time as other layers. It can't use the
+		// Renderer's queues or anything another layer touches, unless that layer is one of its dependencies.
+		// GLFW, Input::*, Window::SetTitle() and ImGui are main thread only, so they're off limits too.
+		// OnRender() and everything else still run on the main thread, in stack order.
+		inline void SetParallel(bool parallel) { m_Parallel = parallel; }
+		inline bool IsParallel() const { return m_Parallel; }
+
+		// OnUpdate() only starts once the OnUpdate() of every dependency is done, for parallel and serial layers alike.
+		// Note: Dependencies that aren't in the LayerStack are ignored.
+		inline void DependsOn(Layer* layer) { m_Dependencies.push_back(layer); m_Generation++; }
+		inline const std::vector<Layer*>& GetDependencies() const { return m_Dependencies; }
+		inline uint32_t GetGeneration() const { return m_Generation; } // Goes up when the dependencies change
+
 	protected:
 		std::string m_DebugName;
+
+		bool m_Parallel = false;
+		std::vector<Layer*> m_Dependencies = { };
+		uint32_t m_Generation = 0;
 	};
 
 }
@@ -54,9 +72,13 @@ namespace VkApp
 		std::vector<Layer*>::const_reverse_iterator rbegin()	const { return m_Layers.rbegin(); }
 		std::vector<Layer*>::const_reverse_iterator rend()		const { return m_Layers.rend(); }
 
+		inline uint32_t GetSize() const { return (uint32_t)m_Layers.size(); }
+		inline uint32_t GetGeneration() const { return m_Generation; } // Goes up when layers are added or removed
+
 	private:
 		std::vector<Layer*> m_Layers;
 		uint32_t m_InsertIndex;
+		uint32_t m_Generation = 0;
 	};
 
 }
\ No newline at end of file
@@ -12,9 +12,32 @@ namespace VkApp
 		s_Sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
 		s_Sink->set_pattern("[%H:%M:%S] [%L]: %v%$");
 
-		s_Logger = std::make_shared<spdlog::logger>("VkApp Logger", s_Sink);
+		// Note: A single thread does the console writes, so messages keep their order.
+		spdlog::init_thread_pool(VKAPP_LOG_QUEUE_SIZE, 1);
+
+		// Note: Overrunning drops the oldest message instead of blocking, a burst of validation messages shouldn't stall a frame.
+		s_Logger = std::make_shared<spdlog::async_logger>("VkApp Logger", s_Sink, spdlog::thread_pool(), spdlog::async_overflow_policy::overrun_oldest);
 		spdlog::set_default_logger(s_Logger);
-		spdlog::set_level(spdlog::level::trace); 
+
+		// Whatever got through the compile time filter gets logged
+		spdlog::set_level(spdlog::level::trace);
+		spdlog::flush_on(spdlog::level::err);
+	}
+
+	void Log::Shutdown()
+	{
+		if (!s_Logger)
+			return;
+
+		size_t dropped = spdlog::thread_pool()->overrun_counter();
+		if (dropped > 0)
+			VKAPP_LOG_WARN("{0} log messages were dropped, the log queue was full.", dropped);
+
+		s_Logger->flush();
+
+		s_Logger.reset();
+		s_Sink.reset();
+		spdlog::shutdown();
 	}
 
 }
\ No newline at end of file
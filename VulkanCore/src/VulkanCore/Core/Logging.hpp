@@ -3,8 +3,26 @@
 #include <memory>
 
 #include <spdlog/spdlog.h>
+#include <spdlog/async.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 
+#define VKAPP_LOG_LEVEL_TRACE 0
+#define VKAPP_LOG_LEVEL_INFO 1
+#define VKAPP_LOG_LEVEL_WARN 2
+#define VKAPP_LOG_LEVEL_ERROR 3
+#define VKAPP_LOG_LEVEL_FATAL 4
+
+// Messages below this level are compiled out, arguments included. Can be overridden from the build.
+#ifndef VKAPP_LOG_LEVEL
+	#if defined(VKAPP_DEBUG)
+		#define VKAPP_LOG_LEVEL VKAPP_LOG_LEVEL_TRACE
+	#else
+		#define VKAPP_LOG_LEVEL VKAPP_LOG_LEVEL_WARN
+	#endif
+#endif
+
+#define VKAPP_LOG_QUEUE_SIZE 8192 // Messages, when full the oldest ones get dropped
+
 namespace VkApp
 {
 
@@ -16,7 +34,10 @@ namespace VkApp
 		//	None = -1, Trace, Info, Warn, Error, Fatal
 		//};
 
+		// Messages are formatted on the calling thread and written to the console by a background thread.
 		static void Init();
+		// Writes out whatever is still queued and stops the background thread.
+		static void Shutdown();
 
 		//template<typename ... Args>
 		//static void LogMessage(Log::Level level, const char* fmt, const Args&... args)
@@ -41,10 +62,26 @@ namespace VkApp
 		//	}
 		//}
 
-		#define VKAPP_LOG_TRACE(...) spdlog::trace(__VA_ARGS__)
-		#define VKAPP_LOG_INFO(...) spdlog::info(__VA_ARGS__)
-		#define VKAPP_LOG_WARN(...) spdlog::warn(__VA_ARGS__)
-		#define VKAPP_LOG_ERROR(...) spdlog::error(__VA_ARGS__)
+		#if VKAPP_LOG_LEVEL <= VKAPP_LOG_LEVEL_TRACE
+			#define VKAPP_LOG_TRACE(...) spdlog::trace(__VA_ARGS__)
+		#else
+			#define VKAPP_LOG_TRACE(...) (void)0
+		#endif
+		#if VKAPP_LOG_LEVEL <= VKAPP_LOG_LEVEL_INFO
+			#define VKAPP_LOG_INFO(...) spdlog::info(__VA_ARGS__)
+		#else
+			#define VKAPP_LOG_INFO(...) (void)0
+		#endif
+		#if VKAPP_LOG_LEVEL <= VKAPP_LOG_LEVEL_WARN
+			#define VKAPP_LOG_WARN(...) spdlog::warn(__VA_ARGS__)
+		#else
+			#define VKAPP_LOG_WARN(...) (void)0
+		#endif
+		#if VKAPP_LOG_LEVEL <= VKAPP_LOG_LEVEL_ERROR
+			#define VKAPP_LOG_ERROR(...) spdlog::error(__VA_ARGS__)
+		#else
+			#define VKAPP_LOG_ERROR(...) (void)0
+		#endif
 		#define VKAPP_LOG_FATAL(...) spdlog::critical(__VA_ARGS__)
 
 	private:
@@ -0,0 +1,253 @@
+#include "vcpch.h"
+#include "Profiler.hpp"
+
+#include <mutex>
+#include <cstring>
+#include <iomanip>
+
+#include "VulkanCore/Core/Logging.hpp"
+
+namespace VkApp
+{
+
+	#define VKAPP_PROFILER_CHUNK_SIZE 1024
+
+	// Written by one thread, read by EndSession(). Count is published after the event is written.
+	struct EventChunk
+	{
+	public:
+		ProfileEvent Events[VKAPP_PROFILER_CHUNK_SIZE] = { };
+		std::atomic<uint32_t> Count = 0;
+		std::atomic<EventChunk*> Next = nullptr;
+	};
+
+	struct ThreadBuffer
+	{
+	public:
+		EventChunk Head = {};
+		EventChunk* Tail = &Head;
+
+		std::atomic<uint32_t> Session = 0; // Session the events belong to
+		uint32_t ThreadID = 0;
+		std::string Name = {}; // Guarded by s_BuffersMutex
+
+		~ThreadBuffer()
+		{
+			EventChunk* chunk = Head.Next.load();
+			while (chunk)
+			{
+				EventChunk* next = chunk->Next.load();
+				delete chunk;
+				chunk = next;
+			}
+		}
+	};
+
+	// ===================================
+	// ------------- Helper --------------
+	// ===================================
+	// Note: Buffers live until the program exits, even after their thread is gone.
+	static std::mutex s_BuffersMutex;
+	static std::vector<std::unique_ptr<ThreadBuffer>> s_Buffers = { };
+
+	static thread_local ThreadBuffer* t_Buffer = nullptr;
+
+	static ThreadBuffer* GetThreadBuffer()
+	{
+		if (!t_Buffer)
+		{
+			std::scoped_lock<std::mutex> lock(s_BuffersMutex);
+
+			s_Buffers.push_back(std::make_unique<ThreadBuffer>());
+			t_Buffer = s_Buffers.back().get();
+			t_Buffer->ThreadID = static_cast<uint32_t>(s_Buffers.size());
+			t_Buffer->Name = "Thread " + std::to_string(t_Buffer->ThreadID);
+		}
+
+		return t_Buffer;
+	}
+
+	// Held for the whole export, so a new session can't reset the buffers while they're written out.
+	static std::mutex s_ExportMutex;
+
+	static void WriteJSONString(std::ofstream& file, const char* str)
+	{
+		static const char hex[] = "0123456789abcdef";
+
+		file << '"';
+		for (; *str; str++)
+		{
+			unsigned char c = static_cast<unsigned char>(*str);
+
+			if (c == '"' || c == '\\')
+				file << '\\' << *str;
+			else if (c < 0x20)
+				file << "\\u00" << hex[c >> 4] << hex[c & 0xF];
+			else
+				file << *str;
+		}
+		file << '"';
+	}
+
+	// ===================================
+	// ------------ Static ---------------
+	// ===================================
+	std::atomic<uint32_t> Profiler::s_Session = 0;
+	uint32_t Profiler::s_SessionCount = 0;
+	std::atomic<int64_t> Profiler::s_Epoch = 0;
+
+	void Profiler::BeginSession()
+	{
+		std::scoped_lock<std::mutex> exportLock(s_ExportMutex);
+
+		if (IsRunning())
+		{
+			VKAPP_LOG_WARN("A profiling session is already running.");
+			return;
+		}
+
+		s_Epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		s_Session = ++s_SessionCount;
+	}
+
+	void Profiler::EndSession(const std::filesystem::path& path)
+	{
+		std::scoped_lock<std::mutex> exportLock(s_ExportMutex);
+
+		uint32_t session = s_Session.exchange(0);
+		if (session == 0)
+		{
+			VKAPP_LOG_WARN("No profiling session is running.");
+			return;
+		}
+
+		std::ofstream file(path);
+		if (!file.is_open())
+		{
+			VKAPP_LOG_ERROR("Failed to open '{0}' to write the profiling results.", path.string());
+			return;
+		}
+
+		file << std::fixed << std::setprecision(3);
+		file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+		bool first = true;
+		size_t eventCount = 0;
+
+		std::scoped_lock<std::mutex> lock(s_BuffersMutex);
+		for (auto& buffer : s_Buffers)
+		{
+			if (buffer->Session.load(std::memory_order_acquire) != session)
+				continue;
+
+			file << (first ? "" : ",") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->ThreadID << ",\"args\":{\"name\":";
+			WriteJSONString(file, buffer->Name.c_str());
+			file << "}}";
+			first = false;
+
+			for (EventChunk* chunk = &buffer->Head; chunk; chunk = chunk->Next.load(std::memory_order_acquire))
+			{
+				uint32_t count = chunk->Count.load(std::memory_order_acquire);
+				for (uint32_t i = 0; i < count; i++)
+				{
+					const ProfileEvent& event = chunk->Events[i];
+
+					// Note: Chrome traces are in microseconds.
+					file << ",{\"name\":";
+					WriteJSONString(file, event.Name);
+					file << ",\"cat\":\"cpu\",\"ph\":\"X\",\"ts\":" << (double)event.Start / 1000.0 << ",\"dur\":" << (double)event.Duration / 1000.0 << ",\"pid\":0,\"tid\":" << buffer->ThreadID << "}";
+				}
+
+				eventCount += count;
+			}
+		}
+
+		file << "]}";
+		VKAPP_LOG_INFO("Wrote {0} profiling zones to '{1}'.", eventCount, path.string());
+	}
+
+	void Profiler::SetThreadName(const std::string& name)
+	{
+		ThreadBuffer* buffer = GetThreadBuffer();
+
+		std::scoped_lock<std::mutex> lock(s_BuffersMutex);
+		buffer->Name = name;
+	}
+
+	int64_t Profiler::Now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count() - s_Epoch.load(std::memory_order_relaxed);
+	}
+
+	void Profiler::Record(const ProfileEvent& event)
+	{
+		uint32_t session = GetSession();
+		if (session == 0)
+			return;
+
+		ThreadBuffer* buffer = GetThreadBuffer();
+
+		// Note: Only this thread writes to its buffer, so starting over for a new session is safe.
+		// The chunks are kept around and reused.
+		if (buffer->Session.load(std::memory_order_relaxed) != session)
+		{
+			for (EventChunk* chunk = &buffer->Head; chunk; chunk = chunk->Next.load(std::memory_order_relaxed))
+				chunk->Count.store(0, std::memory_order_relaxed);
+
+			buffer->Tail = &buffer->Head;
+			buffer->Session.store(session, std::memory_order_release);
+		}
+
+		uint32_t count = buffer->Tail->Count.load(std::memory_order_relaxed);
+		if (count == VKAPP_PROFILER_CHUNK_SIZE)
+		{
+			EventChunk* next = buffer->Tail->Next.load(std::memory_order_relaxed);
+			if (!next)
+			{
+				next = new EventChunk();
+				buffer->Tail->Next.store(next, std::memory_order_release);
+			}
+
+			buffer->Tail = next;
+			count = 0;
+		}
+
+		buffer->Tail->Events[count] = event;
+		buffer->Tail->Count.store(count + 1, std::memory_order_release);
+	}
+
+	// ===================================
+	// ------------- Scope ---------------
+	// ===================================
+	ProfileScope::ProfileScope(const char* name)
+	{
+		m_Session = Profiler::GetSession();
+		if (m_Session == 0)
+			return;
+
+		// Note: Don't cut a multi byte character in half, continuation bytes look like 10xxxxxx.
+		size_t length = strnlen(name, VKAPP_PROFILER_NAME_LENGTH - 1);
+		while (length > 0 && (static_cast<unsigned char>(name[length]) & 0xC0) == 0x80)
+			length--;
+
+		memcpy(m_Event.Name, name, length);
+		m_Event.Name[length] = '\0';
+		m_Event.Start = Profiler::Now();
+	}
+
+	ProfileScope::ProfileScope(const std::string& name)
+		: ProfileScope(name.c_str())
+	{
+	}
+
+	ProfileScope::~ProfileScope()
+	{
+		// Note: Zones that started in an earlier session are dropped.
+		if (m_Session == 0 || m_Session != Profiler::GetSession())
+			return;
+
+		m_Event.Duration = Profiler::Now() - m_Event.Start;
+		Profiler::Record(m_Event);
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <filesystem>
+
+// Note: Profiling is compiled out of Dist builds, the macros below become nothing.
+#if !defined(VKAPP_DIST)
+	#define VKAPP_PROFILING 1
+#else
+	#define VKAPP_PROFILING 0
+#endif
+
+namespace VkApp
+{
+
+	#define VKAPP_PROFILER_NAME_LENGTH 48 // Longer zone names get cut off (on a UTF-8 character boundary)
+
+	struct ProfileEvent
+	{
+	public:
+		char Name[VKAPP_PROFILER_NAME_LENGTH] = { };
+		int64_t Start = 0;		// Nanoseconds since the session began
+		int64_t Duration = 0;	// Nanoseconds
+	};
+
+	// Records CPU zones into per thread buffers, a thread only ever appends to its own buffer so
+	// recording doesn't lock. Zones are only kept while a session is running, EndSession() writes
+	// them as a Chrome trace (chrome://tracing, ui.perfetto.dev).
+	class Profiler
+	{
+	public:
+		// Note: BeginSession() blocks while EndSession() is still writing, a new session would start overwriting the events being exported.
+		static void BeginSession();
+		static void EndSession(const std::filesystem::path& path);
+
+		inline static bool IsRunning() { return GetSession() != 0; }
+		inline static uint32_t GetSession() { return s_Session.load(std::memory_order_relaxed); } // 0 when no session is running
+
+		// Shows up as the name of the calling thread in the trace.
+		static void SetThreadName(const std::string& name);
+
+		static int64_t Now();
+		static void Record(const ProfileEvent& event); // Only takes events of the running session
+
+	private:
+		static std::atomic<uint32_t> s_Session;
+		static uint32_t s_SessionCount;
+		static std::atomic<int64_t> s_Epoch; // Steady clock nanoseconds at the start of the session
+	};
+
+	class ProfileScope
+	{
+	public:
+		ProfileScope(const char* name);
+		ProfileScope(const std::string& name);
+		~ProfileScope();
+
+	private:
+		ProfileEvent m_Event = {};
+		uint32_t m_Session = 0; // 0 when no session was running
+	};
+
+}
+
+#if VKAPP_PROFILING
+	#define VKAPP_PROFILE_CONCAT_INNER(a, b) a##b
+	#define VKAPP_PROFILE_CONCAT(a, b) VKAPP_PROFILE_CONCAT_INNER(a, b)
+
+	#define VKAPP_PROFILE_SCOPE(name) ::VkApp::ProfileScope VKAPP_PROFILE_CONCAT(profileScope, __LINE__)(name)
+	#define VKAPP_PROFILE_FUNCTION() VKAPP_PROFILE_SCOPE(__FUNCTION__)
+
+	#define VKAPP_PROFILE_BEGIN_SESSION() ::VkApp::Profiler::BeginSession()
+	#define VKAPP_PROFILE_END_SESSION(path) ::VkApp::Profiler::EndSession(path)
+	#define VKAPP_PROFILE_THREAD(name) ::VkApp::Profiler::SetThreadName(name)
+#else
+	#define VKAPP_PROFILE_SCOPE(name)
+	#define VKAPP_PROFILE_FUNCTION()
+
+	#define VKAPP_PROFILE_BEGIN_SESSION()
+	#define VKAPP_PROFILE_END_SESSION(path)
+	#define VKAPP_PROFILE_THREAD(name)
+#endif
\ No newline at end of file
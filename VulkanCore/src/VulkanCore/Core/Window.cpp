@@ -1,18 +1,26 @@
 #include "vcpch.h"
 #include "Window.hpp"
 
+#include "VulkanCore/Core/Logging.hpp"
+
 #include "VulkanCore/Platforms/Windows/WindowsWindow.hpp"
+#include "VulkanCore/Platforms/Headless/HeadlessWindow.hpp"
 
 namespace VkApp
 {
 
 	std::unique_ptr<Window> Window::Create(const WindowProperties properties)
 	{
+		if (properties.Headless)
+			return std::make_unique<HeadlessWindow>(properties);
+
 		#ifdef VKAPP_PLATFORM_WINDOWS
 		return std::make_unique<WindowsWindow>(properties);
-		#endif
-
+		#else
 		// TODO(Jorben): Add all the platforms
+		VKAPP_LOG_WARN("No window implementation for this platform, running headless.");
+		return std::make_unique<HeadlessWindow>(properties);
+		#endif
 	}
 
 }
\ No newline at end of file
@@ -5,12 +5,11 @@
 #include <memory>
 
 #include "VulkanCore/Core/Events.hpp"
+#include "VulkanCore/Core/EventQueue.hpp"
 
 namespace VkApp
 {
 
-	using EventCallBackFunction = std::function<void(Event&)>;
-
 	struct WindowProperties
 	{
 		std::string Name;
@@ -20,6 +19,9 @@ namespace VkApp
 		bool Titlebar = true;
 		bool VSync = true;
 
+		// No window or surface, renders offscreen. For servers and CI without a display.
+		bool Headless = false;
+
 		bool CustomPos = false;
 		uint32_t X = 0u;
 		uint32_t Y = 0u;
@@ -37,7 +39,7 @@ namespace VkApp
 		uint32_t Height;
 
 		bool Vsync = false;
-		EventCallBackFunction CallBack;
+		EventQueue* Queue = nullptr; // Events are pushed here, the application dispatches them
 
 		WindowData(std::string name = "VulkanApp Window", uint32_t width = 1280, uint32_t height = 720)
 			: Name(name), Width(width), Height(height)
@@ -60,7 +62,7 @@ namespace VkApp
 	public:
 		virtual ~Window() = default;
 
-		virtual void SetEventCallBack(EventCallBackFunction func) = 0;
+		virtual void SetEventQueue(EventQueue* queue) = 0;
 
 		virtual void OnUpdate() = 0;
 		virtual void OnRender() = 0;
@@ -75,7 +77,8 @@ namespace VkApp
 
 		virtual void SetTitle(const std::string& title) = 0;
 
-		virtual void* GetNativeWindow() const = 0;
+		virtual bool IsHeadless() const = 0;
+		virtual void* GetNativeWindow() const = 0; // nullptr when headless
 
 		static std::unique_ptr<Window> Create(const WindowProperties properties = WindowProperties());
 	};
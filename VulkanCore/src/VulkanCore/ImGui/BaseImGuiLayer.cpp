@@ -76,7 +76,7 @@ namespace VkApp
 		{
 			VkCommandBuffer commandBuffer = BufferManager::BeginSingleTimeCommands();
 			ImGui_ImplVulkan_CreateFontsTexture(commandBuffer);
-			BufferManager::EndSingleTimeCommands(commandBuffer);
+			BufferManager::EndSingleTimeCommandsAndWait(commandBuffer);
 
 			ImGui_ImplVulkan_DestroyFontUploadObjects();
 
@@ -0,0 +1,24 @@
+#include "vcpch.h"
+#include "HeadlessWindow.hpp"
+
+namespace VkApp
+{
+
+	HeadlessWindow::HeadlessWindow(const WindowProperties properties)
+	{
+		m_Data.Name = properties.Name;
+		m_Data.Width = std::max(properties.Width, 1u);
+		m_Data.Height = std::max(properties.Height, 1u);
+		m_Data.Vsync = properties.VSync;
+	}
+
+	void HeadlessWindow::OnUpdate()
+	{
+		// Note: No events, the application has to close itself.
+	}
+
+	void HeadlessWindow::OnRender()
+	{
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "VulkanCore/Core/Window.hpp"
+
+namespace VkApp
+{
+
+	// A window that doesn't exist. There is no surface, the renderer draws into offscreen images
+	// of the requested size instead, see Renderer::ReadBackFrame() to get the pixels.
+	class HeadlessWindow : public Window
+	{
+	public:
+		HeadlessWindow(const WindowProperties properties);
+		virtual ~HeadlessWindow() = default;
+
+		void SetEventQueue(EventQueue* queue) override { m_Data.Queue = queue; }
+
+		void OnUpdate() override;
+		void OnRender() override;
+
+		uint32_t GetWidth() const override { return m_Data.Width; }
+		uint32_t GetHeight() const override { return m_Data.Height; }
+
+		void SetVSync(bool enabled) override { m_Data.Vsync = enabled; } // Nothing is presented, so nothing to sync to
+		bool IsVSync() const override { return m_Data.Vsync; }
+
+		void SetTitle(const std::string& title) override { m_Data.Name = title; }
+
+		bool IsHeadless() const override { return true; }
+		void* GetNativeWindow() const override { return nullptr; }
+
+	private:
+		WindowData m_Data;
+	};
+
+}
\ No newline at end of file
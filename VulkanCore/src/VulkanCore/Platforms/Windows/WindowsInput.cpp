@@ -15,6 +15,8 @@ namespace VkApp
     bool WindowsInput::IsKeyPressedImplementation(Key keycode)
     {
         GLFWwindow* window = static_cast<GLFWwindow*>(Application::Get().GetWindow().GetNativeWindow());
+        if (!window) // Headless
+            return false;
 
         int state = glfwGetKey(window, (int)keycode);
         return state == GLFW_PRESS || state == GLFW_REPEAT;
@@ -23,6 +25,8 @@ namespace VkApp
     bool WindowsInput::IsMousePressedImplementation(MouseButton button)
     {
         GLFWwindow* window = static_cast<GLFWwindow*>(Application::Get().GetWindow().GetNativeWindow());
+        if (!window) // Headless
+            return false;
 
         int state = glfwGetMouseButton(window, (int)button);
         return state == GLFW_PRESS;
@@ -31,6 +35,8 @@ namespace VkApp
     glm::vec2 WindowsInput::GetMousePositionImplementation()
     {
         GLFWwindow* window = static_cast<GLFWwindow*>(Application::Get().GetWindow().GetNativeWindow());
+        if (!window) // Headless
+            return { 0.0f, 0.0f };
 
         double xPos, yPos;
         glfwGetCursorPos(window, &xPos, &yPos);
@@ -41,6 +47,8 @@ namespace VkApp
     void WindowsInput::SetCursorPositionImplementation(glm::vec2 position)
     {
         GLFWwindow* window = static_cast<GLFWwindow*>(Application::Get().GetWindow().GetNativeWindow());
+        if (!window) // Headless
+            return;
 
         glfwSetCursorPos(window, position.x, position.y);
     }
@@ -48,8 +56,10 @@ namespace VkApp
     void WindowsInput::SetCursorModeImplementation(CursorMode mode)
     {
         GLFWwindow* window = static_cast<GLFWwindow*>(Application::Get().GetWindow().GetNativeWindow());
+        if (!window) // Headless
+            return;
 
         glfwSetInputMode(window, GLFW_CURSOR, (int)mode);
     }
 
-}
+}
\ No newline at end of file
@@ -37,10 +37,11 @@ namespace VkApp
 
 	void WindowsWindow::SetVSync(bool enabled)
 	{
-		if (SwapChainManager::Get())
-			SwapChainManager::Get()->RecreateSwapChain(enabled);
-		
 		m_Data.Vsync = enabled;
+
+		// Note: The swapchain picks up the new present mode when it's recreated.
+		if (SwapChainManager::Get())
+			SwapChainManager::Get()->RequestRecreate();
 	}
 
 	void WindowsWindow::SetTitle(const std::string& title)
@@ -84,15 +85,13 @@ namespace VkApp
 				data.Width = width;
 				data.Height = height;
 
-				WindowResizeEvent event(width, height);
-				data.CallBack(event);
+				data.Queue->Push(WindowResizeEvent(width, height));
 			});
 
 		glfwSetWindowCloseCallback(m_Window, [](GLFWwindow* window)
 			{
 				WindowData& data = *(WindowData*)glfwGetWindowUserPointer(window);
-				WindowCloseEvent event;
-				data.CallBack(event);
+				data.Queue->Push(WindowCloseEvent());
 			});
 
 
@@ -104,20 +103,17 @@ namespace VkApp
 				{
 				case GLFW_PRESS:
 				{
-					KeyPressedEvent event(key, 0);
-					data.CallBack(event);
+					data.Queue->Push(KeyPressedEvent(key, 0));
 					break;
 				}
 				case GLFW_RELEASE:
 				{
-					KeyReleasedEvent event(key);
-					data.CallBack(event);
+					data.Queue->Push(KeyReleasedEvent(key));
 					break;
 				}
 				case GLFW_REPEAT:
 				{
-					KeyPressedEvent event(key, 1);
-					data.CallBack(event);
+					data.Queue->Push(KeyPressedEvent(key, 1));
 					break;
 				}
 				}
@@ -127,8 +123,7 @@ namespace VkApp
 			{
 				WindowData& data = *(WindowData*)glfwGetWindowUserPointer(window);
 
-				KeyTypedEvent event(keycode);
-				data.CallBack(event);
+				data.Queue->Push(KeyTypedEvent(keycode));
 			});
 
 		glfwSetMouseButtonCallback(m_Window, [](GLFWwindow* window, int button, int action, int mods)
@@ -139,14 +134,12 @@ namespace VkApp
 				{
 				case GLFW_PRESS:
 				{
-					MouseButtonPressedEvent event(button);
-					data.CallBack(event);
+					data.Queue->Push(MouseButtonPressedEvent(button));
 					break;
 				}
 				case GLFW_RELEASE:
 				{
-					MouseButtonReleasedEvent event(button);
-					data.CallBack(event);
+					data.Queue->Push(MouseButtonReleasedEvent(button));
 					break;
 				}
 				}
@@ -156,16 +149,15 @@ namespace VkApp
 			{
 				WindowData& data = *(WindowData*)glfwGetWindowUserPointer(window);
 
-				MouseScrolledEvent event((float)xOffset, (float)yOffset);
-				data.CallBack(event);
+				data.Queue->Push(MouseScrolledEvent((float)xOffset, (float)yOffset));
 			});
 
 		glfwSetCursorPosCallback(m_Window, [](GLFWwindow* window, double xPos, double yPos)
 			{
 				WindowData& data = *(WindowData*)glfwGetWindowUserPointer(window);
 
-				MouseMovedEvent event((float)xPos, (float)yPos);
-				data.CallBack(event);
+				// Note: High rate mice call this many times per frame, the queue only keeps the latest position.
+				data.Queue->Push(MouseMovedEvent((float)xPos, (float)yPos));
 			});
 
 
@@ -13,7 +13,7 @@ namespace VkApp
 		WindowsWindow(const WindowProperties properties);
 		virtual ~WindowsWindow();
 
-		void SetEventCallBack(EventCallBackFunction func) override { m_Data.CallBack = func; }
+		void SetEventQueue(EventQueue* queue) override { m_Data.Queue = queue; }
 
 		void OnUpdate() override;
 		void OnRender() override;
@@ -26,6 +26,7 @@ namespace VkApp
 
 		void SetTitle(const std::string& title) override;
 
+		bool IsHeadless() const override { return false; }
 		void* GetNativeWindow() const override { return (void*)m_Window; }
 
 	private:
@@ -0,0 +1,497 @@
+#include "vcpch.h"
+#include "AssetManager.hpp"
+
+#include "VulkanCore/Core/Logging.hpp"
+#include "VulkanCore/Core/Profiler.hpp"
+
+#include "VulkanCore/Renderer/Renderer.hpp"
+#include "VulkanCore/Renderer/InstanceManager.hpp"
+#include "VulkanCore/Renderer/ResidencyManager.hpp"
+
+namespace VkApp
+{
+
+	// ===================================
+	// ------------ Static ---------------
+	// ===================================
+	AssetManager* AssetManager::s_Instance = nullptr;
+
+	static MeshData CreateCubeData()
+	{
+		MeshData data = {};
+
+		// 4 vertices per face, so every face gets its own UV's
+		const glm::vec3 normals[6] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+
+		for (const glm::vec3& normal : normals)
+		{
+			glm::vec3 up = std::abs(normal.y) > 0.5f ? glm::vec3(0, 0, 1) : glm::vec3(0, 1, 0);
+			glm::vec3 right = glm::cross(up, normal);
+
+			uint32_t base = static_cast<uint32_t>(data.Vertices.size());
+
+			data.Vertices.push_back({ (normal - right - up) * 0.5f, { 0.0f, 1.0f } });
+			data.Vertices.push_back({ (normal + right - up) * 0.5f, { 1.0f, 1.0f } });
+			data.Vertices.push_back({ (normal + right + up) * 0.5f, { 1.0f, 0.0f } });
+			data.Vertices.push_back({ (normal - right + up) * 0.5f, { 0.0f, 0.0f } });
+
+			for (uint32_t index : { 0u, 1u, 2u, 2u, 3u, 0u })
+				data.Indices.push_back(base + index);
+		}
+
+		data.Submeshes.push_back({ 0, static_cast<uint32_t>(data.Indices.size()), 0, static_cast<uint32_t>(data.Vertices.size()) });
+		data.LODs.push_back({ 0, static_cast<uint32_t>(data.Indices.size()), 0.0f });
+		data.CalculateBounds();
+
+		return data;
+	}
+
+	void AssetManager::Init(uint32_t workerCount)
+	{
+		s_Instance = new AssetManager();
+
+		s_Instance->CreatePlaceholders();
+
+		if (workerCount == 0)
+			workerCount = std::clamp(std::thread::hardware_concurrency() / 2u, 1u, 4u);
+
+		s_Instance->StartWorkers(workerCount);
+	}
+
+	void AssetManager::Destroy()
+	{
+		s_Instance->StopWorkers();
+
+		vkDeviceWaitIdle(InstanceManager::Get()->GetLogicalDevice());
+
+		s_Instance->CollectGarbage(true);
+
+		for (auto& [path, slot] : s_Instance->m_Meshes)
+		{
+			if (slot->State == AssetState::Ready)
+				slot->Asset.Destroy();
+		}
+
+		for (auto& [path, slot] : s_Instance->m_Textures)
+		{
+			if (slot->State == AssetState::Ready)
+				slot->Asset.Destroy();
+		}
+
+		for (auto& [path, slot] : s_Instance->m_StreamedTextures)
+		{
+			if (slot->State == AssetState::Ready)
+				slot->Asset.Destroy();
+		}
+
+		s_Instance->m_PlaceholderMesh.Destroy();
+		s_Instance->m_PlaceholderTexture.Destroy();
+		s_Instance->m_PlaceholderStreamedTexture.Destroy();
+
+		delete s_Instance;
+		s_Instance = nullptr;
+	}
+
+	MeshHandle AssetManager::LoadMesh(const std::filesystem::path& path, MeshLoadedFunction callback)
+	{
+		auto it = s_Instance->m_Meshes.find(path.string());
+		if (it != s_Instance->m_Meshes.end())
+		{
+			auto& slot = it->second;
+			if (callback && slot->State == AssetState::Ready)
+				callback(slot->Asset);
+			if (callback)
+				slot->Callbacks.push_back(callback);
+
+			if (slot->State == AssetState::Evicted)
+				Reload(slot);
+
+			return MeshHandle(slot);
+		}
+
+		auto slot = std::make_shared<AssetSlot<Mesh>>();
+		slot->Path = path;
+		if (callback)
+			slot->Callbacks.push_back(callback);
+
+		s_Instance->m_Meshes[path.string()] = slot;
+		s_Instance->QueueMeshLoad(slot);
+
+		return MeshHandle(slot);
+	}
+
+	TextureHandle AssetManager::LoadTexture(const std::filesystem::path& path, TextureLoadedFunction callback)
+	{
+		auto it = s_Instance->m_Textures.find(path.string());
+		if (it != s_Instance->m_Textures.end())
+		{
+			auto& slot = it->second;
+			if (callback && slot->State == AssetState::Ready)
+				callback(slot->Asset);
+			if (callback)
+				slot->Callbacks.push_back(callback);
+
+			if (slot->State == AssetState::Evicted)
+				Reload(slot);
+
+			return TextureHandle(slot);
+		}
+
+		auto slot = std::make_shared<AssetSlot<Texture>>();
+		slot->Path = path;
+		if (callback)
+			slot->Callbacks.push_back(callback);
+
+		s_Instance->m_Textures[path.string()] = slot;
+		s_Instance->QueueTextureLoad(slot);
+
+		return TextureHandle(slot);
+	}
+
+	StreamedTextureHandle AssetManager::LoadStreamedTexture(const std::filesystem::path& path, StreamedTextureLoadedFunction callback)
+	{
+		auto it = s_Instance->m_StreamedTextures.find(path.string());
+		if (it != s_Instance->m_StreamedTextures.end())
+		{
+			auto& slot = it->second;
+			if (callback && slot->State == AssetState::Ready)
+				callback(slot->Asset);
+			if (callback)
+				slot->Callbacks.push_back(callback);
+
+			return StreamedTextureHandle(slot);
+		}
+
+		auto slot = std::make_shared<AssetSlot<StreamedTexture>>();
+		slot->Path = path;
+		if (callback)
+			slot->Callbacks.push_back(callback);
+
+		s_Instance->m_StreamedTextures[path.string()] = slot;
+		s_Instance->QueueStreamedTextureLoad(slot);
+
+		return StreamedTextureHandle(slot);
+	}
+
+	void AssetManager::Update()
+	{
+		VKAPP_PROFILE_FUNCTION();
+
+		std::vector<std::function<void()>> uploads = { };
+
+		{
+			std::scoped_lock<std::mutex> lock(s_Instance->m_UploadMutex);
+
+			// Note: The uploads still wait for the queue, so spread them out to keep frames smooth.
+			while (!s_Instance->m_Uploads.empty() && uploads.size() < s_Instance->m_MaxUploadsPerFrame)
+			{
+				uploads.push_back(std::move(s_Instance->m_Uploads.front()));
+				s_Instance->m_Uploads.pop_front();
+			}
+		}
+
+		for (auto& upload : uploads)
+		{
+			upload();
+			s_Instance->m_Outstanding--;
+		}
+
+		for (auto& [path, slot] : s_Instance->m_StreamedTextures)
+		{
+			if (slot->State == AssetState::Ready)
+				slot->Asset.Update();
+		}
+
+		s_Instance->m_FrameIndex++;
+		s_Instance->CollectGarbage();
+
+		ResidencyManager* residency = ResidencyManager::Get();
+		residency->Update();
+
+		// Note: Memory that is already waiting to be freed doesn't show up in the budget yet, don't evict for it twice.
+		VkDeviceSize overBudget = residency->GetOverBudget();
+		if (overBudget > s_Instance->m_PendingDestroySize)
+			s_Instance->Evict(overBudget - s_Instance->m_PendingDestroySize);
+	}
+
+	void AssetManager::Reload(std::shared_ptr<AssetSlot<Mesh>> slot)
+	{
+		if (slot->State != AssetState::Evicted)
+			return;
+
+		slot->State = AssetState::Queued;
+		s_Instance->QueueMeshLoad(slot);
+	}
+
+	void AssetManager::Reload(std::shared_ptr<AssetSlot<Texture>> slot)
+	{
+		if (slot->State != AssetState::Evicted)
+			return;
+
+		slot->State = AssetState::Queued;
+		s_Instance->QueueTextureLoad(slot);
+	}
+
+	void AssetManager::Reload(std::shared_ptr<AssetSlot<StreamedTexture>> slot)
+	{
+		if (slot->State != AssetState::Evicted)
+			return;
+
+		slot->State = AssetState::Queued;
+		s_Instance->QueueStreamedTextureLoad(slot);
+	}
+
+	// ===================================
+	// ------------- Helper --------------
+	// ===================================
+	void AssetManager::StartWorkers(uint32_t workerCount)
+	{
+		m_Running = true;
+
+		for (uint32_t i = 0; i < workerCount; i++)
+			m_Workers.emplace_back([this]() { WorkerLoop(); });
+	}
+
+	void AssetManager::StopWorkers()
+	{
+		{
+			std::scoped_lock<std::mutex> lock(m_JobMutex);
+			m_Running = false;
+			m_Jobs.clear(); // Note: Anything that didn't start yet is not worth waiting for.
+		}
+		m_JobCondition.notify_all();
+
+		for (auto& worker : m_Workers)
+			worker.join();
+
+		m_Workers.clear();
+	}
+
+	void AssetManager::WorkerLoop()
+	{
+		while (true)
+		{
+			std::function<void()> job = nullptr;
+
+			{
+				std::unique_lock<std::mutex> lock(m_JobMutex);
+				m_JobCondition.wait(lock, [this]() { return !m_Running || !m_Jobs.empty(); });
+
+				if (!m_Running)
+					return;
+
+				job = std::move(m_Jobs.front());
+				m_Jobs.pop_front();
+			}
+
+			job();
+		}
+	}
+
+	void AssetManager::QueueJob(std::function<void()> job)
+	{
+		{
+			std::scoped_lock<std::mutex> lock(m_JobMutex);
+			m_Jobs.push_back(std::move(job));
+		}
+		m_JobCondition.notify_one();
+	}
+
+	void AssetManager::QueueUpload(std::function<void()> upload)
+	{
+		std::scoped_lock<std::mutex> lock(m_UploadMutex);
+		m_Uploads.push_back(std::move(upload));
+	}
+
+	void AssetManager::QueueMeshLoad(std::shared_ptr<AssetSlot<Mesh>> slot)
+	{
+		m_Outstanding++;
+
+		QueueJob([slot]()
+		{
+			slot->State = AssetState::Loading;
+
+			auto data = std::make_shared<MeshData>();
+			if (!Mesh::LoadMeshData(slot->Path, *data))
+			{
+				s_Instance->QueueUpload([slot]()
+				{
+					slot->State = AssetState::Failed;
+					slot->Callbacks.clear();
+				});
+				return;
+			}
+
+			s_Instance->QueueUpload([slot, data]()
+			{
+				slot->Asset = Mesh(std::move(*data));
+				slot->LastUsedFrame = s_Instance->m_FrameIndex;
+				slot->State.store(AssetState::Ready, std::memory_order_release);
+
+				NotifyChanged(*slot, slot->Asset);
+			});
+		});
+	}
+
+	void AssetManager::QueueTextureLoad(std::shared_ptr<AssetSlot<Texture>> slot)
+	{
+		m_Outstanding++;
+
+		QueueJob([slot]()
+		{
+			slot->State = AssetState::Loading;
+
+			auto data = std::make_shared<TextureData>();
+			if (!Texture::LoadTextureData(slot->Path, *data))
+			{
+				s_Instance->QueueUpload([slot]()
+				{
+					slot->State = AssetState::Failed;
+					slot->Callbacks.clear();
+				});
+				return;
+			}
+
+			s_Instance->QueueUpload([slot, data]()
+			{
+				slot->Asset = Texture(*data);
+				slot->LastUsedFrame = s_Instance->m_FrameIndex;
+				slot->State.store(AssetState::Ready, std::memory_order_release);
+
+				NotifyChanged(*slot, slot->Asset);
+			});
+		});
+	}
+
+	void AssetManager::QueueStreamedTextureLoad(std::shared_ptr<AssetSlot<StreamedTexture>> slot)
+	{
+		m_Outstanding++;
+
+		QueueJob([slot]()
+		{
+			slot->State = AssetState::Loading;
+
+			auto data = std::make_shared<TextureData>();
+			if (!StreamedTexture::LoadTextureData(slot->Path, *data))
+			{
+				s_Instance->QueueUpload([slot]()
+				{
+					slot->State = AssetState::Failed;
+					slot->Callbacks.clear();
+				});
+				return;
+			}
+
+			s_Instance->QueueUpload([slot, data]()
+			{
+				slot->Asset = StreamedTexture(std::move(*data));
+				slot->LastUsedFrame = s_Instance->m_FrameIndex;
+				slot->State.store(AssetState::Ready, std::memory_order_release);
+
+				NotifyChanged(*slot, slot->Asset);
+			});
+		});
+	}
+
+	template<typename TAsset>
+	void AssetManager::NotifyChanged(AssetSlot<TAsset>& slot, TAsset& asset)
+	{
+		for (auto& func : slot.Callbacks)
+			func(asset);
+	}
+
+	void AssetManager::Evict(VkDeviceSize bytes)
+	{
+		struct Candidate
+		{
+		public:
+			uint64_t LastUsedFrame = 0;
+			VkDeviceSize Size = 0;
+			std::function<void()> Evict = nullptr;
+		};
+		std::vector<Candidate> candidates = { };
+
+		// Note: Anything drawn by a frame that might still be in flight is off limits.
+		auto evictable = [this](uint64_t lastUsedFrame, AssetState state)
+		{
+			return state == AssetState::Ready && lastUsedFrame + Renderer::Get()->GetFramesInFlight() < m_FrameIndex;
+		};
+
+		for (auto& [path, slot] : m_Meshes)
+		{
+			if (!evictable(slot->LastUsedFrame, slot->State))
+				continue;
+
+			candidates.push_back({ slot->LastUsedFrame, slot->Asset.GetMemorySize(), [this, slot]()
+			{
+				slot->State = AssetState::Evicted;
+				m_PendingDestroys.push_back({ InstanceManager::Get()->GetGraphicsTimeline().GetLastSubmitted(), slot->Asset.GetMemorySize(), [mesh = slot->Asset]() mutable { mesh.Destroy(); } });
+				slot->Asset = Mesh();
+
+				NotifyChanged(*slot, m_PlaceholderMesh);
+			}});
+		}
+
+		for (auto& [path, slot] : m_Textures)
+		{
+			if (!evictable(slot->LastUsedFrame, slot->State))
+				continue;
+
+			candidates.push_back({ slot->LastUsedFrame, slot->Asset.GetMemorySize(), [this, slot]()
+			{
+				slot->State = AssetState::Evicted;
+				m_PendingDestroys.push_back({ InstanceManager::Get()->GetGraphicsTimeline().GetLastSubmitted(), slot->Asset.GetMemorySize(), [texture = slot->Asset]() mutable { texture.Destroy(); } });
+				slot->Asset = Texture();
+
+				// Note: Evict() runs before the layers record, so their descriptors are back on the placeholder in time.
+				NotifyChanged(*slot, m_PlaceholderTexture);
+			}});
+		}
+
+		// Least recently drawn first
+		std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) { return a.LastUsedFrame < b.LastUsedFrame; });
+
+		VkDeviceSize freed = 0;
+		for (auto& candidate : candidates)
+		{
+			if (freed >= bytes)
+				break;
+
+			candidate.Evict();
+			freed += candidate.Size;
+			m_PendingDestroySize += candidate.Size;
+		}
+
+		if (freed < bytes)
+			VKAPP_LOG_WARN("Over the memory budget by {0} bytes, but only {1} bytes could be evicted.", bytes, freed);
+	}
+
+	void AssetManager::CollectGarbage(bool force)
+	{
+		for (auto it = m_PendingDestroys.begin(); it != m_PendingDestroys.end();)
+		{
+			if (force || InstanceManager::Get()->GetGraphicsTimeline().IsComplete(it->Value))
+			{
+				it->Destroy();
+				m_PendingDestroySize -= it->Size;
+				it = m_PendingDestroys.erase(it);
+			}
+			else
+				++it;
+		}
+	}
+
+	void AssetManager::CreatePlaceholders()
+	{
+		m_PlaceholderMesh = Mesh(CreateCubeData());
+
+		TextureData texture = {};
+		texture.Width = 1;
+		texture.Height = 1;
+		texture.Pixels = { 128, 128, 128, 255 };
+
+		m_PlaceholderTexture = Texture(texture);
+		m_PlaceholderStreamedTexture = StreamedTexture(std::move(texture));
+	}
+
+}
\ No newline at end of file
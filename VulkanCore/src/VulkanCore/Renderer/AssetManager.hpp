@@ -0,0 +1,204 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <deque>
+#include <vector>
+#include <functional>
+#include <filesystem>
+#include <unordered_map>
+#include <condition_variable>
+
+#include "VulkanCore/Renderer/Mesh.hpp"
+#include "VulkanCore/Renderer/Texture.hpp"
+#include "VulkanCore/Renderer/StreamedTexture.hpp"
+
+namespace VkApp
+{
+
+	enum class AssetState
+	{
+		Queued = 0, Loading, Ready, Failed, Evicted
+	};
+
+	template<typename TAsset>
+	struct AssetSlot
+	{
+	public:
+		std::filesystem::path Path = { };
+		std::atomic<AssetState> State = AssetState::Queued;
+
+		TAsset Asset = { };
+
+		// Called every time the asset behind the slot changes: once it's loaded, with the placeholder when it's evicted
+		// and again after every reload, so descriptors that point at it can be rewritten before the next frame records.
+		// Note: Only touched on the main thread.
+		std::vector<std::function<void(TAsset&)>> Callbacks = { };
+		uint64_t LastUsedFrame = 0;
+	};
+
+	template<typename TAsset>
+	class AssetHandle
+	{
+	public:
+		AssetHandle() = default;
+		AssetHandle(std::shared_ptr<AssetSlot<TAsset>> slot)
+			: m_Slot(slot) {}
+
+		inline bool IsValid() const { return m_Slot != nullptr; }
+		inline bool IsReady() const { return m_Slot && m_Slot->State.load(std::memory_order_acquire) == AssetState::Ready; }
+		inline AssetState GetState() const { return m_Slot ? m_Slot->State.load(std::memory_order_acquire) : AssetState::Failed; }
+
+		// Returns the actual asset once it's resident, the placeholder otherwise.
+		// Note: Calling Get() also marks the asset as used this frame, see Touch().
+		TAsset& Get();
+
+		// Marks the asset as used this frame and reloads it if it was evicted.
+		// Assets that are only referenced through descriptors need to be touched every frame they're drawn.
+		void Touch();
+
+		// Empty for a handle without a slot.
+		inline const std::filesystem::path& GetPath() const { static const std::filesystem::path empty = { }; return m_Slot ? m_Slot->Path : empty; }
+
+	private:
+		std::shared_ptr<AssetSlot<TAsset>> m_Slot = nullptr;
+	};
+
+	typedef AssetHandle<Mesh> MeshHandle;
+	typedef AssetHandle<Texture> TextureHandle;
+	typedef AssetHandle<StreamedTexture> StreamedTextureHandle;
+
+	typedef std::function<void(Mesh&)> MeshLoadedFunction;
+	typedef std::function<void(Texture&)> TextureLoadedFunction;
+	typedef std::function<void(StreamedTexture&)> StreamedTextureLoadedFunction;
+
+	class AssetManager
+	{
+	public:
+		static AssetManager* Get() { return s_Instance; }
+
+		static void Init(uint32_t workerCount = 0);
+		static void Destroy();
+
+		// Both return immediately, decoding happens on a worker thread and the GPU upload
+		// plus the callback happen on the main thread during Update().
+		// Note: The callback stays registered, see AssetSlot::Callbacks.
+		static MeshHandle LoadMesh(const std::filesystem::path& path, MeshLoadedFunction callback = nullptr);
+		static TextureHandle LoadTexture(const std::filesystem::path& path, TextureLoadedFunction callback = nullptr);
+
+		// Streamed textures manage their own residency, they're updated every frame and never evicted.
+		static StreamedTextureHandle LoadStreamedTexture(const std::filesystem::path& path, StreamedTextureLoadedFunction callback = nullptr);
+
+		// Uploads finished assets, runs their callbacks and evicts least recently used assets
+		// when the device is over its memory budget. Called once per frame by the Application.
+		static void Update();
+
+		static void Reload(std::shared_ptr<AssetSlot<Mesh>> slot);
+		static void Reload(std::shared_ptr<AssetSlot<Texture>> slot);
+		static void Reload(std::shared_ptr<AssetSlot<StreamedTexture>> slot);
+
+		inline static uint64_t GetFrameIndex() { return s_Instance->m_FrameIndex; }
+
+		static Mesh& GetPlaceholderMesh() { return s_Instance->m_PlaceholderMesh; }
+		static Texture& GetPlaceholderTexture() { return s_Instance->m_PlaceholderTexture; }
+		static StreamedTexture& GetPlaceholderStreamedTexture() { return s_Instance->m_PlaceholderStreamedTexture; }
+
+		inline static bool IsIdle() { return s_Instance->m_Outstanding.load() == 0; }
+
+		inline void SetMaxUploadsPerFrame(uint32_t count) { m_MaxUploadsPerFrame = count; }
+
+	private:
+		static AssetManager* s_Instance;
+
+	private:
+		void StartWorkers(uint32_t workerCount);
+		void StopWorkers();
+		void WorkerLoop();
+
+		void QueueJob(std::function<void()> job);
+		void QueueUpload(std::function<void()> upload);
+
+		void QueueMeshLoad(std::shared_ptr<AssetSlot<Mesh>> slot);
+		void QueueTextureLoad(std::shared_ptr<AssetSlot<Texture>> slot);
+		void QueueStreamedTextureLoad(std::shared_ptr<AssetSlot<StreamedTexture>> slot);
+
+		template<typename TAsset>
+		static void NotifyChanged(AssetSlot<TAsset>& slot, TAsset& asset);
+
+		void Evict(VkDeviceSize bytes);
+		void CollectGarbage(bool force = false);
+
+		void CreatePlaceholders();
+
+	private:
+		std::vector<std::thread> m_Workers = { };
+		bool m_Running = false;
+
+		std::mutex m_JobMutex;
+		std::condition_variable m_JobCondition;
+		std::deque<std::function<void()>> m_Jobs = { };
+
+		std::mutex m_UploadMutex;
+		std::deque<std::function<void()>> m_Uploads = { };
+		uint32_t m_MaxUploadsPerFrame = 4;
+
+		std::atomic<uint32_t> m_Outstanding = 0;
+
+		uint64_t m_FrameIndex = 0;
+
+		// Evicted assets might still be in use by frames in flight, so they're destroyed once the graphics timeline passes the value.
+		struct PendingDestroy
+		{
+		public:
+			uint64_t Value = 0;
+			VkDeviceSize Size = 0;
+			std::function<void()> Destroy = nullptr;
+		};
+		std::vector<PendingDestroy> m_PendingDestroys = { };
+		VkDeviceSize m_PendingDestroySize = 0;
+
+		std::unordered_map<std::string, std::shared_ptr<AssetSlot<Mesh>>> m_Meshes = { };
+		std::unordered_map<std::string, std::shared_ptr<AssetSlot<Texture>>> m_Textures = { };
+		std::unordered_map<std::string, std::shared_ptr<AssetSlot<StreamedTexture>>> m_StreamedTextures = { };
+
+		Mesh m_PlaceholderMesh = {};
+		Texture m_PlaceholderTexture = {};
+		StreamedTexture m_PlaceholderStreamedTexture = {};
+	};
+
+	template<typename TAsset>
+	inline void AssetHandle<TAsset>::Touch()
+	{
+		if (!m_Slot)
+			return;
+
+		m_Slot->LastUsedFrame = AssetManager::GetFrameIndex();
+
+		if (m_Slot->State.load(std::memory_order_acquire) == AssetState::Evicted)
+			AssetManager::Reload(m_Slot);
+	}
+
+	template<>
+	inline Mesh& AssetHandle<Mesh>::Get()
+	{
+		Touch();
+		return IsReady() ? m_Slot->Asset : AssetManager::GetPlaceholderMesh();
+	}
+
+	template<>
+	inline Texture& AssetHandle<Texture>::Get()
+	{
+		Touch();
+		return IsReady() ? m_Slot->Asset : AssetManager::GetPlaceholderTexture();
+	}
+
+	template<>
+	inline StreamedTexture& AssetHandle<StreamedTexture>::Get()
+	{
+		Touch();
+		return IsReady() ? m_Slot->Asset : AssetManager::GetPlaceholderStreamedTexture();
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,262 @@
+#include "vcpch.h"
+#include "DeviceObjectCache.hpp"
+
+#include "VulkanCore/Core/Logging.hpp"
+
+#include "VulkanCore/Renderer/InstanceManager.hpp"
+
+namespace VkApp
+{
+
+	DeviceObjectCache* DeviceObjectCache::s_Instance = nullptr;
+
+	// ===================================
+	// ------------- Helper --------------
+	// ===================================
+	// Note: Keys are built field by field, hashing whole structs would pick up padding and pNext pointers.
+	template<typename T>
+	static void Append(std::string& key, const T& value)
+	{
+		key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	static std::string GetKey(const VkSamplerCreateInfo& info)
+	{
+		std::string key = { };
+		Append(key, info.flags);
+		Append(key, info.magFilter);
+		Append(key, info.minFilter);
+		Append(key, info.mipmapMode);
+		Append(key, info.addressModeU);
+		Append(key, info.addressModeV);
+		Append(key, info.addressModeW);
+		Append(key, info.mipLodBias);
+		Append(key, info.anisotropyEnable);
+		Append(key, info.maxAnisotropy);
+		Append(key, info.compareEnable);
+		Append(key, info.compareOp);
+		Append(key, info.minLod);
+		Append(key, info.maxLod);
+		Append(key, info.borderColor);
+		Append(key, info.unnormalizedCoordinates);
+		return key;
+	}
+
+	static std::string GetKey(const VkImageViewCreateInfo& info)
+	{
+		std::string key = { };
+		Append(key, info.flags);
+		Append(key, info.image);
+		Append(key, info.viewType);
+		Append(key, info.format);
+		Append(key, info.components.r);
+		Append(key, info.components.g);
+		Append(key, info.components.b);
+		Append(key, info.components.a);
+		Append(key, info.subresourceRange.aspectMask);
+		Append(key, info.subresourceRange.baseMipLevel);
+		Append(key, info.subresourceRange.levelCount);
+		Append(key, info.subresourceRange.baseArrayLayer);
+		Append(key, info.subresourceRange.layerCount);
+		return key;
+	}
+
+	static std::string GetKey(const VkDescriptorSetLayoutCreateInfo& info)
+	{
+		// Binding order doesn't matter to Vulkan, so it doesn't matter to the key either.
+		std::vector<VkDescriptorSetLayoutBinding> bindings(info.pBindings, info.pBindings + info.bindingCount);
+		std::sort(bindings.begin(), bindings.end(), [](const VkDescriptorSetLayoutBinding& a, const VkDescriptorSetLayoutBinding& b) { return a.binding < b.binding; });
+
+		std::string key = { };
+		Append(key, info.flags);
+		for (auto& binding : bindings)
+		{
+			Append(key, binding.binding);
+			Append(key, binding.descriptorType);
+			Append(key, binding.descriptorCount);
+			Append(key, binding.stageFlags);
+
+			if (binding.pImmutableSamplers)
+			{
+				for (uint32_t i = 0; i < binding.descriptorCount; i++)
+					Append(key, binding.pImmutableSamplers[i]);
+			}
+		}
+		return key;
+	}
+
+	static std::string GetKey(const VkPipelineLayoutCreateInfo& info)
+	{
+		std::string key = { };
+		Append(key, info.flags);
+		Append(key, info.setLayoutCount);
+		for (uint32_t i = 0; i < info.setLayoutCount; i++)
+			Append(key, info.pSetLayouts[i]);
+
+		for (uint32_t i = 0; i < info.pushConstantRangeCount; i++)
+		{
+			Append(key, info.pPushConstantRanges[i].stageFlags);
+			Append(key, info.pPushConstantRanges[i].offset);
+			Append(key, info.pPushConstantRanges[i].size);
+		}
+		return key;
+	}
+
+	// ===================================
+	// ------------ Public ---------------
+	// ===================================
+	DeviceObjectCache::DeviceObjectCache()
+	{
+		s_Instance = this;
+	}
+
+	void DeviceObjectCache::Destroy()
+	{
+		auto logicalDevice = InstanceManager::Get()->GetLogicalDevice();
+
+		#ifdef VKAPP_DEBUG
+		if (GetObjectCount() != 0)
+			VKAPP_LOG_WARN("{0} cached device objects were not released before shutdown.", GetObjectCount());
+		#endif
+
+		for (auto& [key, entry] : m_Samplers.Entries)
+			vkDestroySampler(logicalDevice, entry.Handle, nullptr);
+		for (auto& [key, entry] : m_ImageViews.Entries)
+			vkDestroyImageView(logicalDevice, entry.Handle, nullptr);
+		for (auto& [key, entry] : m_PipelineLayouts.Entries)
+			vkDestroyPipelineLayout(logicalDevice, entry.Handle, nullptr);
+		for (auto& [key, entry] : m_DescriptorSetLayouts.Entries)
+			vkDestroyDescriptorSetLayout(logicalDevice, entry.Handle, nullptr);
+
+		m_Samplers = {};
+		m_ImageViews = {};
+		m_PipelineLayouts = {};
+		m_DescriptorSetLayouts = {};
+
+		s_Instance = nullptr;
+	}
+
+	VkSampler DeviceObjectCache::AcquireSampler(const VkSamplerCreateInfo& info)
+	{
+		return Acquire(m_Samplers, GetKey(info), [&]()
+		{
+			VkSampler sampler = VK_NULL_HANDLE;
+			if (vkCreateSampler(InstanceManager::Get()->GetLogicalDevice(), &info, nullptr, &sampler) != VK_SUCCESS)
+				VKAPP_LOG_ERROR("Failed to create sampler!");
+
+			return sampler;
+		});
+	}
+
+	VkImageView DeviceObjectCache::AcquireImageView(const VkImageViewCreateInfo& info)
+	{
+		return Acquire(m_ImageViews, GetKey(info), [&]()
+		{
+			VkImageView imageView = VK_NULL_HANDLE;
+			if (vkCreateImageView(InstanceManager::Get()->GetLogicalDevice(), &info, nullptr, &imageView) != VK_SUCCESS)
+				VKAPP_LOG_ERROR("Failed to create image view!");
+
+			return imageView;
+		});
+	}
+
+	VkDescriptorSetLayout DeviceObjectCache::AcquireDescriptorSetLayout(const VkDescriptorSetLayoutCreateInfo& info)
+	{
+		return Acquire(m_DescriptorSetLayouts, GetKey(info), [&]()
+		{
+			VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+			if (vkCreateDescriptorSetLayout(InstanceManager::Get()->GetLogicalDevice(), &info, nullptr, &layout) != VK_SUCCESS)
+				VKAPP_LOG_ERROR("Failed to create descriptor set layout!");
+
+			return layout;
+		});
+	}
+
+	VkPipelineLayout DeviceObjectCache::AcquirePipelineLayout(const VkPipelineLayoutCreateInfo& info)
+	{
+		return Acquire(m_PipelineLayouts, GetKey(info), [&]()
+		{
+			VkPipelineLayout layout = VK_NULL_HANDLE;
+			if (vkCreatePipelineLayout(InstanceManager::Get()->GetLogicalDevice(), &info, nullptr, &layout) != VK_SUCCESS)
+				VKAPP_LOG_ERROR("Failed to create pipeline layout!");
+
+			return layout;
+		});
+	}
+
+	void DeviceObjectCache::Release(VkSampler sampler)
+	{
+		Release(m_Samplers, sampler, [](VkSampler handle) { vkDestroySampler(InstanceManager::Get()->GetLogicalDevice(), handle, nullptr); });
+	}
+
+	void DeviceObjectCache::Release(VkImageView imageView)
+	{
+		Release(m_ImageViews, imageView, [](VkImageView handle) { vkDestroyImageView(InstanceManager::Get()->GetLogicalDevice(), handle, nullptr); });
+	}
+
+	void DeviceObjectCache::Release(VkDescriptorSetLayout layout)
+	{
+		Release(m_DescriptorSetLayouts, layout, [](VkDescriptorSetLayout handle) { vkDestroyDescriptorSetLayout(InstanceManager::Get()->GetLogicalDevice(), handle, nullptr); });
+	}
+
+	void DeviceObjectCache::Release(VkPipelineLayout layout)
+	{
+		Release(m_PipelineLayouts, layout, [](VkPipelineLayout handle) { vkDestroyPipelineLayout(InstanceManager::Get()->GetLogicalDevice(), handle, nullptr); });
+	}
+
+	size_t DeviceObjectCache::GetObjectCount() const
+	{
+		std::scoped_lock<std::mutex> lock(m_Mutex);
+		return m_Samplers.Entries.size() + m_ImageViews.Entries.size() + m_DescriptorSetLayouts.Entries.size() + m_PipelineLayouts.Entries.size();
+	}
+
+	// ===================================
+	// ------------- Helper --------------
+	// ===================================
+	template<typename T, typename CreateFn>
+	T DeviceObjectCache::Acquire(Cache<T>& cache, std::string&& key, CreateFn&& create)
+	{
+		std::scoped_lock<std::mutex> lock(m_Mutex);
+
+		auto it = cache.Entries.find(key);
+		if (it != cache.Entries.end())
+		{
+			it->second.RefCount++;
+			return it->second.Handle;
+		}
+
+		T handle = create();
+		if (handle == VK_NULL_HANDLE)
+			return handle;
+
+		cache.Keys[handle] = key;
+		cache.Entries[std::move(key)] = { handle, 1 };
+		return handle;
+	}
+
+	template<typename T, typename DestroyFn>
+	void DeviceObjectCache::Release(Cache<T>& cache, T handle, DestroyFn&& destroy)
+	{
+		if (handle == VK_NULL_HANDLE)
+			return;
+
+		std::scoped_lock<std::mutex> lock(m_Mutex);
+
+		auto keyIt = cache.Keys.find(handle);
+		if (keyIt == cache.Keys.end())
+		{
+			VKAPP_LOG_WARN("Released a device object that isn't owned by the DeviceObjectCache.");
+			return;
+		}
+
+		auto it = cache.Entries.find(keyIt->second);
+		if (--it->second.RefCount > 0)
+			return;
+
+		destroy(handle);
+
+		cache.Entries.erase(it);
+		cache.Keys.erase(keyIt);
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <vulkan/vulkan.h>
+
+namespace VkApp
+{
+
+	// Deduplicates samplers, image views, descriptor set layouts and pipeline layouts by their create info.
+	// Every Acquire hands out a shared handle and adds a reference, the object is destroyed when the last
+	// reference is released. Identical layouts end up as the same handle, which keeps descriptor sets
+	// compatible across pipelines.
+	// Note: pNext chains are not part of the key, create those objects directly.
+	class DeviceObjectCache
+	{
+	public:
+		static DeviceObjectCache* Get() { return s_Instance; }
+
+		DeviceObjectCache();
+		void Destroy();
+
+		VkSampler AcquireSampler(const VkSamplerCreateInfo& info);
+		VkImageView AcquireImageView(const VkImageViewCreateInfo& info); // Release views before destroying their image, handles get reused
+		VkDescriptorSetLayout AcquireDescriptorSetLayout(const VkDescriptorSetLayoutCreateInfo& info);
+		VkPipelineLayout AcquirePipelineLayout(const VkPipelineLayoutCreateInfo& info);
+
+		void Release(VkSampler sampler);
+		void Release(VkImageView imageView);
+		void Release(VkDescriptorSetLayout layout);
+		void Release(VkPipelineLayout layout);
+
+		size_t GetObjectCount() const;
+
+	private:
+		static DeviceObjectCache* s_Instance;
+
+	private:
+		template<typename T>
+		struct Cache
+		{
+		public:
+			struct Entry
+			{
+			public:
+				T Handle = VK_NULL_HANDLE;
+				uint32_t RefCount = 0;
+			};
+
+			std::unordered_map<std::string, Entry> Entries = { };
+			std::unordered_map<T, std::string> Keys = { };
+		};
+
+		template<typename T, typename CreateFn>
+		T Acquire(Cache<T>& cache, std::string&& key, CreateFn&& create);
+
+		template<typename T, typename DestroyFn>
+		void Release(Cache<T>& cache, T handle, DestroyFn&& destroy);
+
+	private:
+		mutable std::mutex m_Mutex;
+
+		Cache<VkSampler> m_Samplers = { };
+		Cache<VkImageView> m_ImageViews = { };
+		Cache<VkDescriptorSetLayout> m_DescriptorSetLayouts = { };
+		Cache<VkPipelineLayout> m_PipelineLayouts = { };
+	};
+
+}
\ No newline at end of file
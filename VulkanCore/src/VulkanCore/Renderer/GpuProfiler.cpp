@@ -0,0 +1,299 @@
+#include "vcpch.h"
+#include "GpuProfiler.hpp"
+
+#include <imgui.h>
+
+#include "VulkanCore/Core/Logging.hpp"
+
+#include "VulkanCore/Renderer/Renderer.hpp"
+
+namespace VkApp
+{
+
+	// ===================================
+	// ------------ Static ---------------
+	// ===================================
+	GpuProfiler* GpuProfiler::s_Instance = nullptr;
+
+	// ===================================
+	// ------------ Public ---------------
+	// ===================================
+	GpuProfiler::GpuProfiler()
+	{
+		s_Instance = this;
+
+		// Note: The query pools are created on the first frame, once the frames in flight are known.
+	}
+
+	void GpuProfiler::Destroy()
+	{
+		for (auto& frame : m_Frames)
+			vkDestroyQueryPool(InstanceManager::Get()->GetLogicalDevice(), frame.Pool, nullptr);
+
+		m_Frames.clear();
+		m_Stats.clear();
+		m_StatIndices.clear();
+
+		m_Initialized = false;
+		m_Supported = false;
+
+		s_Instance = nullptr;
+	}
+
+	void GpuProfiler::BeginFrame(VkCommandBuffer& commandBuffer, uint32_t frame)
+	{
+		if (!m_Initialized)
+			m_Supported = Init();
+
+		m_CurrentFrame = UINT32_MAX;
+		if (!m_Supported || frame >= m_Frames.size())
+			return;
+
+		ReadBack(frame);
+
+		m_CurrentFrame = frame;
+		m_OpenZones = 0;
+
+		vkCmdResetQueryPool(commandBuffer, m_Frames[frame].Pool, 0, VKAPP_GPU_PROFILER_MAX_ZONES * 2);
+
+		BeginZone(commandBuffer, "Frame");
+	}
+
+	void GpuProfiler::EndFrame(VkCommandBuffer& commandBuffer)
+	{
+		if (m_CurrentFrame == UINT32_MAX)
+			return;
+
+		EndZone(commandBuffer, 0);
+
+		if (m_OpenZones != 0)
+			VKAPP_LOG_WARN("{0} GPU profiler zone(s) weren't ended.", m_OpenZones);
+
+		m_CurrentFrame = UINT32_MAX;
+	}
+
+	uint32_t GpuProfiler::BeginZone(VkCommandBuffer& commandBuffer, const std::string& name)
+	{
+		if (m_CurrentFrame == UINT32_MAX)
+			return UINT32_MAX;
+
+		FrameQueries& frame = m_Frames[m_CurrentFrame];
+		if (frame.Zones.size() >= VKAPP_GPU_PROFILER_MAX_ZONES)
+			return UINT32_MAX;
+
+		Zone zone = {};
+		zone.Name = name;
+		zone.Depth = m_OpenZones++;
+		zone.BeginQuery = frame.QueryCount++;
+		frame.Zones.push_back(zone);
+
+		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.Pool, zone.BeginQuery);
+		return static_cast<uint32_t>(frame.Zones.size() - 1);
+	}
+
+	void GpuProfiler::EndZone(VkCommandBuffer& commandBuffer, uint32_t zone)
+	{
+		if (m_CurrentFrame == UINT32_MAX || zone == UINT32_MAX)
+			return;
+
+		FrameQueries& frame = m_Frames[m_CurrentFrame];
+		if (zone >= frame.Zones.size() || frame.Zones[zone].EndQuery != UINT32_MAX)
+			return;
+
+		frame.Zones[zone].EndQuery = frame.QueryCount++;
+		m_OpenZones--;
+
+		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.Pool, frame.Zones[zone].EndQuery);
+	}
+
+	void GpuProfiler::DrawImGui()
+	{
+		ImGui::Begin("GPU Profiler");
+
+		if (!m_Supported)
+		{
+			ImGui::TextUnformatted("Timestamps aren't supported on the graphics queue.");
+			ImGui::End();
+			return;
+		}
+
+		if (!m_Stats.empty())
+		{
+			const GpuZoneStats& frame = m_Stats[0];
+			char overlay[32] = {};
+			std::snprintf(overlay, sizeof(overlay), "%.3f ms", frame.LastMs);
+
+			ImGui::PlotLines("##GpuFrame", frame.History.data(), static_cast<int>(frame.History.size()), static_cast<int>(frame.HistoryOffset), overlay, 0.0f, frame.MaxMs * 1.2f, ImVec2(0.0f, 60.0f));
+		}
+
+		if (ImGui::BeginTable("##GpuZones", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV))
+		{
+			ImGui::TableSetupColumn("Zone");
+			ImGui::TableSetupColumn("Last (ms)");
+			ImGui::TableSetupColumn("Avg (ms)");
+			ImGui::TableSetupColumn("Max (ms)");
+			ImGui::TableHeadersRow();
+
+			for (auto& stats : m_Stats)
+			{
+				ImGui::TableNextRow();
+
+				ImGui::TableNextColumn();
+				ImGui::Indent(stats.Depth * 10.0f + 1.0f);
+				ImGui::TextUnformatted(stats.Name.c_str());
+				ImGui::Unindent(stats.Depth * 10.0f + 1.0f);
+
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", stats.LastMs);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", stats.AverageMs);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", stats.MaxMs);
+			}
+
+			ImGui::EndTable();
+		}
+
+		ImGui::End();
+	}
+
+	// ===================================
+	// -------- Initialization -----------
+	// ===================================
+	bool GpuProfiler::Init()
+	{
+		m_Initialized = true;
+
+		InstanceManager* instance = InstanceManager::Get();
+
+		VkPhysicalDeviceProperties properties = {};
+		vkGetPhysicalDeviceProperties(instance->GetPhysicalDevice(), &properties);
+
+		uint32_t familyCount = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(instance->GetPhysicalDevice(), &familyCount, nullptr);
+		std::vector<VkQueueFamilyProperties> families(familyCount);
+		vkGetPhysicalDeviceQueueFamilyProperties(instance->GetPhysicalDevice(), &familyCount, families.data());
+
+		// Note: Same family the graphics queue gets picked from, the first one with graphics support.
+		uint32_t validBits = 0;
+		for (auto& family : families)
+		{
+			if (family.queueFlags & VK_QUEUE_GRAPHICS_BIT)
+			{
+				validBits = family.timestampValidBits;
+				break;
+			}
+		}
+
+		if (validBits == 0 || properties.limits.timestampPeriod == 0.0f)
+		{
+			VKAPP_LOG_WARN("The graphics queue doesn't support timestamps, GPU profiling is disabled.");
+			return false;
+		}
+
+		m_TimestampPeriod = properties.limits.timestampPeriod;
+		m_TimestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+		VkQueryPoolCreateInfo poolInfo = {};
+		poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		poolInfo.queryCount = VKAPP_GPU_PROFILER_MAX_ZONES * 2;
+
+		m_Frames.resize(Renderer::Get()->GetFramesInFlight());
+		for (auto& frame : m_Frames)
+		{
+			if (vkCreateQueryPool(instance->GetLogicalDevice(), &poolInfo, nullptr, &frame.Pool) != VK_SUCCESS)
+			{
+				VKAPP_LOG_ERROR("Failed to create timestamp query pool!");
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// ===================================
+	// ------------- Helper --------------
+	// ===================================
+	void GpuProfiler::ReadBack(uint32_t frame)
+	{
+		FrameQueries& queries = m_Frames[frame];
+		if (queries.QueryCount == 0)
+			return;
+
+		std::vector<uint64_t> timestamps(queries.QueryCount);
+		VkResult result = vkGetQueryPoolResults(InstanceManager::Get()->GetLogicalDevice(), queries.Pool, 0, queries.QueryCount, timestamps.size() * sizeof(uint64_t), timestamps.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+
+		std::vector<Zone> zones = std::move(queries.Zones);
+		queries.Zones.clear();
+		queries.QueryCount = 0;
+
+		// Note: Not ready means the frame never got submitted, there's nothing to read then.
+		if (result != VK_SUCCESS)
+			return;
+
+		std::vector<float> times(m_Stats.size(), 0.0f);
+
+		for (auto& zone : zones)
+		{
+			if (zone.EndQuery == UINT32_MAX)
+				continue;
+
+			uint64_t ticks = ((timestamps[zone.EndQuery] & m_TimestampMask) - (timestamps[zone.BeginQuery] & m_TimestampMask)) & m_TimestampMask;
+			float ms = static_cast<float>(static_cast<double>(ticks) * m_TimestampPeriod / 1000000.0);
+
+			auto it = m_StatIndices.find(zone.Name);
+			if (it == m_StatIndices.end())
+			{
+				GpuZoneStats stats = {};
+				stats.Name = zone.Name;
+				stats.Depth = zone.Depth;
+				stats.History.assign(VKAPP_GPU_PROFILER_HISTORY, 0.0f);
+
+				it = m_StatIndices.emplace(zone.Name, m_Stats.size()).first;
+				m_Stats.push_back(stats);
+				times.push_back(0.0f);
+			}
+
+			times[it->second] += ms;
+		}
+
+		for (size_t i = 0; i < m_Stats.size(); i++)
+		{
+			GpuZoneStats& stats = m_Stats[i];
+
+			stats.LastMs = times[i];
+			stats.History[stats.HistoryOffset] = times[i];
+			stats.HistoryOffset = (stats.HistoryOffset + 1) % VKAPP_GPU_PROFILER_HISTORY;
+			stats.HistoryCount = std::min(stats.HistoryCount + 1, VKAPP_GPU_PROFILER_HISTORY);
+
+			float total = 0.0f;
+			stats.MaxMs = 0.0f;
+			for (float time : stats.History)
+			{
+				total += time;
+				stats.MaxMs = std::max(stats.MaxMs, time);
+			}
+
+			// Note: Entries that aren't filled yet are 0, so they only count towards the total once they are.
+			stats.AverageMs = total / stats.HistoryCount;
+		}
+	}
+
+	// ===================================
+	// ------------- Zone ----------------
+	// ===================================
+	GpuZone::GpuZone(VkCommandBuffer& commandBuffer, const std::string& name)
+		: m_CommandBuffer(commandBuffer)
+	{
+		if (GpuProfiler::Get())
+			m_Zone = GpuProfiler::Get()->BeginZone(commandBuffer, name);
+	}
+
+	GpuZone::~GpuZone()
+	{
+		if (GpuProfiler::Get())
+			GpuProfiler::Get()->EndZone(m_CommandBuffer, m_Zone);
+	}
+
+}
\ No newline at end of file
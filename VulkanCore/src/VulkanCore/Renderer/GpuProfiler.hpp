@@ -0,0 +1,113 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include <vulkan/vulkan.h>
+
+namespace VkApp
+{
+
+	#define VKAPP_GPU_PROFILER_MAX_ZONES 256u		// Per frame, zones past this aren't timed
+	#define VKAPP_GPU_PROFILER_HISTORY 120u			// Frames kept for the rolling averages
+
+	struct GpuZoneStats
+	{
+	public:
+		std::string Name = {};
+		uint32_t Depth = 0;
+
+		float LastMs = 0.0f;	// Summed over every time the zone ran in the frame
+		float AverageMs = 0.0f;
+		float MaxMs = 0.0f;
+
+		std::vector<float> History = { }; // Ring buffer, HistoryOffset is the oldest entry
+		uint32_t HistoryOffset = 0;
+		uint32_t HistoryCount = 0; // Filled entries, zones that showed up recently don't have a full history yet
+	};
+
+	// Timestamp queries, one pool per frame in flight. A pool is read back when its frame slot comes
+	// around again, by then the timeline wait in Renderer::BeginFrame() has made sure it's done.
+	// The renderer times the whole frame, every render graph pass and every layer's queued functions.
+	class GpuProfiler
+	{
+	public:
+		static GpuProfiler* Get() { return s_Instance; }
+
+		GpuProfiler();
+		void Destroy();
+
+		// Called by the renderer around the command buffer of a frame.
+		void BeginFrame(VkCommandBuffer& commandBuffer, uint32_t frame);
+		void EndFrame(VkCommandBuffer& commandBuffer);
+
+		// Returns UINT32_MAX when the zone can't be timed, EndZone() ignores that.
+		uint32_t BeginZone(VkCommandBuffer& commandBuffer, const std::string& name);
+		void EndZone(VkCommandBuffer& commandBuffer, uint32_t zone);
+
+		inline bool IsSupported() const { return m_Supported; }
+
+		// In the order they were first seen, the first one is the whole frame.
+		inline const std::vector<GpuZoneStats>& GetStats() const { return m_Stats; }
+		inline float GetFrameMs() const { return m_Stats.empty() ? 0.0f : m_Stats[0].LastMs; }
+
+		// Draws the "GPU Profiler" window, call it from a layer's OnImGuiRender().
+		void DrawImGui();
+
+	private:
+		bool Init();
+		void ReadBack(uint32_t frame);
+
+	private:
+		static GpuProfiler* s_Instance;
+
+	private:
+		struct Zone
+		{
+		public:
+			std::string Name = {};
+			uint32_t Depth = 0;
+			uint32_t BeginQuery = 0;
+			uint32_t EndQuery = UINT32_MAX; // Not ended
+		};
+
+		struct FrameQueries
+		{
+		public:
+			VkQueryPool Pool = VK_NULL_HANDLE;
+			std::vector<Zone> Zones = { };
+			uint32_t QueryCount = 0;
+		};
+
+		bool m_Initialized = false;
+		bool m_Supported = false;
+
+		float m_TimestampPeriod = 1.0f;		// Nanoseconds per tick
+		uint64_t m_TimestampMask = ~0ull;	// Only the valid bits
+
+		std::vector<FrameQueries> m_Frames = { };
+		uint32_t m_CurrentFrame = UINT32_MAX;
+		uint32_t m_OpenZones = 0;
+
+		std::vector<GpuZoneStats> m_Stats = { };
+		std::unordered_map<std::string, size_t> m_StatIndices = { };
+	};
+
+	// Times everything recorded in its scope.
+	class GpuZone
+	{
+	public:
+		GpuZone(VkCommandBuffer& commandBuffer, const std::string& name);
+		~GpuZone();
+
+	private:
+		VkCommandBuffer& m_CommandBuffer;
+		uint32_t m_Zone = UINT32_MAX;
+	};
+
+	#define VKAPP_GPU_ZONE_CONCAT_INNER(a, b) a##b
+	#define VKAPP_GPU_ZONE_CONCAT(a, b) VKAPP_GPU_ZONE_CONCAT_INNER(a, b)
+	#define VKAPP_GPU_ZONE(commandBuffer, name) ::VkApp::GpuZone VKAPP_GPU_ZONE_CONCAT(gpuZone, __LINE__)(commandBuffer, name)
+
+}
\ No newline at end of file
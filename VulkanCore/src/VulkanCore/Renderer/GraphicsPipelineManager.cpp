@@ -10,6 +10,7 @@
 
 #include "VulkanCore/Renderer/Renderer.hpp"
 #include "VulkanCore/Renderer/InstanceManager.hpp" // For the retrieval of the logical device
+#include "VulkanCore/Renderer/DeviceObjectCache.hpp"
 #include "VulkanCore/Renderer/SwapChainManager.hpp"
 
 namespace VkApp
@@ -41,7 +42,7 @@ namespace VkApp
 		for (auto& descriptor : descriptors)
 		{
 			if (descriptor.DescriptorType == type)
-				count++;
+				count += descriptor.DescriptorCount; // Note: Arrays take one descriptor per element.
 		}
 
 		return count;
@@ -68,15 +69,14 @@ namespace VkApp
 		layoutInfo.bindingCount = static_cast<uint32_t>(descriptors.size());
 		layoutInfo.pBindings = layouts.data();
 
-		VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
-		if (vkCreateDescriptorSetLayout(s_InstanceManager->GetLogicalDevice(), &layoutInfo, nullptr, &descriptorSetLayout) != VK_SUCCESS)
-			VKAPP_LOG_ERROR("Failed to create descriptor set layout!");
-
-		return descriptorSetLayout;
+		// Note: Shared through the DeviceObjectCache, release it instead of destroying it.
+		return DeviceObjectCache::Get()->AcquireDescriptorSetLayout(layoutInfo);
 	}
 
 	VkDescriptorPool DescriptorSets::CreatePool(const std::vector<DescriptorInfo>& descriptors)
 	{
+		uint32_t framesInFlight = Renderer::Get()->GetFramesInFlight();
+
 		std::vector<VkDescriptorPoolSize> poolSizes = { };
 		poolSizes.resize(DescriptorSets::GetUniqueTypes(descriptors).size());
 		poolSizes.clear(); // Note(Jorben): For some reason without this line there is a VK_SAMPLER or something in the list.
@@ -85,7 +85,7 @@ namespace VkApp
 		{
 			VkDescriptorPoolSize poolSize = {};
 			poolSize.type = type;
-			poolSize.descriptorCount = DescriptorSets::AmountOf(type, descriptors) * VKAPP_MAX_FRAMES_IN_FLIGHT;
+			poolSize.descriptorCount = DescriptorSets::AmountOf(type, descriptors) * framesInFlight;
 
 			poolSizes.push_back(poolSize);
 		}
@@ -94,7 +94,7 @@ namespace VkApp
 		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
 		poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
 		poolInfo.pPoolSizes = poolSizes.data();
-		poolInfo.maxSets = static_cast<uint32_t>(VKAPP_MAX_FRAMES_IN_FLIGHT); // Amount of sets?
+		poolInfo.maxSets = framesInFlight; // Amount of sets?
 
 		VkDescriptorPool pool = VK_NULL_HANDLE;
 		if (vkCreateDescriptorPool(s_InstanceManager->GetLogicalDevice(), &poolInfo, nullptr, &pool) != VK_SUCCESS)
@@ -105,16 +105,18 @@ namespace VkApp
 
 	std::vector<VkDescriptorSet> DescriptorSets::CreateDescriptorSets(VkDescriptorSetLayout& layout, VkDescriptorPool& pool, const std::vector<DescriptorInfo>& descriptors)
 	{
-		std::vector<VkDescriptorSetLayout> layouts(VKAPP_MAX_FRAMES_IN_FLIGHT, layout);
+		uint32_t framesInFlight = Renderer::Get()->GetFramesInFlight();
+
+		std::vector<VkDescriptorSetLayout> layouts(framesInFlight, layout);
 
 		VkDescriptorSetAllocateInfo allocInfo = {};
 		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
 		allocInfo.descriptorPool = pool;
-		allocInfo.descriptorSetCount = static_cast<uint32_t>(VKAPP_MAX_FRAMES_IN_FLIGHT);
+		allocInfo.descriptorSetCount = framesInFlight;
 		allocInfo.pSetLayouts = layouts.data();
 
 		std::vector<VkDescriptorSet> descriptorSets = { };
-		descriptorSets.resize(VKAPP_MAX_FRAMES_IN_FLIGHT);
+		descriptorSets.resize(framesInFlight);
 
 		if (vkAllocateDescriptorSets(s_InstanceManager->GetLogicalDevice(), &allocInfo, descriptorSets.data()) != VK_SUCCESS)
 			VKAPP_LOG_ERROR("Failed to allocate descriptor sets!");
@@ -176,6 +178,11 @@ namespace VkApp
 			pipeline.second.Destroy();
 			//m_GraphicsPipelines.erase(pipeline.first);
 		}
+
+		for (auto& pipeline : m_ComputePipelines)
+			pipeline.second.Destroy();
+
+		m_ComputePipelines.clear();
 	}
 
 	GraphicsPipeline& GraphicsPipelineManager::CreatePipeline(const std::string& id, const PipelineInfo& info)
@@ -187,6 +194,40 @@ namespace VkApp
 		return m_GraphicsPipelines[id];
 	}
 
+	ComputePipeline& GraphicsPipelineManager::GetComputePipeline(const std::string& id)
+	{
+		auto it = m_ComputePipelines.find(id);
+
+		if (it == m_ComputePipelines.end())
+		{
+			VKAPP_LOG_WARN("Compute Pipeline by ID \"{0}\" not found", id);
+
+			static ComputePipeline empty = {};
+			return empty;
+		}
+
+		return it->second;
+	}
+
+	void GraphicsPipelineManager::DestroyComputePipeline(const std::string& id)
+	{
+		auto it = m_ComputePipelines.find(id);
+		if (it == m_ComputePipelines.end())
+			return;
+
+		it->second.Destroy();
+		m_ComputePipelines.erase(it);
+	}
+
+	ComputePipeline& GraphicsPipelineManager::CreateComputePipeline(const std::string& id, const ComputePipelineInfo& info)
+	{
+		ComputePipeline pipeline(info);
+
+		m_ComputePipelines[id] = pipeline;
+
+		return m_ComputePipelines[id];
+	}
+
 	std::vector<char> GraphicsPipelineManager::ReadFile(const std::filesystem::path& path)
 	{
 		std::ifstream file(path, std::ios::ate | std::ios::binary);
@@ -240,7 +281,7 @@ namespace VkApp
 		vkDeviceWaitIdle(s_InstanceManager->m_Device);
 
 		vkDestroyPipeline(s_InstanceManager->m_Device, m_GraphicsPipeline, nullptr);
-		vkDestroyPipelineLayout(s_InstanceManager->m_Device, m_PipelineLayout, nullptr);
+		DeviceObjectCache::Get()->Release(m_PipelineLayout);
 
 		for (auto& pool : m_DescriptorPools)
 		{
@@ -249,8 +290,15 @@ namespace VkApp
 
 		for (auto& layout : m_DescriptorLayouts)
 		{
-			vkDestroyDescriptorSetLayout(s_InstanceManager->m_Device, layout, nullptr);
+			DeviceObjectCache::Get()->Release(layout);
 		}
+
+		// Note: The layouts are shared now, a second Destroy must not release them again.
+		m_GraphicsPipeline = VK_NULL_HANDLE;
+		m_PipelineLayout = VK_NULL_HANDLE;
+		m_DescriptorPools.clear();
+		m_DescriptorLayouts.clear();
+		m_DescriptorSets.clear();
 	}
 
 	void GraphicsPipeline::Bind(VkCommandBuffer& buffer, VkPipelineBindPoint bindPoint)
@@ -331,12 +379,14 @@ namespace VkApp
 		colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
 		colorBlendAttachment.blendEnable = VK_FALSE; // Note(Jorben): Set true for transparancy
 
+		std::vector<VkPipelineColorBlendAttachmentState> colorBlendAttachments(info.ColorAttachmentCount, colorBlendAttachment);
+
 		VkPipelineColorBlendStateCreateInfo colorBlending = {};
 		colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
 		colorBlending.logicOpEnable = VK_FALSE;
 		colorBlending.logicOp = VK_LOGIC_OP_COPY;
-		colorBlending.attachmentCount = 1;
-		colorBlending.pAttachments = &colorBlendAttachment;
+		colorBlending.attachmentCount = static_cast<uint32_t>(colorBlendAttachments.size());
+		colorBlending.pAttachments = colorBlendAttachments.data();
 		colorBlending.blendConstants[0] = 0.0f;
 		colorBlending.blendConstants[1] = 0.0f;
 		colorBlending.blendConstants[2] = 0.0f;
@@ -370,8 +420,7 @@ namespace VkApp
 		pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(m_DescriptorLayouts.size());					// TODO(Jorben): Remove?
 		pipelineLayoutInfo.pSetLayouts = m_DescriptorLayouts.data();	// TODO(Jorben): Remove?
 
-		if (vkCreatePipelineLayout(s_InstanceManager->m_Device, &pipelineLayoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
-			VKAPP_LOG_ERROR("Failed to create pipeline layout!");
+		m_PipelineLayout = DeviceObjectCache::Get()->AcquirePipelineLayout(pipelineLayoutInfo);
 
 		// Create the actual graphics pipeline (where we actually use the shaders and other info)
 		VkGraphicsPipelineCreateInfo pipelineInfo = {};
@@ -387,7 +436,7 @@ namespace VkApp
 		pipelineInfo.pColorBlendState = &colorBlending;
 		pipelineInfo.pDynamicState = &dynamicState;
 		pipelineInfo.layout = m_PipelineLayout;
-		pipelineInfo.renderPass = SwapChainManager::Get()->GetRenderPass();
+		pipelineInfo.renderPass = info.RenderPass != VK_NULL_HANDLE ? info.RenderPass : SwapChainManager::Get()->GetRenderPass();
 		pipelineInfo.subpass = 0;
 		pipelineInfo.basePipelineHandle = VK_NULL_HANDLE; // Optional
 		pipelineInfo.basePipelineIndex = -1; // Optional
@@ -424,6 +473,112 @@ namespace VkApp
 			m_DescriptorSets.push_back(DescriptorSets::CreateDescriptorSets(m_DescriptorLayouts[3], m_DescriptorPools[3], info.DescriptorSets.Set3));
 	}
 
+	ComputePipeline::ComputePipeline(const ComputePipelineInfo& info)
+	{
+		CreateDescriptorSetLayout(info);
+		CreateComputePipeline(info);
+		CreateDescriptorPool(info);
+		CreateDescriptorSets(info);
+	}
+
+	void ComputePipeline::Destroy()
+	{
+		vkDeviceWaitIdle(s_InstanceManager->GetLogicalDevice());
+
+		vkDestroyPipeline(s_InstanceManager->GetLogicalDevice(), m_ComputePipeline, nullptr);
+		DeviceObjectCache::Get()->Release(m_PipelineLayout);
+
+		for (auto& pool : m_DescriptorPools)
+			vkDestroyDescriptorPool(s_InstanceManager->GetLogicalDevice(), pool, nullptr);
+
+		for (auto& layout : m_DescriptorLayouts)
+			DeviceObjectCache::Get()->Release(layout);
+
+		m_ComputePipeline = VK_NULL_HANDLE;
+		m_PipelineLayout = VK_NULL_HANDLE;
+		m_DescriptorPools.clear();
+		m_DescriptorLayouts.clear();
+		m_DescriptorSets.clear();
+	}
+
+	void ComputePipeline::Bind(VkCommandBuffer& buffer)
+	{
+		vkCmdBindPipeline(buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_ComputePipeline);
+	}
+
+	void ComputePipeline::CreateDescriptorSetLayout(const ComputePipelineInfo& info)
+	{
+		if (!info.DescriptorSets.Set0.empty())
+			m_DescriptorLayouts.push_back(DescriptorSets::GetDescriptorSetLayout(info.DescriptorSets.Set0));
+		if (!info.DescriptorSets.Set1.empty())
+			m_DescriptorLayouts.push_back(DescriptorSets::GetDescriptorSetLayout(info.DescriptorSets.Set1));
+		if (!info.DescriptorSets.Set2.empty())
+			m_DescriptorLayouts.push_back(DescriptorSets::GetDescriptorSetLayout(info.DescriptorSets.Set2));
+		if (!info.DescriptorSets.Set3.empty())
+			m_DescriptorLayouts.push_back(DescriptorSets::GetDescriptorSetLayout(info.DescriptorSets.Set3));
+	}
+
+	void ComputePipeline::CreateComputePipeline(const ComputePipelineInfo& info)
+	{
+		VkShaderModule shaderModule = GraphicsPipelineManager::CreateShaderModule(info.ComputeShader);
+
+		VkPipelineShaderStageCreateInfo stageInfo = {};
+		stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		stageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		stageInfo.module = shaderModule;
+		stageInfo.pName = "main";
+
+		VkPushConstantRange pushConstantRange = {};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		pushConstantRange.offset = 0;
+		pushConstantRange.size = info.PushConstantSize;
+
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(m_DescriptorLayouts.size());
+		pipelineLayoutInfo.pSetLayouts = m_DescriptorLayouts.data();
+		pipelineLayoutInfo.pushConstantRangeCount = info.PushConstantSize > 0 ? 1 : 0;
+		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+		m_PipelineLayout = DeviceObjectCache::Get()->AcquirePipelineLayout(pipelineLayoutInfo);
+
+		VkComputePipelineCreateInfo pipelineInfo = {};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage = stageInfo;
+		pipelineInfo.layout = m_PipelineLayout;
+		pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+		pipelineInfo.basePipelineIndex = -1;
+
+		if (vkCreateComputePipelines(s_InstanceManager->GetLogicalDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_ComputePipeline) != VK_SUCCESS)
+			VKAPP_LOG_ERROR("Failed to create compute pipeline!");
+
+		vkDestroyShaderModule(s_InstanceManager->GetLogicalDevice(), shaderModule, nullptr);
+	}
+
+	void ComputePipeline::CreateDescriptorPool(const ComputePipelineInfo& info)
+	{
+		if (!info.DescriptorSets.Set0.empty())
+			m_DescriptorPools.push_back(DescriptorSets::CreatePool(info.DescriptorSets.Set0));
+		if (!info.DescriptorSets.Set1.empty())
+			m_DescriptorPools.push_back(DescriptorSets::CreatePool(info.DescriptorSets.Set1));
+		if (!info.DescriptorSets.Set2.empty())
+			m_DescriptorPools.push_back(DescriptorSets::CreatePool(info.DescriptorSets.Set2));
+		if (!info.DescriptorSets.Set3.empty())
+			m_DescriptorPools.push_back(DescriptorSets::CreatePool(info.DescriptorSets.Set3));
+	}
+
+	void ComputePipeline::CreateDescriptorSets(const ComputePipelineInfo& info)
+	{
+		if (!info.DescriptorSets.Set0.empty())
+			m_DescriptorSets.push_back(DescriptorSets::CreateDescriptorSets(m_DescriptorLayouts[0], m_DescriptorPools[0], info.DescriptorSets.Set0));
+		if (!info.DescriptorSets.Set1.empty())
+			m_DescriptorSets.push_back(DescriptorSets::CreateDescriptorSets(m_DescriptorLayouts[1], m_DescriptorPools[1], info.DescriptorSets.Set1));
+		if (!info.DescriptorSets.Set2.empty())
+			m_DescriptorSets.push_back(DescriptorSets::CreateDescriptorSets(m_DescriptorLayouts[2], m_DescriptorPools[2], info.DescriptorSets.Set2));
+		if (!info.DescriptorSets.Set3.empty())
+			m_DescriptorSets.push_back(DescriptorSets::CreateDescriptorSets(m_DescriptorLayouts[3], m_DescriptorPools[3], info.DescriptorSets.Set3));
+	}
+
 	void GraphicsPipelineManager::CreateImGuiDescriptorPool()
 	{
 		std::vector<VkDescriptorPoolSize> poolSizes =
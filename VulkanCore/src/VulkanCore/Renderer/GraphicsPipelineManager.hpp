@@ -50,6 +50,18 @@ namespace VkApp
 		std::vector<VkVertexInputAttributeDescription> VertexAttributeDescriptions = { };
 
 		DescriptorSets DescriptorSets = {};
+
+		VkRenderPass RenderPass = VK_NULL_HANDLE; // Defaults to the swapchain's render pass, see RenderGraph::GetRenderPass for other passes
+		uint32_t ColorAttachmentCount = 1;
+	};
+
+	struct ComputePipelineInfo
+	{
+	public:
+		std::vector<char> ComputeShader = { };
+		uint32_t PushConstantSize = 0; // Accessible from the compute stage, starting at offset 0
+
+		DescriptorSets DescriptorSets = {};
 	};
 
 	class GraphicsPipelineManager;
@@ -86,6 +98,36 @@ namespace VkApp
 		friend class GraphicsPipelineManager;
 	};
 
+	class ComputePipeline
+	{
+	public:
+		ComputePipeline() = default;
+		ComputePipeline(const ComputePipelineInfo& info);
+		void Destroy();
+
+		void Bind(VkCommandBuffer& buffer);
+
+		inline VkPipelineLayout& GetPipelineLayout() { return m_PipelineLayout; }
+		inline std::vector<VkDescriptorPool>& GetDescriptorPools() { return m_DescriptorPools; }
+		inline std::vector<std::vector<VkDescriptorSet>>& GetDescriptorSets() { return m_DescriptorSets; }
+
+	private: // Helper functions
+		void CreateDescriptorSetLayout(const ComputePipelineInfo& info);
+		void CreateComputePipeline(const ComputePipelineInfo& info);
+		void CreateDescriptorPool(const ComputePipelineInfo& info);
+		void CreateDescriptorSets(const ComputePipelineInfo& info);
+
+	private:
+		VkPipeline m_ComputePipeline = VK_NULL_HANDLE;
+		VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
+
+		std::vector<VkDescriptorSetLayout> m_DescriptorLayouts = { };
+		std::vector<VkDescriptorPool> m_DescriptorPools = { };
+		std::vector<std::vector<VkDescriptorSet>> m_DescriptorSets = { };
+
+		friend class GraphicsPipelineManager;
+	};
+
 	class GraphicsPipelineManager
 	{
 	public: // Public functions
@@ -101,6 +143,12 @@ namespace VkApp
 
 		GraphicsPipeline& CreatePipeline(const std::string& id, const PipelineInfo& info);
 
+		ComputePipeline& GetComputePipeline(const std::string& id);
+		inline bool HasComputePipeline(const std::string& id) const { return m_ComputePipelines.find(id) != m_ComputePipelines.end(); }
+
+		void DestroyComputePipeline(const std::string& id);
+		ComputePipeline& CreateComputePipeline(const std::string& id, const ComputePipelineInfo& info);
+
 		inline VkDescriptorPool& GetImGuiPool() { return m_ImGuiDescriptorPool; }
 		
 		static std::vector<char> ReadFile(const std::filesystem::path& path);
@@ -116,6 +164,7 @@ namespace VkApp
 		VkDescriptorPool m_ImGuiDescriptorPool = VK_NULL_HANDLE;
 
 		std::unordered_map<std::string, GraphicsPipeline> m_GraphicsPipelines = {};
+		std::unordered_map<std::string, ComputePipeline> m_ComputePipelines = {};
 
 		friend class Renderer;
 		friend class InstanceManager;
@@ -74,6 +74,7 @@ namespace VkApp
 	InstanceManager::InstanceManager()
 	{
 		s_Instance = this;
+		m_Headless = Application::Get().GetWindow().IsHeadless();
 
 		CreateInstance();
 		CreateDebugger();
@@ -84,6 +85,8 @@ namespace VkApp
 
 	void InstanceManager::Destroy()
 	{
+		m_GraphicsTimeline.Destroy();
+
 		s_Instance = nullptr;
 
 		// Wait for the logical device to finish it's tasks
@@ -95,7 +98,8 @@ namespace VkApp
 		DestroyDebugUtilsMessengerEXT(m_Instance, m_DebugMessenger, nullptr);
 		#endif
 
-		vkDestroySurfaceKHR(m_Instance, m_Surface, nullptr);
+		if (m_Surface != VK_NULL_HANDLE)
+			vkDestroySurfaceKHR(m_Instance, m_Surface, nullptr);
 		vkDestroyInstance(m_Instance, nullptr);
 	}
 
@@ -114,7 +118,7 @@ namespace VkApp
 		appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
 		appInfo.pEngineName = "No Engine";
 		appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-		appInfo.apiVersion = VK_API_VERSION_1_0;
+		appInfo.apiVersion = VK_API_VERSION_1_2; // Note: 1.2 for timeline semaphores
 
 		auto extensions = GetRequiredExtensions();
 
@@ -167,6 +171,9 @@ namespace VkApp
 
 	void InstanceManager::CreateSurface()
 	{
+		if (m_Headless)
+			return;
+
 		GLFWwindow* handle = reinterpret_cast<GLFWwindow*>(Application::Get().GetWindow().GetNativeWindow());
 
 		if (glfwCreateWindowSurface(m_Instance, handle, nullptr, &m_Surface) != VK_SUCCESS)
@@ -216,16 +223,39 @@ namespace VkApp
 			queueCreateInfos.push_back(queueCreateInfo);
 		}
 
+		VkPhysicalDeviceFeatures supportedFeatures = {};
+		vkGetPhysicalDeviceFeatures(m_PhysicalDevice, &supportedFeatures);
+
+		m_TextureCompressionBCSupported = supportedFeatures.textureCompressionBC;
+		m_FragmentStoresSupported = supportedFeatures.fragmentStoresAndAtomics;
+
 		VkPhysicalDeviceFeatures deviceFeatures = {};
 		deviceFeatures.samplerAnisotropy = VK_TRUE;
+		deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC; // Optional, cooked textures fall back to RGBA8 without it
+		deviceFeatures.fragmentStoresAndAtomics = supportedFeatures.fragmentStoresAndAtomics; // Optional, needed for virtual texture feedback
 
 		VkDeviceCreateInfo createInfo = {};
 		createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
 		createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
 		createInfo.pQueueCreateInfos = queueCreateInfos.data();
 		createInfo.pEnabledFeatures = &deviceFeatures;
-		createInfo.enabledExtensionCount = static_cast<uint32_t>(s_RequestedDeviceExtensions.size());
-		createInfo.ppEnabledExtensionNames = s_RequestedDeviceExtensions.data();
+
+		VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures = {};
+		timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+		timelineFeatures.timelineSemaphore = VK_TRUE;
+		createInfo.pNext = &timelineFeatures;
+
+		// Optional extensions, only enabled when the device has them
+		std::vector<const char*> extensions = { };
+		if (!m_Headless)
+			extensions = s_RequestedDeviceExtensions;
+
+		m_MemoryBudgetSupported = ExtensionSupported(m_PhysicalDevice, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+		if (m_MemoryBudgetSupported)
+			extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
+		createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+		createInfo.ppEnabledExtensionNames = extensions.data();
 
 		#if VKAPP_VALIDATION_LAYERS
 		createInfo.enabledLayerCount = static_cast<uint32_t>(s_RequestedValidationLayers.size());
@@ -240,6 +270,8 @@ namespace VkApp
 		// Retrieve the graphics & present queue handle
 		vkGetDeviceQueue(m_Device, indices.GraphicsFamily.value(), 0, &m_GraphicsQueue);
 		vkGetDeviceQueue(m_Device, indices.PresentFamily.value(), 0, &m_PresentQueue);
+
+		m_GraphicsTimeline.Init(m_GraphicsQueue);
 	}
 
 	// ===================================
@@ -276,11 +308,17 @@ namespace VkApp
 
 	std::vector<const char*> InstanceManager::GetRequiredExtensions()
 	{
-		uint32_t glfwExtensionCount = 0;
-		const char** glfwExtensions;
-		glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+		std::vector<const char*> extensions = { };
 
-		std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+		// Note: Headless has no surface, so GLFW (which isn't even initialized then) has nothing to add.
+		if (!m_Headless)
+		{
+			uint32_t glfwExtensionCount = 0;
+			const char** glfwExtensions;
+			glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+
+			extensions.insert(extensions.end(), glfwExtensions, glfwExtensions + glfwExtensionCount);
+		}
 
 		#if VKAPP_VALIDATION_LAYERS
 		extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
@@ -295,10 +333,10 @@ namespace VkApp
 	{
 		QueueFamilyIndices indices = FindQueueFamilies(device);
 
-		bool extensionsSupported = ExtensionsSupported(device);
-		bool swapChainAdequate = false;
+		bool extensionsSupported = m_Headless || ExtensionsSupported(device);
+		bool swapChainAdequate = m_Headless;
 
-		if (extensionsSupported)
+		if (extensionsSupported && !m_Headless)
 		{
 			SwapChainSupportDetails swapChainSupport = QuerySwapChainSupport(device);
 			swapChainAdequate = !swapChainSupport.Formats.empty() && !swapChainSupport.PresentModes.empty();
@@ -307,7 +345,25 @@ namespace VkApp
 		VkPhysicalDeviceFeatures supportedFeatures;
 		vkGetPhysicalDeviceFeatures(device, &supportedFeatures);
 
-		return indices.IsComplete() && extensionsSupported && swapChainAdequate && supportedFeatures.samplerAnisotropy;
+		VkPhysicalDeviceProperties properties = {};
+		vkGetPhysicalDeviceProperties(device, &properties);
+
+		// Frame pacing and uploads are built on timeline semaphores.
+		VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures = {};
+		timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+
+		VkPhysicalDeviceFeatures2 features2 = {};
+		features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		features2.pNext = &timelineFeatures;
+
+		bool timelineSupported = properties.apiVersion >= VK_API_VERSION_1_2;
+		if (timelineSupported)
+		{
+			vkGetPhysicalDeviceFeatures2(device, &features2);
+			timelineSupported = timelineFeatures.timelineSemaphore;
+		}
+
+		return indices.IsComplete() && extensionsSupported && swapChainAdequate && supportedFeatures.samplerAnisotropy && timelineSupported;
 	}
 
 	bool InstanceManager::ExtensionsSupported(const VkPhysicalDevice& device)
@@ -327,6 +383,23 @@ namespace VkApp
 		return requiredExtensions.empty();
 	}
 
+	bool InstanceManager::ExtensionSupported(const VkPhysicalDevice& device, const char* extension)
+	{
+		uint32_t extensionCount;
+		vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+
+		std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+		vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+
+		for (const auto& properties : availableExtensions)
+		{
+			if (strcmp(extension, properties.extensionName) == 0)
+				return true;
+		}
+
+		return false;
+	}
+
 	InstanceManager::QueueFamilyIndices InstanceManager::FindQueueFamilies(const VkPhysicalDevice& device)
 	{
 		QueueFamilyIndices indices;
@@ -347,6 +420,14 @@ namespace VkApp
 			if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)
 				indices.GraphicsFamily = i;
 
+			// Note: Nothing gets presented when headless, the "present" queue is just the graphics queue.
+			if (m_Headless)
+			{
+				indices.PresentFamily = indices.GraphicsFamily;
+				i++;
+				continue;
+			}
+
 			VkBool32 presentSupport = false;
 			vkGetPhysicalDeviceSurfaceSupportKHR(device, i, m_Surface, &presentSupport);
 			if (presentSupport)
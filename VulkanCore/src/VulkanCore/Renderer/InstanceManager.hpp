@@ -5,6 +5,8 @@
 
 #include <vulkan/vulkan.h>
 
+#include "VulkanCore/Renderer/QueueTimeline.hpp"
+
 namespace VkApp
 {
 
@@ -28,6 +30,13 @@ namespace VkApp
 		inline VkDevice& GetLogicalDevice() { return m_Device; }
 
 		inline VkQueue& GetGraphicsQueue() { return m_GraphicsQueue; }
+		inline QueueTimeline& GetGraphicsTimeline() { return m_GraphicsTimeline; } // Submit to the graphics queue through this
+
+		inline bool IsHeadless() const { return m_Headless; } // No surface and no swapchain extension
+
+		inline bool IsMemoryBudgetSupported() const { return m_MemoryBudgetSupported; }
+		inline bool IsTextureCompressionBCSupported() const { return m_TextureCompressionBCSupported; }
+		inline bool IsFragmentStoresSupported() const { return m_FragmentStoresSupported; }
 
 	private: // Initialization functions
 		void CreateInstance();
@@ -41,6 +50,7 @@ namespace VkApp
 		std::vector<const char*> GetRequiredExtensions();
 		bool PhysicalDeviceSuitable(const VkPhysicalDevice& device);
 		bool ExtensionsSupported(const VkPhysicalDevice& device);
+		bool ExtensionSupported(const VkPhysicalDevice& device, const char* extension);
 
 		struct QueueFamilyIndices
 		{
@@ -72,6 +82,7 @@ namespace VkApp
 		VkInstance m_Instance = VK_NULL_HANDLE;
 		VkDebugUtilsMessengerEXT m_DebugMessenger = VK_NULL_HANDLE;
 		VkSurfaceKHR m_Surface = VK_NULL_HANDLE;
+		bool m_Headless = false;
 
 		VkPhysicalDevice m_PhysicalDevice = VK_NULL_HANDLE;
 		VkDevice m_Device = VK_NULL_HANDLE;
@@ -79,6 +90,15 @@ namespace VkApp
 		VkQueue m_GraphicsQueue = VK_NULL_HANDLE;
 		VkQueue m_PresentQueue = VK_NULL_HANDLE;
 
+		QueueTimeline m_GraphicsTimeline = {};
+
+		// Optional extensions
+		bool m_MemoryBudgetSupported = false;
+
+		// Optional features
+		bool m_TextureCompressionBCSupported = false;
+		bool m_FragmentStoresSupported = false;
+
 		friend class Renderer;
 		friend class SwapChainManager;
 		friend class GraphicsPipeline;
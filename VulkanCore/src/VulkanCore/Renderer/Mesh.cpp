@@ -4,32 +4,243 @@
 #include "VulkanCore/Core/Logging.hpp"
 
 #include "VulkanCore/Renderer/InstanceManager.hpp"
+#include "VulkanCore/Renderer/MeshCooker.hpp"
+
 #include "VulkanCore/Utils/BufferManager.hpp"
+#include "VulkanCore/Utils/MappedFile.hpp"
+
+#if defined(_M_X64) || defined(__SSE2__)
+	#include <xmmintrin.h>
+	#define VKAPP_MESH_SIMD 1
+#endif
 
 namespace VkApp
 {
 
-	Mesh::Mesh(const std::filesystem::path& path)
+	// ===================================
+	// ------------- Helper --------------
+	// ===================================
+	static_assert(sizeof(MeshVertex) == 5 * sizeof(float), "The bulk conversion expects a tightly packed vec3 + vec2 vertex.");
+	static_assert(sizeof(aiVector3D) == 3 * sizeof(float), "The bulk conversion doesn't support ASSIMP_DOUBLE_PRECISION.");
+
+	// Interleaves Assimp's separate position and UV arrays into MeshVertex's.
+	// Note: Pass nullptr as texCoords to get zeroed UV's.
+	static void ConvertVertices(const aiVector3D* positions, const aiVector3D* texCoords, MeshVertex* output, uint32_t count)
+	{
+		uint32_t i = 0;
+
+		#ifdef VKAPP_MESH_SIMD
+		const float* src = reinterpret_cast<const float*>(positions);
+		const float* uvs = reinterpret_cast<const float*>(texCoords);
+		float* dst = reinterpret_cast<float*>(output);
+
+		// 4 vertices at a time: 12 position floats + 12 UV floats (xyz, z unused) in, 20 floats out.
+		for (; i + 4 <= count; i += 4, src += 12, dst += 20)
+		{
+			__m128 p0 = _mm_loadu_ps(src + 0);	// x0 y0 z0 x1
+			__m128 p1 = _mm_loadu_ps(src + 4);	// y1 z1 x2 y2
+			__m128 p2 = _mm_loadu_ps(src + 8);	// z2 x3 y3 z3
+
+			__m128 t0 = _mm_setzero_ps(), t1 = _mm_setzero_ps(), t2 = _mm_setzero_ps();
+			if (uvs)
+			{
+				t0 = _mm_loadu_ps(uvs + 0);	// u0 v0 w0 u1
+				t1 = _mm_loadu_ps(uvs + 4);	// v1 w1 u2 v2
+				t2 = _mm_loadu_ps(uvs + 8);	// w2 u3 v3 w3
+				uvs += 12;
+			}
+
+			__m128 a = _mm_shuffle_ps(p0, t0, _MM_SHUFFLE(0, 0, 2, 2));	// z0 z0 u0 u0
+			__m128 o0 = _mm_shuffle_ps(p0, a, _MM_SHUFFLE(2, 0, 1, 0));	// x0 y0 z0 u0
+
+			__m128 b = _mm_shuffle_ps(t0, p0, _MM_SHUFFLE(3, 3, 1, 1));	// v0 v0 x1 x1
+			__m128 o1 = _mm_shuffle_ps(b, p1, _MM_SHUFFLE(1, 0, 2, 0));	// v0 x1 y1 z1
+
+			__m128 c = _mm_shuffle_ps(t0, t1, _MM_SHUFFLE(0, 0, 3, 3));	// u1 u1 v1 v1
+			__m128 o2 = _mm_shuffle_ps(c, p1, _MM_SHUFFLE(3, 2, 2, 0));	// u1 v1 x2 y2
+
+			__m128 d = _mm_shuffle_ps(p2, t1, _MM_SHUFFLE(2, 2, 0, 0));	// z2 z2 u2 u2
+			__m128 e = _mm_shuffle_ps(t1, p2, _MM_SHUFFLE(1, 1, 3, 3));	// v2 v2 x3 x3
+			__m128 o3 = _mm_shuffle_ps(d, e, _MM_SHUFFLE(2, 0, 2, 0));	// z2 u2 v2 x3
+
+			__m128 o4 = _mm_shuffle_ps(p2, t2, _MM_SHUFFLE(2, 1, 3, 2));	// y3 z3 u3 v3
+
+			_mm_storeu_ps(dst + 0, o0);
+			_mm_storeu_ps(dst + 4, o1);
+			_mm_storeu_ps(dst + 8, o2);
+			_mm_storeu_ps(dst + 12, o3);
+			_mm_storeu_ps(dst + 16, o4);
+		}
+		#endif
+
+		for (; i < count; i++)
+		{
+			output[i].Position = glm::vec3(positions[i].x, positions[i].y, positions[i].z);
+			output[i].TexCoord = texCoords ? glm::vec2(texCoords[i].x, texCoords[i].y) : glm::vec2(0.0f, 0.0f);
+		}
+	}
+
+	static uint32_t HashVertex(const MeshVertex& vertex)
+	{
+		uint32_t words[5];
+		memcpy(words, &vertex, sizeof(MeshVertex));
+
+		uint32_t hash = 2166136261u;
+		for (uint32_t word : words)
+		{
+			hash ^= word;
+			hash *= 16777619u;
+			hash ^= hash >> 15;
+		}
+
+		return hash;
+	}
+
+	// Appends the unique vertices of 'vertices' to 'output' and fills 'remap' with the new index of every input vertex.
+	// Note: Vertices are compared bitwise, which is exactly what the importer hands us for shared corners.
+	static void WeldVertices(const std::vector<MeshVertex>& vertices, std::vector<MeshVertex>& output, std::vector<uint32_t>& remap)
+	{
+		const uint32_t empty = std::numeric_limits<uint32_t>::max();
+
+		uint32_t capacity = 16;
+		while (capacity < vertices.size() * 2)
+			capacity <<= 1;
+
+		// Open addressing with linear probing, stores indices into 'output'.
+		std::vector<uint32_t> table(capacity, empty);
+		remap.resize(vertices.size());
+
+		for (size_t i = 0; i < vertices.size(); i++)
+		{
+			const MeshVertex& vertex = vertices[i];
+			uint32_t slot = HashVertex(vertex) & (capacity - 1);
+
+			while (true)
+			{
+				uint32_t index = table[slot];
+				if (index == empty)
+				{
+					index = static_cast<uint32_t>(output.size());
+					table[slot] = index;
+					output.push_back(vertex);
+
+					remap[i] = index;
+					break;
+				}
+
+				if (memcmp(&output[index], &vertex, sizeof(MeshVertex)) == 0)
+				{
+					remap[i] = index;
+					break;
+				}
+
+				slot = (slot + 1) & (capacity - 1);
+			}
+		}
+	}
+
+	// ===================================
+	// -------------- Mesh ---------------
+	// ===================================
+
+	void MeshData::CalculateBounds()
+	{
+		if (Vertices.empty())
+		{
+			Bounds = { };
+			return;
+		}
+
+		Bounds.Min = Vertices[0].Position;
+		Bounds.Max = Vertices[0].Position;
+
+		for (const auto& vertex : Vertices)
+		{
+			Bounds.Min = glm::min(Bounds.Min, vertex.Position);
+			Bounds.Max = glm::max(Bounds.Max, vertex.Position);
+		}
+	}
+
+	Mesh::Mesh(const std::filesystem::path& path, bool keepCPUData)
 	{
 		#ifdef VKAPP_DEBUG
 		m_Path = path;
 		#endif
 
-		LoadModel(path, m_Vertices, m_Indices);
-        CreateVertexBuffer(m_Vertices);
-        CreateIndexBuffer(m_Indices);
+		// Try the cooked fast path first, it doesn't need the importer at all.
+		std::filesystem::path cookedPath = MeshCooker::GetCookedPath(path);
+		if (MeshCooker::IsUpToDate(path, cookedPath))
+		{
+			MeshCooker::RefreshWriteTime(path, cookedPath);
+			if (LoadCooked(cookedPath, keepCPUData))
+				return;
+		}
+
+		MeshData data = {};
+		if (!ImportModel(path, data))
+			return;
+
+		if (!MeshCooker::Cook(path, cookedPath, data))
+			VKAPP_LOG_WARN("Failed to cook mesh \"{0}\", it will be imported again on the next load.", path.string());
+
+		Upload(data, keepCPUData);
+	}
+
+	Mesh::Mesh(MeshData&& data, bool keepCPUData)
+	{
+		Upload(data, keepCPUData);
 	}
 
     void Mesh::Destroy()
     {
-        vkDestroyBuffer(InstanceManager::Get()->GetLogicalDevice(), m_VertexBuffer, nullptr);
-        vkFreeMemory(InstanceManager::Get()->GetLogicalDevice(), m_VertexBufferMemory, nullptr);
-
-        vkDestroyBuffer(InstanceManager::Get()->GetLogicalDevice(), m_IndexBuffer, nullptr);
-        vkFreeMemory(InstanceManager::Get()->GetLogicalDevice(), m_IndexBufferMemory, nullptr);
+        BufferManager::DestroyBuffer(m_VertexBuffer, m_VertexBufferMemory);
+        BufferManager::DestroyBuffer(m_IndexBuffer, m_IndexBufferMemory);
     }
 
-    void Mesh::LoadModel(const std::filesystem::path& path, std::vector<MeshVertex>& vertices, std::vector<uint32_t>& indices) 
+	bool Mesh::LoadMeshData(const std::filesystem::path& path, MeshData& data)
+	{
+		std::filesystem::path cookedPath = MeshCooker::GetCookedPath(path);
+		if (MeshCooker::IsUpToDate(path, cookedPath))
+		{
+			MeshCooker::RefreshWriteTime(path, cookedPath);
+
+			MappedFile file(cookedPath);
+
+			CookedMeshHeader header = {};
+			if (file.IsValid() && file.GetSize() >= sizeof(CookedMeshHeader))
+				memcpy(&header, file.GetData(), sizeof(CookedMeshHeader));
+
+			if (file.IsValid() && MeshCooker::ValidateHeader(header, file.GetSize()))
+			{
+				const uint8_t* base = file.GetData();
+
+				data.Submeshes.resize(header.SubmeshCount);
+				memcpy(data.Submeshes.data(), base + header.SubmeshOffset, sizeof(Submesh) * header.SubmeshCount);
+
+				data.LODs.resize(header.LODCount);
+				memcpy(data.LODs.data(), base + header.LODOffset, sizeof(MeshLOD) * header.LODCount);
+
+				data.Vertices.resize(header.VertexCount);
+				memcpy(data.Vertices.data(), base + header.VertexOffset, sizeof(MeshVertex) * header.VertexCount);
+
+				data.Indices.resize(header.IndexCount);
+				memcpy(data.Indices.data(), base + header.IndexOffset, sizeof(uint32_t) * header.IndexCount);
+
+				data.Bounds = header.Bounds;
+				return true;
+			}
+		}
+
+		if (!ImportModel(path, data))
+			return false;
+
+		if (!MeshCooker::Cook(path, cookedPath, data))
+			VKAPP_LOG_WARN("Failed to cook mesh \"{0}\", it will be imported again on the next load.", path.string());
+
+		return true;
+	}
+
+    bool Mesh::ImportModel(const std::filesystem::path& path, MeshData& data)
     {
         Assimp::Importer importer;
         const aiScene* scene = importer.ReadFile(path.string(), aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
@@ -37,76 +248,151 @@ namespace VkApp
         if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) 
         {
             VKAPP_LOG_ERROR("Failed to load mesh from: \"{}\"", path.string());
-            return;
+            return false;
         }
 
-        ProcessNode(scene->mRootNode, scene, vertices, indices);
+        // Note: Reserve for the worst case (nothing welds), so the processing below never reallocates.
+        size_t vertexCount = 0, indexCount = 0;
+        for (unsigned int i = 0; i < scene->mNumMeshes; i++)
+        {
+            vertexCount += scene->mMeshes[i]->mNumVertices;
+            indexCount += static_cast<size_t>(scene->mMeshes[i]->mNumFaces) * 3;
+        }
+
+        data.Vertices.reserve(vertexCount);
+        data.Indices.reserve(indexCount);
+
+        ProcessNode(scene->mRootNode, scene, data);
+
+        VKAPP_LOG_INFO("Imported \"{0}\", welded {1} vertices down to {2} in total over {3} submeshes.", path.string(), vertexCount, data.Vertices.size(), data.Submeshes.size());
+
+        data.Vertices.shrink_to_fit();
+        data.CalculateBounds();
+
+        // Note: The importer only produces the full detail level, cooked files can carry more.
+        MeshLOD lod = {};
+        lod.IndexOffset = 0;
+        lod.IndexCount = static_cast<uint32_t>(data.Indices.size());
+        lod.ScreenSize = 0.0f;
+        data.LODs.push_back(lod);
+
+        return true;
     }
 
-    void Mesh::ProcessNode(aiNode* node, const aiScene* scene, std::vector<MeshVertex>& vertices, std::vector<uint32_t>& indices) 
+	bool Mesh::LoadCooked(const std::filesystem::path& cookedPath, bool keepCPUData)
+	{
+		MappedFile file(cookedPath);
+		if (!file.IsValid() || file.GetSize() < sizeof(CookedMeshHeader))
+			return false;
+
+		CookedMeshHeader header = {};
+		memcpy(&header, file.GetData(), sizeof(CookedMeshHeader));
+
+		if (!MeshCooker::ValidateHeader(header, file.GetSize()))
+		{
+			VKAPP_LOG_WARN("Cooked mesh \"{0}\" is invalid, falling back to the importer.", cookedPath.string());
+			return false;
+		}
+
+		const uint8_t* base = file.GetData();
+
+		m_Submeshes.resize(header.SubmeshCount);
+		memcpy(m_Submeshes.data(), base + header.SubmeshOffset, sizeof(Submesh) * header.SubmeshCount);
+
+		m_LODs.resize(header.LODCount);
+		memcpy(m_LODs.data(), base + header.LODOffset, sizeof(MeshLOD) * header.LODCount);
+
+		m_Bounds = header.Bounds;
+		m_VertexCount = header.VertexCount;
+		m_IndexCount = header.IndexCount;
+
+		// Note: The blobs are already in GPU layout, so they are copied from the mapping into the staging buffers directly.
+		CreateVertexBuffer(base + header.VertexOffset, sizeof(MeshVertex) * header.VertexCount);
+		CreateIndexBuffer(base + header.IndexOffset, sizeof(uint32_t) * header.IndexCount);
+
+		if (keepCPUData)
+		{
+			const MeshVertex* vertices = reinterpret_cast<const MeshVertex*>(base + header.VertexOffset);
+			const uint32_t* indices = reinterpret_cast<const uint32_t*>(base + header.IndexOffset);
+
+			m_Vertices.assign(vertices, vertices + header.VertexCount);
+			m_Indices.assign(indices, indices + header.IndexCount);
+		}
+
+		return true;
+	}
+
+	void Mesh::Upload(MeshData& data, bool keepCPUData)
+	{
+		m_Submeshes = std::move(data.Submeshes);
+		m_LODs = std::move(data.LODs);
+		m_Bounds = data.Bounds;
+
+		m_VertexCount = static_cast<uint32_t>(data.Vertices.size());
+		m_IndexCount = static_cast<uint32_t>(data.Indices.size());
+
+		CreateVertexBuffer(data.Vertices.data(), sizeof(MeshVertex) * data.Vertices.size());
+		CreateIndexBuffer(data.Indices.data(), sizeof(uint32_t) * data.Indices.size());
+
+		// Note: Without this every mesh lives in both RAM and VRAM for its whole lifetime.
+		if (keepCPUData)
+		{
+			m_Vertices = std::move(data.Vertices);
+			m_Indices = std::move(data.Indices);
+		}
+	}
+
+    void Mesh::ProcessNode(aiNode* node, const aiScene* scene, MeshData& data)
     {
         // Process all the node's meshes
         for (unsigned int i = 0; i < node->mNumMeshes; i++) 
         {
             aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-            ProcessMesh(mesh, scene, vertices, indices);
+            ProcessMesh(mesh, scene, data);
         }
 
         // Then do the same for each of its children
         for (unsigned int i = 0; i < node->mNumChildren; i++)
-            ProcessNode(node->mChildren[i], scene, vertices, indices);
+            ProcessNode(node->mChildren[i], scene, data);
     }
 
-    void Mesh::ProcessMesh(aiMesh* mesh, const aiScene* scene, std::vector<MeshVertex>& vertices, std::vector<uint32_t>& indices) 
+    void Mesh::ProcessMesh(aiMesh* mesh, const aiScene* scene, MeshData& data)
     {
+        Submesh submesh = {};
+        submesh.IndexOffset = static_cast<uint32_t>(data.Indices.size());
+        submesh.VertexOffset = static_cast<uint32_t>(data.Vertices.size());
+
         // Vertex processing
-        for (unsigned int i = 0; i < mesh->mNumVertices; i++) 
-        {
-            MeshVertex vertex;
-            glm::vec3 vector(0.0f);
-
-            // Position
-            vector.x = mesh->mVertices[i].x;
-            vector.y = mesh->mVertices[i].y;
-            vector.z = mesh->mVertices[i].z;
-            vertex.Position = vector;
-
-            // Texture coordinates
-            if (mesh->mTextureCoords[0]) 
-            {
-                glm::vec2 vec(0.0f);
-                vec.x = mesh->mTextureCoords[0][i].x;
-                vec.y = mesh->mTextureCoords[0][i].y;
-                vertex.TexCoord = vec; 
-            }
-            else
-                vertex.TexCoord = glm::vec2(0.0f, 0.0f);
-
-            vertices.push_back(vertex);
-        }
+        std::vector<MeshVertex> vertices(mesh->mNumVertices);
+        ConvertVertices(mesh->mVertices, mesh->mTextureCoords[0], vertices.data(), mesh->mNumVertices);
+
+        // Note: OBJ's come through with 3 unique vertices per triangle, welding per submesh keeps the ranges intact.
+        std::vector<uint32_t> remap = { };
+        WeldVertices(vertices, data.Vertices, remap);
+
+        submesh.VertexCount = static_cast<uint32_t>(data.Vertices.size()) - submesh.VertexOffset;
+        VKAPP_LOG_TRACE("Submesh \"{0}\", welded {1} vertices down to {2}.", mesh->mName.C_Str(), mesh->mNumVertices, submesh.VertexCount);
 
         // Index processing
         for (unsigned int i = 0; i < mesh->mNumFaces; i++) 
         {
-            aiFace face = mesh->mFaces[i];
+            const aiFace& face = mesh->mFaces[i];
             for (unsigned int j = 0; j < face.mNumIndices; j++)
-                indices.push_back(face.mIndices[j]);
+                data.Indices.push_back(remap[face.mIndices[j]]);
         }
+
+        submesh.IndexCount = static_cast<uint32_t>(data.Indices.size()) - submesh.IndexOffset;
+        data.Submeshes.push_back(submesh);
     }
-    
-	void Mesh::CreateVertexBuffer(const std::vector<MeshVertex>& vertices)
-	{
-        //for (auto& vertice : vertices)
-        //{
-        //    VKAPP_LOG_TRACE("X: {0}, Y: {1}, Z: {2}", vertice.Position.x, vertice.Position.y, vertice.Position.z);
-        //}
 
-        BufferManager::CreateVertexBuffer(m_VertexBuffer, m_VertexBufferMemory, (void*)vertices.data(), sizeof(vertices[0]) * vertices.size());
+	void Mesh::CreateVertexBuffer(const void* vertices, VkDeviceSize size)
+	{
+		BufferManager::CreateVertexBuffer(m_VertexBuffer, m_VertexBufferMemory, const_cast<void*>(vertices), size);
 	}
 
-	void Mesh::CreateIndexBuffer(const std::vector<uint32_t>& indices)
+	void Mesh::CreateIndexBuffer(const void* indices, VkDeviceSize size)
 	{
-        BufferManager::CreateIndexBuffer(m_IndexBuffer, m_IndexBufferMemory, (void*)indices.data(), sizeof(indices[0]) * indices.size());
+		BufferManager::CreateIndexBuffer(m_IndexBuffer, m_IndexBufferMemory, const_cast<void*>(indices), size);
 	}
 
 }
\ No newline at end of file
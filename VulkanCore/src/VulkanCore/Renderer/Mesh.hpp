@@ -1,5 +1,6 @@
 #pragma once
 
+#include <vector>
 #include <filesystem>
 
 #include <assimp/Importer.hpp>   
@@ -50,13 +51,58 @@ namespace VkApp
 
 	};
 
+	// Note: Indices are stored relative to the start of the mesh, so VertexOffset/VertexCount only describe the range.
+	struct Submesh
+	{
+	public:
+		uint32_t IndexOffset = 0;
+		uint32_t IndexCount = 0;
+		uint32_t VertexOffset = 0;
+		uint32_t VertexCount = 0;
+	};
+
+	struct MeshLOD
+	{
+	public:
+		uint32_t IndexOffset = 0;
+		uint32_t IndexCount = 0;
+		float ScreenSize = 0.0f; // Minimum projected screen size (0..1) at which this LOD is used
+	};
+
+	struct MeshBounds
+	{
+	public:
+		glm::vec3 Min = { 0.0f, 0.0f, 0.0f };
+		glm::vec3 Max = { 0.0f, 0.0f, 0.0f };
+	};
+
+	// CPU side representation of a mesh, as produced by the importer or the cooked loader.
+	struct MeshData
+	{
+	public:
+		std::vector<MeshVertex> Vertices = { };
+		std::vector<uint32_t> Indices = { };
+
+		std::vector<Submesh> Submeshes = { };
+		std::vector<MeshLOD> LODs = { };
+		MeshBounds Bounds = { };
+
+		void CalculateBounds();
+	};
+
 	class Mesh
 	{
 	public:
 		Mesh() = default;
-		Mesh(const std::filesystem::path& path);
+		// Note: The CPU side vertices/indices are dropped after upload, unless keepCPUData is set.
+		Mesh(const std::filesystem::path& path, bool keepCPUData = false);
+		Mesh(MeshData&& data, bool keepCPUData = false);
 		void Destroy();
 
+		// Loads the cooked file (or imports and cooks the source) into CPU memory, doesn't touch the GPU.
+		static bool LoadMeshData(const std::filesystem::path& path, MeshData& data);
+		static bool ImportModel(const std::filesystem::path& path, MeshData& data);
+
 		#ifdef VKAPP_DEBUG
 		std::filesystem::path& GetPath() { return m_Path; }
 		#endif
@@ -64,15 +110,29 @@ namespace VkApp
 		VkBuffer& GetVertexBuffer() { return m_VertexBuffer; }
 		VkBuffer& GetIndexBuffer() { return m_IndexBuffer; }
 
-		uint32_t GetAmountOfIndices() const { return (uint32_t)m_Indices.size(); }
+		uint32_t GetAmountOfVertices() const { return m_VertexCount; }
+		uint32_t GetAmountOfIndices() const { return m_IndexCount; }
+
+		inline bool HasCPUData() const { return !m_Vertices.empty(); }
+		inline const std::vector<MeshVertex>& GetVertices() const { return m_Vertices; }
+		inline const std::vector<uint32_t>& GetIndices() const { return m_Indices; }
+
+		// Size of the vertex and index buffers on the GPU.
+		inline VkDeviceSize GetMemorySize() const { return sizeof(MeshVertex) * (VkDeviceSize)m_VertexCount + sizeof(uint32_t) * (VkDeviceSize)m_IndexCount; }
+
+		inline const std::vector<Submesh>& GetSubmeshes() const { return m_Submeshes; }
+		inline const std::vector<MeshLOD>& GetLODs() const { return m_LODs; }
+		inline const MeshBounds& GetBounds() const { return m_Bounds; }
 
 	private:
-		void LoadModel(const std::filesystem::path& path, std::vector<MeshVertex>& vertices, std::vector<uint32_t>& indices);
-		void ProcessNode(aiNode* node, const aiScene* scene, std::vector<MeshVertex>& vertices, std::vector<uint32_t>& indices);
-		void ProcessMesh(aiMesh* mesh, const aiScene* scene, std::vector<MeshVertex>& vertices, std::vector<uint32_t>& indices);
+		bool LoadCooked(const std::filesystem::path& cookedPath, bool keepCPUData);
+		void Upload(MeshData& data, bool keepCPUData);
 
-		void CreateVertexBuffer(const std::vector<MeshVertex>& vertices);
-		void CreateIndexBuffer(const std::vector<uint32_t>& indices);
+		static void ProcessNode(aiNode* node, const aiScene* scene, MeshData& data);
+		static void ProcessMesh(aiMesh* mesh, const aiScene* scene, MeshData& data);
+
+		void CreateVertexBuffer(const void* vertices, VkDeviceSize size);
+		void CreateIndexBuffer(const void* indices, VkDeviceSize size);
 
 	private:
 		#ifdef VKAPP_DEBUG
@@ -82,6 +142,13 @@ namespace VkApp
 		std::vector<MeshVertex> m_Vertices = { };
 		std::vector<uint32_t> m_Indices = { };
 
+		uint32_t m_VertexCount = 0;
+		uint32_t m_IndexCount = 0;
+
+		std::vector<Submesh> m_Submeshes = { };
+		std::vector<MeshLOD> m_LODs = { };
+		MeshBounds m_Bounds = { };
+
 		VkBuffer m_VertexBuffer = VK_NULL_HANDLE;
 		VkDeviceMemory m_VertexBufferMemory = VK_NULL_HANDLE;
 
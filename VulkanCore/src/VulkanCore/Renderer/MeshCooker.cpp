@@ -0,0 +1,208 @@
+#include "vcpch.h"
+#include "MeshCooker.hpp"
+
+#include "VulkanCore/Core/Logging.hpp"
+
+#include "VulkanCore/Utils/MappedFile.hpp"
+
+namespace VkApp
+{
+
+	static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	std::filesystem::path MeshCooker::GetCookedPath(const std::filesystem::path& sourcePath)
+	{
+		std::filesystem::path cooked = sourcePath;
+		cooked += VKAPP_COOKED_MESH_EXTENSION;
+		return cooked;
+	}
+
+	bool MeshCooker::IsUpToDate(const std::filesystem::path& sourcePath, const std::filesystem::path& cookedPath)
+	{
+		std::error_code error;
+		if (!std::filesystem::exists(cookedPath, error))
+			return false;
+
+		// Note: Shipping only the cooked file is allowed, there is nothing to compare against then.
+		if (!std::filesystem::exists(sourcePath, error))
+			return true;
+
+		std::ifstream file(cookedPath, std::ios::binary);
+		CookedMeshHeader header = {};
+		if (!file.read(reinterpret_cast<char*>(&header), sizeof(CookedMeshHeader)))
+			return false;
+
+		if (header.Magic != VKAPP_COOKED_MESH_MAGIC || header.Version != VKAPP_COOKED_MESH_VERSION)
+			return false;
+
+		// Size and write time are cheap to get, only hash when they can't decide.
+		if (GetFileSize(sourcePath) != header.SourceSize)
+			return false;
+
+		if (GetWriteTime(sourcePath) <= header.SourceWriteTime)
+			return true;
+
+		// The source is newer, but it might just have been touched (e.g. a fresh checkout), so compare contents.
+		return HashFile(sourcePath) == header.SourceHash;
+	}
+
+	void MeshCooker::RefreshWriteTime(const std::filesystem::path& sourcePath, const std::filesystem::path& cookedPath)
+	{
+		CookedMeshHeader header = {};
+		{
+			std::ifstream file(cookedPath, std::ios::binary);
+			if (!file.read(reinterpret_cast<char*>(&header), sizeof(CookedMeshHeader)))
+				return;
+		}
+
+		int64_t writeTime = GetWriteTime(sourcePath);
+		if (header.Magic != VKAPP_COOKED_MESH_MAGIC || header.Version != VKAPP_COOKED_MESH_VERSION || writeTime <= header.SourceWriteTime)
+			return;
+
+		// Note: Failing is fine, a read only cooked file just gets its source hashed again on every load.
+		std::fstream file(cookedPath, std::ios::binary | std::ios::in | std::ios::out);
+		if (!file.is_open())
+			return;
+
+		header.SourceWriteTime = writeTime;
+		file.write(reinterpret_cast<const char*>(&header), sizeof(CookedMeshHeader));
+	}
+
+	bool MeshCooker::Cook(const std::filesystem::path& sourcePath, const std::filesystem::path& cookedPath)
+	{
+		MeshData data = {};
+		if (!Mesh::ImportModel(sourcePath, data))
+			return false;
+
+		return Cook(sourcePath, cookedPath, data);
+	}
+
+	bool MeshCooker::Cook(const std::filesystem::path& sourcePath, const std::filesystem::path& cookedPath, const MeshData& data)
+	{
+		CookedMeshHeader header = {};
+		header.SourceHash = HashFile(sourcePath);
+		header.SourceSize = GetFileSize(sourcePath);
+		header.SourceWriteTime = GetWriteTime(sourcePath);
+		header.VertexStride = sizeof(MeshVertex);
+		header.VertexCount = static_cast<uint32_t>(data.Vertices.size());
+		header.IndexCount = static_cast<uint32_t>(data.Indices.size());
+		header.SubmeshCount = static_cast<uint32_t>(data.Submeshes.size());
+		header.LODCount = static_cast<uint32_t>(data.LODs.size());
+		header.Bounds = data.Bounds;
+
+		header.SubmeshOffset = sizeof(CookedMeshHeader);
+		header.LODOffset = header.SubmeshOffset + sizeof(Submesh) * data.Submeshes.size();
+		header.VertexOffset = AlignUp(header.LODOffset + sizeof(MeshLOD) * data.LODs.size(), 16);
+		header.IndexOffset = AlignUp(header.VertexOffset + sizeof(MeshVertex) * data.Vertices.size(), 16);
+
+		// Note: Write to a temporary file first, so a crash while cooking never leaves a half written file behind.
+		std::filesystem::path tempPath = cookedPath;
+		tempPath += ".tmp";
+
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+			{
+				VKAPP_LOG_WARN("Failed to open \"{0}\" for writing cooked mesh.", tempPath.string());
+				return false;
+			}
+
+			auto writeAt = [&file](uint64_t offset, const void* data, size_t size)
+			{
+				static const char zeroes[16] = { };
+				uint64_t position = static_cast<uint64_t>(file.tellp());
+				if (offset > position)
+					file.write(zeroes, static_cast<std::streamsize>(offset - position));
+
+				if (size)
+					file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+			};
+
+			writeAt(0, &header, sizeof(CookedMeshHeader));
+			writeAt(header.SubmeshOffset, data.Submeshes.data(), sizeof(Submesh) * data.Submeshes.size());
+			writeAt(header.LODOffset, data.LODs.data(), sizeof(MeshLOD) * data.LODs.size());
+			writeAt(header.VertexOffset, data.Vertices.data(), sizeof(MeshVertex) * data.Vertices.size());
+			writeAt(header.IndexOffset, data.Indices.data(), sizeof(uint32_t) * data.Indices.size());
+
+			if (!file.good())
+			{
+				VKAPP_LOG_WARN("Failed to write cooked mesh \"{0}\".", cookedPath.string());
+				return false;
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(tempPath, cookedPath, error);
+		if (error)
+		{
+			VKAPP_LOG_WARN("Failed to move cooked mesh into place \"{0}\": {1}", cookedPath.string(), error.message());
+			std::filesystem::remove(tempPath, error);
+			return false;
+		}
+
+		return true;
+	}
+
+	bool MeshCooker::ValidateHeader(const CookedMeshHeader& header, size_t fileSize)
+	{
+		if (header.Magic != VKAPP_COOKED_MESH_MAGIC || header.Version != VKAPP_COOKED_MESH_VERSION)
+			return false;
+
+		if (header.VertexStride != sizeof(MeshVertex))
+			return false;
+
+		// Note: The counts are 32 bit, so the sizes can't overflow, but the offsets come straight from the file.
+		auto inFile = [fileSize](uint64_t offset, uint64_t size) { return offset <= fileSize && size <= fileSize - offset; };
+
+		if (!inFile(header.SubmeshOffset, sizeof(Submesh) * (uint64_t)header.SubmeshCount) ||
+			!inFile(header.LODOffset, sizeof(MeshLOD) * (uint64_t)header.LODCount) ||
+			!inFile(header.VertexOffset, sizeof(MeshVertex) * (uint64_t)header.VertexCount) ||
+			!inFile(header.IndexOffset, sizeof(uint32_t) * (uint64_t)header.IndexCount))
+			return false;
+
+		return true;
+	}
+
+	uint64_t MeshCooker::HashFile(const std::filesystem::path& path)
+	{
+		// FNV-1a, fast enough compared to parsing the file and stable across platforms.
+		uint64_t hash = 14695981039346656037ull;
+
+		MappedFile file(path);
+		if (!file.IsValid())
+			return hash;
+
+		const uint8_t* data = file.GetData();
+		for (size_t i = 0; i < file.GetSize(); i++)
+		{
+			hash ^= data[i];
+			hash *= 1099511628211ull;
+		}
+
+		return hash;
+	}
+
+	uint64_t MeshCooker::GetFileSize(const std::filesystem::path& path)
+	{
+		std::error_code error;
+		uintmax_t size = std::filesystem::file_size(path, error);
+		if (error)
+			return 0;
+
+		return static_cast<uint64_t>(size);
+	}
+
+	int64_t MeshCooker::GetWriteTime(const std::filesystem::path& path)
+	{
+		std::error_code error;
+		auto time = std::filesystem::last_write_time(path, error);
+		if (error)
+			return 0;
+
+		return static_cast<int64_t>(time.time_since_epoch().count());
+	}
+
+}
\ No newline at end of file
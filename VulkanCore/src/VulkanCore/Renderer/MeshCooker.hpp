@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+
+#include "VulkanCore/Renderer/Mesh.hpp"
+
+namespace VkApp
+{
+
+	#define VKAPP_COOKED_MESH_MAGIC 0x484D4B56u // "VKMH"
+	#define VKAPP_COOKED_MESH_VERSION 3u
+	#define VKAPP_COOKED_MESH_EXTENSION ".vkmesh"
+
+	// On-disk layout of a .vkmesh file. All blobs are stored in the exact layout the GPU consumes,
+	// so the loader can copy them from the mapped file straight into a staging buffer.
+	// [Header][Submeshes][LODs][Vertices (16 byte aligned)][Indices (16 byte aligned)]
+	struct CookedMeshHeader
+	{
+	public:
+		uint32_t Magic = VKAPP_COOKED_MESH_MAGIC;
+		uint32_t Version = VKAPP_COOKED_MESH_VERSION;
+
+		uint64_t SourceHash = 0;
+		uint64_t SourceSize = 0;
+		int64_t SourceWriteTime = 0;
+
+		uint32_t VertexStride = 0;
+		uint32_t VertexCount = 0;
+		uint32_t IndexCount = 0;
+		uint32_t SubmeshCount = 0;
+		uint32_t LODCount = 0;
+		uint32_t Reserved = 0;
+
+		MeshBounds Bounds = { };
+
+		uint64_t SubmeshOffset = 0;
+		uint64_t LODOffset = 0;
+		uint64_t VertexOffset = 0;
+		uint64_t IndexOffset = 0;
+	};
+
+	class MeshCooker
+	{
+	public:
+		static std::filesystem::path GetCookedPath(const std::filesystem::path& sourcePath);
+
+		// Returns true if the cooked file exists and was cooked from the current contents of the source.
+		static bool IsUpToDate(const std::filesystem::path& sourcePath, const std::filesystem::path& cookedPath);
+		// Best effort, call after IsUpToDate() succeeded so a source that was only touched isn't hashed on every load.
+		static void RefreshWriteTime(const std::filesystem::path& sourcePath, const std::filesystem::path& cookedPath);
+
+		// Runs the importer on the source and writes the result to the cooked path.
+		static bool Cook(const std::filesystem::path& sourcePath, const std::filesystem::path& cookedPath);
+		static bool Cook(const std::filesystem::path& sourcePath, const std::filesystem::path& cookedPath, const MeshData& data);
+
+		static bool ValidateHeader(const CookedMeshHeader& header, size_t fileSize);
+
+		static uint64_t HashFile(const std::filesystem::path& path);
+		static uint64_t GetFileSize(const std::filesystem::path& path);
+		static int64_t GetWriteTime(const std::filesystem::path& path);
+	};
+
+}
\ No newline at end of file
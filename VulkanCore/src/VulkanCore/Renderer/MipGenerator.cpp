@@ -0,0 +1,265 @@
+#include "vcpch.h"
+#include "MipGenerator.hpp"
+
+#include <array>
+
+#include "VulkanCore/Core/Logging.hpp"
+
+#include "VulkanCore/Renderer/InstanceManager.hpp"
+#include "VulkanCore/Renderer/GraphicsPipelineManager.hpp"
+
+#include "VulkanCore/Utils/BufferManager.hpp"
+
+namespace VkApp
+{
+
+	MipGenerator* MipGenerator::s_Instance = nullptr;
+
+	// Has to match the push constants in mipgen.comp
+	struct MipGenConstants
+	{
+	public:
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		uint32_t MipCount = 0;
+		uint32_t WorkgroupCount = 0;
+		uint32_t Srgb = 0;
+	};
+
+	// ===================================
+	// ------------- Helper --------------
+	// ===================================
+	static bool IsSrgb(VkFormat format)
+	{
+		return format == VK_FORMAT_R8G8B8A8_SRGB;
+	}
+
+	static VkImageView CreateMipView(VkImage& image, uint32_t mip)
+	{
+		VkImageViewCreateInfo viewInfo = {};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.image = image;
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format = VK_FORMAT_R8G8B8A8_UNORM; // Note: sRGB formats generally can't be used as storage images, the shader converts manually.
+		viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		viewInfo.subresourceRange.baseMipLevel = mip;
+		viewInfo.subresourceRange.levelCount = 1;
+		viewInfo.subresourceRange.baseArrayLayer = 0;
+		viewInfo.subresourceRange.layerCount = 1;
+
+		VkImageView imageView = VK_NULL_HANDLE;
+		if (vkCreateImageView(InstanceManager::Get()->GetLogicalDevice(), &viewInfo, nullptr, &imageView) != VK_SUCCESS)
+			VKAPP_LOG_ERROR("Failed to create mip image view!");
+
+		return imageView;
+	}
+
+	// ===================================
+	// ------------ Public ---------------
+	// ===================================
+	MipGenerator::MipGenerator()
+	{
+		s_Instance = this;
+
+		// Note: The pipeline is created on first use, the shader is loaded from the working directory.
+	}
+
+	void MipGenerator::Destroy()
+	{
+		for (auto& slot : m_Slots)
+		{
+			for (auto& view : slot.Views)
+				vkDestroyImageView(InstanceManager::Get()->GetLogicalDevice(), view, nullptr);
+		}
+		m_Slots.clear();
+
+		if (m_CounterBuffer != VK_NULL_HANDLE)
+			BufferManager::DestroyBuffer(m_CounterBuffer, m_CounterMemory);
+
+		if (GraphicsPipelineManager::Get() && GraphicsPipelineManager::Get()->HasComputePipeline(VKAPP_MIPGEN_PIPELINE))
+			GraphicsPipelineManager::Get()->DestroyComputePipeline(VKAPP_MIPGEN_PIPELINE);
+
+		m_Initialized = false;
+		m_Available = false;
+
+		s_Instance = nullptr;
+	}
+
+	bool MipGenerator::Generate(VkImage& image, VkFormat format, uint32_t width, uint32_t height, uint32_t mipLevels)
+	{
+		if (!IsSupported(format, width, height) || mipLevels < 2 || mipLevels > VKAPP_MIPGEN_MAX_LEVELS)
+			return false;
+
+		auto logicalDevice = InstanceManager::Get()->GetLogicalDevice();
+		ComputePipeline& pipeline = GraphicsPipelineManager::Get()->GetComputePipeline(VKAPP_MIPGEN_PIPELINE);
+
+		// Note: Only waits when the slot's last image is still on the GPU, not for the frames in flight.
+		uint32_t slotIndex = m_NextSlot;
+		m_NextSlot = (m_NextSlot + 1) % static_cast<uint32_t>(m_Slots.size());
+
+		Slot& slot = m_Slots[slotIndex];
+		InstanceManager::Get()->GetGraphicsTimeline().Wait(slot.Value);
+
+		for (auto& view : slot.Views)
+			vkDestroyImageView(logicalDevice, view, nullptr);
+
+		std::vector<VkImageView>& views = slot.Views;
+		views.resize(mipLevels);
+		for (uint32_t i = 0; i < mipLevels; i++)
+			views[i] = CreateMipView(image, i);
+
+		// Unused slots point at the last level, they're never accessed but every element must be valid.
+		std::array<VkDescriptorImageInfo, VKAPP_MIPGEN_MAX_LEVELS> imageInfos = { };
+		for (uint32_t i = 0; i < VKAPP_MIPGEN_MAX_LEVELS; i++)
+		{
+			imageInfos[i].imageView = views[std::min(i, mipLevels - 1)];
+			imageInfos[i].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+		}
+
+		VkDeviceSize counterOffset = static_cast<VkDeviceSize>(slotIndex) * VKAPP_MIPGEN_COUNTER_STRIDE;
+
+		VkDescriptorBufferInfo bufferInfo = {};
+		bufferInfo.buffer = m_CounterBuffer;
+		bufferInfo.offset = counterOffset;
+		bufferInfo.range = sizeof(uint32_t);
+
+		VkDescriptorSet descriptorSet = pipeline.GetDescriptorSets()[0][slotIndex];
+
+		std::array<VkWriteDescriptorSet, 2> writes = { };
+		writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writes[0].dstSet = descriptorSet;
+		writes[0].dstBinding = 0;
+		writes[0].dstArrayElement = 0;
+		writes[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+		writes[0].descriptorCount = VKAPP_MIPGEN_MAX_LEVELS;
+		writes[0].pImageInfo = imageInfos.data();
+
+		writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writes[1].dstSet = descriptorSet;
+		writes[1].dstBinding = 1;
+		writes[1].dstArrayElement = 0;
+		writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		writes[1].descriptorCount = 1;
+		writes[1].pBufferInfo = &bufferInfo;
+
+		vkUpdateDescriptorSets(logicalDevice, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+
+		uint32_t groupsX = (width + 63) / 64;
+		uint32_t groupsY = (height + 63) / 64;
+
+		MipGenConstants constants = {};
+		constants.Width = width;
+		constants.Height = height;
+		constants.MipCount = mipLevels;
+		constants.WorkgroupCount = groupsX * groupsY;
+		constants.Srgb = IsSrgb(format) ? 1 : 0;
+
+		VkCommandBuffer commandBuffer = BufferManager::BeginSingleTimeCommands();
+
+		vkCmdFillBuffer(commandBuffer, m_CounterBuffer, counterOffset, sizeof(uint32_t), 0);
+
+		VkBufferMemoryBarrier counterBarrier = {};
+		counterBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		counterBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		counterBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+		counterBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		counterBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		counterBarrier.buffer = m_CounterBuffer;
+		counterBarrier.offset = counterOffset;
+		counterBarrier.size = sizeof(uint32_t);
+
+		VkImageMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.image = image;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		barrier.subresourceRange.baseMipLevel = 0;
+		barrier.subresourceRange.levelCount = mipLevels;
+		barrier.subresourceRange.baseArrayLayer = 0;
+		barrier.subresourceRange.layerCount = 1;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+		vkCmdPipelineBarrier(commandBuffer,
+			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+			0, nullptr,
+			1, &counterBarrier,
+			1, &barrier);
+
+		pipeline.Bind(commandBuffer);
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline.GetPipelineLayout(), 0, 1, &descriptorSet, 0, nullptr);
+		vkCmdPushConstants(commandBuffer, pipeline.GetPipelineLayout(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(MipGenConstants), &constants);
+		vkCmdDispatch(commandBuffer, groupsX, groupsY, 1);
+
+		barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+		vkCmdPipelineBarrier(commandBuffer,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+			0, nullptr,
+			0, nullptr,
+			1, &barrier);
+
+		slot.Value = BufferManager::EndSingleTimeCommands(commandBuffer);
+		return true;
+	}
+
+	bool MipGenerator::IsSupported(VkFormat format, uint32_t width, uint32_t height)
+	{
+		if (format != VK_FORMAT_R8G8B8A8_UNORM && format != VK_FORMAT_R8G8B8A8_SRGB)
+			return false;
+
+		if (std::max(width, height) > VKAPP_MIPGEN_MAX_SIZE)
+			return false;
+
+		if (!m_Initialized)
+			m_Available = Init();
+
+		return m_Available;
+	}
+
+	// ===================================
+	// -------- Initialization -----------
+	// ===================================
+	bool MipGenerator::Init()
+	{
+		m_Initialized = true;
+
+		VkFormatProperties properties = {};
+		vkGetPhysicalDeviceFormatProperties(InstanceManager::Get()->GetPhysicalDevice(), VK_FORMAT_R8G8B8A8_UNORM, &properties);
+
+		if (!(properties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT))
+		{
+			VKAPP_LOG_WARN("RGBA8 storage images are not supported, mipmaps are generated by blitting.");
+			return false;
+		}
+
+		std::error_code error;
+		if (!std::filesystem::exists(VKAPP_MIPGEN_SHADER, error))
+		{
+			VKAPP_LOG_WARN("Mip generation shader \"{0}\" not found, mipmaps are generated by blitting.", VKAPP_MIPGEN_SHADER);
+			return false;
+		}
+
+		ComputePipelineInfo info = {};
+		info.ComputeShader = GraphicsPipelineManager::ReadFile(VKAPP_MIPGEN_SHADER);
+		info.PushConstantSize = sizeof(MipGenConstants);
+		info.DescriptorSets.Set0 = {
+			{ 0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VKAPP_MIPGEN_MAX_LEVELS, VK_SHADER_STAGE_COMPUTE_BIT },
+			{ 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT }
+		};
+
+		ComputePipeline& pipeline = GraphicsPipelineManager::Get()->CreateComputePipeline(VKAPP_MIPGEN_PIPELINE, info);
+		m_Slots.resize(pipeline.GetDescriptorSets()[0].size());
+
+		BufferManager::CreateBuffer(m_Slots.size() * VKAPP_MIPGEN_COUNTER_STRIDE, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_CounterBuffer, m_CounterMemory);
+
+		return true;
+	}
+
+}
\ No newline at end of file
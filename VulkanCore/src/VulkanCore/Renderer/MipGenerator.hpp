@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+#include <filesystem>
+
+#include <vulkan/vulkan.h>
+
+namespace VkApp
+{
+
+	#define VKAPP_MIPGEN_PIPELINE "VkApp-MipGen"
+	#define VKAPP_MIPGEN_SHADER "assets/shaders/mipgen.spv" // Compiled from mipgen.comp by the VulkanCore prebuild step
+	#define VKAPP_MIPGEN_COUNTER_STRIDE 256u // The largest minStorageBufferOffsetAlignment allowed
+
+	// A workgroup reduces a 64x64 tile to one texel of mip 6 and the last workgroup reduces mip 6
+	// to a single texel, so two passes of 6 levels cover everything up to 4096x4096.
+	#define VKAPP_MIPGEN_MAX_SIZE 4096u
+	#define VKAPP_MIPGEN_MAX_LEVELS 13u
+
+	// Generates a full RGBA8 mip chain with a single compute dispatch (single pass downsampler).
+	// Workgroups count their completion with a global atomic counter, the last one to finish does the tail.
+	class MipGenerator
+	{
+	public:
+		static MipGenerator* Get() { return s_Instance; }
+
+		MipGenerator();
+		void Destroy();
+
+		// Returns false if the image can't be handled, the caller should then fall back to blitting.
+		// Expects every level in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL with level 0 filled in,
+		// leaves them in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL. The image must have VK_IMAGE_USAGE_STORAGE_BIT.
+		// With an sRGB format the texels are filtered in linear space.
+		bool Generate(VkImage& image, VkFormat format, uint32_t width, uint32_t height, uint32_t mipLevels);
+
+		// Use this to decide whether the image needs VK_IMAGE_USAGE_STORAGE_BIT.
+		bool IsSupported(VkFormat format, uint32_t width, uint32_t height);
+
+	private:
+		bool Init();
+
+	private:
+		static MipGenerator* s_Instance;
+
+	private:
+		bool m_Initialized = false;
+		bool m_Available = false;
+
+		// Every slot has its own descriptor set and counter, so images can be generated back to back without waiting.
+		struct Slot
+		{
+		public:
+			uint64_t Value = 0; // Graphics timeline value of the last image generated with it
+			std::vector<VkImageView> Views = { };
+		};
+		std::vector<Slot> m_Slots = { };
+		uint32_t m_NextSlot = 0;
+
+		VkBuffer m_CounterBuffer = VK_NULL_HANDLE;
+		VkDeviceMemory m_CounterMemory = VK_NULL_HANDLE;
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include "vcpch.h"
+#include "QueueTimeline.hpp"
+
+#include "VulkanCore/Core/Logging.hpp"
+
+#include "VulkanCore/Renderer/InstanceManager.hpp"
+
+namespace VkApp
+{
+
+	// ===================================
+	// ------------ Public ---------------
+	// ===================================
+	void QueueTimeline::Init(VkQueue queue)
+	{
+		m_Queue = queue;
+
+		VkSemaphoreTypeCreateInfo typeInfo = {};
+		typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+		typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+		typeInfo.initialValue = 0;
+
+		VkSemaphoreCreateInfo semaphoreInfo = {};
+		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		semaphoreInfo.pNext = &typeInfo;
+
+		if (vkCreateSemaphore(InstanceManager::Get()->GetLogicalDevice(), &semaphoreInfo, nullptr, &m_Semaphore) != VK_SUCCESS)
+			VKAPP_LOG_ERROR("Failed to create timeline semaphore!");
+	}
+
+	void QueueTimeline::Destroy()
+	{
+		if (m_Semaphore == VK_NULL_HANDLE)
+			return;
+
+		WaitIdle();
+
+		vkDestroySemaphore(InstanceManager::Get()->GetLogicalDevice(), m_Semaphore, nullptr);
+		m_Semaphore = VK_NULL_HANDLE;
+		m_Queue = VK_NULL_HANDLE;
+	}
+
+	uint64_t QueueTimeline::Submit(const std::vector<VkCommandBuffer>& commandBuffers, const std::vector<TimelineWait>& waits, const BinarySemaphores& binary)
+	{
+		std::vector<VkSemaphore> waitSemaphores = { };
+		std::vector<uint64_t> waitValues = { };
+		std::vector<VkPipelineStageFlags> waitStages = { };
+
+		for (auto& wait : waits)
+		{
+			// Note: Our own queue executes in order, only other queues need a semaphore wait.
+			if (!wait.Timeline || wait.Timeline == this || wait.Timeline->IsComplete(wait.Value))
+				continue;
+
+			waitSemaphores.push_back(wait.Timeline->GetSemaphore());
+			waitValues.push_back(wait.Value);
+			waitStages.push_back(wait.Stages);
+		}
+
+		if (binary.Wait != VK_NULL_HANDLE)
+		{
+			waitSemaphores.push_back(binary.Wait);
+			waitValues.push_back(0); // Ignored for binary semaphores
+			waitStages.push_back(binary.WaitStages);
+		}
+
+		std::scoped_lock<std::mutex> lock(m_Mutex);
+
+		uint64_t value = m_LastSubmitted + 1;
+
+		std::vector<VkSemaphore> signalSemaphores = { m_Semaphore };
+		std::vector<uint64_t> signalValues = { value };
+
+		if (binary.Signal != VK_NULL_HANDLE)
+		{
+			signalSemaphores.push_back(binary.Signal);
+			signalValues.push_back(0);
+		}
+
+		VkTimelineSemaphoreSubmitInfo timelineInfo = {};
+		timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timelineInfo.waitSemaphoreValueCount = static_cast<uint32_t>(waitValues.size());
+		timelineInfo.pWaitSemaphoreValues = waitValues.data();
+		timelineInfo.signalSemaphoreValueCount = static_cast<uint32_t>(signalValues.size());
+		timelineInfo.pSignalSemaphoreValues = signalValues.data();
+
+		VkSubmitInfo submitInfo = {};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.pNext = &timelineInfo;
+		submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+		submitInfo.pWaitSemaphores = waitSemaphores.data();
+		submitInfo.pWaitDstStageMask = waitStages.data();
+		submitInfo.commandBufferCount = static_cast<uint32_t>(commandBuffers.size());
+		submitInfo.pCommandBuffers = commandBuffers.data();
+		submitInfo.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
+		submitInfo.pSignalSemaphores = signalSemaphores.data();
+
+		if (vkQueueSubmit(m_Queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+		{
+			VKAPP_LOG_ERROR("Failed to submit to the queue!");
+			return m_Completed;
+		}
+
+		m_LastSubmitted = value;
+		return value;
+	}
+
+	VkResult QueueTimeline::Present(VkQueue presentQueue, const VkPresentInfoKHR& presentInfo)
+	{
+		std::scoped_lock<std::mutex> lock(m_Mutex);
+		return vkQueuePresentKHR(presentQueue, &presentInfo);
+	}
+
+	bool QueueTimeline::IsComplete(uint64_t value)
+	{
+		if (value <= m_Completed)
+			return true;
+
+		return value <= GetCompleted();
+	}
+
+	void QueueTimeline::Wait(uint64_t value, uint64_t timeout)
+	{
+		if (value <= m_Completed)
+			return;
+
+		VkSemaphoreWaitInfo waitInfo = {};
+		waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+		waitInfo.semaphoreCount = 1;
+		waitInfo.pSemaphores = &m_Semaphore;
+		waitInfo.pValues = &value;
+
+		if (vkWaitSemaphores(InstanceManager::Get()->GetLogicalDevice(), &waitInfo, timeout) == VK_SUCCESS)
+			GetCompleted();
+	}
+
+	void QueueTimeline::WaitIdle()
+	{
+		Wait(m_LastSubmitted);
+	}
+
+	uint64_t QueueTimeline::GetCompleted()
+	{
+		uint64_t value = 0;
+		if (vkGetSemaphoreCounterValue(InstanceManager::Get()->GetLogicalDevice(), m_Semaphore, &value) != VK_SUCCESS)
+			return m_Completed;
+
+		// Note: Another thread might have stored a newer value in the meantime, never go back.
+		uint64_t completed = m_Completed;
+		while (value > completed && !m_Completed.compare_exchange_weak(completed, value));
+
+		return std::max(value, completed);
+	}
+
+}
\ No newline at end of file
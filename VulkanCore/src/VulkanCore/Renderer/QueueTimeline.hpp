@@ -0,0 +1,68 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+namespace VkApp
+{
+
+	class QueueTimeline;
+
+	// Makes a submission wait until another timeline reaches a value, like graphics waiting on a transfer.
+	struct TimelineWait
+	{
+	public:
+		QueueTimeline* Timeline = nullptr;
+		uint64_t Value = 0;
+		VkPipelineStageFlags Stages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+	};
+
+	// Binary semaphores for the swapchain, which can't use timelines.
+	struct BinarySemaphores
+	{
+	public:
+		VkSemaphore Wait = VK_NULL_HANDLE;
+		VkPipelineStageFlags WaitStages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+		VkSemaphore Signal = VK_NULL_HANDLE;
+	};
+
+	// One timeline semaphore per queue, every submission signals the next value. Anything that
+	// depends on GPU work just remembers the value of that submission and checks or waits on it,
+	// resources that might still be in use retire after GetLastSubmitted().
+	class QueueTimeline
+	{
+	public:
+		QueueTimeline() = default;
+		void Init(VkQueue queue);
+		void Destroy();
+
+		// Returns the value that is signalled once the command buffers are done.
+		uint64_t Submit(const std::vector<VkCommandBuffer>& commandBuffers, const std::vector<TimelineWait>& waits = { }, const BinarySemaphores& binary = {});
+
+		// Presents under the same lock as Submit(), the present queue is usually the very same queue.
+		VkResult Present(VkQueue presentQueue, const VkPresentInfoKHR& presentInfo);
+
+		bool IsComplete(uint64_t value);
+		void Wait(uint64_t value, uint64_t timeout = UINT64_MAX);
+		void WaitIdle();
+
+		uint64_t GetCompleted();
+		inline uint64_t GetLastSubmitted() const { return m_LastSubmitted; }
+
+		inline VkQueue GetQueue() const { return m_Queue; }
+		inline VkSemaphore GetSemaphore() const { return m_Semaphore; }
+
+	private:
+		VkQueue m_Queue = VK_NULL_HANDLE;
+		VkSemaphore m_Semaphore = VK_NULL_HANDLE;
+
+		// Note: Queues need external synchronization, uploads may submit from other threads.
+		std::mutex m_Mutex;
+		std::atomic<uint64_t> m_LastSubmitted = 0;
+		std::atomic<uint64_t> m_Completed = 0; // Cached, saves a driver call for values we know are done
+	};
+
+}
\ No newline at end of file
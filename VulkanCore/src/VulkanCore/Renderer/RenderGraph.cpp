@@ -0,0 +1,1028 @@
+#include "vcpch.h"
+#include "RenderGraph.hpp"
+
+#include "VulkanCore/Core/Logging.hpp"
+#include "VulkanCore/Core/Profiler.hpp"
+
+#include "VulkanCore/Renderer/GpuProfiler.hpp"
+#include "VulkanCore/Renderer/InstanceManager.hpp"
+#include "VulkanCore/Renderer/RenderPassDescription.hpp"
+#include "VulkanCore/Renderer/ResidencyManager.hpp"
+#include "VulkanCore/Renderer/SwapChainManager.hpp"
+
+#include "VulkanCore/Utils/BufferManager.hpp"
+
+namespace VkApp
+{
+
+	// ===================================
+	// ------------- Helper --------------
+	// ===================================
+	struct UsageInfo
+	{
+	public:
+		VkPipelineStageFlags Stages = 0;
+		VkAccessFlags ReadAccess = 0;
+		VkAccessFlags WriteAccess = 0;
+		VkImageLayout Layout = VK_IMAGE_LAYOUT_UNDEFINED; // Undefined for buffer only usages
+
+		VkImageUsageFlags ImageUsage = 0;
+		VkBufferUsageFlags BufferUsage = 0;
+	};
+
+	static UsageInfo GetUsageInfo(RenderGraphUsage usage)
+	{
+		switch (usage)
+		{
+		case RenderGraphUsage::ColorAttachment:
+			return { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_READ_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, 0 };
+		case RenderGraphUsage::DepthAttachment:
+			return { VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, 0 };
+		case RenderGraphUsage::DepthRead:
+			return { VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT, 0, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, 0 };
+		case RenderGraphUsage::FragmentSampled:
+			return { VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, 0, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT };
+		case RenderGraphUsage::ComputeSampled:
+			return { VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, 0, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT };
+		case RenderGraphUsage::StorageRead:
+			return { VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, 0, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT };
+		case RenderGraphUsage::StorageWrite:
+			return { VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT };
+		case RenderGraphUsage::FragmentStorageWrite:
+			return { VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT };
+		case RenderGraphUsage::TransferSrc:
+			return { VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT, 0, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_BUFFER_USAGE_TRANSFER_SRC_BIT };
+		case RenderGraphUsage::TransferDst:
+			return { VK_PIPELINE_STAGE_TRANSFER_BIT, 0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT, VK_BUFFER_USAGE_TRANSFER_DST_BIT };
+		case RenderGraphUsage::VertexBuffer:
+			return { VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT, 0, VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT };
+		case RenderGraphUsage::IndexBuffer:
+			return { VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_INDEX_READ_BIT, 0, VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_BUFFER_USAGE_INDEX_BUFFER_BIT };
+		case RenderGraphUsage::UniformBuffer:
+			return { VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_UNIFORM_READ_BIT, 0, VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT };
+		case RenderGraphUsage::IndirectBuffer:
+			return { VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT, 0, VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT };
+
+		default:
+			break;
+		}
+
+		return {};
+	}
+
+	static bool IsAttachment(RenderGraphUsage usage)
+	{
+		return usage == RenderGraphUsage::ColorAttachment || usage == RenderGraphUsage::DepthAttachment || usage == RenderGraphUsage::DepthRead;
+	}
+
+	static bool IsAttachmentOnly(VkImageUsageFlags usage)
+	{
+		return (usage & ~(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT)) == 0;
+	}
+
+	static bool IsDepthFormat(VkFormat format)
+	{
+		switch (format)
+		{
+		case VK_FORMAT_D16_UNORM:
+		case VK_FORMAT_X8_D24_UNORM_PACK32:
+		case VK_FORMAT_D32_SFLOAT:
+		case VK_FORMAT_D16_UNORM_S8_UINT:
+		case VK_FORMAT_D24_UNORM_S8_UINT:
+		case VK_FORMAT_D32_SFLOAT_S8_UINT:
+			return true;
+
+		default:
+			break;
+		}
+
+		return false;
+	}
+
+	static VkImageAspectFlags GetAspect(VkFormat format)
+	{
+		if (!IsDepthFormat(format))
+			return VK_IMAGE_ASPECT_COLOR_BIT;
+
+		if (BufferManager::HasStencilComponent(format) || format == VK_FORMAT_D16_UNORM_S8_UINT)
+			return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+
+		return VK_IMAGE_ASPECT_DEPTH_BIT;
+	}
+
+	// ===================================
+	// ------------ Builder --------------
+	// ===================================
+	RenderGraphHandle RenderGraphBuilder::CreateImage(const std::string& name, const RenderGraphImageInfo& info)
+	{
+		RenderGraph::Resource resource = {};
+		resource.Name = name;
+		resource.IsImage = true;
+		resource.ImageInfo = info;
+
+		m_Graph.m_Resources.push_back(resource);
+		return { static_cast<uint32_t>(m_Graph.m_Resources.size() - 1) };
+	}
+
+	RenderGraphHandle RenderGraphBuilder::CreateBuffer(const std::string& name, const RenderGraphBufferInfo& info)
+	{
+		RenderGraph::Resource resource = {};
+		resource.Name = name;
+		resource.IsImage = false;
+		resource.BufferInfo = info;
+
+		m_Graph.m_Resources.push_back(resource);
+		return { static_cast<uint32_t>(m_Graph.m_Resources.size() - 1) };
+	}
+
+	void RenderGraphBuilder::Read(RenderGraphHandle resource, RenderGraphUsage usage)
+	{
+		Access(resource, usage, false);
+	}
+
+	void RenderGraphBuilder::Write(RenderGraphHandle resource, RenderGraphUsage usage)
+	{
+		Access(resource, usage, true);
+	}
+
+	void RenderGraphBuilder::SetAttachmentOps(RenderGraphHandle resource, VkAttachmentLoadOp loadOp, VkAttachmentStoreOp storeOp)
+	{
+		RenderGraph::Pass& pass = m_Graph.m_Passes[m_Pass];
+
+		for (auto& access : pass.Accesses)
+		{
+			if (access.Resource != resource.Index)
+				continue;
+
+			if (!IsAttachment(access.Usage))
+				break;
+
+			access.LoadOp = loadOp;
+			access.StoreOp = storeOp;
+			return;
+		}
+
+		VKAPP_LOG_ERROR("Render graph pass \"{0}\" sets attachment ops for a resource it doesn't use as an attachment.", pass.Name);
+	}
+
+	void RenderGraphBuilder::SetSideEffects()
+	{
+		m_Graph.m_Passes[m_Pass].SideEffects = true;
+	}
+
+	void RenderGraphBuilder::Access(RenderGraphHandle resource, RenderGraphUsage usage, bool write)
+	{
+		RenderGraph::Pass& pass = m_Graph.m_Passes[m_Pass];
+
+		if (!resource.IsValid() || resource.Index >= m_Graph.m_Resources.size())
+		{
+			VKAPP_LOG_ERROR("Render graph pass \"{0}\" uses an invalid resource.", pass.Name);
+			return;
+		}
+
+		const RenderGraph::Resource& target = m_Graph.m_Resources[resource.Index];
+		UsageInfo info = GetUsageInfo(usage);
+
+		if ((target.IsImage && info.ImageUsage == 0) || (!target.IsImage && info.BufferUsage == 0))
+		{
+			VKAPP_LOG_ERROR("Render graph pass \"{0}\" uses \"{1}\" in a way that doesn't fit its type.", pass.Name, target.Name);
+			return;
+		}
+
+		if (write && info.WriteAccess == 0)
+		{
+			VKAPP_LOG_ERROR("Render graph pass \"{0}\" writes to \"{1}\" with a read only usage.", pass.Name, target.Name);
+			return;
+		}
+
+		for (auto& access : pass.Accesses)
+		{
+			if (access.Resource != resource.Index)
+				continue;
+
+			// Note: One usage per resource per pass, otherwise the pass would need two layouts at once.
+			if (access.Usage != usage)
+				VKAPP_LOG_ERROR("Render graph pass \"{0}\" uses \"{1}\" in more than one way.", pass.Name, target.Name);
+			else
+				access.Write |= write;
+
+			return;
+		}
+
+		pass.Accesses.push_back({ resource.Index, usage, write });
+	}
+
+	// ===================================
+	// ------------ Public ---------------
+	// ===================================
+	void RenderGraph::Destroy()
+	{
+		Reset();
+		DestroyRetired(true);
+	}
+
+	void RenderGraph::Reset()
+	{
+		DestroyCompiled();
+
+		m_Resources.clear();
+		m_Passes.clear();
+	}
+
+	RenderGraphHandle RenderGraph::ImportImage(const std::string& name, VkImage image, VkImageView view, VkFormat format, VkExtent2D extent, VkImageLayout initialLayout, VkImageLayout finalLayout, const VkClearValue& clearValue)
+	{
+		Resource resource = {};
+		resource.Name = name;
+		resource.IsImage = true;
+		resource.Imported = true;
+		resource.ImageInfo.Width = extent.width;
+		resource.ImageInfo.Height = extent.height;
+		resource.ImageInfo.Format = format;
+		resource.ImageInfo.ClearValue = clearValue;
+		resource.InitialLayout = initialLayout;
+		resource.FinalLayout = finalLayout;
+		resource.Image = image;
+		resource.View = view;
+		resource.Extent = extent;
+
+		m_Resources.push_back(resource);
+		return { static_cast<uint32_t>(m_Resources.size() - 1) };
+	}
+
+	RenderGraphHandle RenderGraph::ImportBuffer(const std::string& name, VkBuffer buffer, VkDeviceSize size, VkPipelineStageFlags finalStages, VkAccessFlags finalAccess)
+	{
+		Resource resource = {};
+		resource.Name = name;
+		resource.IsImage = false;
+		resource.Imported = true;
+		resource.BufferInfo.Size = size;
+		resource.Buffer = buffer;
+		resource.FinalStages = finalStages;
+		resource.FinalAccess = finalAccess;
+
+		m_Resources.push_back(resource);
+		return { static_cast<uint32_t>(m_Resources.size() - 1) };
+	}
+
+	void RenderGraph::SetImportedImage(RenderGraphHandle resource, VkImage image, VkImageView view)
+	{
+		if (!resource.IsValid() || resource.Index >= m_Resources.size() || !m_Resources[resource.Index].Imported)
+			return;
+
+		m_Resources[resource.Index].Image = image;
+		m_Resources[resource.Index].View = view;
+	}
+
+	void RenderGraph::AddPass(const std::string& name, RenderGraphSetupFunction setup, RenderGraphExecuteFunction execute)
+	{
+		if (m_Compiled)
+			VKAPP_LOG_WARN("Render graph pass \"{0}\" was added after compiling, call Compile() again.", name);
+
+		Pass pass = {};
+		pass.Name = name;
+		pass.Execute = execute;
+		m_Passes.push_back(std::move(pass));
+
+		RenderGraphBuilder builder(*this, static_cast<uint32_t>(m_Passes.size() - 1));
+		setup(builder);
+	}
+
+	void RenderGraph::Compile()
+	{
+		VKAPP_PROFILE_FUNCTION();
+
+		DestroyCompiled();
+
+		Cull();
+		CreateTransients();
+		ComputeBarriers();
+
+		m_Compiled = true;
+	}
+
+	void RenderGraph::Execute(VkCommandBuffer& commandBuffer)
+	{
+		if (!m_Compiled)
+		{
+			VKAPP_LOG_ERROR("Render graph executed without being compiled!");
+			return;
+		}
+
+		for (auto& pass : m_Passes)
+		{
+			if (pass.Culled)
+				continue;
+
+			VKAPP_PROFILE_SCOPE(pass.Name);
+			VKAPP_GPU_ZONE(commandBuffer, pass.Name);
+			RecordBarriers(commandBuffer, pass.Barriers);
+
+			if (pass.RenderPass == VK_NULL_HANDLE)
+			{
+				pass.Execute(commandBuffer, *this);
+				continue;
+			}
+
+			VkRenderPassBeginInfo renderPassInfo = {};
+			renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+			renderPassInfo.renderPass = pass.RenderPass;
+			renderPassInfo.framebuffer = GetFramebuffer(pass);
+			renderPassInfo.renderArea.offset = { 0, 0 };
+			renderPassInfo.renderArea.extent = pass.Extent;
+			renderPassInfo.clearValueCount = static_cast<uint32_t>(pass.ClearValues.size());
+			renderPassInfo.pClearValues = pass.ClearValues.data();
+
+			vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+			VkViewport viewport = {};
+			viewport.x = 0.0f;
+			viewport.y = 0.0f;
+			viewport.width = (float)pass.Extent.width;
+			viewport.height = (float)pass.Extent.height;
+			viewport.minDepth = 0.0f;
+			viewport.maxDepth = 1.0f;
+			vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+			VkRect2D scissor = {};
+			scissor.offset = { 0, 0 };
+			scissor.extent = pass.Extent;
+			vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+			pass.Execute(commandBuffer, *this);
+
+			vkCmdEndRenderPass(commandBuffer);
+		}
+
+		RecordBarriers(commandBuffer, m_FinalBarriers);
+	}
+
+	RenderGraphHandle RenderGraph::GetResource(const std::string& name) const
+	{
+		for (uint32_t i = 0; i < m_Resources.size(); i++)
+		{
+			if (m_Resources[i].Name == name)
+				return { i };
+		}
+
+		return {};
+	}
+
+	VkImage RenderGraph::GetImage(RenderGraphHandle resource) const
+	{
+		return resource.IsValid() && resource.Index < m_Resources.size() ? m_Resources[resource.Index].Image : VK_NULL_HANDLE;
+	}
+
+	VkImageView RenderGraph::GetImageView(RenderGraphHandle resource) const
+	{
+		return resource.IsValid() && resource.Index < m_Resources.size() ? m_Resources[resource.Index].View : VK_NULL_HANDLE;
+	}
+
+	VkBuffer RenderGraph::GetBuffer(RenderGraphHandle resource) const
+	{
+		return resource.IsValid() && resource.Index < m_Resources.size() ? m_Resources[resource.Index].Buffer : VK_NULL_HANDLE;
+	}
+
+	VkExtent2D RenderGraph::GetExtent(RenderGraphHandle resource) const
+	{
+		return resource.IsValid() && resource.Index < m_Resources.size() ? m_Resources[resource.Index].Extent : VkExtent2D();
+	}
+
+	VkRenderPass RenderGraph::GetRenderPass(const std::string& pass) const
+	{
+		for (auto& p : m_Passes)
+		{
+			if (p.Name == pass)
+				return p.RenderPass;
+		}
+
+		return VK_NULL_HANDLE;
+	}
+
+	bool RenderGraph::IsPassCulled(const std::string& pass) const
+	{
+		for (auto& p : m_Passes)
+		{
+			if (p.Name == pass)
+				return p.Culled;
+		}
+
+		return true;
+	}
+
+	// ===================================
+	// ------------- Helper --------------
+	// ===================================
+	void RenderGraph::Cull()
+	{
+		// Walk back from the passes with visible results: writes to imported resources or explicit side effects.
+		std::vector<bool> needed(m_Resources.size(), false);
+
+		for (int32_t i = static_cast<int32_t>(m_Passes.size()) - 1; i >= 0; i--)
+		{
+			Pass& pass = m_Passes[i];
+
+			bool keep = pass.SideEffects;
+			for (auto& access : pass.Accesses)
+			{
+				if (access.Write && (m_Resources[access.Resource].Imported || needed[access.Resource]))
+					keep = true;
+			}
+
+			pass.Culled = !keep;
+			if (!keep)
+				continue;
+
+			// Note: Written resources count as read as well, attachments may load and partial writes keep what was there.
+			for (auto& access : pass.Accesses)
+				needed[access.Resource] = true;
+		}
+	}
+
+	void RenderGraph::CreateTransients()
+	{
+		auto logicalDevice = InstanceManager::Get()->GetLogicalDevice();
+		VkExtent2D swapChainExtent = SwapChainManager::Get()->GetExtent();
+
+		for (uint32_t i = 0; i < m_Passes.size(); i++)
+		{
+			if (m_Passes[i].Culled)
+				continue;
+
+			for (auto& access : m_Passes[i].Accesses)
+			{
+				Resource& resource = m_Resources[access.Resource];
+				UsageInfo info = GetUsageInfo(access.Usage);
+
+				resource.FirstPass = std::min(resource.FirstPass, i);
+				resource.LastPass = std::max(resource.LastPass, i);
+				resource.ImageUsage |= info.ImageUsage;
+				resource.BufferUsage |= info.BufferUsage;
+			}
+		}
+
+		std::vector<uint32_t> transients = { };
+		std::vector<VkMemoryRequirements> requirements(m_Resources.size());
+
+		for (uint32_t i = 0; i < m_Resources.size(); i++)
+		{
+			Resource& resource = m_Resources[i];
+			if (resource.Imported || resource.FirstPass == UINT32_MAX)
+				continue;
+
+			if (resource.IsImage)
+			{
+				resource.Extent.width = resource.ImageInfo.Width ? resource.ImageInfo.Width : swapChainExtent.width;
+				resource.Extent.height = resource.ImageInfo.Height ? resource.ImageInfo.Height : swapChainExtent.height;
+
+				VkImageCreateInfo imageInfo = {};
+				imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+				imageInfo.imageType = VK_IMAGE_TYPE_2D;
+				imageInfo.extent = { resource.Extent.width, resource.Extent.height, 1 };
+				imageInfo.mipLevels = 1;
+				imageInfo.arrayLayers = 1;
+				imageInfo.format = resource.ImageInfo.Format;
+				imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+				imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+				imageInfo.usage = resource.ImageUsage;
+
+				// Note: Used by a single attachment pass, so the contents never have to leave the tile.
+				bool transient = IsAttachmentOnly(resource.ImageUsage) && resource.FirstPass == resource.LastPass;
+				if (transient)
+					imageInfo.usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+				imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+				imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+				if (vkCreateImage(logicalDevice, &imageInfo, nullptr, &resource.Image) != VK_SUCCESS)
+				{
+					VKAPP_LOG_ERROR("Failed to create render graph image \"{0}\"!", resource.Name);
+					continue;
+				}
+
+				vkGetImageMemoryRequirements(logicalDevice, resource.Image, &requirements[i]);
+				resource.Lazy = transient && BufferManager::HasMemoryType(requirements[i].memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT);
+			}
+			else
+			{
+				VkBufferCreateInfo bufferInfo = {};
+				bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+				bufferInfo.size = resource.BufferInfo.Size;
+				bufferInfo.usage = resource.BufferUsage;
+				bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+				if (vkCreateBuffer(logicalDevice, &bufferInfo, nullptr, &resource.Buffer) != VK_SUCCESS)
+				{
+					VKAPP_LOG_ERROR("Failed to create render graph buffer \"{0}\"!", resource.Name);
+					continue;
+				}
+
+				vkGetBufferMemoryRequirements(logicalDevice, resource.Buffer, &requirements[i]);
+			}
+
+			transients.push_back(i);
+			m_TransientRequestedSize += requirements[i].size;
+		}
+
+		// Biggest first, each one goes into the first block that is free for its whole lifetime.
+		std::sort(transients.begin(), transients.end(), [&](uint32_t a, uint32_t b) { return requirements[a].size > requirements[b].size; });
+
+		for (uint32_t index : transients)
+		{
+			const Resource& resource = m_Resources[index];
+
+			MemoryBlock* target = nullptr;
+			for (auto& block : m_MemoryBlocks)
+			{
+				if (block.Lazy != resource.Lazy || (block.MemoryTypeBits & requirements[index].memoryTypeBits) == 0)
+					continue;
+
+				bool overlaps = false;
+				for (uint32_t other : block.Resources)
+				{
+					if (resource.FirstPass <= m_Resources[other].LastPass && m_Resources[other].FirstPass <= resource.LastPass)
+					{
+						overlaps = true;
+						break;
+					}
+				}
+
+				if (!overlaps)
+				{
+					target = &block;
+					break;
+				}
+			}
+
+			if (!target)
+			{
+				m_MemoryBlocks.push_back({ 0, requirements[index].memoryTypeBits, resource.Lazy, { }, VK_NULL_HANDLE });
+				target = &m_MemoryBlocks.back();
+			}
+
+			target->Size = std::max(target->Size, requirements[index].size);
+			target->MemoryTypeBits &= requirements[index].memoryTypeBits;
+			target->Resources.push_back(index);
+		}
+
+		for (auto& block : m_MemoryBlocks)
+		{
+			VkMemoryAllocateInfo allocInfo = {};
+			allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+			allocInfo.allocationSize = block.Size;
+			allocInfo.memoryTypeIndex = BufferManager::FindMemoryType(block.MemoryTypeBits, block.Lazy ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT : VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+			if (vkAllocateMemory(logicalDevice, &allocInfo, nullptr, &block.Memory) != VK_SUCCESS)
+			{
+				VKAPP_LOG_ERROR("Failed to allocate render graph memory!");
+				continue;
+			}
+			else if (ResidencyManager::Get())
+				ResidencyManager::Get()->TrackAllocation(block.Memory, allocInfo.allocationSize, allocInfo.memoryTypeIndex);
+
+			m_TransientMemorySize += block.Size;
+
+			// Note: Everything in a block starts at offset 0, lifetimes never overlap so neither do the contents.
+			std::sort(block.Resources.begin(), block.Resources.end(), [&](uint32_t a, uint32_t b) { return m_Resources[a].FirstPass < m_Resources[b].FirstPass; });
+
+			for (size_t i = 0; i < block.Resources.size(); i++)
+			{
+				Resource& resource = m_Resources[block.Resources[i]];
+				resource.AliasedAfter = i > 0 ? block.Resources[i - 1] : UINT32_MAX;
+
+				if (resource.IsImage)
+				{
+					vkBindImageMemory(logicalDevice, resource.Image, block.Memory, 0);
+					resource.View = BufferManager::CreateImageView(resource.Image, resource.ImageInfo.Format, IsDepthFormat(resource.ImageInfo.Format) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT, 1);
+				}
+				else
+					vkBindBufferMemory(logicalDevice, resource.Buffer, block.Memory, 0);
+			}
+		}
+	}
+
+	void RenderGraph::ComputeBarriers()
+	{
+		struct State
+		{
+		public:
+			VkImageLayout Layout = VK_IMAGE_LAYOUT_UNDEFINED;
+			VkPipelineStageFlags WriteStages = 0;	// Stages of the last write or layout transition
+			VkAccessFlags WriteAccess = 0;
+			VkPipelineStageFlags ReadStages = 0;	// Stages reading since then, a write has to wait for them
+			VkPipelineStageFlags SyncedStages = 0;	// Stages that already see the last write
+			bool Defined = false;
+			bool Used = false;
+		};
+
+		// Note: The first use waits for all earlier commands, that covers the previous frame
+		// still using the same memory and the semaphore wait on the swapchain image.
+		// Even when the contents are undefined the previous frame's attachment writes have to finish first (write after write),
+		// so those are always part of the initial state.
+		std::vector<State> states(m_Resources.size());
+		for (uint32_t i = 0; i < m_Resources.size(); i++)
+		{
+			const Resource& resource = m_Resources[i];
+
+			states[i].Layout = resource.Imported ? resource.InitialLayout : VK_IMAGE_LAYOUT_UNDEFINED;
+			states[i].Defined = resource.Imported && (!resource.IsImage || resource.InitialLayout != VK_IMAGE_LAYOUT_UNDEFINED);
+			states[i].WriteStages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+			if (!resource.IsImage)
+				states[i].WriteAccess = VK_ACCESS_MEMORY_WRITE_BIT;
+			else if (IsDepthFormat(resource.ImageInfo.Format))
+				states[i].WriteAccess = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+			else
+				states[i].WriteAccess = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+			if (states[i].Defined)
+				states[i].WriteAccess |= VK_ACCESS_MEMORY_WRITE_BIT;
+		}
+
+		for (uint32_t passIndex = 0; passIndex < m_Passes.size(); passIndex++)
+		{
+			Pass& pass = m_Passes[passIndex];
+			if (pass.Culled)
+				continue;
+
+			BarrierBatch& batch = pass.Barriers;
+
+			std::vector<uint32_t> colorAttachments = { };
+			std::vector<VkAttachmentLoadOp> colorLoadOps = { };
+			std::vector<VkAttachmentStoreOp> colorStoreOps = { };
+			uint32_t depthAttachment = UINT32_MAX;
+			VkAttachmentLoadOp depthLoadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+			VkAttachmentStoreOp depthStoreOp = VK_ATTACHMENT_STORE_OP_STORE;
+
+			for (auto& access : pass.Accesses)
+			{
+				const Resource& resource = m_Resources[access.Resource];
+				State& state = states[access.Resource];
+				UsageInfo info = GetUsageInfo(access.Usage);
+
+				VkAccessFlags accessMask = info.ReadAccess | (access.Write ? info.WriteAccess : 0);
+				VkImageLayout layout = resource.IsImage ? info.Layout : VK_IMAGE_LAYOUT_UNDEFINED;
+				bool defined = state.Defined;
+
+				// The memory was used by another transient, wait for that one instead.
+				if (!state.Used && resource.AliasedAfter != UINT32_MAX)
+				{
+					const State& previous = states[resource.AliasedAfter];
+					state.WriteStages = previous.WriteStages | previous.ReadStages;
+					state.WriteAccess = previous.WriteAccess;
+				}
+				state.Used = true;
+
+				if (access.Write || layout != state.Layout)
+				{
+					Barrier barrier = {};
+					barrier.Resource = access.Resource;
+					barrier.OldLayout = defined ? state.Layout : VK_IMAGE_LAYOUT_UNDEFINED;
+					barrier.NewLayout = layout;
+					barrier.SrcAccess = state.WriteAccess;
+					barrier.DstAccess = accessMask;
+
+					batch.SrcStages |= state.WriteStages | state.ReadStages;
+					batch.DstStages |= info.Stages;
+					batch.Barriers.push_back(barrier);
+
+					state.Layout = layout;
+					state.WriteStages = info.Stages;
+					state.WriteAccess = access.Write ? info.WriteAccess : 0;
+					state.ReadStages = 0;
+					state.SyncedStages = info.Stages;
+				}
+				else
+				{
+					// Same layout, only has to see the last write once per stage.
+					if ((info.Stages & ~state.SyncedStages) != 0)
+					{
+						Barrier barrier = {};
+						barrier.Resource = access.Resource;
+						barrier.OldLayout = layout;
+						barrier.NewLayout = layout;
+						barrier.SrcAccess = state.WriteAccess;
+						barrier.DstAccess = accessMask;
+
+						batch.SrcStages |= state.WriteStages;
+						batch.DstStages |= info.Stages;
+						batch.Barriers.push_back(barrier);
+
+						state.SyncedStages |= info.Stages;
+					}
+
+					state.ReadStages |= info.Stages;
+				}
+
+				if (access.Write)
+					state.Defined = true;
+
+				if (!IsAttachment(access.Usage))
+					continue;
+
+				VkAttachmentLoadOp loadOp = (defined || access.Usage == RenderGraphUsage::DepthRead) ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR;
+				if (access.LoadOp != VK_ATTACHMENT_LOAD_OP_MAX_ENUM)
+					loadOp = access.LoadOp;
+
+				// Only store what a later pass or the outside world looks at.
+				bool readLater = passIndex < resource.LastPass || (resource.Imported && resource.FinalLayout != VK_IMAGE_LAYOUT_UNDEFINED);
+				VkAttachmentStoreOp storeOp = readLater ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+				if (access.StoreOp != VK_ATTACHMENT_STORE_OP_MAX_ENUM)
+					storeOp = access.StoreOp;
+
+				if (loadOp == VK_ATTACHMENT_LOAD_OP_DONT_CARE)
+					state.Defined = access.Write;
+				if (storeOp == VK_ATTACHMENT_STORE_OP_DONT_CARE)
+					state.Defined = false;
+
+				if (access.Usage == RenderGraphUsage::ColorAttachment)
+				{
+					colorAttachments.push_back(access.Resource);
+					colorLoadOps.push_back(loadOp);
+					colorStoreOps.push_back(storeOp);
+				}
+				else if (depthAttachment == UINT32_MAX)
+				{
+					depthAttachment = access.Resource;
+					depthLoadOp = loadOp;
+					depthStoreOp = storeOp;
+				}
+				else
+					VKAPP_LOG_ERROR("Render graph pass \"{0}\" has more than one depth attachment.", pass.Name);
+			}
+
+			if (colorAttachments.empty() && depthAttachment == UINT32_MAX)
+				continue;
+
+			pass.Attachments = colorAttachments;
+			if (depthAttachment != UINT32_MAX)
+			{
+				pass.Attachments.push_back(depthAttachment);
+				colorLoadOps.push_back(depthLoadOp);
+				colorStoreOps.push_back(depthStoreOp);
+			}
+
+			CreateRenderPass(pass, colorLoadOps, colorStoreOps);
+		}
+
+		// Imported images end up in the layout the outside world expects.
+		for (uint32_t i = 0; i < m_Resources.size(); i++)
+		{
+			const Resource& resource = m_Resources[i];
+			const State& state = states[i];
+
+			// Imported buffers only need the graph's writes to be visible to whoever reads them afterwards.
+			if (resource.Imported && !resource.IsImage && resource.FinalAccess != 0 && state.Used && state.WriteAccess != 0)
+			{
+				Barrier barrier = {};
+				barrier.Resource = i;
+				barrier.SrcAccess = state.WriteAccess;
+				barrier.DstAccess = resource.FinalAccess;
+
+				m_FinalBarriers.SrcStages |= state.WriteStages;
+				m_FinalBarriers.DstStages |= resource.FinalStages;
+				m_FinalBarriers.Barriers.push_back(barrier);
+				continue;
+			}
+
+			if (!resource.Imported || !resource.IsImage || resource.FinalLayout == VK_IMAGE_LAYOUT_UNDEFINED || resource.FinalLayout == state.Layout)
+				continue;
+
+			Barrier barrier = {};
+			barrier.Resource = i;
+			barrier.OldLayout = state.Defined ? state.Layout : VK_IMAGE_LAYOUT_UNDEFINED;
+			barrier.NewLayout = resource.FinalLayout;
+			barrier.SrcAccess = state.WriteAccess;
+			barrier.DstAccess = 0;
+
+			// Note: Copies after the graph (like a headless read back) have to see the writes, presenting only needs the transition.
+			VkPipelineStageFlags dstStages = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+			if (resource.FinalLayout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL)
+			{
+				barrier.DstAccess = VK_ACCESS_TRANSFER_READ_BIT;
+				dstStages = VK_PIPELINE_STAGE_TRANSFER_BIT;
+			}
+
+			m_FinalBarriers.SrcStages |= state.WriteStages | state.ReadStages;
+			m_FinalBarriers.DstStages |= dstStages;
+			m_FinalBarriers.Barriers.push_back(barrier);
+		}
+	}
+
+	void RenderGraph::CreateRenderPass(Pass& pass, const std::vector<VkAttachmentLoadOp>& loadOps, const std::vector<VkAttachmentStoreOp>& storeOps)
+	{
+		RenderPassDescription description = {};
+
+		pass.Extent = m_Resources[pass.Attachments[0]].Extent;
+
+		for (uint32_t i = 0; i < pass.Attachments.size(); i++)
+		{
+			const Resource& resource = m_Resources[pass.Attachments[i]];
+
+			RenderGraphUsage usage = RenderGraphUsage::None;
+			for (auto& access : pass.Accesses)
+			{
+				if (access.Resource == pass.Attachments[i])
+					usage = access.Usage;
+			}
+
+			if (resource.Extent.width != pass.Extent.width || resource.Extent.height != pass.Extent.height)
+				VKAPP_LOG_WARN("Render graph pass \"{0}\" has attachments of different sizes.", pass.Name);
+
+			// Note: The layouts stay the same, the graph's barriers do all transitions.
+			AttachmentDescription attachment = {};
+			attachment.Format = resource.ImageInfo.Format;
+			attachment.LoadOp = loadOps[i];
+			attachment.StoreOp = storeOps[i];
+			attachment.Layout = GetUsageInfo(usage).Layout;
+			attachment.InitialLayout = attachment.Layout;
+			attachment.FinalLayout = attachment.Layout;
+
+			pass.ClearValues.push_back(resource.ImageInfo.ClearValue);
+
+			if (usage == RenderGraphUsage::ColorAttachment)
+				description.ColorAttachments.push_back(attachment);
+			else
+				description.DepthAttachment = attachment;
+		}
+
+		pass.RenderPass = description.Create();
+	}
+
+	void RenderGraph::RecordBarriers(VkCommandBuffer& commandBuffer, const BarrierBatch& batch)
+	{
+		if (batch.Barriers.empty())
+			return;
+
+		std::vector<VkImageMemoryBarrier> imageBarriers = { };
+		std::vector<VkBufferMemoryBarrier> bufferBarriers = { };
+
+		for (auto& barrier : batch.Barriers)
+		{
+			const Resource& resource = m_Resources[barrier.Resource];
+
+			if (resource.IsImage)
+			{
+				VkImageMemoryBarrier imageBarrier = {};
+				imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+				imageBarrier.oldLayout = barrier.OldLayout;
+				imageBarrier.newLayout = barrier.NewLayout;
+				imageBarrier.srcAccessMask = barrier.SrcAccess;
+				imageBarrier.dstAccessMask = barrier.DstAccess;
+				imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				imageBarrier.image = resource.Image;
+				imageBarrier.subresourceRange.aspectMask = GetAspect(resource.ImageInfo.Format);
+				imageBarrier.subresourceRange.baseMipLevel = 0;
+				imageBarrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+				imageBarrier.subresourceRange.baseArrayLayer = 0;
+				imageBarrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+				imageBarriers.push_back(imageBarrier);
+			}
+			else
+			{
+				VkBufferMemoryBarrier bufferBarrier = {};
+				bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+				bufferBarrier.srcAccessMask = barrier.SrcAccess;
+				bufferBarrier.dstAccessMask = barrier.DstAccess;
+				bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				bufferBarrier.buffer = resource.Buffer;
+				bufferBarrier.offset = 0;
+				bufferBarrier.size = VK_WHOLE_SIZE;
+				bufferBarriers.push_back(bufferBarrier);
+			}
+		}
+
+		vkCmdPipelineBarrier(commandBuffer,
+			batch.SrcStages ? batch.SrcStages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, batch.DstStages, 0,
+			0, nullptr,
+			static_cast<uint32_t>(bufferBarriers.size()), bufferBarriers.data(),
+			static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+	}
+
+	VkFramebuffer RenderGraph::GetFramebuffer(Pass& pass)
+	{
+		std::vector<VkImageView> views = { };
+		for (uint32_t attachment : pass.Attachments)
+			views.push_back(m_Resources[attachment].View);
+
+		auto it = pass.Framebuffers.find(views);
+		if (it != pass.Framebuffers.end())
+			return it->second;
+
+		VkFramebufferCreateInfo framebufferInfo = {};
+		framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		framebufferInfo.renderPass = pass.RenderPass;
+		framebufferInfo.attachmentCount = static_cast<uint32_t>(views.size());
+		framebufferInfo.pAttachments = views.data();
+		framebufferInfo.width = pass.Extent.width;
+		framebufferInfo.height = pass.Extent.height;
+		framebufferInfo.layers = 1;
+
+		VkFramebuffer framebuffer = VK_NULL_HANDLE;
+		if (vkCreateFramebuffer(InstanceManager::Get()->GetLogicalDevice(), &framebufferInfo, nullptr, &framebuffer) != VK_SUCCESS)
+			VKAPP_LOG_ERROR("Failed to create framebuffer for render graph pass \"{0}\"!", pass.Name);
+
+		pass.Framebuffers[views] = framebuffer;
+		return framebuffer;
+	}
+
+	void RenderGraph::DestroyCompiled()
+	{
+		if (!m_Compiled)
+			return;
+
+		// Note: Recording from now on uses what the next compile creates, so only submitted frames can still use these.
+		Retired retired = {};
+		retired.Value = InstanceManager::Get()->GetGraphicsTimeline().GetLastSubmitted();
+
+		for (auto& pass : m_Passes)
+		{
+			for (auto& [views, framebuffer] : pass.Framebuffers)
+				retired.Framebuffers.push_back(framebuffer);
+
+			retired.RenderPasses.push_back(pass.RenderPass);
+
+			pass.Culled = false;
+			pass.Barriers = {};
+			pass.Attachments.clear();
+			pass.ClearValues.clear();
+			pass.Extent = {};
+			pass.RenderPass = VK_NULL_HANDLE;
+			pass.Framebuffers.clear();
+		}
+
+		for (auto& resource : m_Resources)
+		{
+			if (!resource.Imported)
+			{
+				if (resource.View != VK_NULL_HANDLE)
+					retired.Views.push_back(resource.View);
+
+				retired.Images.push_back(resource.Image);
+				retired.Buffers.push_back(resource.Buffer);
+
+				resource.View = VK_NULL_HANDLE;
+				resource.Image = VK_NULL_HANDLE;
+				resource.Buffer = VK_NULL_HANDLE;
+				resource.Extent = {};
+			}
+
+			resource.ImageUsage = 0;
+			resource.BufferUsage = 0;
+			resource.FirstPass = UINT32_MAX;
+			resource.LastPass = 0;
+			resource.AliasedAfter = UINT32_MAX;
+			resource.Lazy = false;
+		}
+
+		for (auto& block : m_MemoryBlocks)
+			retired.Memory.push_back(block.Memory);
+
+		m_MemoryBlocks.clear();
+		m_Retired.push_back(std::move(retired));
+		m_FinalBarriers = {};
+
+		m_TransientMemorySize = 0;
+		m_TransientRequestedSize = 0;
+		m_Compiled = false;
+	}
+
+
+	void RenderGraph::DestroyRetired(bool force)
+	{
+		auto logicalDevice = InstanceManager::Get()->GetLogicalDevice();
+
+		for (auto it = m_Retired.begin(); it != m_Retired.end();)
+		{
+			if (!force && !InstanceManager::Get()->GetGraphicsTimeline().IsComplete(it->Value))
+			{
+				++it;
+				continue;
+			}
+
+			for (auto framebuffer : it->Framebuffers)
+				vkDestroyFramebuffer(logicalDevice, framebuffer, nullptr);
+			for (auto renderPass : it->RenderPasses)
+				vkDestroyRenderPass(logicalDevice, renderPass, nullptr);
+
+			// Note: Views go back to the DeviceObjectCache before their image is destroyed.
+			for (auto& view : it->Views)
+				BufferManager::DestroyImageView(view);
+			for (auto image : it->Images)
+				vkDestroyImage(logicalDevice, image, nullptr);
+			for (auto buffer : it->Buffers)
+				vkDestroyBuffer(logicalDevice, buffer, nullptr);
+
+			for (auto memory : it->Memory)
+			{
+				if (ResidencyManager::Get())
+					ResidencyManager::Get()->UntrackAllocation(memory);
+
+				vkFreeMemory(logicalDevice, memory, nullptr);
+			}
+
+			it = m_Retired.erase(it);
+		}
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include <vulkan/vulkan.h>
+
+namespace VkApp
+{
+
+	class RenderGraph;
+
+	// How a pass uses a resource, decides the stage, access mask and image layout of the barriers.
+	enum class RenderGraphUsage
+	{
+		None = 0,
+		ColorAttachment, DepthAttachment, DepthRead,	// Attachments, passes using these get a render pass
+		FragmentSampled, ComputeSampled,
+		StorageRead, StorageWrite,						// Compute shader storage images/buffers
+		FragmentStorageWrite,							// Fragment shader storage writes, like virtual texture feedback
+		TransferSrc, TransferDst,
+		VertexBuffer, IndexBuffer, UniformBuffer, IndirectBuffer
+	};
+
+	struct RenderGraphHandle
+	{
+	public:
+		uint32_t Index = UINT32_MAX;
+
+		inline bool IsValid() const { return Index != UINT32_MAX; }
+	};
+
+	struct RenderGraphImageInfo
+	{
+	public:
+		uint32_t Width = 0;		// 0 means the swapchain extent
+		uint32_t Height = 0;
+		VkFormat Format = VK_FORMAT_R8G8B8A8_UNORM;
+
+		VkClearValue ClearValue = {}; // Used when a pass starts writing to it while its contents are undefined
+	};
+
+	struct RenderGraphBufferInfo
+	{
+	public:
+		VkDeviceSize Size = 0;
+	};
+
+	class RenderGraphBuilder
+	{
+	public:
+		// Transient resources, they only live during the frame and share memory when their lifetimes don't overlap.
+		RenderGraphHandle CreateImage(const std::string& name, const RenderGraphImageInfo& info);
+		RenderGraphHandle CreateBuffer(const std::string& name, const RenderGraphBufferInfo& info);
+
+		void Read(RenderGraphHandle resource, RenderGraphUsage usage);
+		void Write(RenderGraphHandle resource, RenderGraphUsage usage);
+
+		// Overrides the load/store ops the graph picks for an attachment of this pass, call it after Read/Write.
+		// By default it loads defined contents, clears undefined ones and only stores what is used afterwards.
+		void SetAttachmentOps(RenderGraphHandle resource, VkAttachmentLoadOp loadOp, VkAttachmentStoreOp storeOp);
+
+		// Keeps the pass even if nothing reads what it writes.
+		void SetSideEffects();
+
+	private:
+		RenderGraphBuilder(RenderGraph& graph, uint32_t pass)
+			: m_Graph(graph), m_Pass(pass) {}
+
+		void Access(RenderGraphHandle resource, RenderGraphUsage usage, bool write);
+
+	private:
+		RenderGraph& m_Graph;
+		uint32_t m_Pass = 0;
+
+		friend class RenderGraph;
+	};
+
+	typedef std::function<void(RenderGraphBuilder&)> RenderGraphSetupFunction;
+	typedef std::function<void(VkCommandBuffer&, RenderGraph&)> RenderGraphExecuteFunction;
+
+	// Frame graph, passes declare what they read and write and the graph takes care of the rest:
+	// unused passes are culled, barriers are computed and batched per pass, attachment passes get
+	// their render pass and framebuffer, and transient resources alias memory when possible.
+	// Images that only live within a single attachment pass become transient attachments with lazily allocated memory.
+	// Build it once, Compile() it and Execute() it every frame. Reset and rebuild when the swapchain changes.
+	class RenderGraph
+	{
+	public:
+		RenderGraph() = default;
+		void Destroy();
+
+		// Removes all passes and resources.
+		void Reset();
+
+		// A final layout of VK_IMAGE_LAYOUT_UNDEFINED means the contents aren't needed after the graph.
+		RenderGraphHandle ImportImage(const std::string& name, VkImage image, VkImageView view, VkFormat format, VkExtent2D extent, VkImageLayout initialLayout, VkImageLayout finalLayout, const VkClearValue& clearValue = {});
+		// The final stages and access are how the buffer is used after the graph, like VK_PIPELINE_STAGE_HOST_BIT and
+		// VK_ACCESS_HOST_READ_BIT for a read back. The final barriers make the graph's writes visible to them.
+		RenderGraphHandle ImportBuffer(const std::string& name, VkBuffer buffer, VkDeviceSize size, VkPipelineStageFlags finalStages = 0, VkAccessFlags finalAccess = 0);
+
+		// Swaps the image behind an import, like the swapchain image of this frame.
+		void SetImportedImage(RenderGraphHandle resource, VkImage image, VkImageView view);
+
+		void AddPass(const std::string& name, RenderGraphSetupFunction setup, RenderGraphExecuteFunction execute);
+
+		void Compile();
+		void Execute(VkCommandBuffer& commandBuffer);
+
+		RenderGraphHandle GetResource(const std::string& name) const;
+
+		VkImage GetImage(RenderGraphHandle resource) const;
+		VkImageView GetImageView(RenderGraphHandle resource) const;
+		VkBuffer GetBuffer(RenderGraphHandle resource) const;
+		VkExtent2D GetExtent(RenderGraphHandle resource) const;
+
+		// Only valid after Compile(), for creating pipelines. Pipelines stay valid with the render pass of later compiles.
+		VkRenderPass GetRenderPass(const std::string& pass) const;
+		bool IsPassCulled(const std::string& pass) const;
+
+		inline bool IsCompiled() const { return m_Compiled; }
+
+		// Destroys what earlier compiles left behind once the frames using it are done, call once per frame.
+		void DestroyRetired(bool force = false);
+
+		inline VkDeviceSize GetTransientMemorySize() const { return m_TransientMemorySize; }		// After aliasing
+		inline VkDeviceSize GetTransientRequestedSize() const { return m_TransientRequestedSize; }	// Without aliasing
+
+	private:
+		struct Resource
+		{
+		public:
+			std::string Name = {};
+			bool IsImage = true;
+			bool Imported = false;
+
+			RenderGraphImageInfo ImageInfo = {};
+			RenderGraphBufferInfo BufferInfo = {};
+
+			VkImageLayout InitialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			VkImageLayout FinalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			VkPipelineStageFlags FinalStages = 0; // Buffers only
+			VkAccessFlags FinalAccess = 0;
+
+			VkImage Image = VK_NULL_HANDLE;
+			VkImageView View = VK_NULL_HANDLE;
+			VkBuffer Buffer = VK_NULL_HANDLE;
+			VkExtent2D Extent = {};
+
+			// Filled in by Compile()
+			VkImageUsageFlags ImageUsage = 0;
+			VkBufferUsageFlags BufferUsage = 0;
+			uint32_t FirstPass = UINT32_MAX;
+			uint32_t LastPass = 0;
+			uint32_t AliasedAfter = UINT32_MAX; // The resource that used the memory before this one
+			bool Lazy = false;
+		};
+
+		struct PassAccess
+		{
+		public:
+			uint32_t Resource = 0;
+			RenderGraphUsage Usage = RenderGraphUsage::None;
+			bool Write = false;
+
+			// Max enum lets the graph decide
+			VkAttachmentLoadOp LoadOp = VK_ATTACHMENT_LOAD_OP_MAX_ENUM;
+			VkAttachmentStoreOp StoreOp = VK_ATTACHMENT_STORE_OP_MAX_ENUM;
+		};
+
+		struct Barrier
+		{
+		public:
+			uint32_t Resource = 0;
+			VkImageLayout OldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			VkImageLayout NewLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			VkAccessFlags SrcAccess = 0;
+			VkAccessFlags DstAccess = 0;
+		};
+
+		struct BarrierBatch
+		{
+		public:
+			VkPipelineStageFlags SrcStages = 0;
+			VkPipelineStageFlags DstStages = 0;
+			std::vector<Barrier> Barriers = { };
+		};
+
+		struct Pass
+		{
+		public:
+			std::string Name = {};
+			RenderGraphExecuteFunction Execute = {};
+			std::vector<PassAccess> Accesses = { };
+			bool SideEffects = false;
+
+			// Filled in by Compile()
+			bool Culled = false;
+			BarrierBatch Barriers = {};
+
+			std::vector<uint32_t> Attachments = { }; // Colour attachments first, depth last
+			std::vector<VkClearValue> ClearValues = { };
+			VkExtent2D Extent = {};
+			VkRenderPass RenderPass = VK_NULL_HANDLE;
+			std::map<std::vector<VkImageView>, VkFramebuffer> Framebuffers = { };
+		};
+
+		struct MemoryBlock
+		{
+		public:
+			VkDeviceSize Size = 0;
+			uint32_t MemoryTypeBits = 0;
+			bool Lazy = false;
+			std::vector<uint32_t> Resources = { };
+			VkDeviceMemory Memory = VK_NULL_HANDLE;
+		};
+
+		void Cull();
+		void CreateTransients();
+		void ComputeBarriers();
+		void CreateRenderPass(Pass& pass, const std::vector<VkAttachmentLoadOp>& loadOps, const std::vector<VkAttachmentStoreOp>& storeOps);
+
+		void RecordBarriers(VkCommandBuffer& commandBuffer, const BarrierBatch& batch);
+		VkFramebuffer GetFramebuffer(Pass& pass);
+
+		void DestroyCompiled();
+
+	private:
+		std::vector<Resource> m_Resources = { };
+		std::vector<Pass> m_Passes = { };
+		std::vector<MemoryBlock> m_MemoryBlocks = { };
+
+		BarrierBatch m_FinalBarriers = {}; // Moves imported images to their final layout, makes imported buffers visible to their final access
+
+		// What an earlier compile created, frames in flight might still use it. Destroyed once the graphics timeline passes the value.
+		struct Retired
+		{
+		public:
+			uint64_t Value = 0;
+
+			std::vector<VkFramebuffer> Framebuffers = { };
+			std::vector<VkRenderPass> RenderPasses = { };
+			std::vector<VkImageView> Views = { };
+			std::vector<VkImage> Images = { };
+			std::vector<VkBuffer> Buffers = { };
+			std::vector<VkDeviceMemory> Memory = { };
+		};
+		std::vector<Retired> m_Retired = { };
+
+		bool m_Compiled = false;
+		VkDeviceSize m_TransientMemorySize = 0;
+		VkDeviceSize m_TransientRequestedSize = 0;
+
+		friend class RenderGraphBuilder;
+	};
+
+}
\ No newline at end of file
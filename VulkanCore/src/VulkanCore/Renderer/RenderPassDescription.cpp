@@ -0,0 +1,80 @@
+#include "vcpch.h"
+#include "RenderPassDescription.hpp"
+
+#include "VulkanCore/Core/Logging.hpp"
+
+#include "VulkanCore/Renderer/InstanceManager.hpp"
+
+#include "VulkanCore/Utils/BufferManager.hpp"
+
+namespace VkApp
+{
+
+	// ===================================
+	// ------------- Helper --------------
+	// ===================================
+	static VkAttachmentDescription ToVulkan(const AttachmentDescription& description, bool stencil)
+	{
+		VkAttachmentDescription attachment = {};
+		attachment.format = description.Format;
+		attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+		attachment.loadOp = description.LoadOp;
+		attachment.storeOp = description.StoreOp;
+		attachment.stencilLoadOp = stencil ? description.LoadOp : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		attachment.stencilStoreOp = stencil ? description.StoreOp : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		attachment.initialLayout = description.InitialLayout;
+		attachment.finalLayout = description.FinalLayout;
+
+		return attachment;
+	}
+
+	// ===================================
+	// ------------ Public ---------------
+	// ===================================
+	VkRenderPass RenderPassDescription::Create() const
+	{
+		std::vector<VkAttachmentDescription> attachments = { };
+		std::vector<VkAttachmentReference> colorReferences = { };
+		VkAttachmentReference depthReference = {};
+
+		for (auto& color : ColorAttachments)
+		{
+			VkImageLayout layout = color.Layout != VK_IMAGE_LAYOUT_UNDEFINED ? color.Layout : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+			colorReferences.push_back({ static_cast<uint32_t>(attachments.size()), layout });
+			attachments.push_back(ToVulkan(color, false));
+		}
+
+		bool hasDepth = DepthAttachment.Format != VK_FORMAT_UNDEFINED;
+		if (hasDepth)
+		{
+			VkImageLayout layout = DepthAttachment.Layout != VK_IMAGE_LAYOUT_UNDEFINED ? DepthAttachment.Layout : VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+			bool stencil = BufferManager::HasStencilComponent(DepthAttachment.Format) || DepthAttachment.Format == VK_FORMAT_D16_UNORM_S8_UINT;
+
+			depthReference = { static_cast<uint32_t>(attachments.size()), layout };
+			attachments.push_back(ToVulkan(DepthAttachment, stencil));
+		}
+
+		VkSubpassDescription subpass = {};
+		subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+		subpass.colorAttachmentCount = static_cast<uint32_t>(colorReferences.size());
+		subpass.pColorAttachments = colorReferences.data();
+		subpass.pDepthStencilAttachment = hasDepth ? &depthReference : nullptr;
+
+		VkRenderPassCreateInfo renderPassInfo = {};
+		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+		renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+		renderPassInfo.pAttachments = attachments.data();
+		renderPassInfo.subpassCount = 1;
+		renderPassInfo.pSubpasses = &subpass;
+		renderPassInfo.dependencyCount = static_cast<uint32_t>(Dependencies.size());
+		renderPassInfo.pDependencies = Dependencies.data();
+
+		VkRenderPass renderPass = VK_NULL_HANDLE;
+		if (vkCreateRenderPass(InstanceManager::Get()->GetLogicalDevice(), &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS)
+			VKAPP_LOG_ERROR("Failed to create render pass!");
+
+		return renderPass;
+	}
+
+}
\ No newline at end of file
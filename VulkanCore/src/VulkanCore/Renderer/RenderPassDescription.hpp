@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+namespace VkApp
+{
+
+	struct AttachmentDescription
+	{
+	public:
+		VkFormat Format = VK_FORMAT_UNDEFINED;
+
+		// Note: Use DONT_CARE for anything that isn't read back afterwards, tiled GPUs then never write it to memory.
+		VkAttachmentLoadOp LoadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		VkAttachmentStoreOp StoreOp = VK_ATTACHMENT_STORE_OP_STORE;
+
+		VkImageLayout InitialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		VkImageLayout FinalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		VkImageLayout Layout = VK_IMAGE_LAYOUT_UNDEFINED; // During the subpass, undefined picks the attachment optimal layout
+	};
+
+	// A render pass with a single subpass, stencil uses the same load/store ops as depth.
+	struct RenderPassDescription
+	{
+	public:
+		std::vector<AttachmentDescription> ColorAttachments = { };
+		AttachmentDescription DepthAttachment = {}; // Left out when the format is undefined
+
+		std::vector<VkSubpassDependency> Dependencies = { };
+
+	public:
+		VkRenderPass Create() const;
+	};
+
+}
\ No newline at end of file
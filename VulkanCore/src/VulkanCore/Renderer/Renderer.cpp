@@ -4,6 +4,9 @@
 #include "VulkanCore/Core/Application.hpp"
 
 #include "VulkanCore/Core/Logging.hpp"
+#include "VulkanCore/Core/Profiler.hpp"
+
+#include "VulkanCore/Utils/BufferManager.hpp"
 
 namespace VkApp
 {
@@ -12,10 +15,14 @@ namespace VkApp
 	// ===================================
 	Renderer* Renderer::s_Instance = nullptr;
 
-	void Renderer::Init()
+	void Renderer::Init(const RendererSettings& settings)
 	{
 		s_Instance = new Renderer();
 
+		s_Instance->m_FramesInFlight = std::clamp(settings.FramesInFlight, 1u, (uint32_t)VKAPP_MAX_FRAMES_IN_FLIGHT);
+		if (s_Instance->m_FramesInFlight != settings.FramesInFlight)
+			VKAPP_LOG_WARN("{0} frames in flight isn't supported, using {1}.", settings.FramesInFlight, s_Instance->m_FramesInFlight);
+
 		// Create our own rendering specific things.
 		s_Instance->CreateCommandPool();
 		s_Instance->CreateCommandBuffers();
@@ -28,28 +35,33 @@ namespace VkApp
 	{
 		vkDeviceWaitIdle(s_Instance->m_InstanceManager.m_Device);
 
+		s_Instance->m_RenderGraph.Destroy();
+		s_Instance->m_GpuProfiler.Destroy();
+		s_Instance->m_MipGenerator.Destroy();
 		s_Instance->m_GraphicsPipelineManager.Destroy();
 		s_Instance->m_SwapChainManager.Destroy();
+		BufferManager::DestroyRetired(true);
 
 		// Destoy our rendering specific stuff before destroying the instance
-		for (size_t i = 0; i < VKAPP_MAX_FRAMES_IN_FLIGHT; i++)
+		for (size_t i = 0; i < s_Instance->m_FramesInFlight; i++)
 		{
 			vkDestroySemaphore(s_Instance->m_InstanceManager.m_Device, s_Instance->m_RenderFinishedSemaphores[i], nullptr);
 			vkDestroySemaphore(s_Instance->m_InstanceManager.m_Device, s_Instance->m_ImageAvailableSemaphores[i], nullptr);
-			vkDestroyFence(s_Instance->m_InstanceManager.m_Device, s_Instance->m_InFlightFences[i], nullptr);
 		}
 
 		vkDestroyCommandPool(s_Instance->m_InstanceManager.m_Device, s_Instance->m_CommandPool, nullptr);
 
+		s_Instance->m_ResidencyManager.Destroy();
+		s_Instance->m_DeviceObjectCache.Destroy();
 		s_Instance->m_InstanceManager.Destroy(); // Note(Jorben): Destroy InstanceManager last.
 
 		delete s_Instance;
 		s_Instance = nullptr;
 	}
 
-	void Renderer::AddToQueue(RenderFunction func)
+	void Renderer::AddToQueue(RenderFunction func, const std::string& zone)
 	{
-		s_Instance->m_RenderQueue.push_back(func);
+		s_Instance->m_RenderQueue.push_back({ func, zone.empty() ? s_Instance->m_QueueZone : zone });
 	}
 
 	void Renderer::AddToUIQueue(UIFunction func)
@@ -57,9 +69,41 @@ namespace VkApp
 		s_Instance->m_UIQueue.push_back(func);
 	}
 
-	void Renderer::Display()
+	void Renderer::SetQueueZone(const std::string& zone)
+	{
+		s_Instance->m_QueueZone = zone.empty() ? "Render" : zone;
+	}
+
+	bool Renderer::BeginFrame()
+	{
+		VKAPP_PROFILE_FUNCTION();
+
+		if (s_Instance->m_FrameBegun)
+		{
+			VKAPP_LOG_WARN("Renderer::BeginFrame() called twice without Renderer::EndFrame().");
+			return true;
+		}
+
+		// Note: Between frames nothing is being recorded, so this is the one place the swapchain can be swapped out.
+		SwapChainManager& swapChain = s_Instance->m_SwapChainManager;
+		if (swapChain.IsRecreateRequested())
+		{
+			VKAPP_PROFILE_SCOPE("Renderer::RecreateSwapChain");
+			swapChain.RecreateSwapChain();
+		}
+		swapChain.DestroyRetired(false);
+		s_Instance->m_RenderGraph.DestroyRetired(false);
+		BufferManager::DestroyRetired(false);
+
+		return s_Instance->AcquireImage();
+	}
+
+	void Renderer::EndFrame()
 	{
-		s_Instance->QueuePresent();
+		VKAPP_PROFILE_FUNCTION();
+
+		if (s_Instance->m_FrameBegun)
+			s_Instance->QueuePresent();
 
 		s_Instance->m_RenderQueue.clear();
 		s_Instance->m_UIQueue.clear();
@@ -67,7 +111,87 @@ namespace VkApp
 
 	void Renderer::OnResize(uint32_t width, uint32_t height)
 	{
-		s_Instance->m_SwapChainManager.RecreateSwapChain(Application::Get().GetWindow().IsVSync());
+		s_Instance->m_SwapChainManager.RequestRecreate();
+	}
+
+	bool Renderer::ReadBackFrame(std::vector<uint8_t>& pixels, uint32_t& width, uint32_t& height)
+	{
+		SwapChainManager& swapChain = s_Instance->m_SwapChainManager;
+
+		if (!swapChain.IsHeadless())
+		{
+			VKAPP_LOG_ERROR("Renderer::ReadBackFrame() is only supported when headless.");
+			return false;
+		}
+
+		// Note: Recreating the images throws away what was rendered.
+		if (s_Instance->m_LastImage == UINT32_MAX || s_Instance->m_RenderGraphGeneration != swapChain.GetGeneration())
+			return false;
+
+		width = swapChain.m_SwapChainExtent.width;
+		height = swapChain.m_SwapChainExtent.height;
+
+		VkDeviceSize size = (VkDeviceSize)width * height * 4;
+
+		VkBuffer stagingBuffer = VK_NULL_HANDLE;
+		VkDeviceMemory stagingBufferMemory = VK_NULL_HANDLE;
+		BufferManager::CreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
+
+		VkBufferImageCopy region = {};
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.layerCount = 1;
+		region.imageExtent = { width, height, 1 };
+
+		// Note: Same queue as the frames, the render graph's final barrier already made the image visible to transfers.
+		VkCommandBuffer commandBuffer = BufferManager::BeginSingleTimeCommands();
+		vkCmdCopyImageToBuffer(commandBuffer, swapChain.m_SwapChainImages[s_Instance->m_LastImage], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, stagingBuffer, 1, &region);
+
+		VkBufferMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.buffer = stagingBuffer;
+		barrier.offset = 0;
+		barrier.size = VK_WHOLE_SIZE;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+
+		BufferManager::EndSingleTimeCommandsAndWait(commandBuffer);
+
+		void* data = nullptr;
+		vkMapMemory(s_Instance->m_InstanceManager.m_Device, stagingBufferMemory, 0, size, 0, &data);
+		pixels.resize(size);
+		memcpy(pixels.data(), data, size);
+		vkUnmapMemory(s_Instance->m_InstanceManager.m_Device, stagingBufferMemory);
+
+		BufferManager::DestroyBuffer(stagingBuffer, stagingBufferMemory);
+		return true;
+	}
+
+	void Renderer::SetRenderGraph(RenderGraphBuildFunction build)
+	{
+		s_Instance->m_BuildRenderGraph = build;
+		s_Instance->m_RenderGraphGeneration = UINT32_MAX;
+	}
+
+	void Renderer::ExecuteRenderQueue(VkCommandBuffer& commandBuffer)
+	{
+		for (auto& item : s_Instance->m_RenderQueue)
+		{
+			VKAPP_GPU_ZONE(commandBuffer, item.Zone);
+			item.Func(commandBuffer, s_Instance->m_ImageIndex);
+		}
+	}
+
+	void Renderer::ExecuteUIQueue(VkCommandBuffer& commandBuffer)
+	{
+		if (s_Instance->m_UIQueue.empty())
+			return;
+
+		VKAPP_GPU_ZONE(commandBuffer, "ImGui");
+		for (auto& func : s_Instance->m_UIQueue)
+			func(commandBuffer);
 	}
 
 	// ===================================
@@ -92,7 +216,7 @@ namespace VkApp
 
 	void Renderer::CreateCommandBuffers()
 	{
-		m_CommandBuffers.resize(VKAPP_MAX_FRAMES_IN_FLIGHT);
+		m_CommandBuffers.resize(m_FramesInFlight);
 
 		VkCommandBufferAllocateInfo allocInfo = {};
 		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -106,23 +230,18 @@ namespace VkApp
 
 	void Renderer::CreateSyncObjects()
 	{
-		m_ImageAvailableSemaphores.resize(VKAPP_MAX_FRAMES_IN_FLIGHT);
-		m_RenderFinishedSemaphores.resize(VKAPP_MAX_FRAMES_IN_FLIGHT);
-		m_InFlightFences.resize(VKAPP_MAX_FRAMES_IN_FLIGHT);
+		m_ImageAvailableSemaphores.resize(m_FramesInFlight);
+		m_RenderFinishedSemaphores.resize(m_FramesInFlight);
+		m_FrameValues.assign(m_FramesInFlight, 0);
 
 		VkSemaphoreCreateInfo semaphoreInfo = {};
 		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-		VkFenceCreateInfo fenceInfo = {};
-		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-		fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
 		// Create our objects
-		for (size_t i = 0; i < VKAPP_MAX_FRAMES_IN_FLIGHT; i++)
+		for (size_t i = 0; i < m_FramesInFlight; i++)
 		{
 			if (vkCreateSemaphore(m_InstanceManager.m_Device, &semaphoreInfo, nullptr, &m_ImageAvailableSemaphores[i]) != VK_SUCCESS ||
-				vkCreateSemaphore(m_InstanceManager.m_Device, &semaphoreInfo, nullptr, &m_RenderFinishedSemaphores[i]) != VK_SUCCESS ||
-				vkCreateFence(m_InstanceManager.m_Device, &fenceInfo, nullptr, &m_InFlightFences[i]) != VK_SUCCESS)
+				vkCreateSemaphore(m_InstanceManager.m_Device, &semaphoreInfo, nullptr, &m_RenderFinishedSemaphores[i]) != VK_SUCCESS)
 			{
 				VKAPP_LOG_ERROR("Failed to create synchronization objects for a frame!");
 			}
@@ -132,47 +251,136 @@ namespace VkApp
 	// ===================================
 	// ------------- Helper --------------
 	// ===================================
-	void Renderer::QueuePresent()
+	void Renderer::BuildRenderGraph()
+	{
+		VKAPP_PROFILE_FUNCTION();
+
+		m_RenderGraph.Reset();
+
+		VkExtent2D extent = m_SwapChainManager.m_SwapChainExtent;
+
+		VkClearValue colorClear = {};
+		colorClear.color = { {0.0f, 0.0f, 0.0f, 1.0f} };
+
+		VkClearValue depthClear = {};
+		depthClear.depthStencil = { 1.0f, 0 };
+
+		// Note: The actual swapchain image is set every frame in RecordCommandBuffer.
+		m_Backbuffer = m_RenderGraph.ImportImage("Backbuffer", VK_NULL_HANDLE, VK_NULL_HANDLE, m_SwapChainManager.m_SwapChainImageFormat, extent, VK_IMAGE_LAYOUT_UNDEFINED, m_SwapChainManager.GetPresentLayout(), colorClear);
+		RenderGraphHandle depth = m_RenderGraph.ImportImage("Depth", m_SwapChainManager.m_DepthImage, m_SwapChainManager.m_DepthImageView, m_SwapChainManager.GetDepthFormat(), extent, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_UNDEFINED, depthClear);
+
+		if (m_BuildRenderGraph)
+			m_BuildRenderGraph(m_RenderGraph, m_Backbuffer);
+		else
+		{
+			RenderGraphHandle backbuffer = m_Backbuffer;
+			m_RenderGraph.AddPass("Main", [backbuffer, depth](RenderGraphBuilder& builder)
+			{
+				builder.Write(backbuffer, RenderGraphUsage::ColorAttachment);
+				builder.Write(depth, RenderGraphUsage::DepthAttachment);
+			},
+			[](VkCommandBuffer& commandBuffer, RenderGraph& graph)
+			{
+				ExecuteRenderQueue(commandBuffer);
+				ExecuteUIQueue(commandBuffer);
+			});
+		}
+
+		m_RenderGraph.Compile();
+		m_RenderGraphGeneration = m_SwapChainManager.GetGeneration();
+	}
+
+	bool Renderer::AcquireImage()
 	{
-		vkWaitForFences(m_InstanceManager.m_Device, 1, &m_InFlightFences[m_CurrentFrame], VK_TRUE, UINT64_MAX);
+		QueueTimeline& timeline = m_InstanceManager.m_GraphicsTimeline;
+
+		// Wait until the last frame that used this slot's command buffer, semaphores and per frame buffers is done
+		{
+			VKAPP_PROFILE_SCOPE("Renderer::WaitForFrame");
+			timeline.Wait(m_FrameValues[m_CurrentFrame]);
+		}
+
+		// Note: Headless the frame slot owns an image, which the wait above already freed up.
+		if (m_SwapChainManager.IsHeadless())
+		{
+			m_ImageIndex = m_CurrentFrame;
+			m_FrameBegun = true;
+			m_FrameGeneration = m_SwapChainManager.GetGeneration();
+			return true;
+		}
 
-		uint32_t imageIndex;
+		VkResult result = VK_SUCCESS;
+		{
+			VKAPP_PROFILE_SCOPE("Renderer::AcquireImage");
+			result = vkAcquireNextImageKHR(m_InstanceManager.m_Device, m_SwapChainManager.m_SwapChain, UINT64_MAX, m_ImageAvailableSemaphores[m_CurrentFrame], VK_NULL_HANDLE, &m_ImageIndex);
+		}
 
-		VkResult result = vkAcquireNextImageKHR(m_InstanceManager.m_Device, m_SwapChainManager.m_SwapChain, UINT64_MAX, m_ImageAvailableSemaphores[m_CurrentFrame], VK_NULL_HANDLE, &imageIndex);
 		if (result == VK_ERROR_OUT_OF_DATE_KHR)
 		{
-			m_SwapChainManager.RecreateSwapChain();
-			return;
+			m_SwapChainManager.RequestRecreate();
+			return false;
 		}
 		else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+		{
 			VKAPP_LOG_ERROR("Failed to acquire swap chain image!");
+			return false;
+		}
+
+		m_FrameBegun = true;
+		m_FrameGeneration = m_SwapChainManager.GetGeneration();
+		return true;
+	}
+
+	void Renderer::QueuePresent()
+	{
+		QueueTimeline& timeline = m_InstanceManager.m_GraphicsTimeline;
+		uint32_t imageIndex = m_ImageIndex;
+
+		m_FrameBegun = false;
 
-		// Only reset the fence if we actually submit the work
-		vkResetFences(m_InstanceManager.m_Device, 1, &m_InFlightFences[m_CurrentFrame]);
+		// The swapchain was recreated during the frame, so the acquired image is gone.
+		// Note: The semaphore still gets signalled, an empty submit consumes it so the next acquire can use it.
+		if (m_FrameGeneration != m_SwapChainManager.GetGeneration())
+		{
+			if (m_SwapChainManager.IsHeadless())
+				return;
+
+			BinarySemaphores consume = {};
+			consume.Wait = m_ImageAvailableSemaphores[m_CurrentFrame];
+
+			m_FrameValues[m_CurrentFrame] = timeline.Submit({ }, { }, consume);
+			m_CurrentFrame = (m_CurrentFrame + 1) % m_FramesInFlight;
+			return;
+		}
 
 		vkResetCommandBuffer(m_CommandBuffers[m_CurrentFrame], 0);
 
 		// Note(Jorben): Record the command buffer with all items in the queue
 		RecordCommandBuffer(m_CommandBuffers[m_CurrentFrame], imageIndex);
 
-		VkSubmitInfo submitInfo = {};
-		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		if (m_SwapChainManager.IsHeadless())
+		{
+			{
+				VKAPP_PROFILE_SCOPE("Renderer::Submit");
+				m_FrameValues[m_CurrentFrame] = timeline.Submit({ m_CommandBuffers[m_CurrentFrame] });
+			}
 
-		VkSemaphore waitSemaphores[] = { m_ImageAvailableSemaphores[m_CurrentFrame] };
-		VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-		submitInfo.waitSemaphoreCount = 1;
-		submitInfo.pWaitSemaphores = waitSemaphores;
-		submitInfo.pWaitDstStageMask = waitStages;
+			m_LastImage = imageIndex;
+			m_CurrentFrame = (m_CurrentFrame + 1) % m_FramesInFlight;
+			return;
+		}
 
-		submitInfo.commandBufferCount = 1;
-		submitInfo.pCommandBuffers = &m_CommandBuffers[m_CurrentFrame];
+		BinarySemaphores swapChainSemaphores = {};
+		swapChainSemaphores.Wait = m_ImageAvailableSemaphores[m_CurrentFrame];
+		swapChainSemaphores.WaitStages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		swapChainSemaphores.Signal = m_RenderFinishedSemaphores[m_CurrentFrame];
 
-		VkSemaphore signalSemaphores[] = { m_RenderFinishedSemaphores[m_CurrentFrame] };
-		submitInfo.signalSemaphoreCount = 1;
-		submitInfo.pSignalSemaphores = signalSemaphores;
+		{
+			VKAPP_PROFILE_SCOPE("Renderer::Submit");
+			m_FrameValues[m_CurrentFrame] = timeline.Submit({ m_CommandBuffers[m_CurrentFrame] }, { }, swapChainSemaphores);
+		}
 
-		if (vkQueueSubmit(m_InstanceManager.m_GraphicsQueue, 1, &submitInfo, m_InFlightFences[m_CurrentFrame]) != VK_SUCCESS)
-			VKAPP_LOG_ERROR("Failed to submit draw command buffer!");
+		VkSemaphore signalSemaphores[] = { m_RenderFinishedSemaphores[m_CurrentFrame] };
 
 		VkPresentInfoKHR presentInfo = {};
 		presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -186,65 +394,47 @@ namespace VkApp
 		presentInfo.pResults = nullptr; // Optional
 
 		// Check for the result on present again
-		result = vkQueuePresentKHR(m_InstanceManager.m_PresentQueue, &presentInfo);
+		VkResult result = VK_SUCCESS;
+		{
+			VKAPP_PROFILE_SCOPE("Renderer::Present");
+			result = timeline.Present(m_InstanceManager.m_PresentQueue, presentInfo);
+		}
+
+		// Note: Only presents that went through count towards retiring the old swapchain.
+		if (result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR)
+			m_SwapChainManager.m_PresentCount++;
 
 		if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
-			m_SwapChainManager.RecreateSwapChain();
+			m_SwapChainManager.RequestRecreate();
 		else if (result != VK_SUCCESS)
 			VKAPP_LOG_ERROR("Failed to present swap chain image!");
 
-		// Note(Jorben): We use the & operator since MAX_FRAMES_IN_FLIGHT is a power of 2 and this is a lot cheaper, if it's not use the % operator
-		m_CurrentFrame = (m_CurrentFrame + 1) & VKAPP_MAX_FRAMES_IN_FLIGHT;
+		m_CurrentFrame = (m_CurrentFrame + 1) % m_FramesInFlight;
 	}
 
 	void Renderer::RecordCommandBuffer(VkCommandBuffer& commandBuffer, uint32_t imageIndex)
 	{
+		VKAPP_PROFILE_FUNCTION();
+
 		VkCommandBufferBeginInfo beginInfo = {};
 		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 
 		if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
 			VKAPP_LOG_ERROR("Failed to begin recording command buffer!");
 
-		std::array<VkClearValue, 2> clearValues = {};
-		clearValues[0].color = { {0.0f, 0.0f, 0.0f, 1.0f} };
-		clearValues[1].depthStencil = { 1.0f, 0 };
-
-		VkRenderPassBeginInfo renderPassInfo = {};
-		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-		renderPassInfo.renderPass = m_SwapChainManager.m_RenderPass;
-		renderPassInfo.framebuffer = m_SwapChainManager.m_SwapChainFramebuffers[imageIndex];
-		renderPassInfo.renderArea.offset = { 0, 0 };
-		renderPassInfo.renderArea.extent = m_SwapChainManager.m_SwapChainExtent;
+		m_GpuProfiler.BeginFrame(commandBuffer, m_CurrentFrame);
 
-		renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-		renderPassInfo.pClearValues = clearValues.data();
+		// The swapchain (and with it the depth buffer and extent) may have been recreated since the graph was built.
+		if (m_RenderGraphGeneration != m_SwapChainManager.GetGeneration())
+			BuildRenderGraph();
 
-		vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+		m_ImageIndex = imageIndex;
+		m_RenderGraph.SetImportedImage(m_Backbuffer, m_SwapChainManager.m_SwapChainImages[imageIndex], m_SwapChainManager.m_SwapChainImageViews[imageIndex]);
 
-		//vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_GraphicsPipelineManager.m_GraphicsPipeline);
-
-		VkViewport viewport = {};
-		viewport.x = 0.0f;
-		viewport.y = 0.0f;
-		viewport.width = (float)m_SwapChainManager.m_SwapChainExtent.width;
-		viewport.height = (float)m_SwapChainManager.m_SwapChainExtent.height;
-		viewport.minDepth = 0.0f;
-		viewport.maxDepth = 1.0f;
-		vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
-
-		VkRect2D scissor = {};
-		scissor.offset = { 0, 0 };
-		scissor.extent = m_SwapChainManager.m_SwapChainExtent;
-		vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
-
-		// Run the queue of commands
-		for (auto& func : m_RenderQueue)
-			func(commandBuffer, imageIndex);
-
-		for (auto& func : m_UIQueue)
-			func(commandBuffer);
+		// Run the queue of commands through the graph
+		m_RenderGraph.Execute(commandBuffer);
 
-		vkCmdEndRenderPass(commandBuffer);
+		m_GpuProfiler.EndFrame(commandBuffer);
 
 		if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
 			VKAPP_LOG_ERROR("Failed to record command buffer!");
@@ -7,33 +7,65 @@
 #include <vulkan/vulkan.h>
 
 #include "VulkanCore/Renderer/InstanceManager.hpp"
+#include "VulkanCore/Renderer/DeviceObjectCache.hpp"
+#include "VulkanCore/Renderer/ResidencyManager.hpp"
 #include "VulkanCore/Renderer/SwapChainManager.hpp"
 #include "VulkanCore/Renderer/GraphicsPipelineManager.hpp"
+#include "VulkanCore/Renderer/MipGenerator.hpp"
+#include "VulkanCore/Renderer/GpuProfiler.hpp"
+#include "VulkanCore/Renderer/RenderGraph.hpp"
+#include "VulkanCore/Renderer/RendererSettings.hpp"
 
 namespace VkApp
 {
 
-	#define VKAPP_MAX_FRAMES_IN_FLIGHT 2
 	typedef std::function<void(VkCommandBuffer&, uint32_t)> RenderFunction;
 	typedef std::function<void(VkCommandBuffer&)> UIFunction;
+	typedef std::function<void(RenderGraph&, RenderGraphHandle)> RenderGraphBuildFunction; // Gets the graph and the imported swapchain image
 
 	class Renderer
 	{
 	public:
 		static Renderer* Get() { return s_Instance; }
 
-		static void Init();
+		static void Init(const RendererSettings& settings = {});
 		static void Destroy();
 
-		static void AddToQueue(RenderFunction func);
+		// Queued functions are timed by the GpuProfiler under the zone name, which defaults to the
+		// name set by SetQueueZone() (the application sets it to the name of the layer being rendered).
+		static void AddToQueue(RenderFunction func, const std::string& zone = {});
 		static void AddToUIQueue(UIFunction func);
-		static void Display();
+		static void SetQueueZone(const std::string& zone);
 
-		static void OnResize(uint32_t width, uint32_t height);
+		// Recreates the swapchain if that was requested, then waits until the GPU is done with the current frame slot
+		// and acquires the next swapchain image.
+		// Per frame resources (like uniform buffers at GetCurrentImage()) can be written after this.
+		// Returns false when no image could be acquired, the frame is then skipped by EndFrame().
+		static bool BeginFrame();
+		// Records the queues, submits and presents.
+		static void EndFrame();
+
+		static void OnResize(uint32_t width, uint32_t height); // Only requests a recreation, see SwapChainManager::RequestRecreate()
+
+		// Headless only, copies the last rendered frame into pixels (RGBA8, tightly packed rows).
+		// Waits for the GPU, meant for tests and captures rather than every frame.
+		static bool ReadBackFrame(std::vector<uint8_t>& pixels, uint32_t& width, uint32_t& height);
+
+		// Replaces the default graph (a single pass drawing both queues into the swapchain image).
+		// The build function runs again whenever the swapchain is recreated, its depth buffer is imported as "Depth",
+		// which is a transient attachment and is thrown away after the graph.
+		static void SetRenderGraph(RenderGraphBuildFunction build);
+
+		// For custom graphs, run the queues inside the pass(es) of your choosing.
+		static void ExecuteRenderQueue(VkCommandBuffer& commandBuffer);
+		static void ExecuteUIQueue(VkCommandBuffer& commandBuffer);
 
 	public:
 		inline VkCommandPool& GetCommandPool() { return m_CommandPool; }
 		inline uint32_t GetCurrentImage() const { return m_CurrentFrame; }
+		inline uint32_t GetFramesInFlight() const { return m_FramesInFlight; } // Per frame resources should be sized from this
+
+		inline RenderGraph& GetRenderGraph() { return m_RenderGraph; }
 
 	private:
 		static Renderer* s_Instance;
@@ -43,27 +75,54 @@ namespace VkApp
 		void CreateCommandBuffers();
 		void CreateSyncObjects();
 
+		void BuildRenderGraph();
+
+		bool AcquireImage();
 		void QueuePresent();
 		void RecordCommandBuffer(VkCommandBuffer& commandBuffer, uint32_t imageIndex);
 
 	private:
 		InstanceManager m_InstanceManager = {};
+		DeviceObjectCache m_DeviceObjectCache = {};
+		ResidencyManager m_ResidencyManager = {};
 		SwapChainManager m_SwapChainManager = {};
 		GraphicsPipelineManager m_GraphicsPipelineManager = {};
+		MipGenerator m_MipGenerator = {};
+		GpuProfiler m_GpuProfiler = {};
 
 		// Own rendering specific things.
 		uint32_t m_CurrentFrame = 0;
+		uint32_t m_FramesInFlight = 2;
 
 		VkCommandPool m_CommandPool = VK_NULL_HANDLE;
 		std::vector<VkCommandBuffer> m_CommandBuffers = { };
 
-		// Used for synchronization
+		// Used for synchronization, the binary semaphores are only for the swapchain
 		std::vector<VkSemaphore> m_ImageAvailableSemaphores = { };
 		std::vector<VkSemaphore> m_RenderFinishedSemaphores = { };
-		std::vector<VkFence> m_InFlightFences = { };
+		std::vector<uint64_t> m_FrameValues = { }; // Graphics timeline value each frame signals
+
+		// Frame graph, rebuilt when the swapchain changes
+		RenderGraph m_RenderGraph = {};
+		RenderGraphHandle m_Backbuffer = {};
+		RenderGraphBuildFunction m_BuildRenderGraph = {};
+		uint32_t m_RenderGraphGeneration = UINT32_MAX;
+		uint32_t m_ImageIndex = 0;
+		uint32_t m_LastImage = UINT32_MAX; // Last image that was rendered to, for ReadBackFrame()
+
+		bool m_FrameBegun = false;
+		uint32_t m_FrameGeneration = 0; // Swapchain generation the image was acquired from
 
 		// Queue of functions
-		std::vector<RenderFunction> m_RenderQueue = { };
+		struct QueuedRenderFunction
+		{
+		public:
+			RenderFunction Func = {};
+			std::string Zone = {};
+		};
+
+		std::vector<QueuedRenderFunction> m_RenderQueue = { };
+		std::string m_QueueZone = "Render";
 		std::vector<UIFunction> m_UIQueue = { };
 
 		friend class InstanceManager;
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+namespace VkApp
+{
+
+	#define VKAPP_MAX_FRAMES_IN_FLIGHT 4 // Upper bound of RendererSettings::FramesInFlight
+
+	struct RendererSettings
+	{
+	public:
+		// More frames let the CPU run further ahead of the GPU, fewer frames mean less input latency.
+		// Clamped to [1, VKAPP_MAX_FRAMES_IN_FLIGHT].
+		uint32_t FramesInFlight = 2;
+	};
+
+}
\ No newline at end of file
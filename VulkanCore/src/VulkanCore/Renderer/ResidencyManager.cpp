@@ -0,0 +1,123 @@
+#include "vcpch.h"
+#include "ResidencyManager.hpp"
+
+#include "VulkanCore/Core/Logging.hpp"
+
+#include "VulkanCore/Renderer/InstanceManager.hpp"
+
+namespace VkApp
+{
+
+	ResidencyManager* ResidencyManager::s_Instance = nullptr;
+
+	// Note: Without VK_EXT_memory_budget there is no way to know what other processes use, so be conservative.
+	#define VKAPP_FALLBACK_BUDGET_FRACTION 0.8f
+
+	ResidencyManager::ResidencyManager()
+	{
+		s_Instance = this;
+
+		VkPhysicalDeviceMemoryProperties memProperties = {};
+		vkGetPhysicalDeviceMemoryProperties(InstanceManager::Get()->GetPhysicalDevice(), &memProperties);
+
+		m_TypeToHeap.resize(memProperties.memoryTypeCount);
+		for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++)
+			m_TypeToHeap[i] = memProperties.memoryTypes[i].heapIndex;
+
+		m_Heaps.resize(memProperties.memoryHeapCount);
+		for (uint32_t i = 0; i < memProperties.memoryHeapCount; i++)
+		{
+			m_Heaps[i].Size = memProperties.memoryHeaps[i].size;
+			m_Heaps[i].DeviceLocal = memProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
+		}
+
+		if (!InstanceManager::Get()->IsMemoryBudgetSupported())
+			VKAPP_LOG_WARN("VK_EXT_memory_budget is not supported, the memory budget is estimated from the heap sizes.");
+
+		Update();
+	}
+
+	void ResidencyManager::Destroy()
+	{
+		#ifdef VKAPP_DEBUG
+		for (size_t i = 0; i < m_Heaps.size(); i++)
+		{
+			if (m_Heaps[i].Tracked != 0)
+				VKAPP_LOG_WARN("Memory heap {0} still has {1} bytes allocated on shutdown.", i, m_Heaps[i].Tracked);
+		}
+		#endif
+
+		s_Instance = nullptr;
+	}
+
+	void ResidencyManager::Update()
+	{
+		std::scoped_lock<std::mutex> lock(m_Mutex);
+
+		if (!InstanceManager::Get()->IsMemoryBudgetSupported())
+		{
+			for (auto& heap : m_Heaps)
+			{
+				heap.Budget = static_cast<VkDeviceSize>(heap.Size * VKAPP_FALLBACK_BUDGET_FRACTION);
+				heap.Usage = heap.Tracked;
+			}
+			return;
+		}
+
+		VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties = {};
+		budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+		VkPhysicalDeviceMemoryProperties2 memProperties = {};
+		memProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+		memProperties.pNext = &budgetProperties;
+
+		vkGetPhysicalDeviceMemoryProperties2(InstanceManager::Get()->GetPhysicalDevice(), &memProperties);
+
+		for (size_t i = 0; i < m_Heaps.size(); i++)
+		{
+			m_Heaps[i].Budget = budgetProperties.heapBudget[i];
+
+			// Note: The driver can lag behind a few frames, never report less than we know we allocated.
+			m_Heaps[i].Usage = std::max(budgetProperties.heapUsage[i], m_Heaps[i].Tracked);
+		}
+	}
+
+	void ResidencyManager::TrackAllocation(VkDeviceMemory memory, VkDeviceSize size, uint32_t memoryTypeIndex)
+	{
+		std::scoped_lock<std::mutex> lock(m_Mutex);
+
+		uint32_t heap = m_TypeToHeap[memoryTypeIndex];
+		m_Allocations[memory] = { size, heap };
+		m_Heaps[heap].Tracked += size;
+	}
+
+	void ResidencyManager::UntrackAllocation(VkDeviceMemory memory)
+	{
+		std::scoped_lock<std::mutex> lock(m_Mutex);
+
+		auto it = m_Allocations.find(memory);
+		if (it == m_Allocations.end())
+			return;
+
+		m_Heaps[it->second.Heap].Tracked -= it->second.Size;
+		m_Allocations.erase(it);
+	}
+
+	VkDeviceSize ResidencyManager::GetOverBudget() const
+	{
+		VkDeviceSize over = 0;
+
+		for (const auto& heap : m_Heaps)
+		{
+			if (!heap.DeviceLocal)
+				continue;
+
+			VkDeviceSize target = static_cast<VkDeviceSize>(heap.Budget * m_TargetFraction);
+			if (heap.Usage > target)
+				over += heap.Usage - target;
+		}
+
+		return over;
+	}
+
+}
\ No newline at end of file
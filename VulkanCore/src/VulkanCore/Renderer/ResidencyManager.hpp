@@ -0,0 +1,68 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+
+#include <vulkan/vulkan.h>
+
+namespace VkApp
+{
+
+	struct MemoryHeapStats
+	{
+	public:
+		VkDeviceSize Size = 0;
+		VkDeviceSize Budget = 0;	// What the driver says we can use, without VK_EXT_memory_budget a fraction of Size
+		VkDeviceSize Usage = 0;		// What the driver says we use, without VK_EXT_memory_budget equal to Tracked
+		VkDeviceSize Tracked = 0;	// What we allocated through the BufferManager
+
+		bool DeviceLocal = false;
+	};
+
+	// Tracks every allocation made through the BufferManager per memory heap and compares it against
+	// the budget reported by VK_EXT_memory_budget. The AssetManager uses it to decide when to evict.
+	class ResidencyManager
+	{
+	public:
+		static ResidencyManager* Get() { return s_Instance; }
+
+		ResidencyManager();
+		void Destroy();
+
+		// Refreshes the budget, called once per frame.
+		void Update();
+
+		void TrackAllocation(VkDeviceMemory memory, VkDeviceSize size, uint32_t memoryTypeIndex);
+		void UntrackAllocation(VkDeviceMemory memory);
+
+		// Returns how many bytes the device local heaps are over the target, 0 if everything fits.
+		VkDeviceSize GetOverBudget() const;
+
+		inline const std::vector<MemoryHeapStats>& GetHeapStats() const { return m_Heaps; }
+
+		// The fraction of the budget we try to stay under, leaves some room for the swapchain and the driver.
+		inline void SetTargetFraction(float fraction) { m_TargetFraction = fraction; }
+		inline float GetTargetFraction() const { return m_TargetFraction; }
+
+	private:
+		static ResidencyManager* s_Instance;
+
+	private:
+		struct Allocation
+		{
+		public:
+			VkDeviceSize Size = 0;
+			uint32_t Heap = 0;
+		};
+
+		std::mutex m_Mutex;
+		std::unordered_map<VkDeviceMemory, Allocation> m_Allocations = { };
+
+		std::vector<uint32_t> m_TypeToHeap = { };
+		std::vector<MemoryHeapStats> m_Heaps = { };
+
+		float m_TargetFraction = 0.9f;
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,360 @@
+#include "vcpch.h"
+#include "StreamedTexture.hpp"
+
+#include "VulkanCore/Core/Logging.hpp"
+
+#include "VulkanCore/Renderer/Renderer.hpp"
+#include "VulkanCore/Renderer/InstanceManager.hpp"
+#include "VulkanCore/Renderer/TextureCooker.hpp"
+
+#include "VulkanCore/Utils/BufferManager.hpp"
+
+namespace VkApp
+{
+
+	std::atomic<uint64_t> StreamedTexture::s_ViewVersion = 0;
+
+	StreamedTexture::StreamedTexture(const std::filesystem::path& path)
+	{
+		TextureData data = {};
+		if (!LoadTextureData(path, data))
+			return;
+
+		Upload(std::move(data));
+	}
+
+	StreamedTexture::StreamedTexture(TextureData&& data)
+	{
+		Upload(std::move(data));
+	}
+
+	void StreamedTexture::Destroy()
+	{
+		// Note: Expects the GPU to be done with this texture, like Texture::Destroy.
+		if (m_Transfer.Value != 0)
+			FinishTransfer(true);
+
+		DestroyRetired(true);
+
+		BufferManager::DestroySampler(m_Sampler);
+		BufferManager::DestroyImageView(m_ImageView);
+
+		if (m_Image != VK_NULL_HANDLE)
+			BufferManager::DestroyImage(m_Image, m_ImageMemory);
+
+		m_MemorySize = 0;
+		m_Data = {};
+	}
+
+	bool StreamedTexture::LoadTextureData(const std::filesystem::path& path, TextureData& data)
+	{
+		if (!Texture::LoadTextureData(path, data))
+			return false;
+
+		// Note: Uncompressed textures normally get their mips on the GPU, streaming needs them on the CPU.
+		TextureCooker::GenerateMips(data);
+		return true;
+	}
+
+	bool StreamedTexture::Update()
+	{
+		DestroyRetired(false);
+
+		if (m_Data.Mips.empty())
+			return false;
+
+		bool changed = false;
+		if (m_Transfer.Value != 0)
+		{
+			changed = FinishTransfer(false);
+
+			if (!changed)
+			{
+				m_Footprint = 0.0f;
+				return false;
+			}
+		}
+
+		uint32_t desired = GetDesiredLevel();
+		m_Footprint = 0.0f;
+
+		if (desired < m_ResidentLevel)
+		{
+			// One level per transfer, so a single texture can't eat the whole frame.
+			m_FramesWantingLess = 0;
+			BeginTransfer(m_ResidentLevel - 1);
+		}
+		else if (desired > m_ResidentLevel)
+		{
+			if (++m_FramesWantingLess >= VKAPP_STREAMING_DROP_DELAY)
+			{
+				m_FramesWantingLess = 0;
+				BeginTransfer(desired);
+			}
+		}
+		else
+			m_FramesWantingLess = 0;
+
+		return changed;
+	}
+
+	float StreamedTexture::EstimateScreenFootprint(const MeshBounds& bounds, const glm::mat4& model, const glm::mat4& viewProjection, const glm::vec2& viewportSize)
+	{
+		glm::mat4 mvp = viewProjection * model;
+
+		glm::vec2 min = glm::vec2(std::numeric_limits<float>::max());
+		glm::vec2 max = glm::vec2(std::numeric_limits<float>::lowest());
+
+		for (uint32_t i = 0; i < 8; i++)
+		{
+			glm::vec3 corner = { (i & 1) ? bounds.Max.x : bounds.Min.x, (i & 2) ? bounds.Max.y : bounds.Min.y, (i & 4) ? bounds.Max.z : bounds.Min.z };
+			glm::vec4 clip = mvp * glm::vec4(corner, 1.0f);
+
+			// Note: Part of the bounds is behind the camera, so we're really close and want every level.
+			if (clip.w <= 0.0001f)
+				return std::max(viewportSize.x, viewportSize.y);
+
+			glm::vec2 ndc = glm::vec2(clip) / clip.w;
+			min = glm::min(min, ndc);
+			max = glm::max(max, ndc);
+		}
+
+		if (max.x < -1.0f || min.x > 1.0f || max.y < -1.0f || min.y > 1.0f)
+			return 0.0f;
+
+		// Note: Not clamped to the screen, a big object close to the camera needs the detail even if it's partly off screen.
+		glm::vec2 extent = (max - min) * 0.5f * viewportSize;
+		return std::max(extent.x, extent.y);
+	}
+
+	// ===================================
+	// ------------- Helper --------------
+	// ===================================
+	void StreamedTexture::Upload(TextureData&& data)
+	{
+		m_Data = std::move(data);
+
+		if (m_Data.Mips.empty())
+			TextureCooker::GenerateMips(m_Data);
+
+		if (m_Data.Mips.empty())
+		{
+			VKAPP_LOG_ERROR("A streamed texture needs a complete mip chain!");
+			return;
+		}
+
+		m_TailLevel = static_cast<uint32_t>(m_Data.Mips.size()) - 1;
+		for (uint32_t i = 0; i < m_Data.Mips.size(); i++)
+		{
+			if (std::max(m_Data.Mips[i].Width, m_Data.Mips[i].Height) <= VKAPP_STREAMING_TAIL_SIZE)
+			{
+				m_TailLevel = i;
+				break;
+			}
+		}
+
+		// Note: The tail is tiny, so waiting for it keeps the texture usable from the first frame.
+		BeginTransfer(m_TailLevel);
+		FinishTransfer(true);
+
+		m_Sampler = BufferManager::CreateSampler(GetMipLevels());
+	}
+
+	uint32_t StreamedTexture::GetDesiredLevel() const
+	{
+		if (m_Footprint <= 0.0f)
+			return m_TailLevel;
+
+		float size = static_cast<float>(std::max(m_Data.Width, m_Data.Height));
+		float level = std::floor(std::log2(size / m_Footprint));
+
+		return std::min(static_cast<uint32_t>(std::max(level, 0.0f)), m_TailLevel);
+	}
+
+	VkDeviceSize StreamedTexture::GetLevelsSize(uint32_t firstLevel, uint32_t endLevel) const
+	{
+		VkDeviceSize size = 0;
+		for (uint32_t i = firstLevel; i < endLevel; i++)
+			size += m_Data.Mips[i].Size;
+
+		return size;
+	}
+
+	void StreamedTexture::BeginTransfer(uint32_t firstLevel)
+	{
+		auto logicalDevice = InstanceManager::Get()->GetLogicalDevice();
+
+		uint32_t mipLevels = GetMipLevels();
+		const TextureMip& top = m_Data.Mips[firstLevel];
+
+		m_Transfer = {};
+		m_Transfer.FirstLevel = firstLevel;
+
+		BufferManager::CreateImage(top.Width, top.Height, mipLevels - firstLevel, m_Data.Format, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_Transfer.Image, m_Transfer.Memory);
+
+		// Levels that aren't on the GPU yet come from the CPU, the rest is copied over from the current image.
+		uint32_t copyLevel = m_Image == VK_NULL_HANDLE ? mipLevels : std::max(firstLevel, m_ResidentLevel);
+		VkDeviceSize uploadSize = GetLevelsSize(firstLevel, copyLevel);
+
+		std::vector<VkBufferImageCopy> uploads = { };
+		if (uploadSize > 0)
+		{
+			BufferManager::CreateBuffer(uploadSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_Transfer.StagingBuffer, m_Transfer.StagingMemory);
+
+			void* mapped;
+			vkMapMemory(logicalDevice, m_Transfer.StagingMemory, 0, uploadSize, 0, &mapped);
+			memcpy(mapped, m_Data.Pixels.data() + top.Offset, static_cast<size_t>(uploadSize));
+			vkUnmapMemory(logicalDevice, m_Transfer.StagingMemory);
+
+			for (uint32_t i = firstLevel; i < copyLevel; i++)
+			{
+				VkBufferImageCopy region = {};
+				region.bufferOffset = m_Data.Mips[i].Offset - top.Offset;
+				region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+				region.imageSubresource.mipLevel = i - firstLevel;
+				region.imageSubresource.baseArrayLayer = 0;
+				region.imageSubresource.layerCount = 1;
+				region.imageExtent = { m_Data.Mips[i].Width, m_Data.Mips[i].Height, 1 };
+				uploads.push_back(region);
+			}
+		}
+
+		VkCommandBufferAllocateInfo allocInfo = {};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandPool = Renderer::Get()->GetCommandPool();
+		allocInfo.commandBufferCount = 1;
+
+		if (vkAllocateCommandBuffers(logicalDevice, &allocInfo, &m_Transfer.CommandBuffer) != VK_SUCCESS)
+			VKAPP_LOG_ERROR("Failed to allocate streaming command buffer!");
+
+		VkCommandBufferBeginInfo beginInfo = {};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+		VkCommandBuffer commandBuffer = m_Transfer.CommandBuffer;
+		vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+		VkImageMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.image = m_Transfer.Image;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		barrier.subresourceRange.baseMipLevel = 0;
+		barrier.subresourceRange.levelCount = mipLevels - firstLevel;
+		barrier.subresourceRange.baseArrayLayer = 0;
+		barrier.subresourceRange.layerCount = 1;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		if (!uploads.empty())
+			vkCmdCopyBufferToImage(commandBuffer, m_Transfer.StagingBuffer, m_Transfer.Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(uploads.size()), uploads.data());
+
+		if (m_Image != VK_NULL_HANDLE)
+		{
+			// Note: Frames in flight still sample the current image, so it goes back to being readable right after the copy.
+			VkImageMemoryBarrier source = barrier;
+			source.image = m_Image;
+			source.subresourceRange.baseMipLevel = copyLevel - m_ResidentLevel;
+			source.subresourceRange.levelCount = mipLevels - copyLevel;
+			source.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			source.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			source.srcAccessMask = 0;
+			source.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &source);
+
+			std::vector<VkImageCopy> copies = { };
+			for (uint32_t i = copyLevel; i < mipLevels; i++)
+			{
+				VkImageCopy copy = {};
+				copy.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+				copy.srcSubresource.mipLevel = i - m_ResidentLevel;
+				copy.srcSubresource.baseArrayLayer = 0;
+				copy.srcSubresource.layerCount = 1;
+				copy.dstSubresource = copy.srcSubresource;
+				copy.dstSubresource.mipLevel = i - firstLevel;
+				copy.extent = { m_Data.Mips[i].Width, m_Data.Mips[i].Height, 1 };
+				copies.push_back(copy);
+			}
+
+			vkCmdCopyImage(commandBuffer, m_Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, m_Transfer.Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(copies.size()), copies.data());
+
+			source.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			source.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			source.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+			source.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &source);
+		}
+
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		vkEndCommandBuffer(commandBuffer);
+
+		// Note: Unlike the single time commands this doesn't wait, Update() polls the timeline.
+		m_Transfer.Value = InstanceManager::Get()->GetGraphicsTimeline().Submit({ commandBuffer });
+	}
+
+	bool StreamedTexture::FinishTransfer(bool wait)
+	{
+		auto logicalDevice = InstanceManager::Get()->GetLogicalDevice();
+		QueueTimeline& timeline = InstanceManager::Get()->GetGraphicsTimeline();
+
+		if (wait)
+			timeline.Wait(m_Transfer.Value);
+		else if (!timeline.IsComplete(m_Transfer.Value))
+			return false;
+
+		vkFreeCommandBuffers(logicalDevice, Renderer::Get()->GetCommandPool(), 1, &m_Transfer.CommandBuffer);
+
+		if (m_Transfer.StagingBuffer != VK_NULL_HANDLE)
+			BufferManager::DestroyBuffer(m_Transfer.StagingBuffer, m_Transfer.StagingMemory);
+
+		if (m_Image != VK_NULL_HANDLE)
+			Retire(m_Image, m_ImageMemory, m_ImageView);
+
+		m_Image = m_Transfer.Image;
+		m_ImageMemory = m_Transfer.Memory;
+		m_ResidentLevel = m_Transfer.FirstLevel;
+		m_ImageView = BufferManager::CreateImageView(m_Image, m_Data.Format, VK_IMAGE_ASPECT_COLOR_BIT, GetMipLevels() - m_ResidentLevel);
+		m_MemorySize = GetLevelsSize(m_ResidentLevel, GetMipLevels());
+		m_ViewVersion = ++s_ViewVersion;
+
+		m_Transfer = {};
+		return true;
+	}
+
+	void StreamedTexture::Retire(VkImage image, VkDeviceMemory memory, VkImageView view)
+	{
+		// Note: Anything recorded from now on uses the new image, so only submitted work can still use this one.
+		m_Retired.push_back({ InstanceManager::Get()->GetGraphicsTimeline().GetLastSubmitted(), image, memory, view });
+	}
+
+	void StreamedTexture::DestroyRetired(bool force)
+	{
+		for (auto it = m_Retired.begin(); it != m_Retired.end();)
+		{
+			if (force || InstanceManager::Get()->GetGraphicsTimeline().IsComplete(it->Value))
+			{
+				BufferManager::DestroyImageView(it->View);
+				BufferManager::DestroyImage(it->Image, it->Memory);
+
+				it = m_Retired.erase(it);
+			}
+			else
+				++it;
+		}
+	}
+
+}
\ No newline at end of file
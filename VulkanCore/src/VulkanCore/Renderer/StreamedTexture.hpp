@@ -0,0 +1,124 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <filesystem>
+
+#include <vulkan/vulkan.h>
+
+#include <glm/glm.hpp>
+
+#include "VulkanCore/Renderer/Mesh.hpp"
+#include "VulkanCore/Renderer/Texture.hpp"
+
+namespace VkApp
+{
+
+	// Levels up to this size are always resident and uploaded when the texture is created.
+	#define VKAPP_STREAMING_TAIL_SIZE 64u
+
+	// Amount of frames a texture has to want fewer levels before they are actually dropped.
+	#define VKAPP_STREAMING_DROP_DELAY 120u
+
+	// A texture that only keeps the mip levels it needs on the GPU. The small tail is uploaded right away,
+	// higher levels stream in one per frame based on the screen space footprint and are dropped again
+	// when the texture is out of view. The image only holds the resident levels, so every change
+	// allocates a new image, copies the levels both have on the GPU and swaps the view once the copy is done.
+	class StreamedTexture
+	{
+	public:
+		StreamedTexture() = default;
+		StreamedTexture(const std::filesystem::path& path);
+		StreamedTexture(TextureData&& data); // Needs a complete mip chain, see TextureCooker::GenerateMips
+		void Destroy();
+
+		// Loads the data like Texture::LoadTextureData, but makes sure every mip level exists on the CPU.
+		static bool LoadTextureData(const std::filesystem::path& path, TextureData& data);
+
+		// Amount of pixels the texture covers on screen along its largest axis, 0 if it isn't visible.
+		// Needs to be set every frame, Update() resets it. With multiple draws the largest footprint wins.
+		inline void SetScreenFootprint(float pixels) { m_Footprint = std::max(m_Footprint, pixels); }
+
+		// Finishes the running transfer and starts the next one, called once per frame.
+		// Returns true if the image view changed.
+		bool Update();
+
+		// Projects the bounds to estimate how many pixels the mesh covers along its largest screen axis.
+		static float EstimateScreenFootprint(const MeshBounds& bounds, const glm::mat4& model, const glm::mat4& viewProjection, const glm::vec2& viewportSize);
+
+		inline VkImageView& GetImageView() { return m_ImageView; }
+		inline VkSampler& GetSampler() { return m_Sampler; }
+
+		// Changes every time the view is swapped and is unique over all streamed textures,
+		// so descriptors can be checked against it.
+		inline uint64_t GetViewVersion() const { return m_ViewVersion; }
+
+		inline VkFormat GetFormat() const { return m_Data.Format; }
+		inline uint32_t GetMipLevels() const { return static_cast<uint32_t>(m_Data.Mips.size()); }
+		inline uint32_t GetResidentLevel() const { return m_ResidentLevel; } // The most detailed level on the GPU
+		inline uint32_t GetWidth() const { return m_Data.Width; }
+		inline uint32_t GetHeight() const { return m_Data.Height; }
+
+		// Size of the resident levels on the GPU.
+		inline VkDeviceSize GetMemorySize() const { return m_MemorySize; }
+
+	private:
+		void Upload(TextureData&& data);
+
+		uint32_t GetDesiredLevel() const;
+		VkDeviceSize GetLevelsSize(uint32_t firstLevel, uint32_t endLevel) const;
+
+		void BeginTransfer(uint32_t firstLevel);
+		bool FinishTransfer(bool wait);
+
+		void Retire(VkImage image, VkDeviceMemory memory, VkImageView view);
+		void DestroyRetired(bool force);
+
+	private:
+		TextureData m_Data = {};
+
+		VkImage m_Image = VK_NULL_HANDLE;
+		VkDeviceMemory m_ImageMemory = VK_NULL_HANDLE;
+		VkImageView m_ImageView = VK_NULL_HANDLE;
+		VkSampler m_Sampler = VK_NULL_HANDLE;
+
+		uint32_t m_ResidentLevel = 0;
+		uint32_t m_TailLevel = 0;
+		VkDeviceSize m_MemorySize = 0;
+		uint64_t m_ViewVersion = 0;
+
+		float m_Footprint = 0.0f;
+		uint32_t m_FramesWantingLess = 0;
+
+		struct Transfer
+		{
+		public:
+			uint32_t FirstLevel = 0;
+
+			VkImage Image = VK_NULL_HANDLE;
+			VkDeviceMemory Memory = VK_NULL_HANDLE;
+
+			VkBuffer StagingBuffer = VK_NULL_HANDLE;
+			VkDeviceMemory StagingMemory = VK_NULL_HANDLE;
+
+			VkCommandBuffer CommandBuffer = VK_NULL_HANDLE;
+			uint64_t Value = 0; // Graphics timeline value, 0 when there is no transfer
+		};
+		Transfer m_Transfer = {};
+
+		// Old images might still be used by frames in flight, they go once the timeline passes the value.
+		struct Retired
+		{
+		public:
+			uint64_t Value = 0;
+
+			VkImage Image = VK_NULL_HANDLE;
+			VkDeviceMemory Memory = VK_NULL_HANDLE;
+			VkImageView View = VK_NULL_HANDLE;
+		};
+		std::vector<Retired> m_Retired = { };
+
+		static std::atomic<uint64_t> s_ViewVersion;
+	};
+
+}
\ No newline at end of file
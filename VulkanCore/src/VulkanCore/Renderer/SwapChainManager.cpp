@@ -9,6 +9,8 @@
 #include "VulkanCore/Core/Application.hpp"
 
 #include "VulkanCore/Renderer/InstanceManager.hpp" // For the retrieval of the logical device
+#include "VulkanCore/Renderer/RenderPassDescription.hpp"
+#include "VulkanCore/Renderer/Renderer.hpp"
 #include "VulkanCore/Utils/BufferManager.hpp" 
 
 namespace VkApp
@@ -29,18 +31,19 @@ namespace VkApp
 		// Retrieve the InstanceManager, so we can use it in our code
 		s_Instance = this;
 		s_InstanceManager = InstanceManager::Get();
+		m_Headless = s_InstanceManager->IsHeadless();
 
 		CreateSwapChain(Application::Get().GetWindow().IsVSync());
 		CreateImageViews();
 		CreateRenderPass();
 		//CreateDepthResources();
-		//CreateFramebuffers();
 	}
 
 	void SwapChainManager::Destroy()
 	{
-		CleanUpSwapChain();
-		
+		RetireSwapChain();
+		DestroyRetired(true);
+
 		vkDestroyRenderPass(s_InstanceManager->m_Device, m_RenderPass, nullptr);
 
 		s_InstanceManager = nullptr;
@@ -49,38 +52,129 @@ namespace VkApp
 
 	void SwapChainManager::InitCommandPoolRequiredFunctions()
 	{
+		// Note: Headless images are created now, the renderer's frames in flight weren't known yet in the constructor.
+		if (m_Headless && m_SwapChainImages.empty())
+		{
+			CreateOffscreenImages();
+			CreateImageViews();
+		}
+
 		CreateDepthResources();
-		CreateFramebuffers();
 	}
 
-	void SwapChainManager::RecreateSwapChain(bool vsync)
+	// ===================================
+	// ------------ Recreation -----------
+	// ===================================
+	void SwapChainManager::RecreateSwapChain()
 	{
-		auto handle = reinterpret_cast<GLFWwindow*>(Application::Get().GetWindow().GetNativeWindow());
-
-		// Pause if minimized
-		int width = 0, height = 0;
-		glfwGetFramebufferSize(handle, &width, &height);
-		while (width == 0 || height == 0) // This loop only executes if it's minimized
+		if (!m_Headless)
 		{
+			auto handle = reinterpret_cast<GLFWwindow*>(Application::Get().GetWindow().GetNativeWindow());
+
+			// Pause if minimized
+			int width = 0, height = 0;
 			glfwGetFramebufferSize(handle, &width, &height);
-			glfwWaitEvents();
+			while (width == 0 || height == 0) // This loop only executes if it's minimized
+			{
+				glfwGetFramebufferSize(handle, &width, &height);
+				glfwWaitEvents();
+			}
 		}
 
-		vkDeviceWaitIdle(s_InstanceManager->m_Device);
-
-		CleanUpSwapChain();
+		// Note: No device wait, the old swapchain is handed to the new one and destroyed once its last frame is done.
+		VkSwapchainKHR oldSwapChain = m_SwapChain;
+		RetireSwapChain();
 
-		CreateSwapChain(vsync);
+		CreateSwapChain(Application::Get().GetWindow().IsVSync(), oldSwapChain);
 		CreateImageViews();
 		CreateDepthResources();
-		CreateFramebuffers();
+
+		m_RecreateRequested = false;
+		m_Generation++;
+	}
+
+	void SwapChainManager::RetireSwapChain()
+	{
+		Retired retired = {};
+		retired.Value = s_InstanceManager->GetGraphicsTimeline().GetLastSubmitted();
+		retired.PresentCount = m_PresentCount;
+		retired.Presented = m_Headless;
+
+		retired.SwapChain = m_SwapChain;
+		retired.Images = std::move(m_SwapChainImages);
+		retired.OffscreenMemory = std::move(m_OffscreenMemory);
+		retired.ImageViews = std::move(m_SwapChainImageViews);
+
+		retired.DepthImage = m_DepthImage;
+		retired.DepthImageMemory = m_DepthImageMemory;
+		retired.DepthImageView = m_DepthImageView;
+
+		m_SwapChain = VK_NULL_HANDLE;
+		m_SwapChainImages.clear();
+		m_OffscreenMemory.clear();
+		m_SwapChainImageViews.clear();
+
+		m_DepthImage = VK_NULL_HANDLE;
+		m_DepthImageMemory = VK_NULL_HANDLE;
+		m_DepthImageView = VK_NULL_HANDLE;
+
+		m_Retired.push_back(std::move(retired));
+	}
+
+	void SwapChainManager::DestroyRetired(bool force)
+	{
+		for (auto it = m_Retired.begin(); it != m_Retired.end();)
+		{
+			// Note: A present can't be waited on, so the old swapchain is kept until the new one got two
+			// successful presents and the frame of the last one is done. The presentation engine is done
+			// with the old images by then.
+			if (!force && !it->Presented)
+			{
+				if (m_PresentCount < it->PresentCount + 2)
+				{
+					++it;
+					continue;
+				}
+
+				it->Value = s_InstanceManager->GetGraphicsTimeline().GetLastSubmitted();
+				it->Presented = true;
+			}
+
+			if (!force && !s_InstanceManager->GetGraphicsTimeline().IsComplete(it->Value))
+			{
+				++it;
+				continue;
+			}
+
+			if (it->DepthImageView != VK_NULL_HANDLE)
+				BufferManager::DestroyImageView(it->DepthImageView);
+			if (it->DepthImage != VK_NULL_HANDLE)
+				BufferManager::DestroyImage(it->DepthImage, it->DepthImageMemory);
+
+			for (size_t i = 0; i < it->ImageViews.size(); i++)
+				BufferManager::DestroyImageView(it->ImageViews[i]);
+
+			for (size_t i = 0; i < it->OffscreenMemory.size(); i++)
+				BufferManager::DestroyImage(it->Images[i], it->OffscreenMemory[i]);
+
+			if (it->SwapChain != VK_NULL_HANDLE)
+				vkDestroySwapchainKHR(s_InstanceManager->m_Device, it->SwapChain, nullptr);
+
+			it = m_Retired.erase(it);
+		}
 	}
 
 	// ===================================
 	// -------- Initialization -----------
 	// ===================================
-	void SwapChainManager::CreateSwapChain(bool vsync)
+	void SwapChainManager::CreateSwapChain(bool vsync, VkSwapchainKHR oldSwapChain)
 	{
+		if (m_Headless)
+		{
+			CreateOffscreenImages();
+			return;
+		}
+
 		InstanceManager::SwapChainSupportDetails swapChainSupport = s_InstanceManager->QuerySwapChainSupport(s_InstanceManager->m_PhysicalDevice);
 
 		VkSurfaceFormatKHR surfaceFormat = ChooseSwapSurfaceFormat(swapChainSupport.Formats);
@@ -125,7 +219,8 @@ namespace VkApp
 		createInfo.presentMode = presentMode;
 		createInfo.clipped = VK_TRUE;
 
-		createInfo.oldSwapchain = VK_NULL_HANDLE;
+		// Note: Lets the driver reuse the old swapchain's resources, images already acquired from it can still be presented.
+		createInfo.oldSwapchain = oldSwapChain;
 
 		// Creation of the swapchain
 		if (vkCreateSwapchainKHR(s_InstanceManager->m_Device, &createInfo, nullptr, &m_SwapChain) != VK_SUCCESS)
@@ -141,6 +236,25 @@ namespace VkApp
 		m_SwapChainExtent = extent;
 	}
 
+	void SwapChainManager::CreateOffscreenImages()
+	{
+		Window& window = Application::Get().GetWindow();
+
+		m_SwapChainImageFormat = VK_FORMAT_R8G8B8A8_UNORM;
+		m_SwapChainExtent = { std::max(window.GetWidth(), 1u), std::max(window.GetHeight(), 1u) };
+
+		// Only the format and extent while the renderer is being constructed, see InitCommandPoolRequiredFunctions().
+		if (!Renderer::Get())
+			return;
+
+		// Note: The renderer uses the frame index as image index, so every frame in flight needs its own image.
+		m_SwapChainImages.resize(Renderer::Get()->GetFramesInFlight());
+		m_OffscreenMemory.resize(Renderer::Get()->GetFramesInFlight());
+
+		for (size_t i = 0; i < m_SwapChainImages.size(); i++)
+			BufferManager::CreateImage(m_SwapChainExtent.width, m_SwapChainExtent.height, 1, m_SwapChainImageFormat, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_SwapChainImages[i], m_OffscreenMemory[i]);
+	}
+
 	void SwapChainManager::CreateImageViews()
 	{
 		m_SwapChainImageViews.resize(m_SwapChainImages.size());
@@ -153,42 +267,23 @@ namespace VkApp
 
 	void SwapChainManager::CreateRenderPass()
 	{
+		RenderPassDescription description = {};
+
 		// Colour
-		VkAttachmentDescription colorAttachment = {};
-		colorAttachment.format = m_SwapChainImageFormat;
-		colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-		colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-		colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-		colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-		colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-		colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-		colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-		VkAttachmentReference colorAttachmentRef = {};
-		colorAttachmentRef.attachment = 0;
-		colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-		// Depth
-		VkAttachmentDescription depthAttachment = {};
-		depthAttachment.format = FindDepthFormat();
-		depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-		depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-		depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-		depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-		depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-		depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-		depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-		VkAttachmentReference depthAttachmentRef = {};
-		depthAttachmentRef.attachment = 1;
-		depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-		// Subpass
-		VkSubpassDescription subpass = {};
-		subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-		subpass.colorAttachmentCount = 1;
-		subpass.pColorAttachments = &colorAttachmentRef;
-		subpass.pDepthStencilAttachment = &depthAttachmentRef;
+		AttachmentDescription color = {};
+		color.Format = m_SwapChainImageFormat;
+		color.LoadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		color.StoreOp = VK_ATTACHMENT_STORE_OP_STORE;
+		color.InitialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		color.FinalLayout = GetPresentLayout();
+		description.ColorAttachments.push_back(color);
+
+		// Depth, nothing reads it after the pass so it never has to leave the tile
+		description.DepthAttachment.Format = FindDepthFormat();
+		description.DepthAttachment.LoadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		description.DepthAttachment.StoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		description.DepthAttachment.InitialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		description.DepthAttachment.FinalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
 		VkSubpassDependency dependency = {};
 		dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
@@ -197,53 +292,19 @@ namespace VkApp
 		dependency.srcAccessMask = 0;
 		dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
 		dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		description.Dependencies.push_back(dependency);
 
-		std::array<VkAttachmentDescription, 2> attachments = { colorAttachment, depthAttachment };
-
-		VkRenderPassCreateInfo renderPassInfo = {};
-		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-		renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
-		renderPassInfo.pAttachments = attachments.data();
-		renderPassInfo.subpassCount = 1;
-		renderPassInfo.pSubpasses = &subpass;
-		renderPassInfo.dependencyCount = 1;
-		renderPassInfo.pDependencies = &dependency;
-
-		if (vkCreateRenderPass(s_InstanceManager->m_Device, &renderPassInfo, nullptr, &m_RenderPass) != VK_SUCCESS)
-			VKAPP_LOG_ERROR("Failed to create render pass!");
+		m_RenderPass = description.Create();
 	}
 
 	void SwapChainManager::CreateDepthResources()
 	{
 		VkFormat depthFormat = FindDepthFormat();
 
-		BufferManager::CreateImage(m_SwapChainExtent.width, m_SwapChainExtent.height, 1, depthFormat, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_DepthImage, m_DepthImageMemory);
+		// Note: Depth only lives within a render pass, so it can be transient and on tiled GPUs never gets backing memory.
+		BufferManager::CreateImage(m_SwapChainExtent.width, m_SwapChainExtent.height, 1, depthFormat, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT, m_DepthImage, m_DepthImageMemory);
 
 		m_DepthImageView = BufferManager::CreateImageView(m_DepthImage, depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT, 1);
-
-		BufferManager::TransitionImageToLayout(m_DepthImage, depthFormat, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, 1);
-	}
-
-	void SwapChainManager::CreateFramebuffers()
-	{
-		m_SwapChainFramebuffers.resize(m_SwapChainImageViews.size());
-
-		for (size_t i = 0; i < m_SwapChainImageViews.size(); i++)
-		{
-			std::array<VkImageView, 2> attachments = { m_SwapChainImageViews[i], m_DepthImageView };
-
-			VkFramebufferCreateInfo framebufferInfo = {};
-			framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-			framebufferInfo.renderPass = m_RenderPass;
-			framebufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
-			framebufferInfo.pAttachments = attachments.data();
-			framebufferInfo.width = m_SwapChainExtent.width;
-			framebufferInfo.height = m_SwapChainExtent.height;
-			framebufferInfo.layers = 1;
-
-			if (vkCreateFramebuffer(s_InstanceManager->m_Device, &framebufferInfo, nullptr, &m_SwapChainFramebuffers[i]) != VK_SUCCESS)
-				VKAPP_LOG_ERROR("Failed to create framebuffer!");
-		}
 	}
 
 	// ===================================
@@ -324,19 +385,4 @@ namespace VkApp
 		return VK_FORMAT_UNDEFINED;
 	}
 
-	void SwapChainManager::CleanUpSwapChain()
-	{
-		vkDestroyImageView(s_InstanceManager->m_Device, m_DepthImageView, nullptr);
-		vkDestroyImage(s_InstanceManager->m_Device, m_DepthImage, nullptr);
-		vkFreeMemory(s_InstanceManager->m_Device, m_DepthImageMemory, nullptr);
-
-		for (size_t i = 0; i < m_SwapChainFramebuffers.size(); i++)
-			vkDestroyFramebuffer(s_InstanceManager->m_Device, m_SwapChainFramebuffers[i], nullptr);
-
-		for (size_t i = 0; i < m_SwapChainImageViews.size(); i++)
-			vkDestroyImageView(s_InstanceManager->m_Device, m_SwapChainImageViews[i], nullptr);
-
-		vkDestroySwapchainKHR(s_InstanceManager->m_Device, m_SwapChain, nullptr);
-	}
-
 }
\ No newline at end of file
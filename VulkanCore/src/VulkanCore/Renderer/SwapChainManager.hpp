@@ -19,21 +19,44 @@ namespace VkApp
 		void Destroy();
 
 		void InitCommandPoolRequiredFunctions();
-		void RecreateSwapChain(bool vsync = false);
+
+		// Recreation happens at the start of the next Renderer::BeginFrame(), any number of requests
+		// before that (a resize storm, a vsync toggle) result in a single recreation.
+		inline void RequestRecreate() { m_RecreateRequested = true; }
+		inline bool IsRecreateRequested() const { return m_RecreateRequested; }
 
 		inline VkRenderPass& GetRenderPass() { return m_RenderPass; }
 		inline VkExtent2D& GetExtent() { return m_SwapChainExtent;  }
+		inline VkFormat GetImageFormat() const { return m_SwapChainImageFormat; }
+		inline VkFormat GetDepthFormat() { return FindDepthFormat(); }
+
+		// Note: Transient, it can only be used as an attachment and its contents are gone after the pass.
+		inline VkImage GetDepthImage() const { return m_DepthImage; }
+		inline VkImageView GetDepthImageView() const { return m_DepthImageView; }
+
+		// Goes up every time the swapchain is recreated, anything built on top of it can compare against it.
+		inline uint32_t GetGeneration() const { return m_Generation; }
 
 		inline std::vector<VkImage>& GetImages() { return m_SwapChainImages; }
 		inline std::vector<VkImageView>& GetImageViews() { return m_SwapChainImageViews; }
 
+		// Headless there's no swapchain, the images are offscreen RGBA8 images (one per frame in flight)
+		// which end every frame in VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, ready to be read back.
+		inline bool IsHeadless() const { return m_Headless; }
+		inline VkImageLayout GetPresentLayout() const { return m_Headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR; }
+
+	private: // Recreation, called by the Renderer
+		void RecreateSwapChain();
+		void RetireSwapChain();
+		void DestroyRetired(bool force);
+
 	private: // Initialization functions
-		void CreateSwapChain(bool vsync = false);
+		void CreateSwapChain(bool vsync = false, VkSwapchainKHR oldSwapChain = VK_NULL_HANDLE);
+		void CreateOffscreenImages();
 		void CreateImageViews();
 		void CreateRenderPass();
 
 		void CreateDepthResources();
-		void CreateFramebuffers();
 
 	private: // Helper functions
 		VkSurfaceFormatKHR ChooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats);
@@ -43,8 +66,6 @@ namespace VkApp
 		VkFormat FindDepthFormat();
 		VkFormat FindSupportedFormat(const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features);
 
-		void CleanUpSwapChain();
-
 	private: // Static things
 		static SwapChainManager* s_Instance;
 
@@ -55,7 +76,9 @@ namespace VkApp
 
 		std::vector<VkImage> m_SwapChainImages = { };
 		std::vector<VkImageView> m_SwapChainImageViews = { };
-		std::vector<VkFramebuffer> m_SwapChainFramebuffers = { };
+		std::vector<VkDeviceMemory> m_OffscreenMemory = { }; // Only when headless
+
+		bool m_Headless = false;
 
 		VkImage m_DepthImage = VK_NULL_HANDLE;
 		VkDeviceMemory m_DepthImageMemory = VK_NULL_HANDLE;
@@ -63,6 +86,30 @@ namespace VkApp
 
 		VkRenderPass m_RenderPass = VK_NULL_HANDLE;
 
+		uint32_t m_Generation = 0;
+		uint64_t m_PresentCount = 0; // Counted by the Renderer
+		bool m_RecreateRequested = false;
+
+		// A replaced swapchain and everything built on it, frames in flight might still use it.
+		// Destroyed once the graphics timeline passes the value.
+		struct Retired
+		{
+		public:
+			uint64_t Value = 0;
+			uint64_t PresentCount = 0;	// m_PresentCount when it was replaced
+			bool Presented = false;		// Whether the new swapchain got its presents and Value was moved past them
+
+			VkSwapchainKHR SwapChain = VK_NULL_HANDLE;
+			std::vector<VkImage> Images = { };				// Only destroyed when headless, the swapchain owns them otherwise
+			std::vector<VkDeviceMemory> OffscreenMemory = { };
+			std::vector<VkImageView> ImageViews = { };
+
+			VkImage DepthImage = VK_NULL_HANDLE;
+			VkDeviceMemory DepthImageMemory = VK_NULL_HANDLE;
+			VkImageView DepthImageView = VK_NULL_HANDLE;
+		};
+		std::vector<Retired> m_Retired = { };
+
 		friend class InstanceManager;
 		friend class Renderer;
 	};
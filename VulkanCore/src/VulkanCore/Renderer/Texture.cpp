@@ -0,0 +1,124 @@
+#include "vcpch.h"
+#include "Texture.hpp"
+
+#include <stb_image.h>
+
+#include "VulkanCore/Core/Logging.hpp"
+
+#include "VulkanCore/Renderer/InstanceManager.hpp"
+#include "VulkanCore/Renderer/TextureCooker.hpp"
+#include "VulkanCore/Utils/BufferManager.hpp"
+
+namespace VkApp
+{
+
+	Texture::Texture(const std::filesystem::path& path)
+	{
+		TextureData data = {};
+		if (!LoadTextureData(path, data))
+			return;
+
+		Upload(data);
+	}
+
+	Texture::Texture(const TextureData& data)
+	{
+		Upload(data);
+	}
+
+	void Texture::Destroy()
+	{
+		BufferManager::DestroySampler(m_Sampler);
+		BufferManager::DestroyImageView(m_ImageView);
+
+		BufferManager::DestroyImage(m_Image, m_ImageMemory);
+	}
+
+	bool Texture::LoadTextureData(const std::filesystem::path& path, TextureData& data)
+	{
+		if (path.extension() == VKAPP_COOKED_TEXTURE_EXTENSION)
+			return TextureCooker::LoadCooked(path, data);
+
+		bool compressionSupported = TextureCooker::IsCompressionSupported();
+		std::filesystem::path cookedPath = TextureCooker::GetCookedPath(path);
+
+		if (compressionSupported && TextureCooker::IsUpToDate(path, cookedPath) && TextureCooker::LoadCooked(cookedPath, data))
+			return true;
+
+		int texWidth, texHeight, texChannels;
+
+		stbi_uc* pixels = stbi_load(path.string().c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+		if (!pixels)
+		{
+			VKAPP_LOG_ERROR("Failed to load texture image: \"{0}\"", path.string());
+			return false;
+		}
+
+		data = {};
+		data.Width = static_cast<uint32_t>(texWidth);
+		data.Height = static_cast<uint32_t>(texHeight);
+		data.Pixels.assign(pixels, pixels + (size_t)texWidth * texHeight * 4);
+
+		stbi_image_free((void*)pixels);
+
+		// Note: Without BC support we stay on the uncompressed path and let the GPU build the mips.
+		if (!compressionSupported)
+			return true;
+
+		TextureData compressed = {};
+		if (TextureCooker::Compress(path, data, compressed))
+		{
+			if (!TextureCooker::Cook(path, cookedPath, compressed))
+				VKAPP_LOG_WARN("Failed to cook texture \"{0}\", it will be compressed again on the next load.", path.string());
+
+			data = std::move(compressed);
+		}
+
+		return true;
+	}
+
+	void Texture::Upload(const TextureData& data)
+	{
+		m_Width = data.Width;
+		m_Height = data.Height;
+		m_Format = data.Format;
+
+		if (data.Mips.empty())
+		{
+			BufferManager::CreateTexture(data.Pixels.data(), data.Width, data.Height, m_Image, m_ImageMemory, m_MipLevels);
+
+			m_MemorySize = 0;
+			for (uint32_t i = 0; i < m_MipLevels; i++)
+				m_MemorySize += (VkDeviceSize)std::max(m_Width >> i, 1u) * std::max(m_Height >> i, 1u) * 4;
+		}
+		else
+		{
+			std::vector<VkBufferImageCopy> regions = { };
+			for (uint32_t i = 0; i < data.Mips.size(); i++)
+			{
+				VkBufferImageCopy region = {};
+				region.bufferOffset = data.Mips[i].Offset;
+				region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+				region.imageSubresource.mipLevel = i;
+				region.imageSubresource.baseArrayLayer = 0;
+				region.imageSubresource.layerCount = 1;
+				region.imageExtent = { data.Mips[i].Width, data.Mips[i].Height, 1 };
+				regions.push_back(region);
+			}
+
+			BufferManager::CreateTexture(data.Pixels.data(), data.Pixels.size(), data.Format, data.Width, data.Height, regions, m_Image, m_ImageMemory);
+
+			m_MipLevels = static_cast<uint32_t>(data.Mips.size());
+			m_MemorySize = data.Pixels.size();
+		}
+
+		CreateViewAndSampler();
+	}
+
+	void Texture::CreateViewAndSampler()
+	{
+		m_ImageView = BufferManager::CreateImageView(m_Image, m_Format, VK_IMAGE_ASPECT_COLOR_BIT, m_MipLevels);
+		m_Sampler = BufferManager::CreateSampler(m_MipLevels);
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <vector>
+#include <filesystem>
+
+#include <vulkan/vulkan.h>
+
+namespace VkApp
+{
+
+	struct TextureMip
+	{
+	public:
+		uint64_t Offset = 0; // Into TextureData::Pixels
+		uint64_t Size = 0;
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+	};
+
+	// CPU side representation of a texture. Either a single RGBA8 level (mips are generated on the GPU)
+	// or a complete, possibly block compressed, mip chain as loaded from a cooked KTX2 file.
+	struct TextureData
+	{
+	public:
+		std::vector<uint8_t> Pixels = { };
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+
+		VkFormat Format = VK_FORMAT_R8G8B8A8_UNORM;
+		std::vector<TextureMip> Mips = { };
+	};
+
+	class Texture
+	{
+	public:
+		Texture() = default;
+		Texture(const std::filesystem::path& path);
+		Texture(const TextureData& data);
+		void Destroy();
+
+		// Loads the cooked KTX2 file when it's up to date, otherwise decodes the source and cooks it
+		// (if the device supports BC formats). Doesn't touch the GPU, so it can run on any thread.
+		static bool LoadTextureData(const std::filesystem::path& path, TextureData& data);
+
+		inline VkImage& GetImage() { return m_Image; }
+		inline VkImageView& GetImageView() { return m_ImageView; }
+		inline VkSampler& GetSampler() { return m_Sampler; }
+
+		inline VkFormat GetFormat() const { return m_Format; }
+		inline uint32_t GetMipLevels() const { return m_MipLevels; }
+		inline uint32_t GetWidth() const { return m_Width; }
+		inline uint32_t GetHeight() const { return m_Height; }
+
+		// Size on the GPU, including the mip chain.
+		inline VkDeviceSize GetMemorySize() const { return m_MemorySize; }
+
+	private:
+		void Upload(const TextureData& data);
+		void CreateViewAndSampler();
+
+	private:
+		VkImage m_Image = VK_NULL_HANDLE;
+		VkDeviceMemory m_ImageMemory = VK_NULL_HANDLE;
+
+		VkImageView m_ImageView = VK_NULL_HANDLE;
+		VkSampler m_Sampler = VK_NULL_HANDLE;
+
+		VkFormat m_Format = VK_FORMAT_R8G8B8A8_UNORM;
+		uint32_t m_MipLevels = 0;
+		uint32_t m_Width = 0;
+		uint32_t m_Height = 0;
+		VkDeviceSize m_MemorySize = 0;
+	};
+
+}
\ No newline at end of file
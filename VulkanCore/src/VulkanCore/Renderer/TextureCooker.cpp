@@ -0,0 +1,254 @@
+#include "vcpch.h"
+#include "TextureCooker.hpp"
+
+#include <cstring>
+
+#include "VulkanCore/Core/Logging.hpp"
+
+#include "VulkanCore/Renderer/InstanceManager.hpp"
+#include "VulkanCore/Renderer/MeshCooker.hpp"
+
+#include "VulkanCore/Utils/KTX2.hpp"
+#include "VulkanCore/Utils/MappedFile.hpp"
+
+namespace VkApp
+{
+
+	// Stored under VKAPP_COOKED_TEXTURE_SOURCE_KEY, so the cooked file can be checked against its source.
+	struct CookedTextureSource
+	{
+	public:
+		uint32_t Version = VKAPP_COOKED_TEXTURE_VERSION;
+		uint32_t Reserved = 0;
+		uint64_t SourceHash = 0;
+		int64_t SourceWriteTime = 0;
+	};
+
+	// ===================================
+	// ------------- Helper --------------
+	// ===================================
+	static void Downsample(const uint8_t* source, uint32_t width, uint32_t height, std::vector<uint8_t>& output, uint32_t& outWidth, uint32_t& outHeight)
+	{
+		outWidth = std::max(width / 2, 1u);
+		outHeight = std::max(height / 2, 1u);
+		output.resize((size_t)outWidth * outHeight * 4);
+
+		// Simple 2x2 box filter, odd edges reuse the last row/column.
+		for (uint32_t y = 0; y < outHeight; y++)
+		{
+			uint32_t y0 = std::min(y * 2, height - 1), y1 = std::min(y * 2 + 1, height - 1);
+			for (uint32_t x = 0; x < outWidth; x++)
+			{
+				uint32_t x0 = std::min(x * 2, width - 1), x1 = std::min(x * 2 + 1, width - 1);
+				for (uint32_t c = 0; c < 4; c++)
+				{
+					uint32_t sum = source[((size_t)y0 * width + x0) * 4 + c] + source[((size_t)y0 * width + x1) * 4 + c] +
+						source[((size_t)y1 * width + x0) * 4 + c] + source[((size_t)y1 * width + x1) * 4 + c];
+
+					output[((size_t)y * outWidth + x) * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+				}
+			}
+		}
+	}
+
+	// Calls func with every level of the box filtered chain, starting with the source itself.
+	static void ForEachMip(const TextureData& source, const std::function<void(const std::vector<uint8_t>&, uint32_t, uint32_t)>& func)
+	{
+		uint32_t width = source.Width, height = source.Height;
+		std::vector<uint8_t> level = { source.Pixels.begin(), source.Pixels.begin() + (size_t)width * height * 4 };
+
+		while (true)
+		{
+			func(level, width, height);
+
+			if (width == 1 && height == 1)
+				break;
+
+			std::vector<uint8_t> next = { };
+			Downsample(level.data(), width, height, next, width, height);
+			level = std::move(next);
+		}
+	}
+
+	// ===================================
+	// ------------ Static ---------------
+	// ===================================
+	std::filesystem::path TextureCooker::GetCookedPath(const std::filesystem::path& sourcePath)
+	{
+		std::filesystem::path cooked = sourcePath;
+		cooked += VKAPP_COOKED_TEXTURE_EXTENSION;
+		return cooked;
+	}
+
+	bool TextureCooker::IsUpToDate(const std::filesystem::path& sourcePath, const std::filesystem::path& cookedPath)
+	{
+		std::error_code error;
+		if (!std::filesystem::exists(cookedPath, error))
+			return false;
+
+		if (!std::filesystem::exists(sourcePath, error))
+			return true;
+
+		MappedFile file(cookedPath);
+		KTX2Image image = {};
+		if (!file.IsValid() || !KTX2::Parse(file.GetData(), file.GetSize(), image))
+			return false;
+
+		auto it = image.KeyValues.find(VKAPP_COOKED_TEXTURE_SOURCE_KEY);
+		if (it == image.KeyValues.end() || it->second.size() != sizeof(CookedTextureSource))
+			return false;
+
+		CookedTextureSource source = {};
+		memcpy(&source, it->second.data(), sizeof(CookedTextureSource));
+
+		if (source.Version != VKAPP_COOKED_TEXTURE_VERSION)
+			return false;
+
+		if (MeshCooker::GetWriteTime(sourcePath) <= source.SourceWriteTime)
+			return true;
+
+		return MeshCooker::HashFile(sourcePath) == source.SourceHash;
+	}
+
+	bool TextureCooker::Compress(const std::filesystem::path& sourcePath, const TextureData& source, TextureData& compressed)
+	{
+		if (source.Format != VK_FORMAT_R8G8B8A8_UNORM || source.Width == 0 || source.Height == 0)
+			return false;
+
+		BlockFormat format = ChooseFormat(sourcePath);
+
+		compressed = {};
+		compressed.Format = BlockCompression::GetVkFormat(format);
+		compressed.Width = source.Width;
+		compressed.Height = source.Height;
+
+		ForEachMip(source, [&compressed, format](const std::vector<uint8_t>& level, uint32_t width, uint32_t height)
+		{
+			std::vector<uint8_t> blocks = BlockCompression::Compress(level.data(), width, height, format);
+
+			TextureMip mip = {};
+			mip.Offset = compressed.Pixels.size();
+			mip.Size = blocks.size();
+			mip.Width = width;
+			mip.Height = height;
+			compressed.Mips.push_back(mip);
+
+			compressed.Pixels.insert(compressed.Pixels.end(), blocks.begin(), blocks.end());
+		});
+
+		return true;
+	}
+
+	bool TextureCooker::Cook(const std::filesystem::path& sourcePath, const std::filesystem::path& cookedPath, const TextureData& compressed)
+	{
+		CookedTextureSource source = {};
+		source.SourceHash = MeshCooker::HashFile(sourcePath);
+		source.SourceWriteTime = MeshCooker::GetWriteTime(sourcePath);
+
+		std::map<std::string, std::vector<uint8_t>> keyValues = { };
+		keyValues["KTXwriter"] = { 'V', 'u', 'l', 'k', 'a', 'n', 'A', 'p', 'p', '\0' };
+		keyValues[VKAPP_COOKED_TEXTURE_SOURCE_KEY] = std::vector<uint8_t>(reinterpret_cast<const uint8_t*>(&source), reinterpret_cast<const uint8_t*>(&source) + sizeof(CookedTextureSource));
+
+		std::vector<std::vector<uint8_t>> levels = { };
+		for (const TextureMip& mip : compressed.Mips)
+			levels.emplace_back(compressed.Pixels.begin() + mip.Offset, compressed.Pixels.begin() + mip.Offset + mip.Size);
+
+		return KTX2::Write(cookedPath, compressed.Format, compressed.Width, compressed.Height, levels, keyValues);
+	}
+
+	bool TextureCooker::LoadCooked(const std::filesystem::path& cookedPath, TextureData& data)
+	{
+		MappedFile file(cookedPath);
+		KTX2Image image = {};
+		if (!file.IsValid() || !KTX2::Parse(file.GetData(), file.GetSize(), image))
+		{
+			VKAPP_LOG_WARN("Failed to parse KTX2 texture \"{0}\".", cookedPath.string());
+			return false;
+		}
+
+		if (!IsFormatSupported(image.Format))
+			return false;
+
+		data = {};
+		data.Format = image.Format;
+		data.Width = image.Width;
+		data.Height = image.Height;
+
+		uint64_t totalSize = 0;
+		for (const KTX2Level& level : image.Levels)
+			totalSize += level.ByteLength;
+
+		data.Pixels.reserve(totalSize);
+
+		// Note: The file stores the smallest level first, in memory they're kept in level order.
+		for (uint32_t i = 0; i < image.Levels.size(); i++)
+		{
+			const KTX2Level& level = image.Levels[i];
+
+			TextureMip mip = {};
+			mip.Offset = data.Pixels.size();
+			mip.Size = level.ByteLength;
+			mip.Width = std::max(image.Width >> i, 1u);
+			mip.Height = std::max(image.Height >> i, 1u);
+			data.Mips.push_back(mip);
+
+			data.Pixels.insert(data.Pixels.end(), file.GetData() + level.ByteOffset, file.GetData() + level.ByteOffset + level.ByteLength);
+		}
+
+		return true;
+	}
+
+	void TextureCooker::GenerateMips(TextureData& data)
+	{
+		if (!data.Mips.empty() || data.Format != VK_FORMAT_R8G8B8A8_UNORM || data.Width == 0 || data.Height == 0)
+			return;
+
+		TextureData source = {};
+		source.Width = data.Width;
+		source.Height = data.Height;
+		source.Pixels = std::move(data.Pixels);
+
+		data.Pixels.clear();
+
+		ForEachMip(source, [&data](const std::vector<uint8_t>& level, uint32_t width, uint32_t height)
+		{
+			TextureMip mip = {};
+			mip.Offset = data.Pixels.size();
+			mip.Size = level.size();
+			mip.Width = width;
+			mip.Height = height;
+			data.Mips.push_back(mip);
+
+			data.Pixels.insert(data.Pixels.end(), level.begin(), level.end());
+		});
+	}
+
+	bool TextureCooker::IsFormatSupported(VkFormat format)
+	{
+		if (KTX2::IsBlockCompressed(format) && !InstanceManager::Get()->IsTextureCompressionBCSupported())
+			return false;
+
+		VkFormatProperties properties = {};
+		vkGetPhysicalDeviceFormatProperties(InstanceManager::Get()->GetPhysicalDevice(), format, &properties);
+
+		const VkFormatFeatureFlags required = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+		return (properties.optimalTilingFeatures & required) == required;
+	}
+
+	bool TextureCooker::IsCompressionSupported()
+	{
+		return IsFormatSupported(VK_FORMAT_BC5_UNORM_BLOCK) && IsFormatSupported(VK_FORMAT_BC7_UNORM_BLOCK);
+	}
+
+	BlockFormat TextureCooker::ChooseFormat(const std::filesystem::path& sourcePath)
+	{
+		std::string name = sourcePath.stem().string();
+		std::transform(name.begin(), name.end(), name.begin(), [](char c) { return static_cast<char>(std::tolower(c)); });
+
+		if (name.find("normal") != std::string::npos || name.ends_with("_n"))
+			return BlockFormat::BC5;
+
+		return BlockFormat::BC7;
+	}
+
+}
\ No newline at end of file
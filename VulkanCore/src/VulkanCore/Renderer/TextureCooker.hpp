@@ -0,0 +1,42 @@
+#pragma once
+
+#include <filesystem>
+
+#include "VulkanCore/Renderer/Texture.hpp"
+#include "VulkanCore/Utils/BlockCompression.hpp"
+
+namespace VkApp
+{
+
+	#define VKAPP_COOKED_TEXTURE_VERSION 1u
+	#define VKAPP_COOKED_TEXTURE_EXTENSION ".ktx2"
+	#define VKAPP_COOKED_TEXTURE_SOURCE_KEY "VkAppSource"
+
+	// Turns decoded RGBA8 images into block compressed mip chains stored as KTX2 next to the source.
+	class TextureCooker
+	{
+	public:
+		static std::filesystem::path GetCookedPath(const std::filesystem::path& sourcePath);
+
+		// Returns true if the cooked file exists and was cooked from the current contents of the source.
+		static bool IsUpToDate(const std::filesystem::path& sourcePath, const std::filesystem::path& cookedPath);
+
+		// Builds the mip chain on the CPU and compresses every level, blocks are spread over all cores.
+		// Normal maps (by name) get BC5, everything else BC7.
+		static bool Compress(const std::filesystem::path& sourcePath, const TextureData& source, TextureData& compressed);
+		static bool Cook(const std::filesystem::path& sourcePath, const std::filesystem::path& cookedPath, const TextureData& compressed);
+
+		static bool LoadCooked(const std::filesystem::path& cookedPath, TextureData& data);
+
+		// Appends a box filtered mip chain to a single level RGBA8 texture, used when the levels need to exist on the CPU.
+		static void GenerateMips(TextureData& data);
+
+		// Checks the device for BC support through vkGetPhysicalDeviceFormatProperties.
+		static bool IsFormatSupported(VkFormat format);
+		static bool IsCompressionSupported();
+
+	private:
+		static BlockFormat ChooseFormat(const std::filesystem::path& sourcePath);
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,711 @@
+#include "vcpch.h"
+#include "VirtualTexture.hpp"
+
+#include <stb_image.h>
+
+#include "VulkanCore/Core/Logging.hpp"
+
+#include "VulkanCore/Renderer/Renderer.hpp"
+#include "VulkanCore/Renderer/InstanceManager.hpp"
+#include "VulkanCore/Renderer/DeviceObjectCache.hpp"
+#include "VulkanCore/Renderer/TextureCooker.hpp"
+
+#include "VulkanCore/Utils/BufferManager.hpp"
+
+namespace VkApp
+{
+
+	#define VKAPP_VIRTUAL_SLOT_BYTES ((VkDeviceSize)VKAPP_VIRTUAL_SLOT_SIZE * VKAPP_VIRTUAL_SLOT_SIZE * 4)
+
+	// ===================================
+	// ------------- Helper --------------
+	// ===================================
+	static bool IsValidVirtualSize(uint32_t size)
+	{
+		uint32_t pages = size / VKAPP_VIRTUAL_PAGE_SIZE;
+		return size % VKAPP_VIRTUAL_PAGE_SIZE == 0 && pages > 0 && (pages & (pages - 1)) == 0;
+	}
+
+	static uint32_t PackEntry(uint32_t slotX, uint32_t slotY, uint32_t mip)
+	{
+		return slotX | (slotY << 8) | (mip << 16) | (255u << 24);
+	}
+
+	static VkSampler CreateNearestSampler()
+	{
+		VkSamplerCreateInfo samplerInfo = {};
+		samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+		samplerInfo.magFilter = VK_FILTER_NEAREST;
+		samplerInfo.minFilter = VK_FILTER_NEAREST;
+		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+		samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+
+		return DeviceObjectCache::Get()->AcquireSampler(samplerInfo);
+	}
+
+	// ===================================
+	// ------------ Sources --------------
+	// ===================================
+	ImageVirtualTextureSource::ImageVirtualTextureSource(const std::filesystem::path& path)
+	{
+		int width, height, channels;
+
+		// Note: Not through Texture::LoadTextureData, pages are copied texel by texel so they have to stay RGBA8.
+		stbi_uc* pixels = stbi_load(path.string().c_str(), &width, &height, &channels, STBI_rgb_alpha);
+		if (!pixels)
+		{
+			VKAPP_LOG_ERROR("Failed to load virtual texture image: \"{0}\"", path.string());
+			return;
+		}
+
+		m_Data.Width = static_cast<uint32_t>(width);
+		m_Data.Height = static_cast<uint32_t>(height);
+		m_Data.Pixels.assign(pixels, pixels + (size_t)width * height * 4);
+
+		stbi_image_free((void*)pixels);
+
+		TextureCooker::GenerateMips(m_Data);
+	}
+
+	ImageVirtualTextureSource::ImageVirtualTextureSource(TextureData&& data)
+		: m_Data(std::move(data))
+	{
+		if (m_Data.Format != VK_FORMAT_R8G8B8A8_UNORM)
+		{
+			VKAPP_LOG_ERROR("Virtual texture images must be RGBA8.");
+			m_Data = {};
+			return;
+		}
+
+		TextureCooker::GenerateMips(m_Data);
+	}
+
+	bool ImageVirtualTextureSource::ReadPage(uint32_t mip, uint32_t pageX, uint32_t pageY, uint8_t* pixels)
+	{
+		if (mip >= m_Data.Mips.size())
+			return false;
+
+		const TextureMip& level = m_Data.Mips[mip];
+		const uint8_t* source = m_Data.Pixels.data() + level.Offset;
+
+		int32_t originX = static_cast<int32_t>(pageX * VKAPP_VIRTUAL_PAGE_SIZE) - static_cast<int32_t>(VKAPP_VIRTUAL_PAGE_BORDER);
+		int32_t originY = static_cast<int32_t>(pageY * VKAPP_VIRTUAL_PAGE_SIZE) - static_cast<int32_t>(VKAPP_VIRTUAL_PAGE_BORDER);
+
+		// Note: The border outside of the image repeats the edge texels.
+		for (int32_t y = 0; y < (int32_t)VKAPP_VIRTUAL_SLOT_SIZE; y++)
+		{
+			int32_t sourceY = std::clamp(originY + y, 0, (int32_t)level.Height - 1);
+			for (int32_t x = 0; x < (int32_t)VKAPP_VIRTUAL_SLOT_SIZE; x++)
+			{
+				int32_t sourceX = std::clamp(originX + x, 0, (int32_t)level.Width - 1);
+				memcpy(pixels + ((size_t)y * VKAPP_VIRTUAL_SLOT_SIZE + x) * 4, source + ((size_t)sourceY * level.Width + sourceX) * 4, 4);
+			}
+		}
+
+		return true;
+	}
+
+	// ===================================
+	// ------------ Public ---------------
+	// ===================================
+	VirtualTexture::VirtualTexture(const VirtualTextureInfo& info)
+		: m_Info(info)
+	{
+		if (!m_Info.Source)
+		{
+			VKAPP_LOG_ERROR("A virtual texture needs a source!");
+			return;
+		}
+
+		uint32_t width = m_Info.Source->GetWidth(), height = m_Info.Source->GetHeight();
+		if (!IsValidVirtualSize(width) || !IsValidVirtualSize(height))
+		{
+			VKAPP_LOG_ERROR("Virtual texture size {0}x{1} is not a power of two multiple of {2}.", width, height, VKAPP_VIRTUAL_PAGE_SIZE);
+			m_Info.Source = nullptr;
+			return;
+		}
+
+		if (!InstanceManager::Get()->IsFragmentStoresSupported())
+			VKAPP_LOG_WARN("fragmentStoresAndAtomics is not supported, virtual textures won't get any feedback.");
+
+		m_MipLevels = 1;
+		while ((std::max(width, height) / VKAPP_VIRTUAL_PAGE_SIZE) >> m_MipLevels)
+			m_MipLevels++;
+
+		uint32_t topPages = GetPagesX(m_MipLevels - 1) * GetPagesY(m_MipLevels - 1);
+		if (topPages * 2 > m_Info.AtlasPages * m_Info.AtlasPages || m_Info.AtlasPages > 256)
+		{
+			VKAPP_LOG_ERROR("Virtual texture atlas of {0}x{0} pages can't hold the {1} pages of the coarsest level.", m_Info.AtlasPages, topPages);
+			m_Info.Source = nullptr;
+			return;
+		}
+
+		m_Slots.resize(m_Info.AtlasPages * m_Info.AtlasPages);
+
+		CreateAtlas();
+		CreateIndirection();
+		CreateFeedbackBuffer(m_Info.ViewportWidth, m_Info.ViewportHeight);
+
+		// The coarsest level is loaded right away and stays resident, every lookup can fall back to it.
+		for (uint32_t y = 0; y < GetPagesY(m_MipLevels - 1); y++)
+		{
+			for (uint32_t x = 0; x < GetPagesX(m_MipLevels - 1); x++)
+			{
+				LoadedPage page = {};
+				page.Page = VKAPP_VIRTUAL_PAGE_ID(x, y, m_MipLevels - 1);
+				page.Pixels.resize(VKAPP_VIRTUAL_SLOT_BYTES);
+
+				// Note: Without these pages lookups have nothing to fall back to, so a failed read still gets a (grey) page.
+				if (!m_Info.Source->ReadPage(m_MipLevels - 1, x, y, page.Pixels.data()))
+				{
+					VKAPP_LOG_ERROR("Failed to read virtual texture page {0}x{1} of the coarsest mip {2}, using a fallback.", x, y, m_MipLevels - 1);
+					memset(page.Pixels.data(), 128, page.Pixels.size());
+				}
+
+				m_PendingPages.insert(page.Page);
+				m_Loaded.push_back(std::move(page));
+			}
+		}
+
+		UploadPages(UINT32_MAX);
+		if (m_Upload.Value != 0)
+			FinishUpload(true);
+
+		StartWorker();
+	}
+
+	void VirtualTexture::Destroy()
+	{
+		if (!m_Info.Source)
+			return;
+
+		StopWorker();
+
+		if (m_Upload.Value != 0)
+			FinishUpload(true);
+
+		auto logicalDevice = InstanceManager::Get()->GetLogicalDevice();
+
+		BufferManager::DestroySampler(m_AtlasSampler);
+		BufferManager::DestroyImageView(m_AtlasView);
+		BufferManager::DestroyImage(m_Atlas, m_AtlasMemory);
+
+		BufferManager::DestroySampler(m_IndirectionSampler);
+		BufferManager::DestroyImageView(m_IndirectionView);
+		BufferManager::DestroyImage(m_Indirection, m_IndirectionMemory);
+
+		vkUnmapMemory(logicalDevice, m_FeedbackMemory);
+		BufferManager::DestroyBuffer(m_FeedbackBuffer, m_FeedbackMemory);
+		m_FeedbackData = nullptr;
+
+		m_Slots.clear();
+		m_ResidentPages.clear();
+		m_PendingPages.clear();
+		m_IndirectionData.clear();
+
+		m_Info.Source = nullptr;
+	}
+
+	void VirtualTexture::Update()
+	{
+		if (!m_Info.Source)
+			return;
+
+		m_FrameIndex++;
+
+		ReadFeedback();
+		UploadPages(m_Info.MaxUploadsPerFrame);
+	}
+
+	void VirtualTexture::Resize(uint32_t width, uint32_t height)
+	{
+		if (!m_Info.Source)
+			return;
+
+		auto logicalDevice = InstanceManager::Get()->GetLogicalDevice();
+		vkDeviceWaitIdle(logicalDevice);
+
+		vkUnmapMemory(logicalDevice, m_FeedbackMemory);
+		BufferManager::DestroyBuffer(m_FeedbackBuffer, m_FeedbackMemory);
+
+		CreateFeedbackBuffer(width, height);
+	}
+
+	RenderGraphHandle VirtualTexture::ImportFeedback(RenderGraph& graph, const std::string& name) const
+	{
+		return graph.ImportBuffer(name, m_FeedbackBuffer, m_FeedbackSectionSize * m_FeedbackSections, VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_HOST_READ_BIT);
+	}
+
+	VirtualTextureParams VirtualTexture::GetParams() const
+	{
+		VirtualTextureParams params = {};
+		if (!m_Info.Source)
+			return params;
+
+		params.VirtualSize = { (float)m_Info.Source->GetWidth(), (float)m_Info.Source->GetHeight() };
+		params.AtlasSize = glm::vec2((float)(m_Info.AtlasPages * VKAPP_VIRTUAL_SLOT_SIZE));
+		params.MaxMip = m_MipLevels - 1;
+		params.FeedbackWidth = m_FeedbackWidth;
+
+		return params;
+	}
+
+	// ===================================
+	// -------- Initialization -----------
+	// ===================================
+	void VirtualTexture::CreateAtlas()
+	{
+		uint32_t size = m_Info.AtlasPages * VKAPP_VIRTUAL_SLOT_SIZE;
+
+		BufferManager::CreateImage(size, size, 1, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_Atlas, m_AtlasMemory);
+		BufferManager::TransitionImageToLayout(m_Atlas, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1);
+		BufferManager::TransitionImageToLayout(m_Atlas, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 1);
+
+		m_AtlasView = BufferManager::CreateImageView(m_Atlas, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_ASPECT_COLOR_BIT, 1);
+		m_AtlasSampler = BufferManager::CreateSampler(1);
+	}
+
+	void VirtualTexture::CreateIndirection()
+	{
+		BufferManager::CreateImage(GetPagesX(0), GetPagesY(0), m_MipLevels, VK_FORMAT_R8G8B8A8_UINT, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_Indirection, m_IndirectionMemory);
+		BufferManager::TransitionImageToLayout(m_Indirection, VK_FORMAT_R8G8B8A8_UINT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, m_MipLevels);
+		BufferManager::TransitionImageToLayout(m_Indirection, VK_FORMAT_R8G8B8A8_UINT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, m_MipLevels);
+
+		m_IndirectionView = BufferManager::CreateImageView(m_Indirection, VK_FORMAT_R8G8B8A8_UINT, VK_IMAGE_ASPECT_COLOR_BIT, m_MipLevels);
+		m_IndirectionSampler = CreateNearestSampler();
+
+		m_IndirectionData.resize(m_MipLevels);
+		m_DirtyRects.resize(m_MipLevels);
+		for (uint32_t i = 0; i < m_MipLevels; i++)
+		{
+			m_IndirectionData[i].assign((size_t)GetPagesX(i) * GetPagesY(i), 0);
+			MarkDirty(i, 0, 0, GetPagesX(i), GetPagesY(i));
+		}
+	}
+
+	void VirtualTexture::CreateFeedbackBuffer(uint32_t width, uint32_t height)
+	{
+		m_FeedbackWidth = std::max((width + VKAPP_VIRTUAL_FEEDBACK_SCALE - 1) / VKAPP_VIRTUAL_FEEDBACK_SCALE, 1u);
+		m_FeedbackHeight = std::max((height + VKAPP_VIRTUAL_FEEDBACK_SCALE - 1) / VKAPP_VIRTUAL_FEEDBACK_SCALE, 1u);
+
+		// Note: A section is read back once the frame that wrote it is guaranteed done, which is
+		// frames in flight + 1 frames later, plus the section the current frame writes to.
+		m_FeedbackSections = Renderer::Get()->GetFramesInFlight() + 2;
+
+		VkPhysicalDeviceProperties properties = {};
+		vkGetPhysicalDeviceProperties(InstanceManager::Get()->GetPhysicalDevice(), &properties);
+
+		VkDeviceSize alignment = std::max<VkDeviceSize>(properties.limits.minStorageBufferOffsetAlignment, 4);
+		m_FeedbackSectionSize = (GetFeedbackRange() + alignment - 1) / alignment * alignment;
+
+		VkDeviceSize size = m_FeedbackSectionSize * m_FeedbackSections;
+		BufferManager::CreateBuffer(size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_FeedbackBuffer, m_FeedbackMemory);
+
+		void* mapped = nullptr;
+		vkMapMemory(InstanceManager::Get()->GetLogicalDevice(), m_FeedbackMemory, 0, size, 0, &mapped);
+		m_FeedbackData = static_cast<uint32_t*>(mapped);
+
+		memset(m_FeedbackData, 0, static_cast<size_t>(size));
+	}
+
+	// ===================================
+	// ------------- Helper --------------
+	// ===================================
+	void VirtualTexture::ReadFeedback()
+	{
+		// Note: The render graph's final barriers make the shader writes visible to the host, see ImportFeedback().
+		uint32_t section = static_cast<uint32_t>((m_FrameIndex + 1) % m_FeedbackSections);
+		uint32_t* feedback = m_FeedbackData + section * (m_FeedbackSectionSize / sizeof(uint32_t));
+		size_t count = (size_t)m_FeedbackWidth * m_FeedbackHeight;
+
+		std::unordered_set<uint32_t> requested = { };
+		for (size_t i = 0; i < count; i++)
+		{
+			if (feedback[i] != 0)
+				requested.insert(feedback[i]);
+		}
+
+		memset(feedback, 0, count * sizeof(uint32_t));
+
+		std::vector<uint32_t> missing = { };
+		for (uint32_t page : requested)
+		{
+			uint32_t mip = VKAPP_VIRTUAL_PAGE_MIP(page), x = VKAPP_VIRTUAL_PAGE_X(page), y = VKAPP_VIRTUAL_PAGE_Y(page);
+			if (mip >= m_MipLevels || x >= GetPagesX(mip) || y >= GetPagesY(mip))
+				continue;
+
+			// Note: The parents are requested as well, they're what the lookup falls back to.
+			for (; mip < m_MipLevels; mip++, x >>= 1, y >>= 1)
+			{
+				uint32_t id = VKAPP_VIRTUAL_PAGE_ID(x, y, mip);
+
+				auto it = m_ResidentPages.find(id);
+				if (it != m_ResidentPages.end())
+				{
+					m_Slots[it->second].LastUsedFrame = m_FrameIndex;
+					continue;
+				}
+
+				if (m_PendingPages.insert(id).second)
+					missing.push_back(id);
+			}
+		}
+
+		if (missing.empty())
+			return;
+
+		// Coarse pages first, they fill the biggest holes.
+		std::sort(missing.begin(), missing.end(), [](uint32_t a, uint32_t b) { return VKAPP_VIRTUAL_PAGE_MIP(a) > VKAPP_VIRTUAL_PAGE_MIP(b); });
+
+		{
+			std::scoped_lock<std::mutex> lock(m_Mutex);
+
+			// Note: What is visible now matters more than what was requested a few frames ago.
+			for (auto it = missing.rbegin(); it != missing.rend(); ++it)
+				m_Requests.push_front(*it);
+		}
+		m_Condition.notify_one();
+	}
+
+	void VirtualTexture::UploadPages(uint32_t limit)
+	{
+		if (m_Upload.Value != 0 && !FinishUpload(false))
+			return;
+
+		std::vector<LoadedPage> pages = { };
+		{
+			std::scoped_lock<std::mutex> lock(m_Mutex);
+			while (!m_Loaded.empty() && pages.size() < limit)
+			{
+				pages.push_back(std::move(m_Loaded.front()));
+				m_Loaded.pop_front();
+			}
+		}
+
+		std::vector<std::pair<size_t, uint32_t>> placed = { }; // Index into pages, slot
+		for (size_t i = 0; i < pages.size(); i++)
+		{
+			m_PendingPages.erase(pages[i].Page);
+
+			if (pages[i].Pixels.empty())
+			{
+				VKAPP_LOG_WARN("Failed to read virtual texture page {0}x{1} of mip {2}.", VKAPP_VIRTUAL_PAGE_X(pages[i].Page), VKAPP_VIRTUAL_PAGE_Y(pages[i].Page), VKAPP_VIRTUAL_PAGE_MIP(pages[i].Page));
+				continue;
+			}
+
+			// Note: When the atlas is full of pages in use the rest is dropped, they get requested again if they're still visible.
+			uint32_t slot = AllocateSlot();
+			if (slot == UINT32_MAX)
+				continue;
+
+			MapPage(pages[i].Page, slot);
+			placed.push_back({ i, slot });
+		}
+
+		// Staging layout: the pages, followed by the dirty part of every indirection level
+		VkDeviceSize size = placed.size() * VKAPP_VIRTUAL_SLOT_BYTES;
+
+		std::vector<VkBufferImageCopy> indirectionCopies = { };
+		for (uint32_t i = 0; i < m_MipLevels; i++)
+		{
+			const DirtyRect& rect = m_DirtyRects[i];
+			if (rect.IsEmpty())
+				continue;
+
+			VkBufferImageCopy region = {};
+			region.bufferOffset = size;
+			region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			region.imageSubresource.mipLevel = i;
+			region.imageSubresource.baseArrayLayer = 0;
+			region.imageSubresource.layerCount = 1;
+			region.imageOffset = { (int32_t)rect.X0, (int32_t)rect.Y0, 0 };
+			region.imageExtent = { rect.X1 - rect.X0, rect.Y1 - rect.Y0, 1 };
+			indirectionCopies.push_back(region);
+
+			size += (VkDeviceSize)(rect.X1 - rect.X0) * (rect.Y1 - rect.Y0) * sizeof(uint32_t);
+		}
+
+		if (size == 0)
+			return;
+
+		auto logicalDevice = InstanceManager::Get()->GetLogicalDevice();
+
+		BufferManager::CreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_Upload.StagingBuffer, m_Upload.StagingMemory);
+
+		void* mapped = nullptr;
+		vkMapMemory(logicalDevice, m_Upload.StagingMemory, 0, size, 0, &mapped);
+		uint8_t* staging = static_cast<uint8_t*>(mapped);
+
+		std::vector<VkBufferImageCopy> pageCopies = { };
+		for (size_t i = 0; i < placed.size(); i++)
+		{
+			memcpy(staging + i * VKAPP_VIRTUAL_SLOT_BYTES, pages[placed[i].first].Pixels.data(), VKAPP_VIRTUAL_SLOT_BYTES);
+
+			uint32_t slot = placed[i].second;
+
+			VkBufferImageCopy region = {};
+			region.bufferOffset = i * VKAPP_VIRTUAL_SLOT_BYTES;
+			region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			region.imageSubresource.mipLevel = 0;
+			region.imageSubresource.baseArrayLayer = 0;
+			region.imageSubresource.layerCount = 1;
+			region.imageOffset = { (int32_t)((slot % m_Info.AtlasPages) * VKAPP_VIRTUAL_SLOT_SIZE), (int32_t)((slot / m_Info.AtlasPages) * VKAPP_VIRTUAL_SLOT_SIZE), 0 };
+			region.imageExtent = { VKAPP_VIRTUAL_SLOT_SIZE, VKAPP_VIRTUAL_SLOT_SIZE, 1 };
+			pageCopies.push_back(region);
+		}
+
+		for (auto& region : indirectionCopies)
+		{
+			const DirtyRect& rect = m_DirtyRects[region.imageSubresource.mipLevel];
+			const std::vector<uint32_t>& data = m_IndirectionData[region.imageSubresource.mipLevel];
+			uint32_t stride = GetPagesX(region.imageSubresource.mipLevel);
+
+			uint8_t* destination = staging + region.bufferOffset;
+			for (uint32_t y = rect.Y0; y < rect.Y1; y++)
+			{
+				memcpy(destination, data.data() + (size_t)y * stride + rect.X0, (rect.X1 - rect.X0) * sizeof(uint32_t));
+				destination += (rect.X1 - rect.X0) * sizeof(uint32_t);
+			}
+		}
+
+		vkUnmapMemory(logicalDevice, m_Upload.StagingMemory);
+
+		for (auto& rect : m_DirtyRects)
+			rect = {};
+
+		VkCommandBufferAllocateInfo allocInfo = {};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandPool = Renderer::Get()->GetCommandPool();
+		allocInfo.commandBufferCount = 1;
+
+		if (vkAllocateCommandBuffers(logicalDevice, &allocInfo, &m_Upload.CommandBuffer) != VK_SUCCESS)
+			VKAPP_LOG_ERROR("Failed to allocate virtual texture command buffer!");
+
+		VkCommandBufferBeginInfo beginInfo = {};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+		VkCommandBuffer commandBuffer = m_Upload.CommandBuffer;
+		vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+		// Note: Frames in flight still sample the atlas and indirection, the barriers make the copies wait for them.
+		auto copyToImage = [&](VkImage image, uint32_t mipLevels, const std::vector<VkBufferImageCopy>& regions)
+		{
+			if (regions.empty())
+				return;
+
+			VkImageMemoryBarrier barrier = {};
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.image = image;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			barrier.subresourceRange.baseMipLevel = 0;
+			barrier.subresourceRange.levelCount = mipLevels;
+			barrier.subresourceRange.baseArrayLayer = 0;
+			barrier.subresourceRange.layerCount = 1;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.srcAccessMask = 0;
+			barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+			vkCmdCopyBufferToImage(commandBuffer, m_Upload.StagingBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()), regions.data());
+
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+		};
+
+		copyToImage(m_Atlas, 1, pageCopies);
+		copyToImage(m_Indirection, m_MipLevels, indirectionCopies);
+
+		vkEndCommandBuffer(commandBuffer);
+
+		m_Upload.Value = InstanceManager::Get()->GetGraphicsTimeline().Submit({ commandBuffer });
+	}
+
+	bool VirtualTexture::FinishUpload(bool wait)
+	{
+		auto logicalDevice = InstanceManager::Get()->GetLogicalDevice();
+		QueueTimeline& timeline = InstanceManager::Get()->GetGraphicsTimeline();
+
+		if (wait)
+			timeline.Wait(m_Upload.Value);
+		else if (!timeline.IsComplete(m_Upload.Value))
+			return false;
+
+		vkFreeCommandBuffers(logicalDevice, Renderer::Get()->GetCommandPool(), 1, &m_Upload.CommandBuffer);
+		BufferManager::DestroyBuffer(m_Upload.StagingBuffer, m_Upload.StagingMemory);
+
+		m_Upload = {};
+		return true;
+	}
+
+	uint32_t VirtualTexture::AllocateSlot()
+	{
+		for (uint32_t i = 0; i < m_Slots.size(); i++)
+		{
+			if (m_Slots[i].Page == 0)
+				return i;
+		}
+
+		// Least recently requested, pages requested this frame are still visible so they stay.
+		uint32_t oldest = UINT32_MAX;
+		for (uint32_t i = 0; i < m_Slots.size(); i++)
+		{
+			if (m_Slots[i].Pinned || m_Slots[i].LastUsedFrame >= m_FrameIndex)
+				continue;
+
+			if (oldest == UINT32_MAX || m_Slots[i].LastUsedFrame < m_Slots[oldest].LastUsedFrame)
+				oldest = i;
+		}
+
+		if (oldest != UINT32_MAX)
+			UnmapPage(m_Slots[oldest].Page);
+
+		return oldest;
+	}
+
+	void VirtualTexture::MapPage(uint32_t page, uint32_t slot)
+	{
+		uint32_t mip = VKAPP_VIRTUAL_PAGE_MIP(page), x = VKAPP_VIRTUAL_PAGE_X(page), y = VKAPP_VIRTUAL_PAGE_Y(page);
+
+		m_Slots[slot].Page = page;
+		m_Slots[slot].LastUsedFrame = m_FrameIndex;
+		m_Slots[slot].Pinned = (mip == m_MipLevels - 1);
+		m_ResidentPages[page] = slot;
+
+		uint32_t entry = PackEntry(slot % m_Info.AtlasPages, slot / m_Info.AtlasPages, mip);
+
+		// Every entry under this page that points at a coarser page (or nothing) now points here.
+		for (int32_t level = (int32_t)mip; level >= 0; level--)
+		{
+			uint32_t shift = mip - level;
+			uint32_t x0 = x << shift, y0 = y << shift;
+			uint32_t x1 = std::min((x + 1) << shift, GetPagesX(level)), y1 = std::min((y + 1) << shift, GetPagesY(level));
+
+			std::vector<uint32_t>& data = m_IndirectionData[level];
+			uint32_t stride = GetPagesX(level);
+
+			for (uint32_t py = y0; py < y1; py++)
+			{
+				for (uint32_t px = x0; px < x1; px++)
+				{
+					uint32_t& current = data[(size_t)py * stride + px];
+					if ((current >> 24) == 0 || ((current >> 16) & 0xFF) >= mip)
+						current = entry;
+				}
+			}
+
+			MarkDirty(level, x0, y0, x1, y1);
+		}
+	}
+
+	void VirtualTexture::UnmapPage(uint32_t page)
+	{
+		auto it = m_ResidentPages.find(page);
+		if (it == m_ResidentPages.end())
+			return;
+
+		uint32_t slot = it->second;
+		m_ResidentPages.erase(it);
+		m_Slots[slot] = {};
+
+		uint32_t mip = VKAPP_VIRTUAL_PAGE_MIP(page), x = VKAPP_VIRTUAL_PAGE_X(page), y = VKAPP_VIRTUAL_PAGE_Y(page);
+		uint32_t entry = PackEntry(slot % m_Info.AtlasPages, slot / m_Info.AtlasPages, mip);
+
+		// Entries that pointed here fall back to whatever the parent's entry points at.
+		uint32_t parent = 0;
+		if (mip + 1 < m_MipLevels)
+			parent = m_IndirectionData[mip + 1][(size_t)(y >> 1) * GetPagesX(mip + 1) + (x >> 1)];
+
+		for (int32_t level = (int32_t)mip; level >= 0; level--)
+		{
+			uint32_t shift = mip - level;
+			uint32_t x0 = x << shift, y0 = y << shift;
+			uint32_t x1 = std::min((x + 1) << shift, GetPagesX(level)), y1 = std::min((y + 1) << shift, GetPagesY(level));
+
+			std::vector<uint32_t>& data = m_IndirectionData[level];
+			uint32_t stride = GetPagesX(level);
+
+			for (uint32_t py = y0; py < y1; py++)
+			{
+				for (uint32_t px = x0; px < x1; px++)
+				{
+					uint32_t& current = data[(size_t)py * stride + px];
+					if (current == entry)
+						current = parent;
+				}
+			}
+
+			MarkDirty(level, x0, y0, x1, y1);
+		}
+	}
+
+	void VirtualTexture::MarkDirty(uint32_t mip, uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1)
+	{
+		DirtyRect& rect = m_DirtyRects[mip];
+		rect.X0 = std::min(rect.X0, x0);
+		rect.Y0 = std::min(rect.Y0, y0);
+		rect.X1 = std::max(rect.X1, x1);
+		rect.Y1 = std::max(rect.Y1, y1);
+	}
+
+	void VirtualTexture::StartWorker()
+	{
+		m_Running = true;
+		m_Worker = std::thread([this]() { WorkerLoop(); });
+	}
+
+	void VirtualTexture::StopWorker()
+	{
+		{
+			std::scoped_lock<std::mutex> lock(m_Mutex);
+			m_Running = false;
+			m_Requests.clear();
+		}
+		m_Condition.notify_all();
+
+		if (m_Worker.joinable())
+			m_Worker.join();
+	}
+
+	void VirtualTexture::WorkerLoop()
+	{
+		while (true)
+		{
+			uint32_t page = 0;
+
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_Condition.wait(lock, [this]() { return !m_Running || !m_Requests.empty(); });
+
+				if (!m_Running)
+					return;
+
+				page = m_Requests.front();
+				m_Requests.pop_front();
+			}
+
+			LoadedPage loaded = {};
+			loaded.Page = page;
+			loaded.Pixels.resize(VKAPP_VIRTUAL_SLOT_BYTES);
+
+			if (!m_Info.Source->ReadPage(VKAPP_VIRTUAL_PAGE_MIP(page), VKAPP_VIRTUAL_PAGE_X(page), VKAPP_VIRTUAL_PAGE_Y(page), loaded.Pixels.data()))
+				loaded.Pixels.clear();
+
+			std::scoped_lock<std::mutex> lock(m_Mutex);
+			m_Loaded.push_back(std::move(loaded));
+		}
+	}
+
+}
\ No newline at end of file
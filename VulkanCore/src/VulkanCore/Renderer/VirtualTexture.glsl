@@ -0,0 +1,69 @@
+// Virtual texture lookup, see VirtualTexture.hpp.
+// Include with GL_GOOGLE_include_directive and VulkanCore/src/VulkanCore/Renderer as an include directory,
+// the defines have to match the VKAPP_VIRTUAL_* ones. See VulkanSandbox's virtualtexture.frag for a full example.
+//
+// Usage in a fragment shader:
+//     uint request;
+//     outColor = VT_Sample(u_Indirection, u_Atlas, fragTexCoord, u_Params, request);
+//
+//     uvec2 feedbackTexel = uvec2(gl_FragCoord.xy) / VT_FEEDBACK_SCALE;
+//     u_Feedback.Requests[feedbackTexel.y * u_Params.FeedbackWidth + feedbackTexel.x] = request;
+//
+// Where u_Feedback is bound at VirtualTexture::GetFeedbackOffset() with GetFeedbackRange().
+
+#define VT_PAGE_SIZE 128.0
+#define VT_PAGE_BORDER 4.0
+#define VT_SLOT_SIZE 136.0
+#define VT_FEEDBACK_SCALE 8u
+
+struct VirtualTextureParams
+{
+    vec2 VirtualSize;
+    vec2 AtlasSize;
+    uint MaxMip;
+    uint FeedbackWidth;
+    uint Padding0;
+    uint Padding1;
+};
+
+uint VT_PackRequest(uvec2 page, uint mip)
+{
+    return (1u << 31) | (mip << 24) | (page.y << 12) | page.x;
+}
+
+uvec2 VT_GetPage(vec2 uv, VirtualTextureParams params, uint mip)
+{
+    vec2 pages = max(floor(params.VirtualSize / (VT_PAGE_SIZE * exp2(float(mip)))), vec2(1.0));
+    return uvec2(clamp(floor(uv * pages), vec2(0.0), pages - 1.0));
+}
+
+vec4 VT_Sample(usampler2D indirection, sampler2D atlas, vec2 uv, VirtualTextureParams params, out uint request)
+{
+    uv = clamp(uv, vec2(0.0), vec2(1.0));
+
+    vec2 texel = uv * params.VirtualSize;
+    vec2 dx = dFdx(texel);
+    vec2 dy = dFdy(texel);
+
+    float lod = 0.5 * log2(max(max(dot(dx, dx), dot(dy, dy)), 1e-8));
+    uint mip = uint(clamp(floor(lod), 0.0, float(params.MaxMip)));
+
+    uvec2 page = VT_GetPage(uv, params, mip);
+    request = VT_PackRequest(page, mip);
+
+    // x, y = atlas slot, z = mip of the page that is actually resident, w = valid
+    uvec4 entry = texelFetch(indirection, ivec2(page), int(mip));
+    if (entry.w == 0u)
+        return vec4(0.0);
+
+    // Note: Position inside the resident page in texels of its own mip, so pages of
+    // levels smaller than a page (which only partially fill it) still line up.
+    float scale = exp2(-float(entry.z));
+    vec2 residentTexel = texel * scale;
+    vec2 inPage = residentTexel - vec2(VT_GetPage(uv, params, entry.z)) * VT_PAGE_SIZE;
+
+    vec2 atlasTexel = vec2(entry.xy) * VT_SLOT_SIZE + VT_PAGE_BORDER + inPage;
+    vec2 gradScale = vec2(scale) / params.AtlasSize;
+
+    return textureGrad(atlas, atlasTexel / params.AtlasSize, dx * gradScale, dy * gradScale);
+}
\ No newline at end of file
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <mutex>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <memory>
+#include <filesystem>
+#include <unordered_map>
+#include <unordered_set>
+#include <condition_variable>
+
+#include <vulkan/vulkan.h>
+
+#include <glm/glm.hpp>
+
+#include "VulkanCore/Renderer/Texture.hpp"
+#include "VulkanCore/Renderer/RenderGraph.hpp"
+
+namespace VkApp
+{
+
+	// Has to match VirtualTexture.glsl, which lives next to this file so shaders can include it with -I.
+	#define VKAPP_VIRTUAL_PAGE_SIZE 128u
+	#define VKAPP_VIRTUAL_PAGE_BORDER 4u // Texels copied from the neighbouring pages, so bilinear/anisotropic filtering works across page edges
+	#define VKAPP_VIRTUAL_SLOT_SIZE (VKAPP_VIRTUAL_PAGE_SIZE + 2u * VKAPP_VIRTUAL_PAGE_BORDER)
+	#define VKAPP_VIRTUAL_FEEDBACK_SCALE 8u // One feedback texel per 8x8 pixels
+
+	// Page requests as written to the feedback buffer, 0 means no request.
+	#define VKAPP_VIRTUAL_PAGE_ID(x, y, mip) ((1u << 31) | ((uint32_t)(mip) << 24) | ((uint32_t)(y) << 12) | (uint32_t)(x))
+	#define VKAPP_VIRTUAL_PAGE_X(id) ((id) & 0xFFFu)
+	#define VKAPP_VIRTUAL_PAGE_Y(id) (((id) >> 12) & 0xFFFu)
+	#define VKAPP_VIRTUAL_PAGE_MIP(id) (((id) >> 24) & 0x1Fu)
+
+	// Where the pages come from. Pages are read on the streaming thread, so implementations must be thread safe
+	// with respect to themselves. The size must be a power of two multiple of VKAPP_VIRTUAL_PAGE_SIZE.
+	class VirtualTextureSource
+	{
+	public:
+		virtual ~VirtualTextureSource() = default;
+
+		virtual uint32_t GetWidth() const = 0;
+		virtual uint32_t GetHeight() const = 0;
+
+		// Writes VKAPP_VIRTUAL_SLOT_SIZE x VKAPP_VIRTUAL_SLOT_SIZE RGBA8 texels, the page plus its border.
+		virtual bool ReadPage(uint32_t mip, uint32_t pageX, uint32_t pageY, uint8_t* pixels) = 0;
+	};
+
+	// Serves pages out of a regular image kept in memory, meant for atlases that are too big to keep resident.
+	// The whole image and its mips stay in RAM (4/3 of the RGBA8 size), so this doesn't scale to the 512K x 512K
+	// the page ids allow, a 64K x 64K texture alone would take over 21GB. Sources that big should read their pages from disk.
+	class ImageVirtualTextureSource : public VirtualTextureSource
+	{
+	public:
+		ImageVirtualTextureSource(const std::filesystem::path& path);
+		ImageVirtualTextureSource(TextureData&& data); // Expects RGBA8, the mips are generated if needed
+
+		inline uint32_t GetWidth() const override { return m_Data.Width; }
+		inline uint32_t GetHeight() const override { return m_Data.Height; }
+
+		bool ReadPage(uint32_t mip, uint32_t pageX, uint32_t pageY, uint8_t* pixels) override;
+
+	private:
+		TextureData m_Data = {};
+	};
+
+	struct VirtualTextureInfo
+	{
+	public:
+		std::shared_ptr<VirtualTextureSource> Source = nullptr;
+
+		uint32_t AtlasPages = 24;				// Per axis, the physical atlas holds AtlasPages^2 pages
+		uint32_t MaxUploadsPerFrame = 16;
+
+		uint32_t ViewportWidth = 0;				// Used to size the feedback buffer, see Resize()
+		uint32_t ViewportHeight = 0;
+	};
+
+	// Matches VirtualTextureParams in VirtualTexture.glsl, usually part of a uniform buffer.
+	struct VirtualTextureParams
+	{
+	public:
+		glm::vec2 VirtualSize = { 0.0f, 0.0f };
+		glm::vec2 AtlasSize = { 0.0f, 0.0f };
+		uint32_t MaxMip = 0;
+		uint32_t FeedbackWidth = 0;
+		uint32_t Padding[2] = { };
+	};
+
+	// Software virtual texturing: the shader writes the pages it needs to a low resolution feedback buffer,
+	// a streaming thread reads the missing pages from the source and they're copied into a fixed size page atlas.
+	// An indirection texture (one texel per virtual page, per mip) maps every page to its atlas slot, or to
+	// the slot of the closest resident parent. No sparse residency needed, so it runs on any device.
+	class VirtualTexture
+	{
+	public:
+		VirtualTexture() = default;
+		VirtualTexture(const VirtualTextureInfo& info);
+		void Destroy();
+
+		// Reads back the feedback of the oldest frame, queues the missing pages and uploads the finished ones.
+		// Call once per frame before recording.
+		void Update();
+
+		// Recreates the feedback buffer, waits for the device.
+		void Resize(uint32_t width, uint32_t height);
+
+		inline VkImageView& GetAtlasView() { return m_AtlasView; }
+		inline VkSampler& GetAtlasSampler() { return m_AtlasSampler; }
+		inline VkImageView& GetIndirectionView() { return m_IndirectionView; }
+		inline VkSampler& GetIndirectionSampler() { return m_IndirectionSampler; }
+
+		// The feedback buffer holds a section per frame, bind it as VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC
+		// with GetFeedbackOffset() as the dynamic offset and GetFeedbackRange() as the range.
+		inline VkBuffer& GetFeedbackBuffer() { return m_FeedbackBuffer; }
+		inline uint32_t GetFeedbackOffset() const { return static_cast<uint32_t>((m_FrameIndex % m_FeedbackSections) * m_FeedbackSectionSize); }
+		inline VkDeviceSize GetFeedbackRange() const { return m_FeedbackWidth * m_FeedbackHeight * sizeof(uint32_t); }
+
+		// Imports the feedback buffer with a host read as its final access, passes drawing with the virtual texture
+		// write it with RenderGraphUsage::FragmentStorageWrite. Call it while building the graph, Resize() replaces the buffer.
+		RenderGraphHandle ImportFeedback(RenderGraph& graph, const std::string& name) const;
+
+		VirtualTextureParams GetParams() const;
+
+		inline uint32_t GetResidentPageCount() const { return static_cast<uint32_t>(m_ResidentPages.size()); }
+		inline uint32_t GetPendingPageCount() const { return static_cast<uint32_t>(m_PendingPages.size()); }
+
+	private:
+		void CreateAtlas();
+		void CreateIndirection();
+		void CreateFeedbackBuffer(uint32_t width, uint32_t height);
+
+		void ReadFeedback();
+		void UploadPages(uint32_t limit);
+		bool FinishUpload(bool wait);
+
+		uint32_t AllocateSlot();
+		void MapPage(uint32_t page, uint32_t slot);
+		void UnmapPage(uint32_t page);
+		void MarkDirty(uint32_t mip, uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1);
+
+		inline uint32_t GetPagesX(uint32_t mip) const { return std::max((m_Info.Source->GetWidth() / VKAPP_VIRTUAL_PAGE_SIZE) >> mip, 1u); }
+		inline uint32_t GetPagesY(uint32_t mip) const { return std::max((m_Info.Source->GetHeight() / VKAPP_VIRTUAL_PAGE_SIZE) >> mip, 1u); }
+
+		void StartWorker();
+		void StopWorker();
+		void WorkerLoop();
+
+	private:
+		VirtualTextureInfo m_Info = {};
+		uint32_t m_MipLevels = 0;
+		uint64_t m_FrameIndex = 0;
+
+		// Physical page atlas
+		VkImage m_Atlas = VK_NULL_HANDLE;
+		VkDeviceMemory m_AtlasMemory = VK_NULL_HANDLE;
+		VkImageView m_AtlasView = VK_NULL_HANDLE;
+		VkSampler m_AtlasSampler = VK_NULL_HANDLE;
+
+		struct Slot
+		{
+		public:
+			uint32_t Page = 0;		// 0 if free
+			uint64_t LastUsedFrame = 0;
+			bool Pinned = false;	// The coarsest level, so every lookup has something to fall back to
+		};
+		std::vector<Slot> m_Slots = { };
+		std::unordered_map<uint32_t, uint32_t> m_ResidentPages = { }; // Page -> slot
+		std::unordered_set<uint32_t> m_PendingPages = { };
+
+		// Indirection, RGBA8_UINT per virtual page: atlas slot x/y, the mip that is actually resident and 255 if valid
+		VkImage m_Indirection = VK_NULL_HANDLE;
+		VkDeviceMemory m_IndirectionMemory = VK_NULL_HANDLE;
+		VkImageView m_IndirectionView = VK_NULL_HANDLE;
+		VkSampler m_IndirectionSampler = VK_NULL_HANDLE;
+
+		struct DirtyRect
+		{
+		public:
+			uint32_t X0 = UINT32_MAX, Y0 = UINT32_MAX;
+			uint32_t X1 = 0, Y1 = 0; // Exclusive
+
+			inline bool IsEmpty() const { return X0 >= X1 || Y0 >= Y1; }
+		};
+		std::vector<std::vector<uint32_t>> m_IndirectionData = { }; // CPU copy, per mip
+		std::vector<DirtyRect> m_DirtyRects = { };
+
+		// Feedback, host visible with a section per frame. A section is only read back once its frame is done.
+		VkBuffer m_FeedbackBuffer = VK_NULL_HANDLE;
+		VkDeviceMemory m_FeedbackMemory = VK_NULL_HANDLE;
+		uint32_t* m_FeedbackData = nullptr;
+		uint32_t m_FeedbackWidth = 0;
+		uint32_t m_FeedbackHeight = 0;
+		uint32_t m_FeedbackSections = 0;
+		VkDeviceSize m_FeedbackSectionSize = 0;
+
+		// Streaming thread
+		struct LoadedPage
+		{
+		public:
+			uint32_t Page = 0;
+			std::vector<uint8_t> Pixels = { };
+		};
+
+		std::thread m_Worker;
+		bool m_Running = false;
+		std::mutex m_Mutex;
+		std::condition_variable m_Condition;
+		std::deque<uint32_t> m_Requests = { };
+		std::deque<LoadedPage> m_Loaded = { };
+
+		// The upload that is currently on the GPU, polled so the main thread never waits for it.
+		struct Upload
+		{
+		public:
+			VkBuffer StagingBuffer = VK_NULL_HANDLE;
+			VkDeviceMemory StagingMemory = VK_NULL_HANDLE;
+			VkCommandBuffer CommandBuffer = VK_NULL_HANDLE;
+			uint64_t Value = 0; // Graphics timeline value, 0 when there is no upload
+		};
+		Upload m_Upload = {};
+	};
+
+}
\ No newline at end of file
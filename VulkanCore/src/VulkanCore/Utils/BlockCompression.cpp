@@ -0,0 +1,448 @@
+#include "vcpch.h"
+#include "BlockCompression.hpp"
+
+#include <cmath>
+#include <cstring>
+
+#include "VulkanCore/Core/JobSystem.hpp"
+
+namespace VkApp
+{
+
+	// ===================================
+	// ------------- Helper --------------
+	// ===================================
+	static const uint32_t s_BC7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	// Finds the mean and the direction of largest variance of the texels using power iteration.
+	template<uint32_t Dimensions>
+	static void PrincipalAxis(const float (*points)[4], float* mean, float* axis)
+	{
+		for (uint32_t d = 0; d < Dimensions; d++)
+		{
+			mean[d] = 0.0f;
+			for (uint32_t i = 0; i < 16; i++)
+				mean[d] += points[i][d];
+			mean[d] /= 16.0f;
+		}
+
+		float covariance[Dimensions][Dimensions] = { };
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			for (uint32_t a = 0; a < Dimensions; a++)
+			{
+				for (uint32_t b = 0; b < Dimensions; b++)
+					covariance[a][b] += (points[i][a] - mean[a]) * (points[i][b] - mean[b]);
+			}
+		}
+
+		for (uint32_t d = 0; d < Dimensions; d++)
+			axis[d] = 1.0f;
+
+		for (uint32_t iteration = 0; iteration < 8; iteration++)
+		{
+			float next[Dimensions] = { };
+			float length = 0.0f;
+
+			for (uint32_t a = 0; a < Dimensions; a++)
+			{
+				for (uint32_t b = 0; b < Dimensions; b++)
+					next[a] += covariance[a][b] * axis[b];
+				length = std::max(length, std::abs(next[a]));
+			}
+
+			// Note: A flat block has no variance, any axis works then.
+			if (length < 1e-6f)
+				break;
+
+			for (uint32_t d = 0; d < Dimensions; d++)
+				axis[d] = next[d] / length;
+		}
+
+		float length = 0.0f;
+		for (uint32_t d = 0; d < Dimensions; d++)
+			length += axis[d] * axis[d];
+
+		length = std::sqrt(length);
+		for (uint32_t d = 0; d < Dimensions; d++)
+			axis[d] /= length;
+	}
+
+	template<uint32_t Dimensions>
+	static void FitEndpoints(const float (*points)[4], float* low, float* high)
+	{
+		float mean[4] = { }, axis[4] = { };
+		PrincipalAxis<Dimensions>(points, mean, axis);
+
+		float minT = std::numeric_limits<float>::max(), maxT = -std::numeric_limits<float>::max();
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			float t = 0.0f;
+			for (uint32_t d = 0; d < Dimensions; d++)
+				t += (points[i][d] - mean[d]) * axis[d];
+
+			minT = std::min(minT, t);
+			maxT = std::max(maxT, t);
+		}
+
+		for (uint32_t d = 0; d < Dimensions; d++)
+		{
+			low[d] = std::clamp(mean[d] + axis[d] * minT, 0.0f, 255.0f);
+			high[d] = std::clamp(mean[d] + axis[d] * maxT, 0.0f, 255.0f);
+		}
+	}
+
+	static uint16_t To565(const float* color)
+	{
+		uint32_t r = static_cast<uint32_t>(color[0] * 31.0f / 255.0f + 0.5f);
+		uint32_t g = static_cast<uint32_t>(color[1] * 63.0f / 255.0f + 0.5f);
+		uint32_t b = static_cast<uint32_t>(color[2] * 31.0f / 255.0f + 0.5f);
+
+		return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+	}
+
+	static void From565(uint16_t color, int32_t* output)
+	{
+		int32_t r = (color >> 11) & 31, g = (color >> 5) & 63, b = color & 31;
+
+		output[0] = (r << 3) | (r >> 2);
+		output[1] = (g << 2) | (g >> 4);
+		output[2] = (b << 3) | (b >> 2);
+	}
+
+	struct BitWriter
+	{
+	public:
+		uint8_t* Output = nullptr;
+		uint32_t Position = 0;
+
+		void Write(uint32_t value, uint32_t bits)
+		{
+			for (uint32_t i = 0; i < bits; i++, Position++)
+			{
+				if (value & (1u << i))
+					Output[Position >> 3] |= static_cast<uint8_t>(1u << (Position & 7));
+			}
+		}
+	};
+
+	// ===================================
+	// ------------ Static ---------------
+	// ===================================
+	void BlockCompression::CompressBlockBC1(const uint8_t* block, uint8_t* output)
+	{
+		float points[16][4] = { };
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			for (uint32_t d = 0; d < 3; d++)
+				points[i][d] = block[i * 4 + d];
+		}
+
+		float low[4] = { }, high[4] = { };
+		FitEndpoints<3>(points, low, high);
+
+		// Inset the endpoints a little, the extremes are usually outliers and this lowers the average error.
+		for (uint32_t d = 0; d < 3; d++)
+		{
+			float inset = (high[d] - low[d]) / 16.0f;
+			low[d] += inset;
+			high[d] -= inset;
+		}
+
+		uint16_t color0 = To565(high);
+		uint16_t color1 = To565(low);
+
+		// Note: color0 > color1 selects the 4 colour mode, color0 == color1 just means a flat block.
+		if (color0 < color1)
+			std::swap(color0, color1);
+
+		memset(output, 0, 8);
+		memcpy(output + 0, &color0, sizeof(uint16_t));
+		memcpy(output + 2, &color1, sizeof(uint16_t));
+
+		if (color0 == color1)
+			return;
+
+		int32_t palette[4][3] = { };
+		From565(color0, palette[0]);
+		From565(color1, palette[1]);
+		for (uint32_t d = 0; d < 3; d++)
+		{
+			palette[2][d] = (2 * palette[0][d] + palette[1][d]) / 3;
+			palette[3][d] = (palette[0][d] + 2 * palette[1][d]) / 3;
+		}
+
+		uint32_t indices = 0;
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			uint32_t best = 0;
+			int32_t bestError = INT32_MAX;
+
+			for (uint32_t p = 0; p < 4; p++)
+			{
+				int32_t error = 0;
+				for (uint32_t d = 0; d < 3; d++)
+				{
+					int32_t difference = block[i * 4 + d] - palette[p][d];
+					error += difference * difference;
+				}
+
+				if (error < bestError)
+				{
+					bestError = error;
+					best = p;
+				}
+			}
+
+			indices |= best << (i * 2);
+		}
+
+		memcpy(output + 4, &indices, sizeof(uint32_t));
+	}
+
+	void BlockCompression::CompressBlockBC4(const uint8_t* block, uint32_t channel, uint8_t* output)
+	{
+		uint8_t minimum = 255, maximum = 0;
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			minimum = std::min(minimum, block[i * 4 + channel]);
+			maximum = std::max(maximum, block[i * 4 + channel]);
+		}
+
+		memset(output, 0, 8);
+		output[0] = maximum;
+		output[1] = minimum;
+
+		if (maximum == minimum)
+			return;
+
+		// 8 value mode, since the first endpoint is larger than the second
+		int32_t palette[8] = { maximum, minimum };
+		for (int32_t i = 2; i < 8; i++)
+			palette[i] = ((8 - i) * maximum + (i - 1) * minimum) / 7;
+
+		uint64_t indices = 0;
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			uint64_t best = 0;
+			int32_t bestError = INT32_MAX;
+
+			for (uint32_t p = 0; p < 8; p++)
+			{
+				int32_t error = std::abs(block[i * 4 + channel] - palette[p]);
+				if (error < bestError)
+				{
+					bestError = error;
+					best = p;
+				}
+			}
+
+			indices |= best << (i * 3);
+		}
+
+		for (uint32_t i = 0; i < 6; i++)
+			output[2 + i] = static_cast<uint8_t>(indices >> (i * 8));
+	}
+
+	void BlockCompression::CompressBlockBC5(const uint8_t* block, uint8_t* output)
+	{
+		CompressBlockBC4(block, 0, output);
+		CompressBlockBC4(block, 1, output + 8);
+	}
+
+	void BlockCompression::CompressBlockBC7(const uint8_t* block, uint8_t* output)
+	{
+		float points[16][4] = { };
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			for (uint32_t d = 0; d < 4; d++)
+				points[i][d] = block[i * 4 + d];
+		}
+
+		float low[4] = { }, high[4] = { };
+		FitEndpoints<4>(points, low, high);
+
+		// Mode 6 stores 7 bit endpoints plus a shared p-bit per endpoint, try every p-bit combination and keep the best.
+		uint32_t bestError = UINT32_MAX;
+		uint32_t bestEndpoints[2][4] = { };
+		uint32_t bestPBits[2] = { };
+		uint32_t bestIndices[16] = { };
+
+		for (uint32_t combination = 0; combination < 4; combination++)
+		{
+			uint32_t pBits[2] = { combination & 1, combination >> 1 };
+			uint32_t endpoints[2][4] = { };
+			int32_t palette[16][4] = { };
+
+			for (uint32_t d = 0; d < 4; d++)
+			{
+				endpoints[0][d] = static_cast<uint32_t>(std::clamp((low[d] - pBits[0]) / 2.0f + 0.5f, 0.0f, 127.0f));
+				endpoints[1][d] = static_cast<uint32_t>(std::clamp((high[d] - pBits[1]) / 2.0f + 0.5f, 0.0f, 127.0f));
+
+				int32_t e0 = static_cast<int32_t>((endpoints[0][d] << 1) | pBits[0]);
+				int32_t e1 = static_cast<int32_t>((endpoints[1][d] << 1) | pBits[1]);
+
+				for (uint32_t p = 0; p < 16; p++)
+					palette[p][d] = ((64 - s_BC7Weights4[p]) * e0 + s_BC7Weights4[p] * e1 + 32) >> 6;
+			}
+
+			uint32_t totalError = 0;
+			uint32_t indices[16] = { };
+
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				uint32_t bestTexelError = UINT32_MAX;
+				for (uint32_t p = 0; p < 16; p++)
+				{
+					uint32_t error = 0;
+					for (uint32_t d = 0; d < 4; d++)
+					{
+						int32_t difference = block[i * 4 + d] - palette[p][d];
+						error += static_cast<uint32_t>(difference * difference);
+					}
+
+					if (error < bestTexelError)
+					{
+						bestTexelError = error;
+						indices[i] = p;
+					}
+				}
+
+				totalError += bestTexelError;
+			}
+
+			if (totalError < bestError)
+			{
+				bestError = totalError;
+				memcpy(bestEndpoints, endpoints, sizeof(endpoints));
+				memcpy(bestPBits, pBits, sizeof(pBits));
+				memcpy(bestIndices, indices, sizeof(indices));
+			}
+		}
+
+		// The anchor index (texel 0) only has 3 bits, so its top bit must be 0. Swap the endpoints if it isn't.
+		if (bestIndices[0] & 8)
+		{
+			for (uint32_t d = 0; d < 4; d++)
+				std::swap(bestEndpoints[0][d], bestEndpoints[1][d]);
+			std::swap(bestPBits[0], bestPBits[1]);
+
+			for (uint32_t i = 0; i < 16; i++)
+				bestIndices[i] = 15 - bestIndices[i];
+		}
+
+		memset(output, 0, 16);
+		BitWriter writer = { output, 0 };
+
+		writer.Write(1u << 6, 7); // Mode 6
+		for (uint32_t d = 0; d < 4; d++)
+		{
+			writer.Write(bestEndpoints[0][d], 7);
+			writer.Write(bestEndpoints[1][d], 7);
+		}
+
+		writer.Write(bestPBits[0], 1);
+		writer.Write(bestPBits[1], 1);
+
+		writer.Write(bestIndices[0], 3);
+		for (uint32_t i = 1; i < 16; i++)
+			writer.Write(bestIndices[i], 4);
+	}
+
+	std::vector<uint8_t> BlockCompression::Compress(const uint8_t* pixels, uint32_t width, uint32_t height, BlockFormat format, uint32_t threadCount)
+	{
+		uint32_t blocksX = (width + 3) / 4;
+		uint32_t blocksY = (height + 3) / 4;
+		uint32_t blockSize = GetBlockSize(format);
+
+		std::vector<uint8_t> output((size_t)blocksX * blocksY * blockSize);
+
+		auto compressRows = [&](uint32_t firstRow, uint32_t lastRow)
+		{
+			uint8_t block[64] = { };
+
+			for (uint32_t by = firstRow; by < lastRow; by++)
+			{
+				for (uint32_t bx = 0; bx < blocksX; bx++)
+				{
+					// Note: Blocks hanging over the edge repeat the last row/column.
+					for (uint32_t y = 0; y < 4; y++)
+					{
+						uint32_t sourceY = std::min(by * 4 + y, height - 1);
+						for (uint32_t x = 0; x < 4; x++)
+						{
+							uint32_t sourceX = std::min(bx * 4 + x, width - 1);
+							memcpy(block + (y * 4 + x) * 4, pixels + ((size_t)sourceY * width + sourceX) * 4, 4);
+						}
+					}
+
+					uint8_t* destination = output.data() + ((size_t)by * blocksX + bx) * blockSize;
+					switch (format)
+					{
+					case BlockFormat::BC1: CompressBlockBC1(block, destination); break;
+					case BlockFormat::BC5: CompressBlockBC5(block, destination); break;
+					case BlockFormat::BC7: CompressBlockBC7(block, destination); break;
+					}
+				}
+			}
+		};
+
+		// Note: Cooking runs on the asset workers, sharing the job system's threads keeps several textures at once from oversubscribing the CPU.
+		if (threadCount == 0 && JobSystem::Get())
+		{
+			JobSystem::ParallelFor(blocksY, 1, compressRows);
+			return output;
+		}
+
+		if (threadCount == 0)
+			threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+		threadCount = std::min(threadCount, blocksY);
+
+		if (threadCount <= 1)
+		{
+			compressRows(0, blocksY);
+			return output;
+		}
+
+		std::vector<std::thread> threads = { };
+		uint32_t rowsPerThread = (blocksY + threadCount - 1) / threadCount;
+
+		for (uint32_t i = 0; i < threadCount; i++)
+		{
+			uint32_t first = i * rowsPerThread;
+			uint32_t last = std::min(first + rowsPerThread, blocksY);
+			if (first < last)
+				threads.emplace_back(compressRows, first, last);
+		}
+
+		for (auto& thread : threads)
+			thread.join();
+
+		return output;
+	}
+
+	uint32_t BlockCompression::GetBlockSize(BlockFormat format)
+	{
+		switch (format)
+		{
+		case BlockFormat::BC1: return 8;
+		case BlockFormat::BC5: return 16;
+		case BlockFormat::BC7: return 16;
+		}
+
+		return 0;
+	}
+
+	VkFormat BlockCompression::GetVkFormat(BlockFormat format)
+	{
+		switch (format)
+		{
+		case BlockFormat::BC1: return VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+		case BlockFormat::BC5: return VK_FORMAT_BC5_UNORM_BLOCK;
+		case BlockFormat::BC7: return VK_FORMAT_BC7_UNORM_BLOCK;
+		}
+
+		return VK_FORMAT_UNDEFINED;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <vulkan/vulkan.h>
+
+namespace VkApp
+{
+
+	enum class BlockFormat
+	{
+		BC1 = 0,	// RGB, 4 bits per texel, no alpha
+		BC5,		// RG, 8 bits per texel, meant for normal maps
+		BC7			// RGBA, 8 bits per texel
+	};
+
+	// CPU block compressors, every block is 4x4 RGBA8 texels (64 bytes) laid out row by row.
+	class BlockCompression
+	{
+	public:
+		static void CompressBlockBC1(const uint8_t* block, uint8_t* output);
+		static void CompressBlockBC4(const uint8_t* block, uint32_t channel, uint8_t* output);
+		static void CompressBlockBC5(const uint8_t* block, uint8_t* output);
+		static void CompressBlockBC7(const uint8_t* block, uint8_t* output); // Note: Only uses mode 6, which is good enough for most colour data.
+
+		// Compresses a whole RGBA8 image, rows of blocks are spread over threadCount threads
+		// (0 = the JobSystem's workers, or hardware concurrency without a JobSystem).
+		static std::vector<uint8_t> Compress(const uint8_t* pixels, uint32_t width, uint32_t height, BlockFormat format, uint32_t threadCount = 0);
+
+		static uint32_t GetBlockSize(BlockFormat format);
+		static VkFormat GetVkFormat(BlockFormat format);
+	};
+
+}
\ No newline at end of file
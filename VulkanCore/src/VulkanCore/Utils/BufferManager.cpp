@@ -7,11 +7,29 @@
 
 #include "VulkanCore/Renderer/Renderer.hpp"
 #include "VulkanCore/Renderer/InstanceManager.hpp"
+#include "VulkanCore/Renderer/DeviceObjectCache.hpp"
+#include "VulkanCore/Renderer/MipGenerator.hpp"
+#include "VulkanCore/Renderer/ResidencyManager.hpp"
 #include "VulkanCore/Renderer/SwapChainManager.hpp"
 
 namespace VkApp
 {
 
+	// What single time commands used, freed once the graphics timeline passes the value.
+	struct RetiredUpload
+	{
+	public:
+		uint64_t Value = 0;
+
+		VkCommandBuffer CommandBuffer = VK_NULL_HANDLE;
+		VkBuffer Buffer = VK_NULL_HANDLE;
+		VkDeviceMemory Memory = VK_NULL_HANDLE;
+	};
+
+	// Note: Uploads may come from other threads, see QueueTimeline.
+	static std::mutex s_RetiredMutex;
+	static std::vector<RetiredUpload> s_RetiredUploads = { };
+
 	// ===================================
 	// ------------ Static ---------------
 	// ===================================
@@ -38,6 +56,8 @@ namespace VkApp
 
 		if (vkAllocateMemory(logicalDevice, &allocInfo, nullptr, &dstBufferMemory) != VK_SUCCESS)
 			VKAPP_LOG_ERROR("Failed to allocate buffer memory!");
+		else if (ResidencyManager::Get())
+			ResidencyManager::Get()->TrackAllocation(dstBufferMemory, allocInfo.allocationSize, allocInfo.memoryTypeIndex);
 
 		vkBindBufferMemory(logicalDevice, dstBuffer, dstBufferMemory, 0);
 	}
@@ -50,9 +70,30 @@ namespace VkApp
 		copyRegion.size = size;
 		vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
 
+		// Note: Nothing waits for the copy on the CPU, so later submissions need the barrier to see it.
+		VkMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
 		EndSingleTimeCommands(commandBuffer);
 	}
 
+	void BufferManager::DestroyBuffer(VkBuffer& buffer, VkDeviceMemory& memory)
+	{
+		auto logicalDevice = InstanceManager::Get()->GetLogicalDevice();
+
+		if (ResidencyManager::Get())
+			ResidencyManager::Get()->UntrackAllocation(memory);
+
+		vkDestroyBuffer(logicalDevice, buffer, nullptr);
+		vkFreeMemory(logicalDevice, memory, nullptr);
+
+		buffer = VK_NULL_HANDLE;
+		memory = VK_NULL_HANDLE;
+	}
+
 	uint32_t BufferManager::FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties)
 	{
 		VkPhysicalDeviceMemoryProperties memProperties = {};
@@ -68,6 +109,20 @@ namespace VkApp
 		return -1;
 	}
 
+	bool BufferManager::HasMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties)
+	{
+		VkPhysicalDeviceMemoryProperties memProperties = {};
+		vkGetPhysicalDeviceMemoryProperties(InstanceManager::Get()->GetPhysicalDevice(), &memProperties);
+
+		for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++)
+		{
+			if ((typeFilter & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
+				return true;
+		}
+
+		return false;
+	}
+
 	void BufferManager::CreateVertexBuffer(VkBuffer& dstBuffer, VkDeviceMemory& dstMemory, void* vertices, VkDeviceSize size)
 	{
 		auto logicalDevice = InstanceManager::Get()->GetLogicalDevice();
@@ -85,9 +140,8 @@ namespace VkApp
 		CreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, dstBuffer, dstMemory);
 		CopyBuffer(stagingBuffer, dstBuffer, size);
 
-		// Free the staging buffer
-		vkDestroyBuffer(logicalDevice, stagingBuffer, nullptr);
-		vkFreeMemory(logicalDevice, stagingBufferMemory, nullptr);
+		// Free the staging buffer once the copy is done
+		RetireBuffer(stagingBuffer, stagingBufferMemory);
 	}
 
 	void BufferManager::CreateIndexBuffer(VkBuffer& dstBuffer, VkDeviceMemory& dstMemory, void* indices, VkDeviceSize size)
@@ -107,20 +161,21 @@ namespace VkApp
 		CreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, dstBuffer, dstMemory);
 		CopyBuffer(stagingBuffer, dstBuffer, size);
 
-		// Free the staging buffer
-		vkDestroyBuffer(logicalDevice, stagingBuffer, nullptr);
-		vkFreeMemory(logicalDevice, stagingBufferMemory, nullptr);
+		// Free the staging buffer once the copy is done
+		RetireBuffer(stagingBuffer, stagingBufferMemory);
 	}
 
 	void BufferManager::CreateUniformBuffer(std::vector<VkBuffer>& buffers, VkDeviceSize size, std::vector<VkDeviceMemory>& buffersMemory, std::vector<void*>& mappedBuffers)
 	{
 		auto logicalDevice = InstanceManager::Get()->GetLogicalDevice();
 
-		buffers.resize(VKAPP_MAX_FRAMES_IN_FLIGHT);
-		buffersMemory.resize(VKAPP_MAX_FRAMES_IN_FLIGHT);
-		mappedBuffers.resize(VKAPP_MAX_FRAMES_IN_FLIGHT);
+		uint32_t framesInFlight = Renderer::Get()->GetFramesInFlight();
+
+		buffers.resize(framesInFlight);
+		buffersMemory.resize(framesInFlight);
+		mappedBuffers.resize(framesInFlight);
 
-		for (size_t i = 0; i < VKAPP_MAX_FRAMES_IN_FLIGHT; i++) {
+		for (size_t i = 0; i < framesInFlight; i++) {
 			CreateBuffer(size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, buffers[i], buffersMemory[i]);
 
 			vkMapMemory(logicalDevice, buffersMemory[i], 0, size, 0, &mappedBuffers[i]);
@@ -134,18 +189,30 @@ namespace VkApp
 
 	void BufferManager::CreateTexture(const std::filesystem::path& path, VkImage& dstImage, VkDeviceMemory& dstImageMemory, uint32_t& mipLevels)
 	{
-		VkBuffer stagingBuffer;
-		VkDeviceMemory stagingMemory;
-
 		int texWidth, texHeight, texChannels;
 		
 		stbi_uc* pixels = stbi_load(path.string().c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
-		VkDeviceSize imageSize = texWidth * texHeight * 4;
-
-		mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(texWidth, texHeight)))) + 1;
 
 		if (!pixels)
+		{
 			VKAPP_LOG_ERROR("Failed to load texture image!");
+			return;
+		}
+
+		CreateTexture((const void*)pixels, static_cast<uint32_t>(texWidth), static_cast<uint32_t>(texHeight), dstImage, dstImageMemory, mipLevels);
+
+		// Clean up data
+		stbi_image_free((void*)pixels);
+	}
+
+	void BufferManager::CreateTexture(const void* pixels, uint32_t width, uint32_t height, VkImage& dstImage, VkDeviceMemory& dstImageMemory, uint32_t& mipLevels)
+	{
+		VkBuffer stagingBuffer;
+		VkDeviceMemory stagingMemory;
+
+		VkDeviceSize imageSize = (VkDeviceSize)width * height * 4;
+
+		mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
 
 		CreateBuffer(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingMemory);
 
@@ -156,19 +223,50 @@ namespace VkApp
 		memcpy(data, pixels, static_cast<size_t>(imageSize));
 		vkUnmapMemory(logicalDevice, stagingMemory);
 
-		// Clean up data
-		stbi_image_free((void*)pixels);
+		VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		if (MipGenerator::Get() && MipGenerator::Get()->IsSupported(VK_FORMAT_R8G8B8A8_UNORM, width, height))
+			usage |= VK_IMAGE_USAGE_STORAGE_BIT;
 
-		CreateImage(texWidth, texHeight, mipLevels, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, dstImage, dstImageMemory);
+		CreateImage(width, height, mipLevels, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_TILING_OPTIMAL, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, dstImage, dstImageMemory);
 		
 		TransitionImageToLayout(dstImage, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevels);
-		CopyBufferToImage(stagingBuffer, dstImage, static_cast<uint32_t>(texWidth), static_cast<uint32_t>(texHeight));
+		CopyBufferToImage(stagingBuffer, dstImage, width, height);
 		//TransitionImageToLayout(dstImage, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, mipLevels);
-		GenerateMipmaps(dstImage, VK_FORMAT_R8G8B8A8_SRGB, texWidth, texHeight, mipLevels);
+		GenerateMipmaps(dstImage, VK_FORMAT_R8G8B8A8_UNORM, (int32_t)width, (int32_t)height, mipLevels);
 
 		// Cleanup
-		vkDestroyBuffer(logicalDevice, stagingBuffer, nullptr);
-		vkFreeMemory(logicalDevice, stagingMemory, nullptr);
+		RetireBuffer(stagingBuffer, stagingMemory);
+	}
+
+	void BufferManager::CreateTexture(const void* data, VkDeviceSize size, VkFormat format, uint32_t width, uint32_t height, const std::vector<VkBufferImageCopy>& mipRegions, VkImage& dstImage, VkDeviceMemory& dstImageMemory)
+	{
+		VkBuffer stagingBuffer;
+		VkDeviceMemory stagingMemory;
+
+		uint32_t mipLevels = static_cast<uint32_t>(mipRegions.size());
+
+		CreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingMemory);
+
+		auto logicalDevice = InstanceManager::Get()->GetLogicalDevice();
+
+		void* mapped;
+		vkMapMemory(logicalDevice, stagingMemory, 0, size, 0, &mapped);
+		memcpy(mapped, data, static_cast<size_t>(size));
+		vkUnmapMemory(logicalDevice, stagingMemory);
+
+		CreateImage(width, height, mipLevels, format, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, dstImage, dstImageMemory);
+
+		// Note: All levels are already there, so no blitting, just one copy for the whole chain.
+		TransitionImageToLayout(dstImage, format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevels);
+
+		VkCommandBuffer commandBuffer = BeginSingleTimeCommands();
+		vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, dstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(mipRegions.size()), mipRegions.data());
+		EndSingleTimeCommands(commandBuffer);
+
+		TransitionImageToLayout(dstImage, format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, mipLevels);
+
+		// Cleanup
+		RetireBuffer(stagingBuffer, stagingMemory);
 	}
 
 	VkImageView BufferManager::CreateImageView(VkImage& image, VkFormat format, VkImageAspectFlags aspectFlags, uint32_t mipLevels)
@@ -185,11 +283,7 @@ namespace VkApp
 		viewInfo.subresourceRange.layerCount = 1;
 		viewInfo.subresourceRange.aspectMask = aspectFlags;
 
-		VkImageView imageView;
-		if (vkCreateImageView(InstanceManager::Get()->GetLogicalDevice(), &viewInfo, nullptr, &imageView) != VK_SUCCESS)
-			VKAPP_LOG_ERROR("Failed to create texture image view!");
-
-		return imageView;
+		return DeviceObjectCache::Get()->AcquireImageView(viewInfo);
 	}
 
 	VkSampler BufferManager::CreateSampler(uint32_t mipLevels)
@@ -218,11 +312,19 @@ namespace VkApp
 		samplerInfo.maxLod = static_cast<float>(mipLevels);
 		samplerInfo.mipLodBias = 0.0f; // Optional
 
-		VkSampler sampler;
-		if (vkCreateSampler(InstanceManager::Get()->GetLogicalDevice(), &samplerInfo, nullptr, &sampler) != VK_SUCCESS)
-			VKAPP_LOG_ERROR("Failed to create texture sampler!");
+		return DeviceObjectCache::Get()->AcquireSampler(samplerInfo);
+	}
+
+	void BufferManager::DestroyImageView(VkImageView& imageView)
+	{
+		DeviceObjectCache::Get()->Release(imageView);
+		imageView = VK_NULL_HANDLE;
+	}
 
-		return sampler;
+	void BufferManager::DestroySampler(VkSampler& sampler)
+	{
+		DeviceObjectCache::Get()->Release(sampler);
+		sampler = VK_NULL_HANDLE;
 	}
 
 	void BufferManager::CreateImage(uint32_t width, uint32_t height, uint32_t mipLevels, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory)
@@ -250,6 +352,10 @@ namespace VkApp
 		VkMemoryRequirements memRequirements = {};
 		vkGetImageMemoryRequirements(logicalDevice, image, &memRequirements);
 
+		// Note: Lazily allocated memory mostly exists on tiled GPUs, elsewhere transient attachments just get normal memory.
+		if ((properties & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) && !HasMemoryType(memRequirements.memoryTypeBits, properties))
+			properties &= ~VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+
 		VkMemoryAllocateInfo allocInfo = {};
 		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
 		allocInfo.allocationSize = memRequirements.size;
@@ -257,10 +363,26 @@ namespace VkApp
 
 		if (vkAllocateMemory(logicalDevice, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS)
 			VKAPP_LOG_ERROR("Failed to allocate image memory!");
+		else if (ResidencyManager::Get())
+			ResidencyManager::Get()->TrackAllocation(imageMemory, allocInfo.allocationSize, allocInfo.memoryTypeIndex);
 
 		vkBindImageMemory(logicalDevice, image, imageMemory, 0);
 	}
 
+	void BufferManager::DestroyImage(VkImage& image, VkDeviceMemory& imageMemory)
+	{
+		auto logicalDevice = InstanceManager::Get()->GetLogicalDevice();
+
+		if (ResidencyManager::Get())
+			ResidencyManager::Get()->UntrackAllocation(imageMemory);
+
+		vkDestroyImage(logicalDevice, image, nullptr);
+		vkFreeMemory(logicalDevice, imageMemory, nullptr);
+
+		image = VK_NULL_HANDLE;
+		imageMemory = VK_NULL_HANDLE;
+	}
+
 	void BufferManager::TransitionImageToLayout(VkImage& image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels)
 	{
 		VkCommandBuffer commandBuffer = BeginSingleTimeCommands();
@@ -349,6 +471,14 @@ namespace VkApp
 	}
 
 	void BufferManager::GenerateMipmaps(VkImage& image, VkFormat imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels)
+	{
+		if (MipGenerator::Get() && MipGenerator::Get()->Generate(image, imageFormat, static_cast<uint32_t>(texWidth), static_cast<uint32_t>(texHeight), mipLevels))
+			return;
+
+		BlitMipmaps(image, imageFormat, texWidth, texHeight, mipLevels);
+	}
+
+	void BufferManager::BlitMipmaps(VkImage& image, VkFormat imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels)
 	{
 		// Check if image format supports linear blitting
 		VkFormatProperties formatProperties;
@@ -457,19 +587,69 @@ namespace VkApp
 		return commandBuffer;
 	}
 
-	void BufferManager::EndSingleTimeCommands(VkCommandBuffer commandBuffer)
+	uint64_t BufferManager::EndSingleTimeCommands(VkCommandBuffer commandBuffer)
 	{
 		vkEndCommandBuffer(commandBuffer);
 
-		VkSubmitInfo submitInfo = {};
-		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-		submitInfo.commandBufferCount = 1;
-		submitInfo.pCommandBuffers = &commandBuffer;
+		// Note: Same queue as the frames, so the frames submitted after this see everything it did.
+		uint64_t value = InstanceManager::Get()->GetGraphicsTimeline().Submit({ commandBuffer });
+
+		RetiredUpload retired = {};
+		retired.Value = value;
+		retired.CommandBuffer = commandBuffer;
 
-		vkQueueSubmit(InstanceManager::Get()->GetGraphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE);
-		vkQueueWaitIdle(InstanceManager::Get()->GetGraphicsQueue());
+		std::scoped_lock<std::mutex> lock(s_RetiredMutex);
+		s_RetiredUploads.push_back(retired);
+
+		return value;
+	}
+
+	void BufferManager::EndSingleTimeCommandsAndWait(VkCommandBuffer commandBuffer)
+	{
+		vkEndCommandBuffer(commandBuffer);
+
+		QueueTimeline& timeline = InstanceManager::Get()->GetGraphicsTimeline();
+		timeline.Wait(timeline.Submit({ commandBuffer }));
 
 		vkFreeCommandBuffers(InstanceManager::Get()->GetLogicalDevice(), Renderer::Get()->GetCommandPool(), 1, &commandBuffer);
 	}
 
-}
+	void BufferManager::RetireBuffer(VkBuffer& buffer, VkDeviceMemory& memory)
+	{
+		RetiredUpload retired = {};
+		retired.Value = InstanceManager::Get()->GetGraphicsTimeline().GetLastSubmitted();
+		retired.Buffer = buffer;
+		retired.Memory = memory;
+
+		{
+			std::scoped_lock<std::mutex> lock(s_RetiredMutex);
+			s_RetiredUploads.push_back(retired);
+		}
+
+		buffer = VK_NULL_HANDLE;
+		memory = VK_NULL_HANDLE;
+	}
+
+	void BufferManager::DestroyRetired(bool force)
+	{
+		QueueTimeline& timeline = InstanceManager::Get()->GetGraphicsTimeline();
+
+		std::scoped_lock<std::mutex> lock(s_RetiredMutex);
+		for (auto it = s_RetiredUploads.begin(); it != s_RetiredUploads.end();)
+		{
+			if (!force && !timeline.IsComplete(it->Value))
+			{
+				++it;
+				continue;
+			}
+
+			if (it->CommandBuffer != VK_NULL_HANDLE)
+				vkFreeCommandBuffers(InstanceManager::Get()->GetLogicalDevice(), Renderer::Get()->GetCommandPool(), 1, &it->CommandBuffer);
+			if (it->Buffer != VK_NULL_HANDLE)
+				DestroyBuffer(it->Buffer, it->Memory);
+
+			it = s_RetiredUploads.erase(it);
+		}
+	}
+
+}
\ No newline at end of file
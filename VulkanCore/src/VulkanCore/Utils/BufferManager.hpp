@@ -13,8 +13,10 @@ namespace VkApp
 	public:
 		static void CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& dstBuffer, VkDeviceMemory& dstBufferMemory);
 		static void CopyBuffer(VkBuffer& srcBuffer, VkBuffer& dstBuffer, VkDeviceSize& size);
+		static void DestroyBuffer(VkBuffer& buffer, VkDeviceMemory& memory);
 
 		static uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
+		static bool HasMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
 
 		static void CreateVertexBuffer(VkBuffer& dstBuffer, VkDeviceMemory& dstMemory, void* vertices, VkDeviceSize size = { 0u });
 		static void CreateIndexBuffer(VkBuffer& dstBuffer, VkDeviceMemory& dstMemory, void* indices, VkDeviceSize size = { 0u });
@@ -23,21 +25,38 @@ namespace VkApp
 		static void SetUniformData(void* mappedBuffer, void* data, uint32_t size);
 
 		static void CreateTexture(const std::filesystem::path& path, VkImage& dstImage, VkDeviceMemory& dstImageMemory, uint32_t& mipLevels);
+		static void CreateTexture(const void* pixels, uint32_t width, uint32_t height, VkImage& dstImage, VkDeviceMemory& dstImageMemory, uint32_t& mipLevels); // Expects RGBA8 pixels
+		static void CreateTexture(const void* data, VkDeviceSize size, VkFormat format, uint32_t width, uint32_t height, const std::vector<VkBufferImageCopy>& mipRegions, VkImage& dstImage, VkDeviceMemory& dstImageMemory); // Uploads a prebuilt mip chain, one region per level
 		static VkImageView CreateImageView(VkImage& image, VkFormat format, VkImageAspectFlags aspectFlags, uint32_t mipLevels);
 		static VkSampler CreateSampler(uint32_t mipLevels); // TODO(Jorben): Make it usable with multiple formats and stuff.
 
+		// Views and samplers come from the DeviceObjectCache, so they have to be released through these.
+		static void DestroyImageView(VkImageView& imageView);
+		static void DestroySampler(VkSampler& sampler);
+
 	public:
 		static void CreateImage(uint32_t width, uint32_t height, uint32_t mipLevels, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory);
+		static void DestroyImage(VkImage& image, VkDeviceMemory& imageMemory);
 		static void TransitionImageToLayout(VkImage& image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels);
 		static void CopyBufferToImage(VkBuffer& buffer, VkImage& image, uint32_t width, uint32_t height);
 
 		static inline bool HasStencilComponent(VkFormat format) { return format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT; }
 
+		// Uses the compute MipGenerator when possible, blits otherwise. Pass an sRGB format to filter in linear space.
 		static void GenerateMipmaps(VkImage& image, VkFormat imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels);
+		static void BlitMipmaps(VkImage& image, VkFormat imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels);
 
 	public:
 		static VkCommandBuffer BeginSingleTimeCommands();
-		static void EndSingleTimeCommands(VkCommandBuffer commandBuffer);
+		// Submits without waiting and returns the graphics timeline value, the command buffer is freed once it passes.
+		static uint64_t EndSingleTimeCommands(VkCommandBuffer commandBuffer);
+		// Only for callers that read back or reuse what the commands touched right away.
+		// Note: Timeline values only go up, so this also waits for everything submitted before, frames in flight included.
+		static void EndSingleTimeCommandsAndWait(VkCommandBuffer commandBuffer);
+
+		// Destroys the buffer once everything submitted so far is done, for staging buffers of single time commands.
+		static void RetireBuffer(VkBuffer& buffer, VkDeviceMemory& memory);
+		static void DestroyRetired(bool force); // Called by the Renderer every frame
 	};
 
 }
\ No newline at end of file
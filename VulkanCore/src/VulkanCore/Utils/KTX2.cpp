@@ -0,0 +1,288 @@
+#include "vcpch.h"
+#include "KTX2.hpp"
+
+#include <cstring>
+
+#include "VulkanCore/Core/Logging.hpp"
+
+namespace VkApp
+{
+
+	static_assert(sizeof(KTX2Header) == 80, "KTX2Header must match the on-disk layout.");
+	static_assert(sizeof(KTX2Level) == 24, "KTX2Level must match the on-disk layout.");
+
+	static const uint8_t s_KTX2Identifier[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+
+	// ===================================
+	// ------------- Helper --------------
+	// ===================================
+	static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	// Builds the basic data format descriptor, which KTX2 requires even though we rely on VkFormat when loading.
+	static std::vector<uint32_t> CreateDFD(VkFormat format)
+	{
+		// Khronos data format constants
+		const uint32_t modelRGBSDA = 1, modelBC1A = 128, modelBC5 = 132, modelBC7 = 134;
+		const uint32_t primariesBT709 = 1, transferLinear = 1;
+
+		struct Sample
+		{
+		public:
+			uint32_t BitOffset = 0;
+			uint32_t BitLength = 0;
+			uint32_t Channel = 0;
+			uint32_t Upper = 0;
+		};
+
+		uint32_t model = 0;
+		uint32_t blockDimension = 0; // Each dimension minus 1, packed per byte
+		uint32_t bytesPlane0 = 0;
+		std::vector<Sample> samples = { };
+
+		switch (format)
+		{
+		case VK_FORMAT_R8G8B8A8_UNORM:
+			model = modelRGBSDA;
+			bytesPlane0 = 4;
+			samples = { { 0, 7, 0, 255 }, { 8, 7, 1, 255 }, { 16, 7, 2, 255 }, { 24, 7, 15, 255 } };
+			break;
+		case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+			model = modelBC1A;
+			blockDimension = 3 | (3 << 8);
+			bytesPlane0 = 8;
+			samples = { { 0, 63, 0, UINT32_MAX } };
+			break;
+		case VK_FORMAT_BC5_UNORM_BLOCK:
+			model = modelBC5;
+			blockDimension = 3 | (3 << 8);
+			bytesPlane0 = 16;
+			samples = { { 0, 63, 0, UINT32_MAX }, { 64, 63, 1, UINT32_MAX } };
+			break;
+		case VK_FORMAT_BC7_UNORM_BLOCK:
+			model = modelBC7;
+			blockDimension = 3 | (3 << 8);
+			bytesPlane0 = 16;
+			samples = { { 0, 127, 0, UINT32_MAX } };
+			break;
+
+		default:
+			return { };
+		}
+
+		uint32_t blockSize = 24 + 16 * static_cast<uint32_t>(samples.size());
+
+		std::vector<uint32_t> dfd = { };
+		dfd.push_back(4 + blockSize);									// dfdTotalSize
+		dfd.push_back(0);												// vendorId | descriptorType
+		dfd.push_back(2 | (blockSize << 16));							// versionNumber | descriptorBlockSize
+		dfd.push_back(model | (primariesBT709 << 8) | (transferLinear << 16));
+		dfd.push_back(blockDimension);
+		dfd.push_back(bytesPlane0);										// bytesPlane0..3
+		dfd.push_back(0);												// bytesPlane4..7
+
+		for (const Sample& sample : samples)
+		{
+			dfd.push_back(sample.BitOffset | (sample.BitLength << 16) | (sample.Channel << 24));
+			dfd.push_back(0);											// samplePosition
+			dfd.push_back(0);											// sampleLower
+			dfd.push_back(sample.Upper);								// sampleUpper
+		}
+
+		return dfd;
+	}
+
+	// ===================================
+	// ------------ Static ---------------
+	// ===================================
+	bool KTX2::Write(const std::filesystem::path& path, VkFormat format, uint32_t width, uint32_t height, const std::vector<std::vector<uint8_t>>& levels, const std::map<std::string, std::vector<uint8_t>>& keyValues)
+	{
+		std::vector<uint32_t> dfd = CreateDFD(format);
+		if (dfd.empty())
+		{
+			VKAPP_LOG_ERROR("KTX2: Format {0} is not supported for writing.", (uint32_t)format);
+			return false;
+		}
+
+		// Key/value data, the map keeps the keys sorted like the spec requires
+		std::vector<uint8_t> kvd = { };
+		for (const auto& [key, value] : keyValues)
+		{
+			uint32_t length = static_cast<uint32_t>(key.size() + 1 + value.size());
+
+			kvd.insert(kvd.end(), reinterpret_cast<const uint8_t*>(&length), reinterpret_cast<const uint8_t*>(&length) + sizeof(uint32_t));
+			kvd.insert(kvd.end(), key.begin(), key.end());
+			kvd.push_back(0);
+			kvd.insert(kvd.end(), value.begin(), value.end());
+			kvd.resize(AlignUp(kvd.size(), 4), 0);
+		}
+
+		KTX2Header header = {};
+		memcpy(header.Identifier, s_KTX2Identifier, sizeof(s_KTX2Identifier));
+		header.Format = static_cast<uint32_t>(format);
+		header.TypeSize = 1;
+		header.PixelWidth = width;
+		header.PixelHeight = height;
+		header.FaceCount = 1;
+		header.LevelCount = static_cast<uint32_t>(levels.size());
+
+		header.DFDByteOffset = static_cast<uint32_t>(sizeof(KTX2Header) + sizeof(KTX2Level) * levels.size());
+		header.DFDByteLength = static_cast<uint32_t>(dfd.size() * sizeof(uint32_t));
+		header.KVDByteOffset = kvd.empty() ? 0 : header.DFDByteOffset + header.DFDByteLength;
+		header.KVDByteLength = static_cast<uint32_t>(kvd.size());
+
+		// Note: Levels are stored smallest first so a streaming reader gets a usable image as early as possible.
+		uint64_t alignment = std::lcm<uint64_t>(GetFormatBlockSize(format), 4);
+		uint64_t offset = header.DFDByteOffset + header.DFDByteLength + header.KVDByteLength;
+
+		std::vector<KTX2Level> index(levels.size());
+		for (size_t i = levels.size(); i-- > 0;)
+		{
+			offset = AlignUp(offset, alignment);
+
+			index[i].ByteOffset = offset;
+			index[i].ByteLength = levels[i].size();
+			index[i].UncompressedByteLength = levels[i].size();
+
+			offset += levels[i].size();
+		}
+
+		std::filesystem::path tempPath = path;
+		tempPath += ".tmp";
+
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+			{
+				VKAPP_LOG_WARN("KTX2: Failed to open \"{0}\" for writing.", tempPath.string());
+				return false;
+			}
+
+			file.write(reinterpret_cast<const char*>(&header), sizeof(KTX2Header));
+			file.write(reinterpret_cast<const char*>(index.data()), sizeof(KTX2Level) * index.size());
+			file.write(reinterpret_cast<const char*>(dfd.data()), header.DFDByteLength);
+			file.write(reinterpret_cast<const char*>(kvd.data()), kvd.size());
+
+			for (size_t i = levels.size(); i-- > 0;)
+			{
+				static const char zeroes[16] = { };
+				uint64_t position = static_cast<uint64_t>(file.tellp());
+				file.write(zeroes, static_cast<std::streamsize>(index[i].ByteOffset - position));
+				file.write(reinterpret_cast<const char*>(levels[i].data()), levels[i].size());
+			}
+
+			if (!file.good())
+			{
+				VKAPP_LOG_WARN("KTX2: Failed to write \"{0}\".", path.string());
+				return false;
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(tempPath, path, error);
+		if (error)
+		{
+			VKAPP_LOG_WARN("KTX2: Failed to move \"{0}\" into place: {1}", path.string(), error.message());
+			std::filesystem::remove(tempPath, error);
+			return false;
+		}
+
+		return true;
+	}
+
+	bool KTX2::Parse(const uint8_t* data, size_t size, KTX2Image& image)
+	{
+		if (size < sizeof(KTX2Header))
+			return false;
+
+		KTX2Header header = {};
+		memcpy(&header, data, sizeof(KTX2Header));
+
+		if (memcmp(header.Identifier, s_KTX2Identifier, sizeof(s_KTX2Identifier)) != 0)
+			return false;
+
+		if (header.SupercompressionScheme != 0 || header.PixelDepth > 1 || header.LayerCount > 1 || header.FaceCount != 1)
+		{
+			VKAPP_LOG_WARN("KTX2: Only uncompressed, single 2D images are supported.");
+			return false;
+		}
+
+		uint32_t levelCount = std::max(header.LevelCount, 1u);
+		if (sizeof(KTX2Header) + sizeof(KTX2Level) * levelCount > size)
+			return false;
+
+		image.Format = static_cast<VkFormat>(header.Format);
+		image.Width = header.PixelWidth;
+		image.Height = header.PixelHeight;
+
+		image.Levels.resize(levelCount);
+		memcpy(image.Levels.data(), data + sizeof(KTX2Header), sizeof(KTX2Level) * levelCount);
+
+		for (const auto& level : image.Levels)
+		{
+			if (level.ByteOffset + level.ByteLength > size)
+				return false;
+		}
+
+		// Key/value data
+		image.KeyValues.clear();
+		if ((uint64_t)header.KVDByteOffset + header.KVDByteLength > size)
+			return false;
+
+		const uint8_t* kvd = data + header.KVDByteOffset;
+		uint32_t position = 0;
+		while (position + sizeof(uint32_t) <= header.KVDByteLength)
+		{
+			uint32_t length = 0;
+			memcpy(&length, kvd + position, sizeof(uint32_t));
+			position += sizeof(uint32_t);
+
+			if (position + length > header.KVDByteLength)
+				break;
+
+			const char* entry = reinterpret_cast<const char*>(kvd + position);
+			size_t keyLength = strnlen(entry, length);
+			if (keyLength < length)
+				image.KeyValues[std::string(entry, keyLength)] = std::vector<uint8_t>(kvd + position + keyLength + 1, kvd + position + length);
+
+			position = static_cast<uint32_t>(AlignUp(position + length, 4));
+		}
+
+		return true;
+	}
+
+	uint32_t KTX2::GetFormatBlockSize(VkFormat format)
+	{
+		switch (format)
+		{
+		case VK_FORMAT_R8G8B8A8_UNORM:
+		case VK_FORMAT_R8G8B8A8_SRGB:
+			return 4;
+
+		case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+		case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+		case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+		case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+		case VK_FORMAT_BC4_UNORM_BLOCK:
+			return 8;
+
+		case VK_FORMAT_BC5_UNORM_BLOCK:
+		case VK_FORMAT_BC7_UNORM_BLOCK:
+		case VK_FORMAT_BC7_SRGB_BLOCK:
+			return 16;
+
+		default:
+			break;
+		}
+
+		return 0;
+	}
+
+	bool KTX2::IsBlockCompressed(VkFormat format)
+	{
+		return format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && format <= VK_FORMAT_BC7_SRGB_BLOCK;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+
+#include <vulkan/vulkan.h>
+
+namespace VkApp
+{
+
+	// Header of a KTX 2.0 file, see https://registry.khronos.org/KTX/specs/2.0/ktxspec.v2.html
+	struct KTX2Header
+	{
+	public:
+		uint8_t Identifier[12] = { };
+		uint32_t Format = 0;
+		uint32_t TypeSize = 0;
+		uint32_t PixelWidth = 0;
+		uint32_t PixelHeight = 0;
+		uint32_t PixelDepth = 0;
+		uint32_t LayerCount = 0;
+		uint32_t FaceCount = 0;
+		uint32_t LevelCount = 0;
+		uint32_t SupercompressionScheme = 0;
+
+		uint32_t DFDByteOffset = 0;
+		uint32_t DFDByteLength = 0;
+		uint32_t KVDByteOffset = 0;
+		uint32_t KVDByteLength = 0;
+		uint64_t SGDByteOffset = 0;
+		uint64_t SGDByteLength = 0;
+	};
+
+	struct KTX2Level
+	{
+	public:
+		uint64_t ByteOffset = 0;
+		uint64_t ByteLength = 0;
+		uint64_t UncompressedByteLength = 0;
+	};
+
+	// A parsed KTX2 file, the level offsets point into the memory that was parsed.
+	struct KTX2Image
+	{
+	public:
+		VkFormat Format = VK_FORMAT_UNDEFINED;
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+
+		std::vector<KTX2Level> Levels = { }; // Level 0 is the full resolution
+		std::map<std::string, std::vector<uint8_t>> KeyValues = { };
+	};
+
+	// Minimal KTX2 support: single 2D images, no supercompression, only the formats this engine writes.
+	class KTX2
+	{
+	public:
+		static bool Write(const std::filesystem::path& path, VkFormat format, uint32_t width, uint32_t height, const std::vector<std::vector<uint8_t>>& levels, const std::map<std::string, std::vector<uint8_t>>& keyValues = { });
+		static bool Parse(const uint8_t* data, size_t size, KTX2Image& image);
+
+		// Number of bytes per 4x4 block for block compressed formats, per texel otherwise.
+		static uint32_t GetFormatBlockSize(VkFormat format);
+		static bool IsBlockCompressed(VkFormat format);
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,139 @@
+#include "vcpch.h"
+#include "MappedFile.hpp"
+
+#include "VulkanCore/Core/Logging.hpp"
+
+#ifdef VKAPP_PLATFORM_WINDOWS
+	#include <Windows.h>
+#else
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
+namespace VkApp
+{
+
+	MappedFile::MappedFile(const std::filesystem::path& path)
+	{
+		#ifdef VKAPP_PLATFORM_WINDOWS
+		HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return;
+
+		LARGE_INTEGER size = {};
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return;
+		}
+
+		HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping)
+		{
+			CloseHandle(file);
+			return;
+		}
+
+		void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (!data)
+		{
+			CloseHandle(mapping);
+			CloseHandle(file);
+			return;
+		}
+
+		m_FileHandle = file;
+		m_MappingHandle = mapping;
+		m_Data = static_cast<const uint8_t*>(data);
+		m_Size = static_cast<size_t>(size.QuadPart);
+		#else
+		int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+			return;
+
+		struct stat info = {};
+		if (fstat(fd, &info) != 0 || info.st_size == 0)
+		{
+			close(fd);
+			return;
+		}
+
+		void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data == MAP_FAILED)
+		{
+			close(fd);
+			return;
+		}
+
+		// Note: The whole file gets copied front to back into a staging buffer, so let the kernel read ahead.
+		madvise(data, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+
+		m_FileDescriptor = fd;
+		m_Data = static_cast<const uint8_t*>(data);
+		m_Size = static_cast<size_t>(info.st_size);
+		#endif
+	}
+
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if (this == &other)
+			return *this;
+
+		Close();
+
+		m_Data = other.m_Data;
+		m_Size = other.m_Size;
+		other.m_Data = nullptr;
+		other.m_Size = 0;
+
+		#ifdef VKAPP_PLATFORM_WINDOWS
+		m_FileHandle = other.m_FileHandle;
+		m_MappingHandle = other.m_MappingHandle;
+		other.m_FileHandle = nullptr;
+		other.m_MappingHandle = nullptr;
+		#else
+		m_FileDescriptor = other.m_FileDescriptor;
+		other.m_FileDescriptor = -1;
+		#endif
+
+		return *this;
+	}
+
+	void MappedFile::Close()
+	{
+		#ifdef VKAPP_PLATFORM_WINDOWS
+		if (m_Data)
+			UnmapViewOfFile(m_Data);
+		if (m_MappingHandle)
+			CloseHandle(m_MappingHandle);
+		if (m_FileHandle)
+			CloseHandle(m_FileHandle);
+
+		m_FileHandle = nullptr;
+		m_MappingHandle = nullptr;
+		#else
+		if (m_Data)
+			munmap(const_cast<uint8_t*>(m_Data), m_Size);
+		if (m_FileDescriptor >= 0)
+			close(m_FileDescriptor);
+
+		m_FileDescriptor = -1;
+		#endif
+
+		m_Data = nullptr;
+		m_Size = 0;
+	}
+
+}
\ No newline at end of file
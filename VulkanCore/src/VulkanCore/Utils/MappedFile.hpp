@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+
+namespace VkApp
+{
+
+	// Read-only memory mapping of a file, the mapping lives as long as the object.
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		MappedFile(const std::filesystem::path& path);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		void Close();
+
+		inline bool IsValid() const { return m_Data != nullptr; }
+
+		inline const uint8_t* GetData() const { return m_Data; }
+		inline size_t GetSize() const { return m_Size; }
+
+	private:
+		const uint8_t* m_Data = nullptr;
+		size_t m_Size = 0;
+
+		#ifdef VKAPP_PLATFORM_WINDOWS
+		void* m_FileHandle = nullptr;
+		void* m_MappingHandle = nullptr;
+		#else
+		int m_FileDescriptor = -1;
+		#endif
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,218 @@
+#include "MicroBench.hpp"
+
+#include <cmath>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+#include <VulkanCore/Renderer/MipGenerator.hpp>
+#include <VulkanCore/Renderer/InstanceManager.hpp>
+#include <VulkanCore/Utils/BufferManager.hpp>
+
+using namespace VkApp;
+
+static std::vector<uint8_t> GeneratePixels(uint32_t size)
+{
+	std::vector<uint8_t> pixels((size_t)size * size * 4);
+	for (size_t i = 0; i < pixels.size(); i++)
+		pixels[i] = (uint8_t)((i * 2654435761u) >> 24);
+
+	return pixels;
+}
+
+static uint32_t GetMipLevels(uint32_t size)
+{
+	return static_cast<uint32_t>(std::floor(std::log2(size))) + 1;
+}
+
+// Single time commands don't wait, so the timings include waiting for the GPU explicitly.
+static void WaitForUploads()
+{
+	QueueTimeline& timeline = InstanceManager::Get()->GetGraphicsTimeline();
+	timeline.Wait(timeline.GetLastSubmitted());
+
+	BufferManager::DestroyRetired(false);
+}
+
+// ===================================
+// ------------- Buffers -------------
+// ===================================
+static void BM_CreateBuffer(MicroBenchState& state)
+{
+	VkDeviceSize size = (VkDeviceSize)state.Range(0);
+
+	for (auto _ : state)
+	{
+		VkBuffer buffer = VK_NULL_HANDLE;
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		BufferManager::CreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, buffer, memory);
+
+		state.PauseTiming();
+		BufferManager::DestroyBuffer(buffer, memory);
+		state.ResumeTiming();
+	}
+}
+VKAPP_MICROBENCH(BM_CreateBuffer)->Range(4 << 10, 64 << 20);
+
+static void BM_CreateVertexBuffer(MicroBenchState& state)
+{
+	VkDeviceSize size = (VkDeviceSize)state.Range(0);
+	std::vector<uint8_t> vertices(size, 0x3F);
+
+	for (auto _ : state)
+	{
+		VkBuffer buffer = VK_NULL_HANDLE;
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		BufferManager::CreateVertexBuffer(buffer, memory, vertices.data(), size);
+		WaitForUploads();
+
+		state.PauseTiming();
+		BufferManager::DestroyBuffer(buffer, memory);
+		state.ResumeTiming();
+	}
+
+	state.SetBytesProcessed((int64_t)(state.Iterations() * size));
+}
+VKAPP_MICROBENCH(BM_CreateVertexBuffer)->Range(4 << 10, 64 << 20);
+
+static void BM_CreateIndexBuffer(MicroBenchState& state)
+{
+	VkDeviceSize size = (VkDeviceSize)state.Range(0);
+	std::vector<uint32_t> indices(size / sizeof(uint32_t));
+	for (size_t i = 0; i < indices.size(); i++)
+		indices[i] = (uint32_t)i;
+
+	for (auto _ : state)
+	{
+		VkBuffer buffer = VK_NULL_HANDLE;
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		BufferManager::CreateIndexBuffer(buffer, memory, indices.data(), size);
+		WaitForUploads();
+
+		state.PauseTiming();
+		BufferManager::DestroyBuffer(buffer, memory);
+		state.ResumeTiming();
+	}
+
+	state.SetBytesProcessed((int64_t)(state.Iterations() * size));
+}
+VKAPP_MICROBENCH(BM_CreateIndexBuffer)->Range(4 << 10, 64 << 20);
+
+// ===================================
+// ------------- Textures ------------
+// ===================================
+// Upload of a single RGBA8 level followed by the mip generation, what a Texture from an uncooked image does.
+static void BM_CreateTexture(MicroBenchState& state)
+{
+	uint32_t size = (uint32_t)state.Range(0);
+	std::vector<uint8_t> pixels = GeneratePixels(size);
+
+	for (auto _ : state)
+	{
+		VkImage image = VK_NULL_HANDLE;
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		uint32_t mipLevels = 0;
+		BufferManager::CreateTexture(pixels.data(), size, size, image, memory, mipLevels);
+		WaitForUploads();
+
+		state.PauseTiming();
+		BufferManager::DestroyImage(image, memory);
+		state.ResumeTiming();
+	}
+
+	state.SetBytesProcessed((int64_t)(state.Iterations() * pixels.size()));
+}
+VKAPP_MICROBENCH(BM_CreateTexture)->RangeMultiplier(4)->Range(64, 4096);
+
+static void CreateStagingBuffer(const std::vector<uint8_t>& pixels, VkBuffer& staging, VkDeviceMemory& stagingMemory)
+{
+	BufferManager::CreateBuffer(pixels.size(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, staging, stagingMemory);
+
+	void* data = nullptr;
+	vkMapMemory(InstanceManager::Get()->GetLogicalDevice(), stagingMemory, 0, pixels.size(), 0, &data);
+	memcpy(data, pixels.data(), pixels.size());
+	vkUnmapMemory(InstanceManager::Get()->GetLogicalDevice(), stagingMemory);
+}
+
+// Creates an image with level 0 filled in and every level in TRANSFER_DST_OPTIMAL, as the mip paths expect it.
+static void CreateMipSource(uint32_t size, VkBuffer& staging, VkDeviceMemory& stagingMemory, VkImage& image, VkDeviceMemory& memory)
+{
+	VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+	if (MipGenerator::Get() && MipGenerator::Get()->IsSupported(VK_FORMAT_R8G8B8A8_SRGB, size, size))
+		usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+
+	uint32_t mipLevels = GetMipLevels(size);
+	BufferManager::CreateImage(size, size, mipLevels, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_TILING_OPTIMAL, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, image, memory);
+	BufferManager::TransitionImageToLayout(image, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevels);
+	BufferManager::CopyBufferToImage(staging, image, size, size);
+	WaitForUploads();
+}
+
+static void BM_GenerateMipmaps(MicroBenchState& state)
+{
+	uint32_t size = (uint32_t)state.Range(0);
+	uint32_t mipLevels = GetMipLevels(size);
+
+	if (!MipGenerator::Get() || !MipGenerator::Get()->IsSupported(VK_FORMAT_R8G8B8A8_SRGB, size, size))
+	{
+		state.SkipWithError("The compute mip generator isn't available, see BM_BlitMipmaps.");
+		return;
+	}
+
+	std::vector<uint8_t> pixels = GeneratePixels(size);
+
+	VkBuffer staging = VK_NULL_HANDLE;
+	VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
+	CreateStagingBuffer(pixels, staging, stagingMemory);
+
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		VkImage image = VK_NULL_HANDLE;
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		CreateMipSource(size, staging, stagingMemory, image, memory);
+		state.ResumeTiming();
+
+		BufferManager::GenerateMipmaps(image, VK_FORMAT_R8G8B8A8_SRGB, (int32_t)size, (int32_t)size, mipLevels);
+		WaitForUploads();
+
+		state.PauseTiming();
+		BufferManager::DestroyImage(image, memory);
+		state.ResumeTiming();
+	}
+
+	BufferManager::DestroyBuffer(staging, stagingMemory);
+	state.SetBytesProcessed((int64_t)(state.Iterations() * pixels.size()));
+}
+VKAPP_MICROBENCH(BM_GenerateMipmaps)->RangeMultiplier(4)->Range(64, 4096);
+
+static void BM_BlitMipmaps(MicroBenchState& state)
+{
+	uint32_t size = (uint32_t)state.Range(0);
+	uint32_t mipLevels = GetMipLevels(size);
+	std::vector<uint8_t> pixels = GeneratePixels(size);
+
+	VkBuffer staging = VK_NULL_HANDLE;
+	VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
+	CreateStagingBuffer(pixels, staging, stagingMemory);
+
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		VkImage image = VK_NULL_HANDLE;
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		CreateMipSource(size, staging, stagingMemory, image, memory);
+		state.ResumeTiming();
+
+		BufferManager::BlitMipmaps(image, VK_FORMAT_R8G8B8A8_UNORM, (int32_t)size, (int32_t)size, mipLevels);
+		WaitForUploads();
+
+		state.PauseTiming();
+		BufferManager::DestroyImage(image, memory);
+		state.ResumeTiming();
+	}
+
+	BufferManager::DestroyBuffer(staging, stagingMemory);
+	state.SetBytesProcessed((int64_t)(state.Iterations() * pixels.size()));
+}
+VKAPP_MICROBENCH(BM_BlitMipmaps)->RangeMultiplier(4)->Range(64, 4096);
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "MicroBench.hpp"
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+
+#include <VulkanCore/Renderer/Mesh.hpp>
+#include <VulkanCore/Renderer/MeshCooker.hpp>
+
+using namespace VkApp;
+
+// Writes a flat grid of size x size quads as an OBJ, so the importer has something of a known size to chew on.
+// Every size is written once per process, cooked next to it.
+static std::filesystem::path GetGridMesh(uint32_t size)
+{
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "VulkanMicroBench";
+	std::filesystem::path path = directory / ("Grid" + std::to_string(size) + ".obj");
+
+	static std::vector<uint32_t> s_Written = { };
+	if (std::find(s_Written.begin(), s_Written.end(), size) != s_Written.end())
+		return path;
+
+	std::filesystem::create_directories(directory);
+
+	std::ofstream file(path);
+	for (uint32_t y = 0; y <= size; y++)
+	{
+		for (uint32_t x = 0; x <= size; x++)
+			file << "v " << x << " 0 " << y << "\n";
+	}
+
+	for (uint32_t y = 0; y <= size; y++)
+	{
+		for (uint32_t x = 0; x <= size; x++)
+			file << "vt " << (float)x / (float)size << " " << (float)y / (float)size << "\n";
+	}
+
+	for (uint32_t y = 0; y < size; y++)
+	{
+		for (uint32_t x = 0; x < size; x++)
+		{
+			// Note: OBJ indices start at 1.
+			uint32_t i = y * (size + 1) + x + 1;
+			uint32_t j = i + size + 1;
+			file << "f " << i << "/" << i << " " << j << "/" << j << " " << (j + 1) << "/" << (j + 1) << " " << (i + 1) << "/" << (i + 1) << "\n";
+		}
+	}
+
+	file.close();
+
+	MeshCooker::Cook(path, MeshCooker::GetCookedPath(path));
+	s_Written.push_back(size);
+
+	return path;
+}
+
+// ===================================
+// ------------- Loading -------------
+// ===================================
+// The slow path, Assimp parsing the source file.
+static void BM_ImportMesh(MicroBenchState& state)
+{
+	std::filesystem::path path = GetGridMesh((uint32_t)state.Range(0));
+
+	size_t vertices = 0;
+	for (auto _ : state)
+	{
+		MeshData data = {};
+		if (!Mesh::ImportModel(path, data))
+		{
+			state.SkipWithError("Failed to import the grid mesh.");
+			break;
+		}
+
+		vertices = data.Vertices.size();
+	}
+
+	state.SetItemsProcessed((int64_t)(state.Iterations() * vertices));
+}
+VKAPP_MICROBENCH(BM_ImportMesh)->ArgNames({ "quads" })->Range(16, 1024);
+
+// The fast path, validating and copying out of the mapped .vkmesh file.
+static void BM_LoadCookedMesh(MicroBenchState& state)
+{
+	std::filesystem::path path = GetGridMesh((uint32_t)state.Range(0));
+	if (!MeshCooker::IsUpToDate(path, MeshCooker::GetCookedPath(path)))
+	{
+		state.SkipWithError("Failed to cook the grid mesh.");
+		return;
+	}
+
+	size_t vertices = 0;
+	for (auto _ : state)
+	{
+		MeshData data = {};
+		Mesh::LoadMeshData(path, data);
+
+		vertices = data.Vertices.size();
+	}
+
+	state.SetItemsProcessed((int64_t)(state.Iterations() * vertices));
+}
+VKAPP_MICROBENCH(BM_LoadCookedMesh)->ArgNames({ "quads" })->Range(16, 1024);
+
+// Everything a Mesh constructor does for a cooked mesh, loading plus the vertex and index upload.
+static void BM_CreateMesh(MicroBenchState& state)
+{
+	std::filesystem::path path = GetGridMesh((uint32_t)state.Range(0));
+
+	for (auto _ : state)
+	{
+		Mesh mesh(path);
+
+		state.PauseTiming();
+		mesh.Destroy();
+		state.ResumeTiming();
+	}
+}
+VKAPP_MICROBENCH(BM_CreateMesh)->ArgNames({ "quads" })->Range(16, 1024);
\ No newline at end of file
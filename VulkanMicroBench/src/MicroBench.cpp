@@ -0,0 +1,391 @@
+#include "MicroBench.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+
+#include <VulkanCore/Core/Logging.hpp>
+
+// ===================================
+// -------------- State --------------
+// ===================================
+MicroBenchState::MicroBenchState(const std::vector<int64_t>& args, uint64_t iterations)
+	: m_Args(args), m_Iterations(iterations)
+{
+}
+
+void MicroBenchState::PauseTiming()
+{
+	if (!m_Running)
+		return;
+
+	m_Elapsed += std::chrono::steady_clock::now() - m_Start;
+	m_Running = false;
+}
+
+void MicroBenchState::ResumeTiming()
+{
+	if (m_Running)
+		return;
+
+	m_Start = std::chrono::steady_clock::now();
+	m_Running = true;
+}
+
+void MicroBenchState::SkipWithError(const std::string& message)
+{
+	m_Error = message;
+}
+
+MicroBenchState::Iterator MicroBenchState::begin()
+{
+	ResumeTiming();
+	return { this, m_Iterations };
+}
+
+MicroBenchState::Iterator MicroBenchState::end()
+{
+	return { this, 0 };
+}
+
+// ===================================
+// ------------ Benchmark ------------
+// ===================================
+MicroBenchmark::MicroBenchmark(const std::string& name, Function function)
+	: m_Name(name), m_Function(function)
+{
+}
+
+MicroBenchmark* MicroBenchmark::Arg(int64_t arg)
+{
+	m_Args.push_back({ arg });
+	return this;
+}
+
+MicroBenchmark* MicroBenchmark::Args(std::initializer_list<int64_t> args)
+{
+	m_Args.push_back(args);
+	return this;
+}
+
+MicroBenchmark* MicroBenchmark::Range(int64_t start, int64_t limit)
+{
+	for (int64_t arg = start; arg < limit; arg *= m_RangeMultiplier)
+		m_Args.push_back({ arg });
+
+	m_Args.push_back({ limit });
+	return this;
+}
+
+MicroBenchmark* MicroBenchmark::RangeMultiplier(int64_t multiplier)
+{
+	m_RangeMultiplier = std::max<int64_t>(multiplier, 2);
+	return this;
+}
+
+MicroBenchmark* MicroBenchmark::ArgNames(std::initializer_list<std::string> names)
+{
+	m_ArgNames = names;
+	return this;
+}
+
+MicroBenchmark* MicroBenchmark::Iterations(uint64_t iterations)
+{
+	m_Iterations = iterations;
+	return this;
+}
+
+std::string MicroBenchmark::GetRunName(size_t argsIndex) const
+{
+	std::string name = m_Name;
+	if (argsIndex >= m_Args.size())
+		return name;
+
+	for (size_t i = 0; i < m_Args[argsIndex].size(); i++)
+	{
+		name += "/";
+		if (i < m_ArgNames.size() && !m_ArgNames[i].empty())
+			name += m_ArgNames[i] + ":";
+
+		name += std::to_string(m_Args[argsIndex][i]);
+	}
+
+	return name;
+}
+
+// ===================================
+// ------------ Settings -------------
+// ===================================
+bool MicroBenchSettings::Parse(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		std::string value = { };
+
+		size_t equals = arg.find('=');
+		if (equals != std::string::npos)
+		{
+			value = arg.substr(equals + 1);
+			arg = arg.substr(0, equals);
+		}
+
+		if (arg == "--benchmark_list_tests")
+		{
+			List = value.empty() || value == "true";
+			continue;
+		}
+
+		if (equals == std::string::npos && i + 1 < argc)
+			value = argv[++i];
+
+		if (arg == "--benchmark_filter")
+			Filter = value;
+		else if (arg == "--benchmark_min_time")
+			MinTime = std::atof(value.c_str()); // Google Benchmark's "0.5s" form parses the same
+		else if (arg == "--benchmark_repetitions")
+			Repetitions = std::max(std::atoi(value.c_str()), 1);
+		else if (arg == "--benchmark_out")
+			Output = value;
+		else
+		{
+			VKAPP_LOG_ERROR("Unknown argument '{0}'.", arg);
+			return false;
+		}
+	}
+
+	if (MinTime <= 0.0)
+	{
+		VKAPP_LOG_ERROR("--benchmark_min_time has to be above 0.");
+		return false;
+	}
+
+	return true;
+}
+
+// ===================================
+// ------------- Runner --------------
+// ===================================
+MicroBenchmark* MicroBenchRunner::Register(const std::string& name, MicroBenchmark::Function function)
+{
+	GetBenchmarks().push_back(new MicroBenchmark(name, function));
+	return GetBenchmarks().back();
+}
+
+uint32_t MicroBenchRunner::RunAll(const MicroBenchSettings& settings)
+{
+	std::vector<MicroBenchResult> results = { };
+	uint32_t failed = 0;
+
+	if (!settings.List)
+		PrintHeader();
+
+	for (MicroBenchmark* benchmark : GetBenchmarks())
+	{
+		size_t runs = std::max<size_t>(benchmark->GetArgs().size(), 1);
+		for (size_t i = 0; i < runs; i++)
+		{
+			std::string name = benchmark->GetRunName(i);
+			if (!settings.Filter.empty() && name.find(settings.Filter) == std::string::npos)
+				continue;
+
+			if (settings.List)
+			{
+				std::printf("%s\n", name.c_str());
+				continue;
+			}
+
+			std::vector<MicroBenchResult> repetitions = { };
+			for (uint32_t repetition = 0; repetition < settings.Repetitions; repetition++)
+			{
+				MicroBenchResult result = Run(*benchmark, i, settings);
+				PrintResult(result);
+
+				repetitions.push_back(result);
+				results.push_back(result);
+
+				if (!result.Error.empty())
+					break;
+			}
+
+			if (!repetitions.back().Error.empty())
+			{
+				failed++;
+				continue;
+			}
+
+			if (repetitions.size() < 2)
+				continue;
+
+			std::vector<double> times = { };
+			for (auto& result : repetitions)
+				times.push_back(result.TimeNs);
+
+			std::sort(times.begin(), times.end());
+
+			double mean = 0.0;
+			for (double time : times)
+				mean += time / (double)times.size();
+
+			double variance = 0.0;
+			for (double time : times)
+				variance += (time - mean) * (time - mean) / (double)(times.size() - 1);
+
+			size_t middle = times.size() / 2;
+			double median = (times.size() % 2) ? times[middle] : (times[middle - 1] + times[middle]) / 2.0;
+
+			std::vector<std::pair<std::string, double>> aggregates = { { "mean", mean }, { "median", median }, { "stddev", std::sqrt(variance) } };
+			for (auto& [aggregate, time] : aggregates)
+			{
+				// Note: Like Google Benchmark, the iteration count of an aggregate is the amount of repetitions.
+				MicroBenchResult result = repetitions.back();
+				result.Name = name + "_" + aggregate;
+				result.Aggregate = aggregate;
+				result.Iterations = repetitions.size();
+
+				// Throughput scales inversely with the time, it means nothing for the deviation.
+				double scale = (aggregate != "stddev" && time > 0.0) ? result.TimeNs / time : 0.0;
+				result.BytesPerSecond *= scale;
+				result.ItemsPerSecond *= scale;
+				result.TimeNs = time;
+
+				PrintResult(result);
+				results.push_back(result);
+			}
+		}
+	}
+
+	if (!settings.List && !settings.Output.empty())
+		WriteJSON(settings.Output, results);
+
+	return failed;
+}
+
+MicroBenchResult MicroBenchRunner::Run(MicroBenchmark& benchmark, size_t argsIndex, const MicroBenchSettings& settings)
+{
+	std::vector<int64_t> args = argsIndex < benchmark.m_Args.size() ? benchmark.m_Args[argsIndex] : std::vector<int64_t>();
+
+	MicroBenchResult result = {};
+	result.Name = benchmark.GetRunName(argsIndex);
+
+	// Note: Same approach as Google Benchmark, grow the iteration count until the run is long enough.
+	// The first run doubles as the warmup, it's never the one that gets reported unless it already took long enough.
+	uint64_t iterations = benchmark.m_Iterations ? benchmark.m_Iterations : 1;
+	while (true)
+	{
+		MicroBenchState state(args, iterations);
+		RunOnce(benchmark, state);
+
+		double seconds = std::chrono::duration<double>(state.m_Elapsed).count();
+
+		if (state.HasError())
+		{
+			result.Error = state.m_Error;
+			return result;
+		}
+
+		if (benchmark.m_Iterations || seconds >= settings.MinTime || iterations >= 1000000000ull)
+		{
+			result.Iterations = iterations;
+			result.TimeNs = seconds * 1e9 / (double)iterations;
+			result.BytesPerSecond = seconds > 0.0 ? (double)state.m_BytesProcessed / seconds : 0.0;
+			result.ItemsPerSecond = seconds > 0.0 ? (double)state.m_ItemsProcessed / seconds : 0.0;
+			result.Label = state.m_Label;
+			return result;
+		}
+
+		// Aim for 40% over the minimum, but never grow more than 10x at once.
+		double multiplier = seconds > 0.0 ? settings.MinTime * 1.4 / seconds : 10.0;
+		iterations = std::max(iterations + 1, (uint64_t)((double)iterations * std::clamp(multiplier, 1.0, 10.0)));
+	}
+}
+
+void MicroBenchRunner::RunOnce(MicroBenchmark& benchmark, MicroBenchState& state)
+{
+	benchmark.m_Function(state);
+	state.PauseTiming();
+}
+
+void MicroBenchRunner::PrintHeader()
+{
+	std::printf("%-56s %16s %12s %20s\n", "Benchmark", "Time", "Iterations", "Throughput");
+	std::printf("%s\n", std::string(107, '-').c_str());
+}
+
+void MicroBenchRunner::PrintResult(const MicroBenchResult& result)
+{
+	if (!result.Error.empty())
+	{
+		std::printf("%-56s ERROR: %s\n", result.Name.c_str(), result.Error.c_str());
+		return;
+	}
+
+	char time[32] = {};
+	if (result.TimeNs >= 1e6)
+		std::snprintf(time, sizeof(time), "%.3f ms", result.TimeNs / 1e6);
+	else if (result.TimeNs >= 1e3)
+		std::snprintf(time, sizeof(time), "%.3f us", result.TimeNs / 1e3);
+	else
+		std::snprintf(time, sizeof(time), "%.1f ns", result.TimeNs);
+
+	char throughput[32] = {};
+	if (result.BytesPerSecond > 0.0)
+		std::snprintf(throughput, sizeof(throughput), "%.2f MiB/s", result.BytesPerSecond / (1024.0 * 1024.0));
+	else if (result.ItemsPerSecond > 0.0)
+		std::snprintf(throughput, sizeof(throughput), "%.2f k items/s", result.ItemsPerSecond / 1000.0);
+
+	std::printf("%-56s %16s %12llu %20s %s\n", result.Name.c_str(), time, (unsigned long long)result.Iterations, throughput, result.Label.c_str());
+	std::fflush(stdout);
+}
+
+bool MicroBenchRunner::WriteJSON(const std::filesystem::path& path, const std::vector<MicroBenchResult>& results)
+{
+	std::ofstream file(path);
+	if (!file.is_open())
+	{
+		VKAPP_LOG_ERROR("Failed to open '{0}' to write the benchmark results.", path.string());
+		return false;
+	}
+
+	// Note: Uses Google Benchmark's field names, so its compare.py can diff two runs.
+	file << std::fixed << std::setprecision(3);
+	file << "{\n\t\"benchmarks\": [\n";
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const MicroBenchResult& result = results[i];
+
+		file << "\t\t{ \"name\": \"" << result.Name << "\", \"run_type\": \"" << (result.Aggregate.empty() ? "iteration" : "aggregate") << "\"";
+		if (!result.Aggregate.empty())
+			file << ", \"aggregate_name\": \"" << result.Aggregate << "\"";
+
+		if (!result.Error.empty())
+			file << ", \"error_occurred\": true, \"error_message\": \"" << result.Error << "\"";
+		else
+		{
+			file << ", \"iterations\": " << result.Iterations << ", \"real_time\": " << result.TimeNs << ", \"cpu_time\": " << result.TimeNs << ", \"time_unit\": \"ns\"";
+			if (result.BytesPerSecond > 0.0)
+				file << ", \"bytes_per_second\": " << result.BytesPerSecond;
+			if (result.ItemsPerSecond > 0.0)
+				file << ", \"items_per_second\": " << result.ItemsPerSecond;
+			if (!result.Label.empty())
+				file << ", \"label\": \"" << result.Label << "\"";
+		}
+
+		file << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+	}
+
+	file << "\t]\n}\n";
+
+	VKAPP_LOG_INFO("Wrote {0} benchmark results to '{1}'.", results.size(), path.string());
+	return true;
+}
+
+std::vector<MicroBenchmark*>& MicroBenchRunner::GetBenchmarks()
+{
+	// Note: A function local static, registration happens during static initialization of other files.
+	static std::vector<MicroBenchmark*> benchmarks = { };
+	return benchmarks;
+}
\ No newline at end of file
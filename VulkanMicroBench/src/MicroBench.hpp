@@ -0,0 +1,164 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include <filesystem>
+#include <initializer_list>
+
+// A small harness in the style of Google Benchmark. A benchmark is a function taking a MicroBenchState,
+// it times the body of its `for (auto _ : state)` loop and the harness picks the iteration count.
+//
+//	static void BM_Something(MicroBenchState& state)
+//	{
+//		for (auto _ : state)
+//			DoSomething(state.Range(0));
+//	}
+//	VKAPP_MICROBENCH(BM_Something)->Range(64, 4096);
+class MicroBenchState
+{
+public:
+	MicroBenchState(const std::vector<int64_t>& args, uint64_t iterations);
+
+	inline int64_t Range(size_t index = 0) const { return m_Args[index]; }
+	inline uint64_t Iterations() const { return m_Iterations; }
+
+	// Everything between these isn't counted, use it for per iteration setup and cleanup.
+	void PauseTiming();
+	void ResumeTiming();
+
+	// Reported as throughput, in total over all iterations.
+	inline void SetBytesProcessed(int64_t bytes) { m_BytesProcessed = bytes; }
+	inline void SetItemsProcessed(int64_t items) { m_ItemsProcessed = items; }
+	inline void SetLabel(const std::string& label) { m_Label = label; }
+
+	// Stops the benchmark, the message is reported instead of the timings.
+	void SkipWithError(const std::string& message);
+
+	inline bool HasError() const { return !m_Error.empty(); }
+
+public:
+	struct Iterator
+	{
+	public:
+		MicroBenchState* State = nullptr;
+		uint64_t Remaining = 0;
+
+		// Note: Timing stops as soon as the loop ends, whatever comes after it isn't counted.
+		inline bool operator!=(const Iterator&) const
+		{
+			if (Remaining != 0 && !State->HasError())
+				return true;
+
+			State->PauseTiming();
+			return false;
+		}
+		inline Iterator& operator++() { Remaining--; return *this; }
+		inline int operator*() const { return 0; }
+	};
+
+	Iterator begin();
+	Iterator end();
+
+private:
+	std::vector<int64_t> m_Args = { };
+	uint64_t m_Iterations = 0;
+
+	std::chrono::steady_clock::time_point m_Start = { };
+	std::chrono::nanoseconds m_Elapsed = { };
+	bool m_Running = false;
+
+	int64_t m_BytesProcessed = 0;
+	int64_t m_ItemsProcessed = 0;
+	std::string m_Label = { };
+	std::string m_Error = { };
+
+	friend class MicroBenchRunner;
+};
+
+class MicroBenchmark
+{
+public:
+	using Function = std::function<void(MicroBenchState&)>;
+
+	MicroBenchmark(const std::string& name, Function function);
+
+	MicroBenchmark* Arg(int64_t arg);
+	MicroBenchmark* Args(std::initializer_list<int64_t> args);
+	MicroBenchmark* Range(int64_t start, int64_t limit); // Powers of RangeMultiplier in between, both ends included
+	MicroBenchmark* RangeMultiplier(int64_t multiplier);
+	MicroBenchmark* ArgNames(std::initializer_list<std::string> names);
+
+	// Fixes the iteration count, for benchmarks that are too slow to be repeated much.
+	MicroBenchmark* Iterations(uint64_t iterations);
+
+	std::string GetRunName(size_t argsIndex) const;
+
+	inline const std::string& GetName() const { return m_Name; }
+	inline const std::vector<std::vector<int64_t>>& GetArgs() const { return m_Args; }
+
+private:
+	std::string m_Name;
+	Function m_Function;
+
+	std::vector<std::vector<int64_t>> m_Args = { };
+	std::vector<std::string> m_ArgNames = { };
+	int64_t m_RangeMultiplier = 8;
+	uint64_t m_Iterations = 0; // 0 means picked by the runner
+
+	friend class MicroBenchRunner;
+};
+
+struct MicroBenchSettings
+{
+public:
+	std::string Filter = { };	// Only runs benchmarks whose run name contains this
+	double MinTime = 0.5;		// Seconds, the iteration count grows until a run takes at least this long
+	uint32_t Repetitions = 1;	// Above 1, mean/median/stddev are reported as well
+	bool List = false;			// Only prints the run names
+
+	std::filesystem::path Output = { }; // JSON results are written here when set
+
+public:
+	// Takes Google Benchmark's flag names: --benchmark_filter, --benchmark_min_time,
+	// --benchmark_repetitions, --benchmark_list_tests and --benchmark_out. Returns false on unknown flags.
+	bool Parse(int argc, char* argv[]);
+};
+
+struct MicroBenchResult
+{
+public:
+	std::string Name = { };
+	std::string Aggregate = { }; // Empty for single runs, "mean", "median" or "stddev" otherwise
+	std::string Label = { };
+	std::string Error = { };
+
+	uint64_t Iterations = 0;
+	double TimeNs = 0.0;			// Per iteration
+	double BytesPerSecond = 0.0;
+	double ItemsPerSecond = 0.0;
+};
+
+class MicroBenchRunner
+{
+public:
+	static MicroBenchmark* Register(const std::string& name, MicroBenchmark::Function function);
+
+	// Returns the number of benchmarks that failed.
+	static uint32_t RunAll(const MicroBenchSettings& settings);
+
+private:
+	static MicroBenchResult Run(MicroBenchmark& benchmark, size_t argsIndex, const MicroBenchSettings& settings);
+	static void RunOnce(MicroBenchmark& benchmark, MicroBenchState& state);
+
+	static void PrintHeader();
+	static void PrintResult(const MicroBenchResult& result);
+	static bool WriteJSON(const std::filesystem::path& path, const std::vector<MicroBenchResult>& results);
+
+	static std::vector<MicroBenchmark*>& GetBenchmarks();
+};
+
+#define VKAPP_MICROBENCH_CONCAT_INNER(a, b) a##b
+#define VKAPP_MICROBENCH_CONCAT(a, b) VKAPP_MICROBENCH_CONCAT_INNER(a, b)
+#define VKAPP_MICROBENCH(function) static MicroBenchmark* VKAPP_MICROBENCH_CONCAT(s_MicroBench, __LINE__) = MicroBenchRunner::Register(#function, function)
\ No newline at end of file
@@ -0,0 +1,134 @@
+#include "MicroBench.hpp"
+
+#include <string>
+#include <vector>
+#include <filesystem>
+
+#include <VulkanCore/Renderer/Mesh.hpp>
+#include <VulkanCore/Renderer/InstanceManager.hpp>
+#include <VulkanCore/Renderer/DeviceObjectCache.hpp>
+#include <VulkanCore/Renderer/GraphicsPipelineManager.hpp>
+
+using namespace VkApp;
+
+static const char* s_VertexShader = "assets/shaders/vert.spv";
+static const char* s_FragmentShader = "assets/shaders/frag.spv";
+
+// Note: ReadFile() doesn't handle missing files, so check first.
+static bool ShadersExist()
+{
+	return std::filesystem::exists(s_VertexShader) && std::filesystem::exists(s_FragmentShader);
+}
+
+static PipelineInfo GetPipelineInfo()
+{
+	DescriptorInfo uniformDescriptor = {};
+	uniformDescriptor.Binding = 0;
+
+	DescriptorInfo imageDescriptor = {};
+	imageDescriptor.Binding = 1;
+	imageDescriptor.DescriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	imageDescriptor.StageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+	PipelineInfo info = {};
+	info.VertexShader = GraphicsPipelineManager::ReadFile(s_VertexShader);
+	info.FragmentShader = GraphicsPipelineManager::ReadFile(s_FragmentShader);
+	info.VertexBindingDescription = MeshVertex::GetBindingDescription();
+	info.VertexAttributeDescriptions = MeshVertex::GetAttributeDescriptions();
+	info.DescriptorSets.Set0 = { uniformDescriptor, imageDescriptor };
+
+	return info;
+}
+
+// ===================================
+// ------------- Shaders -------------
+// ===================================
+static void BM_CreateShaderModule(MicroBenchState& state)
+{
+	if (!ShadersExist())
+	{
+		state.SkipWithError("Failed to find the shaders, run from the VulkanSandbox directory.");
+		return;
+	}
+
+	std::vector<char> code = GraphicsPipelineManager::ReadFile(state.Range(0) == 0 ? s_VertexShader : s_FragmentShader);
+
+	for (auto _ : state)
+	{
+		VkShaderModule module = GraphicsPipelineManager::CreateShaderModule(code);
+
+		state.PauseTiming();
+		vkDestroyShaderModule(InstanceManager::Get()->GetLogicalDevice(), module, nullptr);
+		state.ResumeTiming();
+	}
+
+	state.SetBytesProcessed((int64_t)(state.Iterations() * code.size()));
+	state.SetLabel(state.Range(0) == 0 ? "vert.spv" : "frag.spv");
+}
+VKAPP_MICROBENCH(BM_CreateShaderModule)->ArgNames({ "stage" })->Arg(0)->Arg(1);
+
+// ===================================
+// ------------ Pipelines ------------
+// ===================================
+// Creates a batch of identical pipelines, which includes their layouts, descriptor pools and sets.
+static void BM_CreatePipeline(MicroBenchState& state)
+{
+	int64_t count = state.Range(0);
+
+	if (!ShadersExist())
+	{
+		state.SkipWithError("Failed to find the shaders, run from the VulkanSandbox directory.");
+		return;
+	}
+
+	PipelineInfo info = GetPipelineInfo();
+
+	for (auto _ : state)
+	{
+		for (int64_t i = 0; i < count; i++)
+			GraphicsPipelineManager::Get()->CreatePipeline("MicroBench Pipeline " + std::to_string(i), info);
+
+		state.PauseTiming();
+		for (int64_t i = 0; i < count; i++)
+			GraphicsPipelineManager::Get()->DestroyPipeline("MicroBench Pipeline " + std::to_string(i));
+		state.ResumeTiming();
+	}
+
+	state.SetItemsProcessed((int64_t)state.Iterations() * count);
+}
+VKAPP_MICROBENCH(BM_CreatePipeline)->ArgNames({ "count" })->Range(1, 64);
+
+// ===================================
+// ------------ Descriptors ----------
+// ===================================
+// A pool and a set per frame in flight for a layout of the given amount of bindings, half of them samplers.
+static void BM_AllocateDescriptorSets(MicroBenchState& state)
+{
+	uint32_t bindings = (uint32_t)state.Range(0);
+
+	std::vector<DescriptorInfo> descriptors(bindings);
+	for (uint32_t i = 0; i < bindings; i++)
+	{
+		descriptors[i].Binding = i;
+		if (i % 2)
+		{
+			descriptors[i].DescriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			descriptors[i].StageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+		}
+	}
+
+	VkDescriptorSetLayout layout = DescriptorSets::GetDescriptorSetLayout(descriptors);
+
+	for (auto _ : state)
+	{
+		VkDescriptorPool pool = DescriptorSets::CreatePool(descriptors);
+		std::vector<VkDescriptorSet> sets = DescriptorSets::CreateDescriptorSets(layout, pool, descriptors);
+
+		state.PauseTiming();
+		vkDestroyDescriptorPool(InstanceManager::Get()->GetLogicalDevice(), pool, nullptr);
+		state.ResumeTiming();
+	}
+
+	DeviceObjectCache::Get()->Release(layout);
+}
+VKAPP_MICROBENCH(BM_AllocateDescriptorSets)->ArgNames({ "bindings" })->RangeMultiplier(2)->Range(1, 32);
\ No newline at end of file
@@ -0,0 +1,36 @@
+#include <VulkanCore/Core/Application.hpp>
+#include <VulkanCore/Core/Logging.hpp>
+
+#include "MicroBench.hpp"
+
+// ----------------------------------------------------------------
+// Usage: VulkanMicroBench [--benchmark_filter name] [--benchmark_min_time seconds]
+//                         [--benchmark_repetitions n] [--benchmark_out results.json]
+//
+// Runs headless, so any Vulkan 1.2 driver works, including a software
+// one like lavapipe (VK_ICD_FILENAMES=.../lvp_icd.x86_64.json).
+// Run it from the VulkanSandbox directory, it needs the shaders.
+// ----------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+	MicroBenchSettings settings = {};
+	if (!settings.Parse(argc, argv))
+		return 2;
+
+	VkApp::AppInfo appInfo;
+	appInfo.ArgCount = argc;
+	appInfo.Args = argv;
+
+	appInfo.WindowProperties.Name = "VulkanMicroBench";
+	appInfo.WindowProperties.Headless = true;
+
+	// Note: The application is only created to initialize the renderer, Run() is never called.
+	VkApp::Application* app = new VkApp::Application(appInfo);
+
+	uint32_t failed = MicroBenchRunner::RunAll(settings);
+	if (failed != 0)
+		VKAPP_LOG_ERROR("{0} benchmark(s) failed.", failed);
+
+	delete app;
+	return failed == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -1,3 +1,6 @@
 C:/VulkanSDK/1.3.216.0/Bin/glslc.exe shader.vert -o vert.spv
 C:/VulkanSDK/1.3.216.0/Bin/glslc.exe shader.frag -o frag.spv
+C:/VulkanSDK/1.3.216.0/Bin/glslc.exe mipgen.comp -o mipgen.spv
+C:/VulkanSDK/1.3.216.0/Bin/glslc.exe -I ../../../VulkanCore/src/VulkanCore/Renderer virtualtexture.vert -o vtvert.spv
+C:/VulkanSDK/1.3.216.0/Bin/glslc.exe -I ../../../VulkanCore/src/VulkanCore/Renderer virtualtexture.frag -o vtfrag.spv
 pause
\ No newline at end of file
@@ -0,0 +1,32 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+#include "VirtualTexture.glsl"
+
+layout(binding = 0) uniform VirtualTextureUniforms {
+    VirtualTextureParams Params;
+    vec2 Center;
+    float Zoom;
+} u_Uniforms;
+
+layout(binding = 1) uniform usampler2D u_Indirection;
+layout(binding = 2) uniform sampler2D u_Atlas;
+
+layout(binding = 3) writeonly buffer VirtualTextureFeedback {
+    uint Requests[];
+} u_Feedback;
+
+layout(location = 0) in vec2 fragTexCoord;
+
+layout(location = 0) out vec4 outColor;
+
+void main() 
+{
+    vec2 uv = u_Uniforms.Center + (fragTexCoord - 0.5) / u_Uniforms.Zoom;
+
+    uint request;
+    outColor = VT_Sample(u_Indirection, u_Atlas, uv, u_Uniforms.Params, request);
+
+    uvec2 feedbackTexel = uvec2(gl_FragCoord.xy) / VT_FEEDBACK_SCALE;
+    u_Feedback.Requests[feedbackTexel.y * u_Uniforms.Params.FeedbackWidth + feedbackTexel.x] = request;
+}
\ No newline at end of file
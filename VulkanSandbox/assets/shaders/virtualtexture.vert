@@ -0,0 +1,17 @@
+#version 450
+
+layout(location = 0) out vec2 fragTexCoord;
+
+// No vertex buffer, a quad in the bottom right corner of the screen.
+const vec2 c_Corners[6] = vec2[](
+    vec2(0.0, 0.0), vec2(0.0, 1.0), vec2(1.0, 1.0),
+    vec2(0.0, 0.0), vec2(1.0, 1.0), vec2(1.0, 0.0)
+);
+
+void main() 
+{
+    vec2 corner = c_Corners[gl_VertexIndex];
+    gl_Position = vec4(mix(vec2(0.3), vec2(0.95), corner), 0.0, 1.0);
+
+    fragTexCoord = corner;
+}
\ No newline at end of file
@@ -56,6 +56,13 @@ project "VulkanSandbox"
 			"GLFW_INCLUDE_NONE"
 		}
 
+		-- The virtual texture shaders include VirtualTexture.glsl from VulkanCore
+		prebuildcommands
+		{
+			'"%{VULKAN_SDK}/Bin/glslc.exe" -I "%{wks.location}/VulkanCore/src/VulkanCore/Renderer" "%{prj.location}/assets/shaders/virtualtexture.vert" -o "%{prj.location}/assets/shaders/vtvert.spv"',
+			'"%{VULKAN_SDK}/Bin/glslc.exe" -I "%{wks.location}/VulkanCore/src/VulkanCore/Renderer" "%{prj.location}/assets/shaders/virtualtexture.frag" -o "%{prj.location}/assets/shaders/vtfrag.spv"'
+		}
+
 	filter "configurations:Debug"
 		defines "VKAPP_DEBUG"
 		runtime "Debug"
@@ -1,10 +1,13 @@
 #include "Custom.hpp"
 
+#include <cmath>
+
 #include <imgui.h>
 
 #include <VulkanCore/Core/Application.hpp>
 #include <VulkanCore/Core/Input/Input.hpp>
 #include <VulkanCore/Core/Logging.hpp>
+#include <VulkanCore/Core/Profiler.hpp>
 #include <VulkanCore/Renderer/Renderer.hpp>
 #include <VulkanCore/Utils/BufferManager.hpp>
 
@@ -23,6 +26,24 @@ struct UniformBufferObject
 	glm::mat4 Proj;
 };
 
+SpinLayer::SpinLayer()
+	: Layer("SpinLayer")
+{
+	SetParallel(true);
+}
+
+void SpinLayer::OnUpdate(float deltaTime)
+{
+	m_Angle = std::fmod(m_Angle + m_Speed * deltaTime, 360.0f);
+}
+
+CustomLayer::CustomLayer(SpinLayer* spin)
+	: Layer("CustomLayer"), m_Spin(spin)
+{
+	// Note: The model matrix uses the angle, so it has to be updated first.
+	DependsOn(spin);
+}
+
 void CustomLayer::OnAttach()
 {
 	PipelineInfo info = {};
@@ -44,17 +65,15 @@ void CustomLayer::OnAttach()
 
 	m_Pipeline = GraphicsPipelineManager::Get()->CreatePipeline("My Pipeline", info);
 
-	m_Mesh = Mesh("assets/objects/Cat.obj");
+	m_Mesh = AssetManager::LoadMesh("assets/objects/Cat.obj");
+	m_Texture = AssetManager::LoadStreamedTexture("assets/objects/Cat_diffuse.jpg");
 
 	BufferManager::CreateUniformBuffer(m_UniformBuffers, sizeof(UniformBufferObject), m_UniformBuffersMemory, m_UniformBuffersMapped);
 
-	uint32_t mipLevels = 0;
-	BufferManager::CreateTexture("assets/objects/Cat_diffuse.jpg", m_TextureImage, m_TextureImageMemory, mipLevels);
-	m_TextureView = BufferManager::CreateImageView(m_TextureImage, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels);
-	m_Sampler = BufferManager::CreateSampler(mipLevels);
+	m_TextureVersions.assign(Renderer::Get()->GetFramesInFlight(), m_Texture.Get().GetViewVersion());
 
 	// Initialize the descriptor sets/uniforms
-	for (size_t i = 0; i < VKAPP_MAX_FRAMES_IN_FLIGHT; i++) 
+	for (size_t i = 0; i < Renderer::Get()->GetFramesInFlight(); i++) 
 	{
 		// Uniform
 		VkDescriptorBufferInfo bufferInfo = {};
@@ -74,8 +93,8 @@ void CustomLayer::OnAttach()
 		// Image
 		VkDescriptorImageInfo imageInfo = {};
 		imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-		imageInfo.imageView = m_TextureView;
-		imageInfo.sampler = m_Sampler;
+		imageInfo.imageView = m_Texture.Get().GetImageView();
+		imageInfo.sampler = m_Texture.Get().GetSampler();
 
 		VkWriteDescriptorSet descriptorWrite2 = {};
 		descriptorWrite2.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -106,24 +125,21 @@ void CustomLayer::OnDetach()
 
 	vkDeviceWaitIdle(logicalDevice);
 
-	m_Mesh.Destroy();
+	// Note: The mesh and texture are owned by the AssetManager.
 
-	for (size_t i = 0; i < VKAPP_MAX_FRAMES_IN_FLIGHT; i++) 
+	for (size_t i = 0; i < m_UniformBuffers.size(); i++) 
 	{
-		vkDestroyBuffer(logicalDevice, m_UniformBuffers[i], nullptr);
-		vkFreeMemory(logicalDevice, m_UniformBuffersMemory[i], nullptr);
+		BufferManager::DestroyBuffer(m_UniformBuffers[i], m_UniformBuffersMemory[i]);
 	}
-
-	vkDestroySampler(logicalDevice, m_Sampler, nullptr);
-	vkDestroyImageView(logicalDevice, m_TextureView, nullptr);
-
-	vkDestroyImage(logicalDevice, m_TextureImage, nullptr);
-	vkFreeMemory(logicalDevice, m_TextureImageMemory, nullptr);
 }
 
 void CustomLayer::OnUpdate(float deltaTime)
 {
+	if (m_TraceFrames > 0 && --m_TraceFrames == 0)
+		VKAPP_PROFILE_END_SESSION(Application::GetWorkingDirectory() / "CpuTrace.json");
+
 	UpdateUniformBuffers(deltaTime, Renderer::Get()->GetCurrentImage());
+	UpdateTextureDescriptor(Renderer::Get()->GetCurrentImage());
 
 	static float timer = 0.0f;
 	timer += deltaTime;
@@ -145,14 +161,17 @@ void CustomLayer::OnRender()
 			std::vector<VkDeviceSize> offsets = { {0} };
 			uint32_t currentFrame = Renderer::Get()->GetCurrentImage();
 
+			Mesh& mesh = m_Mesh.Get();
+			m_Texture.Touch(); // Note: Only referenced through the descriptor set, so mark it as used manually.
+
 			m_Pipeline.Bind(buffer, VK_PIPELINE_BIND_POINT_GRAPHICS);
 
-			vkCmdBindVertexBuffers(buffer, 0, 1, &m_Mesh.GetVertexBuffer(), offsets.data());
-			vkCmdBindIndexBuffer(buffer, m_Mesh.GetIndexBuffer(), 0, VK_INDEX_TYPE_UINT32);
+			vkCmdBindVertexBuffers(buffer, 0, 1, &mesh.GetVertexBuffer(), offsets.data());
+			vkCmdBindIndexBuffer(buffer, mesh.GetIndexBuffer(), 0, VK_INDEX_TYPE_UINT32);
 
 			vkCmdBindDescriptorSets(buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipeline.GetPipelineLayout(), 0, 1, &m_Pipeline.GetDescriptorSets()[0][currentFrame], 0, nullptr);
 	
-			vkCmdDrawIndexed(buffer, m_Mesh.GetAmountOfIndices(), 1, 0, 0, 0);
+			vkCmdDrawIndexed(buffer, mesh.GetAmountOfIndices(), 1, 0, 0, 0);
 		});
 }
 
@@ -167,8 +186,21 @@ void CustomLayer::OnImGuiRender()
 	ImGui::DragFloat("Pitch", &m_Camera.GetCameraSettings().Pitch);
 	ImGui::Spacing();
 	ImGui::DragFloat("Speed", &m_Camera.GetSpeed(), 0.2f);
+	ImGui::Spacing();
+	ImGui::DragFloat("Spin Speed", &m_Spin->GetSpeed(), 1.0f);
+
+	#if VKAPP_PROFILING
+	ImGui::Spacing();
+	if (m_TraceFrames == 0 && ImGui::Button("Capture CPU Trace"))
+	{
+		VKAPP_PROFILE_BEGIN_SESSION();
+		m_TraceFrames = 120;
+	}
+	#endif
 
 	ImGui::End();
+
+	GpuProfiler::Get()->DrawImGui();
 }
 
 void CustomLayer::OnEvent(Event& e)
@@ -189,6 +221,7 @@ void CustomLayer::UpdateUniformBuffers(float deltaTime, uint32_t imageIndex)
 
 		UniformBufferObject ubo = {};
 		ubo.Model = glm::rotate(glm::mat4(1.0f), glm::radians(270.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+		ubo.Model = glm::rotate(ubo.Model, glm::radians(m_Spin->GetAngle()), glm::vec3(0.0f, 0.0f, 1.0f));
 
 		ubo.View = m_Camera.GetViewMatrix();
 
@@ -196,5 +229,35 @@ void CustomLayer::UpdateUniformBuffers(float deltaTime, uint32_t imageIndex)
 		ubo.Proj[1][1] *= -1;
 
 		BufferManager::SetUniformData(m_UniformBuffersMapped[imageIndex], (void*)(&ubo), sizeof(ubo));
+
+		// Stream in as much detail as the mesh covers on screen
+		glm::vec2 viewportSize = { (float)window.GetWidth(), (float)window.GetHeight() };
+		m_Texture.Get().SetScreenFootprint(StreamedTexture::EstimateScreenFootprint(m_Mesh.Get().GetBounds(), ubo.Model, ubo.Proj * ubo.View, viewportSize));
 	}
 }
+
+
+void CustomLayer::UpdateTextureDescriptor(uint32_t imageIndex)
+{
+	StreamedTexture& texture = m_Texture.Get();
+	if (m_TextureVersions[imageIndex] == texture.GetViewVersion())
+		return;
+
+	VkDescriptorImageInfo imageInfo = {};
+	imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	imageInfo.imageView = texture.GetImageView();
+	imageInfo.sampler = texture.GetSampler();
+
+	VkWriteDescriptorSet descriptorWrite = {};
+	descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	descriptorWrite.dstSet = m_Pipeline.GetDescriptorSets()[0][imageIndex];
+	descriptorWrite.dstBinding = 1;
+	descriptorWrite.dstArrayElement = 0;
+	descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	descriptorWrite.descriptorCount = 1;
+	descriptorWrite.pImageInfo = &imageInfo;
+
+	vkUpdateDescriptorSets(InstanceManager::Get()->GetLogicalDevice(), 1, &descriptorWrite, 0, nullptr);
+
+	m_TextureVersions[imageIndex] = texture.GetViewVersion();
+}
\ No newline at end of file
@@ -4,6 +4,7 @@
 
 #include <VulkanCore/Core/Layer.hpp>
 #include <VulkanCore/Renderer/Mesh.hpp>
+#include <VulkanCore/Renderer/AssetManager.hpp>
 #include <VulkanCore/Renderer/GraphicsPipelineManager.hpp>
 
 #include <vulkan/vulkan.h>
@@ -12,9 +13,27 @@
 
 using namespace VkApp;
 
+// Turns the model, parallel since it only touches its own state.
+class SpinLayer : public Layer
+{
+public:
+	SpinLayer();
+
+	void OnUpdate(float deltaTime) override;
+
+	inline float GetAngle() const { return m_Angle; }
+	inline float& GetSpeed() { return m_Speed; }
+
+private:
+	float m_Angle = 0.0f;	// Degrees
+	float m_Speed = 20.0f;	// Degrees per second
+};
+
 class CustomLayer : public Layer
 {
 public:
+	CustomLayer(SpinLayer* spin);
+
 	void OnAttach() override;
 	void OnDetach() override;
 
@@ -26,21 +45,24 @@ public:
 
 private:
 	void UpdateUniformBuffers(float deltaTime, uint32_t imageIndex);
+	void UpdateTextureDescriptor(uint32_t imageIndex);
 
 private:
 	GraphicsPipeline m_Pipeline;
 
-	Mesh m_Mesh;
+	MeshHandle m_Mesh;
+	StreamedTextureHandle m_Texture;
 
 	std::vector<VkBuffer> m_UniformBuffers = { };
 	std::vector<VkDeviceMemory> m_UniformBuffersMemory = { };
 	std::vector<void*> m_UniformBuffersMapped = { };
 
-	VkImage m_TextureImage = VK_NULL_HANDLE;
-	VkDeviceMemory m_TextureImageMemory = VK_NULL_HANDLE;
-
-	VkImageView m_TextureView = VK_NULL_HANDLE;
-	VkSampler m_Sampler = VK_NULL_HANDLE;
+	// Note: Descriptors of frames in flight can't be touched, so each frame swaps in the texture on its own turn.
+	// The view changes when the texture finishes loading and every time a mip level streams in or out.
+	std::vector<uint64_t> m_TextureVersions = { };
 
 	Camera m_Camera;
+	SpinLayer* m_Spin = nullptr;
+
+	uint32_t m_TraceFrames = 0; // Frames left to capture, the trace is written when it hits 0
 };
\ No newline at end of file
@@ -0,0 +1,266 @@
+#include "VirtualTextureLayer.hpp"
+
+#include <array>
+#include <memory>
+
+#include <imgui.h>
+
+#include <VulkanCore/Core/Application.hpp>
+#include <VulkanCore/Core/Logging.hpp>
+#include <VulkanCore/Renderer/Renderer.hpp>
+#include <VulkanCore/Renderer/InstanceManager.hpp>
+#include <VulkanCore/Utils/BufferManager.hpp>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#define VIRTUAL_TEXTURE_SIZE 2048u
+
+struct VirtualTextureUniforms
+{
+	VirtualTextureParams Params;
+	glm::vec2 Center;
+	float Zoom;
+};
+
+// A colour per page with a grid every 16 texels, so it's easy to see which pages and mips are resident.
+static TextureData CreateVirtualTextureData()
+{
+	TextureData data = {};
+	data.Width = VIRTUAL_TEXTURE_SIZE;
+	data.Height = VIRTUAL_TEXTURE_SIZE;
+	data.Pixels.resize((size_t)data.Width * data.Height * 4);
+
+	for (uint32_t y = 0; y < data.Height; y++)
+	{
+		for (uint32_t x = 0; x < data.Width; x++)
+		{
+			uint32_t pageX = x / VKAPP_VIRTUAL_PAGE_SIZE, pageY = y / VKAPP_VIRTUAL_PAGE_SIZE;
+			bool grid = (x % 16 == 0) || (y % 16 == 0);
+
+			uint8_t* pixel = data.Pixels.data() + ((size_t)y * data.Width + x) * 4;
+			pixel[0] = grid ? 255 : (uint8_t)(pageX * 255 / (VIRTUAL_TEXTURE_SIZE / VKAPP_VIRTUAL_PAGE_SIZE));
+			pixel[1] = grid ? 255 : (uint8_t)(pageY * 255 / (VIRTUAL_TEXTURE_SIZE / VKAPP_VIRTUAL_PAGE_SIZE));
+			pixel[2] = grid ? 255 : (uint8_t)(((pageX + pageY) % 2) * 128);
+			pixel[3] = 255;
+		}
+	}
+
+	return data;
+}
+
+VirtualTextureLayer::VirtualTextureLayer()
+	: Layer("VirtualTextureLayer")
+{
+}
+
+void VirtualTextureLayer::OnAttach()
+{
+	if (!InstanceManager::Get()->IsFragmentStoresSupported())
+	{
+		VKAPP_LOG_WARN("fragmentStoresAndAtomics is not supported, the virtual texture layer is disabled.");
+		return;
+	}
+
+	auto& window = Application::Get().GetWindow();
+
+	VirtualTextureInfo vtInfo = {};
+	vtInfo.Source = std::make_shared<ImageVirtualTextureSource>(CreateVirtualTextureData());
+	vtInfo.ViewportWidth = window.GetWidth();
+	vtInfo.ViewportHeight = window.GetHeight();
+
+	m_VirtualTexture = std::make_unique<VirtualTexture>(vtInfo);
+
+	PipelineInfo info = {};
+	info.VertexShader = GraphicsPipelineManager::ReadFile("assets\\shaders\\vtvert.spv");
+	info.FragmentShader = GraphicsPipelineManager::ReadFile("assets\\shaders\\vtfrag.spv");
+
+	DescriptorInfo uniformDescriptor = {};
+	uniformDescriptor.Binding = 0;
+	uniformDescriptor.StageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+	info.DescriptorSets.Set0.push_back(uniformDescriptor);
+
+	DescriptorInfo indirectionDescriptor = {};
+	indirectionDescriptor.Binding = 1;
+	indirectionDescriptor.DescriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	indirectionDescriptor.StageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+	info.DescriptorSets.Set0.push_back(indirectionDescriptor);
+
+	DescriptorInfo atlasDescriptor = {};
+	atlasDescriptor.Binding = 2;
+	atlasDescriptor.DescriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	atlasDescriptor.StageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+	info.DescriptorSets.Set0.push_back(atlasDescriptor);
+
+	DescriptorInfo feedbackDescriptor = {};
+	feedbackDescriptor.Binding = 3;
+	feedbackDescriptor.DescriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+	feedbackDescriptor.StageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+	info.DescriptorSets.Set0.push_back(feedbackDescriptor);
+
+	m_Pipeline = GraphicsPipelineManager::Get()->CreatePipeline("VirtualTexture", info);
+
+	BufferManager::CreateUniformBuffer(m_UniformBuffers, sizeof(VirtualTextureUniforms), m_UniformBuffersMemory, m_UniformBuffersMapped);
+
+	UpdateDescriptors();
+
+	Renderer::SetRenderGraph([this](RenderGraph& graph, RenderGraphHandle backbuffer) { BuildRenderGraph(graph, backbuffer); });
+
+	m_Enabled = true;
+}
+
+void VirtualTextureLayer::OnDetach()
+{
+	if (!m_Enabled)
+		return;
+
+	vkDeviceWaitIdle(InstanceManager::Get()->GetLogicalDevice());
+
+	Renderer::SetRenderGraph({ });
+	m_VirtualTexture->Destroy();
+	m_VirtualTexture.reset();
+
+	for (size_t i = 0; i < m_UniformBuffers.size(); i++)
+		BufferManager::DestroyBuffer(m_UniformBuffers[i], m_UniformBuffersMemory[i]);
+
+	m_Enabled = false;
+}
+
+void VirtualTextureLayer::OnUpdate(float deltaTime)
+{
+	if (!m_Enabled)
+		return;
+
+	m_VirtualTexture->Update();
+
+	VirtualTextureUniforms uniforms = {};
+	uniforms.Params = m_VirtualTexture->GetParams();
+	uniforms.Center = m_Center;
+	uniforms.Zoom = m_Zoom;
+
+	BufferManager::SetUniformData(m_UniformBuffersMapped[Renderer::Get()->GetCurrentImage()], (void*)(&uniforms), sizeof(uniforms));
+}
+
+void VirtualTextureLayer::OnRender()
+{
+	if (!m_Enabled)
+		return;
+
+	// Note: The section of the feedback buffer belongs to this frame, so it's captured now.
+	uint32_t feedbackOffset = m_VirtualTexture->GetFeedbackOffset();
+
+	Renderer::AddToQueue([this, feedbackOffset](VkCommandBuffer& buffer, uint32_t imageIndex)
+		{
+			uint32_t currentFrame = Renderer::Get()->GetCurrentImage();
+
+			m_Pipeline.Bind(buffer, VK_PIPELINE_BIND_POINT_GRAPHICS);
+
+			vkCmdBindDescriptorSets(buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipeline.GetPipelineLayout(), 0, 1, &m_Pipeline.GetDescriptorSets()[0][currentFrame], 1, &feedbackOffset);
+
+			vkCmdDraw(buffer, 6, 1, 0, 0);
+		}, "VirtualTexture");
+}
+
+void VirtualTextureLayer::OnImGuiRender()
+{
+	if (!m_Enabled)
+		return;
+
+	ImGui::Begin("Virtual Texture");
+
+	ImGui::DragFloat2("Center", glm::value_ptr(m_Center), 0.005f, 0.0f, 1.0f);
+	ImGui::DragFloat("Zoom", &m_Zoom, 0.05f, 1.0f, 64.0f);
+	ImGui::Spacing();
+	ImGui::Text("Resident pages: %u", m_VirtualTexture->GetResidentPageCount());
+	ImGui::Text("Pending pages: %u", m_VirtualTexture->GetPendingPageCount());
+
+	ImGui::End();
+}
+
+void VirtualTextureLayer::OnEvent(Event& e)
+{
+	EventHandler handler(e);
+
+	handler.Handle<WindowResizeEvent>(VKAPP_BIND_EVENT_FN(VirtualTextureLayer::Resize));
+}
+
+bool VirtualTextureLayer::Resize(WindowResizeEvent& e)
+{
+	if (!m_Enabled || e.GetWidth() == 0 || e.GetHeight() == 0)
+		return false;
+
+	// Note: Resize() waits for the device, so the descriptors can be rewritten right away.
+	// The graph is rebuilt because it imported the old feedback buffer.
+	m_VirtualTexture->Resize(e.GetWidth(), e.GetHeight());
+	UpdateDescriptors();
+
+	Renderer::SetRenderGraph([this](RenderGraph& graph, RenderGraphHandle backbuffer) { BuildRenderGraph(graph, backbuffer); });
+
+	return false;
+}
+
+void VirtualTextureLayer::BuildRenderGraph(RenderGraph& graph, RenderGraphHandle backbuffer)
+{
+	RenderGraphHandle depth = graph.GetResource("Depth");
+	RenderGraphHandle feedback = m_VirtualTexture->ImportFeedback(graph, "VirtualTextureFeedback");
+
+	// The default graph's main pass, plus the feedback the virtual texture writes.
+	graph.AddPass("Main", [backbuffer, depth, feedback](RenderGraphBuilder& builder)
+	{
+		builder.Write(backbuffer, RenderGraphUsage::ColorAttachment);
+		builder.Write(depth, RenderGraphUsage::DepthAttachment);
+		builder.Write(feedback, RenderGraphUsage::FragmentStorageWrite);
+	},
+	[](VkCommandBuffer& commandBuffer, RenderGraph& graph)
+	{
+		Renderer::ExecuteRenderQueue(commandBuffer);
+		Renderer::ExecuteUIQueue(commandBuffer);
+	});
+}
+
+void VirtualTextureLayer::UpdateDescriptors()
+{
+	for (size_t i = 0; i < Renderer::Get()->GetFramesInFlight(); i++)
+	{
+		VkDescriptorBufferInfo uniformInfo = {};
+		uniformInfo.buffer = m_UniformBuffers[i];
+		uniformInfo.offset = 0;
+		uniformInfo.range = sizeof(VirtualTextureUniforms);
+
+		VkDescriptorImageInfo indirectionInfo = {};
+		indirectionInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		indirectionInfo.imageView = m_VirtualTexture->GetIndirectionView();
+		indirectionInfo.sampler = m_VirtualTexture->GetIndirectionSampler();
+
+		VkDescriptorImageInfo atlasInfo = {};
+		atlasInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		atlasInfo.imageView = m_VirtualTexture->GetAtlasView();
+		atlasInfo.sampler = m_VirtualTexture->GetAtlasSampler();
+
+		// Note: The offset is the dynamic offset of the frame, see VirtualTexture::GetFeedbackOffset().
+		VkDescriptorBufferInfo feedbackInfo = {};
+		feedbackInfo.buffer = m_VirtualTexture->GetFeedbackBuffer();
+		feedbackInfo.offset = 0;
+		feedbackInfo.range = m_VirtualTexture->GetFeedbackRange();
+
+		std::array<VkWriteDescriptorSet, 4> writes = { };
+		for (uint32_t binding = 0; binding < writes.size(); binding++)
+		{
+			writes[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[binding].dstSet = m_Pipeline.GetDescriptorSets()[0][i];
+			writes[binding].dstBinding = binding;
+			writes[binding].dstArrayElement = 0;
+			writes[binding].descriptorCount = 1;
+		}
+
+		writes[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		writes[0].pBufferInfo = &uniformInfo;
+		writes[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		writes[1].pImageInfo = &indirectionInfo;
+		writes[2].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		writes[2].pImageInfo = &atlasInfo;
+		writes[3].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+		writes[3].pBufferInfo = &feedbackInfo;
+
+		vkUpdateDescriptorSets(InstanceManager::Get()->GetLogicalDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+
+#include <VulkanCore/Core/Layer.hpp>
+#include <VulkanCore/Core/Events.hpp>
+#include <VulkanCore/Renderer/VirtualTexture.hpp>
+#include <VulkanCore/Renderer/GraphicsPipelineManager.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <glm/glm.hpp>
+
+using namespace VkApp;
+
+// Shows a procedural virtual texture on a quad in the corner of the screen, zooming in streams in the finer pages.
+// Replaces the render graph to add the feedback buffer to the main pass.
+class VirtualTextureLayer : public Layer
+{
+public:
+	VirtualTextureLayer();
+
+	void OnAttach() override;
+	void OnDetach() override;
+
+	void OnUpdate(float deltaTime) override;
+	void OnRender() override;
+	void OnImGuiRender() override;
+
+	void OnEvent(Event& e) override;
+
+private:
+	bool Resize(WindowResizeEvent& e);
+
+	void BuildRenderGraph(RenderGraph& graph, RenderGraphHandle backbuffer);
+	void UpdateDescriptors();
+
+private:
+	bool m_Enabled = false; // Feedback is written from the fragment shader, which needs fragmentStoresAndAtomics
+
+	std::unique_ptr<VirtualTexture> m_VirtualTexture = nullptr; // Owns a streaming thread, so it can't be moved
+	GraphicsPipeline m_Pipeline;
+
+	std::vector<VkBuffer> m_UniformBuffers = { };
+	std::vector<VkDeviceMemory> m_UniformBuffersMemory = { };
+	std::vector<void*> m_UniformBuffersMapped = { };
+
+	glm::vec2 m_Center = { 0.5f, 0.5f };
+	float m_Zoom = 1.0f;
+};
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <VulkanCore/Entrypoint.hpp>
 
 #include "Custom.hpp"
+#include "VirtualTextureLayer.hpp"
 
 // Create your own application class
 class Sandbox : public VkApp::Application
@@ -11,7 +12,10 @@ public:
 		: VkApp::Application(appInfo)
 	{
 		// Add your own custom layers/overlays
-		AddLayer(new CustomLayer());
+		SpinLayer* spin = new SpinLayer();
+		AddLayer(spin);
+		AddLayer(new CustomLayer(spin));
+		AddLayer(new VirtualTextureLayer());
 	}
 };
 
@@ -30,5 +34,7 @@ VkApp::Application* VkApp::CreateApplication(int argc, char* argv[])
 	appInfo.WindowProperties.Name = "Custom";
 	appInfo.WindowProperties.VSync = false;
 
+	appInfo.RendererSettings.FramesInFlight = 2;
+
 	return new Sandbox(appInfo);
 }
\ No newline at end of file
@@ -29,4 +29,9 @@ group "Core"
 	include "VulkanCore"
 group ""
 
-include "VulkanSandbox"
\ No newline at end of file
+include "VulkanSandbox"
+
+group "Tools"
+	include "VulkanBench"
+	include "VulkanMicroBench"
+group ""
\ No newline at end of file